@@ -15,6 +15,7 @@
 
 #include "ui_appearance.h"
 #include "ui_appearance_ability_client.h"
+#include "ui_appearance_cache.h"
 namespace OHOS {
 namespace ArkUi::UiAppearance {
 namespace {
@@ -95,10 +96,14 @@ void AniThrow(ani_env *env, const std::string &errMsg, int32_t code)
 
 void OnComplete([[maybe_unused]] ani_env* env, AsyncContext* asyncContext)
 {
-    if (env == nullptr) {
-        delete asyncContext;
-        return;
+    if (env != nullptr) {
+        SettleAsyncContext(env, asyncContext);
     }
+    AsyncContextPool::Release(asyncContext);
+}
+
+void SettleAsyncContext(ani_env* env, AsyncContext* asyncContext)
+{
     ani_boolean errorExists;
     env->ExistUnhandledError(&errorExists);
     ani_status OnStatus = ANI_OK;
@@ -139,7 +144,6 @@ void OnComplete([[maybe_unused]] ani_env* env, AsyncContext* asyncContext)
             }
         }
     }
-    delete asyncContext;
 }
 
 DarkMode ConvertJsDarkMode2Enum(int32_t jsVal)
@@ -159,7 +163,7 @@ void SetDarkMode([[maybe_unused]] ani_env* env, ani_enum_item mode, ani_object c
     if (!env) {
         return;
     }
-    auto asyncContext = new (std::nothrow) AsyncContext();
+    auto asyncContext = AsyncContextPool::Acquire();
     if (asyncContext == nullptr) {
         AniThrow(env, "create AsyncContext failed.", UiAppearanceAbilityErrCode::SYS_ERR);
         return;
@@ -197,7 +201,7 @@ ani_object SetDarkModeWithPromise([[maybe_unused]] ani_env* env, ani_enum_item m
     }
     env->GetUndefined(&resultref);
     ani_object result = static_cast<ani_object>(resultref);
-    auto asyncContext = new (std::nothrow) AsyncContext();
+    auto asyncContext = AsyncContextPool::Acquire();
     if (asyncContext == nullptr) {
         AniThrow(env, "create AsyncContext failed.", UiAppearanceAbilityErrCode::SYS_ERR);
         return result;
@@ -239,7 +243,7 @@ ani_enum_item GetDarkMode([[maybe_unused]] ani_env* env)
         return result;
     }
     env->GetUndefined(&resultref);
-    auto mode = UiAppearanceAbilityClient::GetInstance()->GetDarkMode();
+    auto mode = UiAppearanceCache::GetInstance().GetDarkMode();
     if (mode == UiAppearanceAbilityErrCode::SYS_ERR) {
         AniThrow(env, "get dark-mode failed.", UiAppearanceAbilityErrCode::SYS_ERR);
         return result;
@@ -273,13 +277,12 @@ ani_object SetFontScale([[maybe_unused]] ani_env* env, ani_double fontScale)
     ani_ref resultref = nullptr;
     env->GetUndefined(&resultref);
     ani_object result = static_cast<ani_object>(resultref);
-    auto asyncContext = new (std::nothrow) AsyncContext();
+    auto asyncContext = AsyncContextPool::Acquire();
     if (asyncContext == nullptr) {
         AniThrow(env, "create AsyncContext failed.", UiAppearanceAbilityErrCode::SYS_ERR);
         return result;
     }
     asyncContext->ani_FontScale = fontScale;
-    asyncContext->fontScale = std::to_string(asyncContext->ani_FontScale);
     if (asyncContext->callbackRef == nullptr) {
         if (ANI_OK != env->Promise_New(&asyncContext->deferred, &result)) {
             LOGE("Promise_New failed");
@@ -290,7 +293,7 @@ ani_object SetFontScale([[maybe_unused]] ani_env* env, ani_double fontScale)
     if (asyncContext->ani_FontScale <= MIN_FONT_SCALE || asyncContext->ani_FontScale > MAX_FONT_SCALE) {
         resCode = UiAppearanceAbilityErrCode::INVALID_ARG;
     } else {
-        resCode = UiAppearanceAbilityClient::GetInstance()->SetFontScale(asyncContext->fontScale);
+        resCode = UiAppearanceAbilityClient::GetInstance()->SetFontScaleValue(asyncContext->ani_FontScale);
     }
     asyncContext->status = static_cast<UiAppearanceAbilityErrCode>(resCode);
     if (asyncContext->status == UiAppearanceAbilityErrCode::PERMISSION_ERR) {
@@ -314,8 +317,8 @@ ani_double GetFontScale([[maybe_unused]] ani_env* env)
         return result;
     }
     env->GetUndefined(&resultref);
-    std::string fontScale;
-    auto ret = UiAppearanceAbilityClient::GetInstance()->GetFontScale(fontScale);
+    double fontScale = 0;
+    auto ret = UiAppearanceCache::GetInstance().GetFontScale(fontScale);
     if (ret == UiAppearanceAbilityErrCode::SYS_ERR) {
         AniThrow(env, "get font-scale failed.", UiAppearanceAbilityErrCode::SYS_ERR);
         return result;
@@ -326,8 +329,7 @@ ani_double GetFontScale([[maybe_unused]] ani_env* env)
             UiAppearanceAbilityErrCode::PERMISSION_ERR);
         return result;
     }
-    double fontScaleNumber = std::stod(fontScale);
-    result = ani_double(fontScaleNumber);
+    result = ani_double(fontScale);
     return result;
 }
 
@@ -342,13 +344,12 @@ ani_object SetFontWeightScale([[maybe_unused]] ani_env* env, ani_double fontWeig
     if (env == nullptr) {
         return result;
     }
-    auto asyncContext = new (std::nothrow) AsyncContext();
+    auto asyncContext = AsyncContextPool::Acquire();
     if (asyncContext == nullptr) {
         AniThrow(env, "create AsyncContext failed.", UiAppearanceAbilityErrCode::SYS_ERR);
         return result;
     }
     asyncContext->ani_FontWeightScale = fontWeightScale;
-    asyncContext->fontWeightScale = std::to_string(asyncContext->ani_FontWeightScale);
     if (asyncContext->callbackRef == nullptr) {
         if (ANI_OK != env->Promise_New(&asyncContext->deferred, &result)) {
             LOGE("Promise_New failed");
@@ -362,7 +363,7 @@ ani_object SetFontWeightScale([[maybe_unused]] ani_env* env, ani_double fontWeig
         resCode = UiAppearanceAbilityErrCode::INVALID_ARG;
     } else {
         resCode = UiAppearanceAbilityClient::GetInstance()
-            ->SetFontWeightScale(asyncContext->fontWeightScale);
+            ->SetFontWeightScaleValue(asyncContext->ani_FontWeightScale);
     }
     asyncContext->status = static_cast<UiAppearanceAbilityErrCode>(resCode);
     if (asyncContext->status == UiAppearanceAbilityErrCode::PERMISSION_ERR) {
@@ -384,8 +385,8 @@ ani_double GetFontWeightScale([[maybe_unused]] ani_env* env)
         return result;
     }
     env->GetUndefined(&resultref);
-    std::string fontWeightScale;
-    auto ret = UiAppearanceAbilityClient::GetInstance()->GetFontWeightScale(fontWeightScale);
+    double fontWeightScale = 0;
+    auto ret = UiAppearanceCache::GetInstance().GetFontWeightScale(fontWeightScale);
     if (ret == UiAppearanceAbilityErrCode::SYS_ERR) {
         AniThrow(env, "get font-Weight-scale failed.", UiAppearanceAbilityErrCode::SYS_ERR);
         return result;
@@ -396,8 +397,48 @@ ani_double GetFontWeightScale([[maybe_unused]] ani_env* env)
             UiAppearanceAbilityErrCode::PERMISSION_ERR);
         return result;
     }
-    double fontWeightScaleNumber = std::stod(fontWeightScale);
-    result = ani_double(fontWeightScaleNumber);
+    result = ani_double(fontWeightScale);
+    return result;
+}
+
+ani_object Refresh([[maybe_unused]] ani_env* env)
+{
+    if (!env) {
+        return nullptr;
+    }
+    ani_ref resultref = nullptr;
+    env->GetUndefined(&resultref);
+    ani_object result = static_cast<ani_object>(resultref);
+    ani_vm* vm = nullptr;
+    if (ANI_OK != env->GetVM(&vm)) {
+        AniThrow(env, "get vm failed.", UiAppearanceAbilityErrCode::SYS_ERR);
+        return result;
+    }
+    // Settled on the worker thread, so it does not come from the per-thread pool.
+    auto asyncContext = new (std::nothrow) AsyncContext();
+    if (asyncContext == nullptr) {
+        AniThrow(env, "create AsyncContext failed.", UiAppearanceAbilityErrCode::SYS_ERR);
+        return result;
+    }
+    if (ANI_OK != env->Promise_New(&asyncContext->deferred, &result)) {
+        LOGE("Promise_New failed");
+        delete asyncContext;
+        return nullptr;
+    }
+    // Refreshing waits for the service, so it runs off the ETS thread like the NAPI async work does.
+    std::thread([vm, asyncContext]() {
+        asyncContext->status = static_cast<UiAppearanceAbilityErrCode>(UiAppearanceCache::GetInstance().Refresh());
+        ani_env* workerEnv = nullptr;
+        ani_options aniArgs { 0, nullptr };
+        if (ANI_OK != vm->AttachCurrentThread(&aniArgs, ANI_VERSION_1, &workerEnv)) {
+            LOGE("AttachCurrentThread failed, refresh result dropped");
+            delete asyncContext;
+            return;
+        }
+        SettleAsyncContext(workerEnv, asyncContext);
+        vm->DetachCurrentThread();
+        delete asyncContext;
+    }).detach();
     return result;
 }
 } // namespace ArkUi::UiAppearance
@@ -443,10 +484,13 @@ ANI_EXPORT ani_status ANI_Constructor(ani_vm *vm, uint32_t *result)
             "setFontWeightScale", nullptr, reinterpret_cast<void*>(OHOS::ArkUi::UiAppearance::SetFontWeightScale) },
         ani_native_function {
             "getFontWeightScale", nullptr, reinterpret_cast<void*>(OHOS::ArkUi::UiAppearance::GetFontWeightScale) },
+        ani_native_function { "refresh", nullptr, reinterpret_cast<void*>(OHOS::ArkUi::UiAppearance::Refresh) },
     };
     if (ANI_OK != env->Namespace_BindNativeFunctions(ns, methods.data(), methods.size())) {
         return ANI_ERROR;
     }
+    // Getters are served from memory; warm the cache in the background before the first one runs.
+    OHOS::ArkUi::UiAppearance::UiAppearanceCache::GetInstance().Prefetch();
 
     *result = ANI_VERSION_1;
     return ANI_OK;
@@ -28,6 +28,7 @@
 #include <string>
 #include <ani_signature_builder.h>
 
+#include "thread_local_free_list.h"
 #include "ui_appearance_types.h"
 #include "ui_appearance_log.h"
 namespace OHOS {
@@ -40,15 +41,31 @@ struct AsyncContext {
     ani_double ani_FontScale = 0;
     ani_double ani_FontWeightScale = 0;
     std::string errMsg;
-    UiAppearanceAbilityErrCode status;
-    DarkMode mode;
-    std::string fontScale;
-    std::string fontWeightScale;
+    UiAppearanceAbilityErrCode status = UiAppearanceAbilityErrCode::SUCCEEDED;
+    DarkMode mode = DarkMode::UNKNOWN;
+
+    void Reset()
+    {
+        deferred = nullptr;
+        callbackRef = nullptr;
+        ani_SetArg = -1;
+        ani_FontScale = 0;
+        ani_FontWeightScale = 0;
+        errMsg.clear();
+        status = UiAppearanceAbilityErrCode::SUCCEEDED;
+        mode = DarkMode::UNKNOWN;
+    }
 };
 
+// Contexts are acquired and settled on the calling ETS thread, so they are recycled per thread.
+constexpr size_t ASYNC_CONTEXT_POOL_CAPACITY = 4;
+using AsyncContextPool = ThreadLocalFreeList<AsyncContext, ASYNC_CONTEXT_POOL_CAPACITY>;
+
 ani_object GetErrorObject(ani_env *env, const std::string &errMsg, int32_t code);
 void AniThrow(ani_env *env, const std::string &errMsg, int32_t code);
 void OnComplete([[maybe_unused]] ani_env* env, AsyncContext* asyncContext);
+// Resolves or rejects without releasing, for contexts settled off the thread that acquired them.
+void SettleAsyncContext(ani_env* env, AsyncContext* asyncContext);
 DarkMode ConvertJsDarkMode2Enum(int32_t jsVal);
 void SetDarkMode([[maybe_unused]] ani_env* env, ani_enum_item mode, ani_object callbackObj);
 ani_object SetDarkModeWithPromise([[maybe_unused]] ani_env* env, ani_enum_item mode);
@@ -57,6 +74,7 @@ ani_object SetFontScale([[maybe_unused]] ani_env* env, ani_double fontScale);
 ani_double GetFontScale([[maybe_unused]] ani_env* env);
 ani_object SetFontWeightScale([[maybe_unused]] ani_env* env, ani_double fontWeightScale);
 ani_double GetFontWeightScale([[maybe_unused]] ani_env* env);
+ani_object Refresh([[maybe_unused]] ani_env* env);
 ANI_EXPORT ani_status ANI_Constructor(ani_vm *vm, uint32_t *result);
 } // namespace ArkUi::UiAppearance
 } // namespace OHOS
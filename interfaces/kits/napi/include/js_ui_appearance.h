@@ -16,27 +16,136 @@
 #ifndef JS_UI_APPEARANCE_H
 #define JS_UI_APPEARANCE_H
 
+#include <array>
+#include <mutex>
 #include <string>
+#include <vector>
 
 #include "napi/native_api.h"
 #include "napi/native_common.h"
 #include "napi/native_node_api.h"
+#include "thread_local_free_list.h"
 #include "ui_appearance_ability_client.h"
 
 namespace OHOS {
 namespace ArkUi::UiAppearance {
-struct AsyncContext {
-    napi_async_work work = nullptr;
+// One JS caller waiting for a request, settled through either its promise or its callback.
+struct AsyncWaiter {
     napi_deferred deferred = nullptr;
     napi_ref callbackRef = nullptr;
+};
+
+struct AsyncContext {
+    napi_async_work work = nullptr;
+    std::vector<AsyncWaiter> waiters;
     int32_t jsSetArg = -1;
     double jsFontScale = 0;
     double jsFontWeightScale = 0;
     std::string errMsg;
-    UiAppearanceAbilityErrCode status;
-    DarkMode mode;
-    std::string fontScale;
-    std::string fontWeightScale;
+    UiAppearanceAbilityErrCode status = UiAppearanceAbilityErrCode::SUCCEEDED;
+    DarkMode mode = DarkMode::UNKNOWN;
+    // Guards the request arguments and waiters against the worker once the context is queued.
+    std::mutex mutex;
+    bool isExecuting = false;
+
+    void Reset()
+    {
+        work = nullptr;
+        waiters.clear();
+        jsSetArg = -1;
+        jsFontScale = 0;
+        jsFontWeightScale = 0;
+        errMsg.clear();
+        status = UiAppearanceAbilityErrCode::SUCCEEDED;
+        mode = DarkMode::UNKNOWN;
+        isExecuting = false;
+    }
+
+    // Called on the JS thread: folds a newer request into this queued one, so only the latest value reaches the
+    // service and every caller is settled with its result. Fails once a worker has started on this context.
+    template<typename Update>
+    bool TryMerge(const AsyncWaiter& waiter, const Update& update)
+    {
+        std::lock_guard lock(mutex);
+        if (isExecuting) {
+            return false;
+        }
+        update(*this);
+        waiters.push_back(waiter);
+        return true;
+    }
+
+    // Called on the worker before it reads the arguments; later requests get a context of their own.
+    void BeginExecute()
+    {
+        std::lock_guard lock(mutex);
+        isExecuting = true;
+    }
+};
+
+// Per-env recycling of contexts, see ThreadLocalFreeList.
+constexpr size_t ASYNC_CONTEXT_POOL_CAPACITY = 8;
+using AsyncContextPool = ThreadLocalFreeList<AsyncContext, ASYNC_CONTEXT_POOL_CAPACITY>;
+
+enum RequestKind : size_t {
+    REQUEST_SET_DARK_MODE = 0,
+    REQUEST_SET_FONT_SCALE,
+    REQUEST_SET_FONT_WEIGHT_SCALE,
+    REQUEST_REFRESH,
+    REQUEST_KIND_COUNT,
+};
+
+/**
+ * Keeps, per kind, the queued context that later requests may still merge into. Requests are made and completed on
+ * the JS thread, so a thread-local table is a per-env table.
+ */
+class RequestMerger final {
+public:
+    // Folds the request into the queued context of its kind and sets isMerged when it can, otherwise returns a new
+    // context carrying the request for the caller to queue. Returns nullptr when no context can be allocated.
+    template<typename Update>
+    static AsyncContext* Submit(
+        RequestKind kind, const AsyncWaiter& waiter, const Update& update, bool isMergeable, bool& isMerged)
+    {
+        AsyncContext*& queued = GetTable()[kind];
+        isMerged = isMergeable && queued != nullptr && queued->TryMerge(waiter, update);
+        if (isMerged) {
+            return queued;
+        }
+        AsyncContext* asyncContext = AsyncContextPool::Acquire();
+        if (asyncContext == nullptr) {
+            return nullptr;
+        }
+        update(*asyncContext);
+        asyncContext->waiters.push_back(waiter);
+        // An invalid value is never merged with, so its caller keeps its own error.
+        queued = isMergeable ? asyncContext : nullptr;
+        return asyncContext;
+    }
+
+    // Called once the worker is done with the context: later requests get a context of their own, and the returned
+    // waiters are every caller merged into it, in call order. They stay valid until the context is released.
+    static const std::vector<AsyncWaiter>& Complete(AsyncContext* asyncContext)
+    {
+        for (auto& queued : GetTable()) {
+            if (queued == asyncContext) {
+                queued = nullptr;
+            }
+        }
+        return asyncContext->waiters;
+    }
+
+    static AsyncContext* GetQueued(RequestKind kind)
+    {
+        return GetTable()[kind];
+    }
+
+private:
+    static std::array<AsyncContext*, REQUEST_KIND_COUNT>& GetTable()
+    {
+        thread_local std::array<AsyncContext*, REQUEST_KIND_COUNT> table = {};
+        return table;
+    }
 };
 
 class JsUiAppearance final {
@@ -45,6 +154,7 @@ public:
     static void OnComplete(napi_env env, napi_status status, void* data);
     static void OnSetFontScale(napi_env env, void* data);
     static void OnSetFontWeightScale(napi_env env, void* data);
+    static void OnRefresh(napi_env env, void* data);
     static napi_status CheckArgs(napi_env env, size_t argc, napi_value* argv);
     static napi_status CheckFontScaleArgs(napi_env env, size_t argc, napi_value* argv);
     static DarkMode ConvertJsDarkMode2Enum(int32_t jsVal);
@@ -19,6 +19,7 @@
 #include "js_native_api.h"
 #include "ipc_skeleton.h"
 #include "tokenid_kit.h"
+#include "ui_appearance_cache.h"
 #include "ui_appearance_log.h"
 
 namespace OHOS {
@@ -64,6 +65,52 @@ void NapiThrow(napi_env env, const std::string& message, int32_t errCode)
     napi_create_error(env, code, msg, &error);
     napi_throw(env, error);
 }
+
+// Takes the trailing callback when the caller passed callbackArgc arguments, otherwise creates the promise to return.
+AsyncWaiter CreateWaiter(napi_env env, size_t argc, napi_value* argv, size_t callbackArgc, napi_value& result)
+{
+    AsyncWaiter waiter;
+    if (argc == callbackArgc) {
+        napi_create_reference(env, argv[callbackArgc - 1], 1, &waiter.callbackRef);
+    }
+    if (waiter.callbackRef == nullptr) {
+        napi_create_promise(env, &waiter.deferred, &result);
+    }
+    return waiter;
+}
+
+template<typename Update>
+bool QueueRequest(napi_env env, RequestKind kind, const char* resourceName, napi_async_execute_callback execute,
+    const AsyncWaiter& waiter, const Update& update, bool isMergeable)
+{
+    bool isMerged = false;
+    AsyncContext* asyncContext = RequestMerger::Submit(kind, waiter, update, isMergeable, isMerged);
+    if (asyncContext == nullptr) {
+        return false;
+    }
+    if (isMerged) {
+        return true;
+    }
+    napi_value resource = nullptr;
+    napi_create_string_utf8(env, resourceName, NAPI_AUTO_LENGTH, &resource);
+    napi_create_async_work(env, nullptr, resource, execute, JsUiAppearance::OnComplete,
+        reinterpret_cast<void*>(asyncContext), &asyncContext->work);
+    napi_queue_async_work(env, asyncContext->work);
+    return true;
+}
+
+void QueueRequestFailed(napi_env env, const AsyncWaiter& waiter)
+{
+    if (waiter.callbackRef != nullptr) {
+        napi_delete_reference(env, waiter.callbackRef);
+    }
+    NapiThrow(env, "create AsyncContext failed.", UiAppearanceAbilityErrCode::SYS_ERR);
+}
+
+bool IsValidFontScale(double fontScale)
+{
+    return fontScale > MIN_FONT_SCALE && fontScale <= MAX_FONT_SCALE;
+}
 } // namespace
 
 void JsUiAppearance::OnExecute(napi_env env, void* data)
@@ -74,6 +121,7 @@ void JsUiAppearance::OnExecute(napi_env env, void* data)
         NapiThrow(env, "asyncContext is null.", UiAppearanceAbilityErrCode::SYS_ERR);
         return;
     }
+    asyncContext->BeginExecute();
     auto resCode = UiAppearanceAbilityClient::GetInstance()->SetDarkMode(asyncContext->mode);
     asyncContext->status = static_cast<UiAppearanceAbilityErrCode>(resCode);
     if (asyncContext->status == UiAppearanceAbilityErrCode::PERMISSION_ERR) {
@@ -93,13 +141,14 @@ void JsUiAppearance::OnSetFontScale(napi_env env, void* data)
         NapiThrow(env, "asyncContext is null.", UiAppearanceAbilityErrCode::SYS_ERR);
         return;
     }
+    asyncContext->BeginExecute();
     int32_t resCode = 0;
     if (!CheckCallerIsSystemApp()) {
         resCode = UiAppearanceAbilityErrCode::NOT_SYSTEM_APP;
-    } else if (asyncContext->jsFontScale <= MIN_FONT_SCALE || asyncContext->jsFontScale > MAX_FONT_SCALE) {
+    } else if (!IsValidFontScale(asyncContext->jsFontScale)) {
         resCode = UiAppearanceAbilityErrCode::INVALID_ARG;
     } else {
-        resCode = UiAppearanceAbilityClient::GetInstance()->SetFontScale(asyncContext->fontScale);
+        resCode = UiAppearanceAbilityClient::GetInstance()->SetFontScaleValue(asyncContext->jsFontScale);
     }
 
     asyncContext->status = static_cast<UiAppearanceAbilityErrCode>(resCode);
@@ -122,15 +171,15 @@ void JsUiAppearance::OnSetFontWeightScale(napi_env env, void* data)
         NapiThrow(env, "asyncContext is null.", UiAppearanceAbilityErrCode::SYS_ERR);
         return;
     }
+    asyncContext->BeginExecute();
     int32_t resCode = 0;
     if (!CheckCallerIsSystemApp()) {
         resCode = UiAppearanceAbilityErrCode::NOT_SYSTEM_APP;
-    } else if (asyncContext->jsFontWeightScale <= MIN_FONT_SCALE ||
-        asyncContext->jsFontWeightScale > MAX_FONT_SCALE) {
+    } else if (!IsValidFontScale(asyncContext->jsFontWeightScale)) {
         resCode = UiAppearanceAbilityErrCode::INVALID_ARG;
     } else {
         resCode = UiAppearanceAbilityClient::GetInstance()
-            ->SetFontWeightScale(asyncContext->fontWeightScale);
+            ->SetFontWeightScaleValue(asyncContext->jsFontWeightScale);
     }
 
     asyncContext->status = static_cast<UiAppearanceAbilityErrCode>(resCode);
@@ -145,6 +194,20 @@ void JsUiAppearance::OnSetFontWeightScale(napi_env env, void* data)
     }
 }
 
+void JsUiAppearance::OnRefresh(napi_env env, void* data)
+{
+    LOGI("OnRefresh begin.");
+    AsyncContext* asyncContext = static_cast<AsyncContext*>(data);
+    if (asyncContext == nullptr) {
+        NapiThrow(env, "asyncContext is null.", UiAppearanceAbilityErrCode::SYS_ERR);
+        return;
+    }
+    asyncContext->BeginExecute();
+    auto resCode = UiAppearanceCache::GetInstance().Refresh();
+    asyncContext->status = static_cast<UiAppearanceAbilityErrCode>(resCode);
+    asyncContext->errMsg = "";
+}
+
 void JsUiAppearance::OnComplete(napi_env env, napi_status status, void* data)
 {
     LOGI("OnComplete begin.");
@@ -161,17 +224,11 @@ void JsUiAppearance::OnComplete(napi_env env, napi_status status, void* data)
         return;
     }
 
+    const std::vector<AsyncWaiter>& waiters = RequestMerger::Complete(asyncContext);
+
+    napi_value result = nullptr;
     if (asyncContext->status == UiAppearanceAbilityErrCode::SUCCEEDED) {
-        napi_value result = nullptr;
         napi_get_null(env, &result);
-        if (asyncContext->deferred) { // promise
-            napi_resolve_deferred(env, asyncContext->deferred, result);
-        } else { // AsyncCallback
-            napi_value callback = nullptr;
-            napi_get_reference_value(env, asyncContext->callbackRef, &callback);
-            napi_value ret;
-            napi_call_function(env, nullptr, callback, 1, &result, &ret);
-        }
     } else {
         napi_value code = nullptr;
         std::string strCode = std::to_string(asyncContext->status);
@@ -182,22 +239,26 @@ void JsUiAppearance::OnComplete(napi_env env, napi_status status, void* data)
         LOGI("napi throw errCode %{public}d, strMsg %{public}s", asyncContext->status, strMsg.c_str());
         napi_create_string_utf8(env, strMsg.c_str(), strMsg.length(), &msg);
 
-        napi_value error = nullptr;
-        napi_create_error(env, code, msg, &error);
-        if (asyncContext->deferred) { // promise
-            napi_reject_deferred(env, asyncContext->deferred, error);
-        } else { // AsyncCallback
+        napi_create_error(env, code, msg, &result);
+    }
+    // Merged callers are settled in call order with the result of the value that reached the service.
+    for (const AsyncWaiter& waiter : waiters) {
+        if (waiter.deferred) { // promise
+            if (asyncContext->status == UiAppearanceAbilityErrCode::SUCCEEDED) {
+                napi_resolve_deferred(env, waiter.deferred, result);
+            } else {
+                napi_reject_deferred(env, waiter.deferred, result);
+            }
+        } else if (waiter.callbackRef) { // AsyncCallback
             napi_value callback = nullptr;
-            napi_get_reference_value(env, asyncContext->callbackRef, &callback);
+            napi_get_reference_value(env, waiter.callbackRef, &callback);
             napi_value ret;
-            napi_call_function(env, nullptr, callback, 1, &error, &ret);
+            napi_call_function(env, nullptr, callback, 1, &result, &ret);
+            napi_delete_reference(env, waiter.callbackRef);
         }
     }
     napi_delete_async_work(env, asyncContext->work);
-    if (asyncContext->callbackRef) {
-        napi_delete_reference(env, asyncContext->callbackRef);
-    }
-    delete asyncContext;
+    AsyncContextPool::Release(asyncContext);
     napi_close_handle_scope(env, scope);
 }
 
@@ -307,27 +368,18 @@ static napi_value JSSetDarkMode(napi_env env, napi_callback_info info)
         return result;
     }
 
-    auto asyncContext = new (std::nothrow) AsyncContext();
-    if (asyncContext == nullptr) {
-        NapiThrow(env, "create AsyncContext failed.", UiAppearanceAbilityErrCode::SYS_ERR);
-        return result;
-    }
-
-    napi_get_value_int32(env, argv[0], &asyncContext->jsSetArg);
-    asyncContext->mode = JsUiAppearance::ConvertJsDarkMode2Enum(asyncContext->jsSetArg);
-    if (argc == ARGC_WITH_TWO) {
-        napi_create_reference(env, argv[1], 1, &asyncContext->callbackRef);
-    }
-    if (asyncContext->callbackRef == nullptr) {
-        napi_create_promise(env, &asyncContext->deferred, &result);
+    int32_t jsSetArg = -1;
+    napi_get_value_int32(env, argv[0], &jsSetArg);
+    DarkMode mode = JsUiAppearance::ConvertJsDarkMode2Enum(jsSetArg);
+    AsyncWaiter waiter = CreateWaiter(env, argc, argv, ARGC_WITH_TWO, result);
+    auto update = [jsSetArg, mode](AsyncContext& asyncContext) {
+        asyncContext.jsSetArg = jsSetArg;
+        asyncContext.mode = mode;
+    };
+    if (!QueueRequest(env, REQUEST_SET_DARK_MODE, "JSSetDarkMode", JsUiAppearance::OnExecute, waiter, update,
+        mode != DarkMode::UNKNOWN)) {
+        QueueRequestFailed(env, waiter);
     }
-
-    napi_value resource = nullptr;
-    napi_create_string_utf8(env, "JSSetDarkMode", NAPI_AUTO_LENGTH, &resource);
-    napi_create_async_work(env, nullptr, resource, JsUiAppearance::OnExecute, JsUiAppearance::OnComplete,
-        reinterpret_cast<void*>(asyncContext), &asyncContext->work);
-    napi_queue_async_work(env, asyncContext->work);
-
     return result;
 }
 
@@ -344,7 +396,7 @@ static napi_value JSGetDarkMode(napi_env env, napi_callback_info info)
         return result;
     }
 
-    auto mode = UiAppearanceAbilityClient::GetInstance()->GetDarkMode();
+    auto mode = UiAppearanceCache::GetInstance().GetDarkMode();
     if (mode == UiAppearanceAbilityErrCode::SYS_ERR) {
         NapiThrow(env, "get dark-mode failed.", UiAppearanceAbilityErrCode::SYS_ERR);
         return result;
@@ -365,15 +417,14 @@ static napi_value JSGetFontScale(napi_env env, napi_callback_info info)
         return result;
     }
 
-    std::string fontScale;
-    auto ret = UiAppearanceAbilityClient::GetInstance()->GetFontScale(fontScale);
+    double fontScale = 0;
+    auto ret = UiAppearanceCache::GetInstance().GetFontScale(fontScale);
     if (ret == UiAppearanceAbilityErrCode::SYS_ERR) {
         NapiThrow(env, "get font-scale failed.", UiAppearanceAbilityErrCode::SYS_ERR);
         return result;
     }
 
-    double fontScaleNumber = std::stod(fontScale);
-    NAPI_CALL(env, napi_create_double(env, fontScaleNumber, &result));
+    NAPI_CALL(env, napi_create_double(env, fontScale, &result));
     return result;
 }
 
@@ -397,27 +448,14 @@ static napi_value JSSetFontScale(napi_env env, napi_callback_info info)
         NapiThrow(env, "parameter parsing error.", UiAppearanceAbilityErrCode::INVALID_ARG);
         return result;
     }
-    auto asyncContext = new (std::nothrow) AsyncContext();
-    if (asyncContext == nullptr) {
-        NapiThrow(env, "create AsyncContext failed.", UiAppearanceAbilityErrCode::SYS_ERR);
-        return result;
-    }
-    napi_get_value_double(env, argv[0], &asyncContext->jsFontScale);
-
-    asyncContext->fontScale = std::to_string(asyncContext->jsFontScale);
-    if (argc == ARGC_WITH_TWO) {
-        napi_create_reference(env, argv[1], 1, &asyncContext->callbackRef);
-    }
-    if (asyncContext->callbackRef == nullptr) {
-        napi_create_promise(env, &asyncContext->deferred, &result);
+    double fontScale = 0;
+    napi_get_value_double(env, argv[0], &fontScale);
+    AsyncWaiter waiter = CreateWaiter(env, argc, argv, ARGC_WITH_TWO, result);
+    auto update = [fontScale](AsyncContext& asyncContext) { asyncContext.jsFontScale = fontScale; };
+    if (!QueueRequest(env, REQUEST_SET_FONT_SCALE, "JSSetFontScale", JsUiAppearance::OnSetFontScale, waiter, update,
+        IsValidFontScale(fontScale))) {
+        QueueRequestFailed(env, waiter);
     }
-
-    napi_value resource = nullptr;
-    napi_create_string_utf8(env, "JSSetFontScale", NAPI_AUTO_LENGTH, &resource);
-    napi_create_async_work(env, nullptr, resource, JsUiAppearance::OnSetFontScale, JsUiAppearance::OnComplete,
-        reinterpret_cast<void*>(asyncContext), &asyncContext->work);
-    napi_queue_async_work(env, asyncContext->work);
-
     return result;
 }
 
@@ -433,15 +471,14 @@ static napi_value JSGetFontWeightScale(napi_env env, napi_callback_info info)
         return result;
     }
 
-    std::string fontWeightScale;
-    auto ret = UiAppearanceAbilityClient::GetInstance()->GetFontWeightScale(fontWeightScale);
+    double fontWeightScale = 0;
+    auto ret = UiAppearanceCache::GetInstance().GetFontWeightScale(fontWeightScale);
     if (ret == UiAppearanceAbilityErrCode::SYS_ERR) {
         NapiThrow(env, "get font-Weight-scale failed.", UiAppearanceAbilityErrCode::SYS_ERR);
         return result;
     }
 
-    double fontWeightScaleNumber = std::stod(fontWeightScale);
-    NAPI_CALL(env, napi_create_double(env, fontWeightScaleNumber, &result));
+    NAPI_CALL(env, napi_create_double(env, fontWeightScale, &result));
     return result;
 }
 
@@ -465,27 +502,43 @@ static napi_value JSSetFontWeightScale(napi_env env, napi_callback_info info)
         NapiThrow(env, "parameter parsing error.", UiAppearanceAbilityErrCode::INVALID_ARG);
         return result;
     }
-    auto asyncContext = new (std::nothrow) AsyncContext();
-    if (asyncContext == nullptr) {
-        NapiThrow(env, "create AsyncContext failed.", UiAppearanceAbilityErrCode::SYS_ERR);
-        return result;
+    double fontWeightScale = 0;
+    napi_get_value_double(env, argv[0], &fontWeightScale);
+    AsyncWaiter waiter = CreateWaiter(env, argc, argv, ARGC_WITH_TWO, result);
+    auto update = [fontWeightScale](AsyncContext& asyncContext) { asyncContext.jsFontWeightScale = fontWeightScale; };
+    if (!QueueRequest(env, REQUEST_SET_FONT_WEIGHT_SCALE, "JSSetFontWeightScale", JsUiAppearance::OnSetFontWeightScale,
+        waiter, update, IsValidFontScale(fontWeightScale))) {
+        QueueRequestFailed(env, waiter);
     }
-    napi_get_value_double(env, argv[0], &asyncContext->jsFontWeightScale);
+    return result;
+}
+
+// Getters are served by UiAppearanceCache; refresh resolves once the cache holds what the service holds now.
+static napi_value JSRefresh(napi_env env, napi_callback_info info)
+{
+    size_t argc = ARGC_WITH_ONE;
+    napi_value argv[ARGC_WITH_ONE] = { 0 };
+    napi_value result = nullptr;
+    napi_get_undefined(env, &result);
 
-    asyncContext->fontWeightScale = std::to_string(asyncContext->jsFontWeightScale);
-    if (argc == ARGC_WITH_TWO) {
-        napi_create_reference(env, argv[1], 1, &asyncContext->callbackRef);
+    napi_status napiStatus = napi_get_cb_info(env, info, &argc, argv, nullptr, nullptr);
+    if (napiStatus != napi_ok) {
+        NapiThrow(env, "get callback info failed.", UiAppearanceAbilityErrCode::INVALID_ARG);
+        return result;
     }
-    if (asyncContext->callbackRef == nullptr) {
-        napi_create_promise(env, &asyncContext->deferred, &result);
+    if (argc == ARGC_WITH_ONE) {
+        napi_valuetype valueType = napi_undefined;
+        napi_typeof(env, argv[0], &valueType);
+        if (valueType != napi_function) {
+            NapiThrow(env, "the first parameter must be a function.", UiAppearanceAbilityErrCode::INVALID_ARG);
+            return result;
+        }
+    }
+    AsyncWaiter waiter = CreateWaiter(env, argc, argv, ARGC_WITH_ONE, result);
+    if (!QueueRequest(env, REQUEST_REFRESH, "JSRefresh", JsUiAppearance::OnRefresh, waiter, [](AsyncContext&) {},
+        true)) {
+        QueueRequestFailed(env, waiter);
     }
-
-    napi_value resource = nullptr;
-    napi_create_string_utf8(env, "JSSetFontWeightScale", NAPI_AUTO_LENGTH, &resource);
-    napi_create_async_work(env, nullptr, resource, JsUiAppearance::OnSetFontWeightScale, JsUiAppearance::OnComplete,
-        reinterpret_cast<void*>(asyncContext), &asyncContext->work);
-    napi_queue_async_work(env, asyncContext->work);
-
     return result;
 }
 
@@ -507,9 +560,12 @@ static napi_value UiAppearanceExports(napi_env env, napi_value exports)
         DECLARE_NAPI_FUNCTION("setFontScale", JSSetFontScale),
         DECLARE_NAPI_FUNCTION("getFontWeightScale", JSGetFontWeightScale),
         DECLARE_NAPI_FUNCTION("setFontWeightScale", JSSetFontWeightScale),
+        DECLARE_NAPI_FUNCTION("refresh", JSRefresh),
         DECLARE_NAPI_STATIC_PROPERTY("DarkMode", DarkMode),
     };
     NAPI_CALL(env, napi_define_properties(env, exports, sizeof(properties) / sizeof(properties[0]), properties));
+    // Warm the cache off the JS thread so that the first getter does not wait for the service either.
+    UiAppearanceCache::GetInstance().Prefetch();
     return exports;
 }
 EXTERN_C_END
@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef INTERFACE_KITS_NATIVE_INCLUDE_OH_UI_APPEARANCE_H
+#define INTERFACE_KITS_NATIVE_INCLUDE_OH_UI_APPEARANCE_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Appearance of the calling user as cached in this process. darkMode takes the DarkMode values (0 dark, 1 light).
+ * version grows by one for every change delivered to callbacks in this process.
+ */
+typedef struct OH_UIAppearance_Snapshot {
+    int32_t darkMode;
+    double fontScale;
+    double fontWeightScale;
+    uint64_t version;
+} OH_UIAppearance_Snapshot;
+
+/**
+ * Called on an internal worker thread after the dark mode, font scale or font weight scale changed. Callbacks run
+ * one change at a time and must not block; the snapshot is only valid during the call.
+ */
+typedef void (*OH_UIAppearance_ChangeCallback)(const OH_UIAppearance_Snapshot* snapshot, void* userData);
+
+/**
+ * Copies the cached appearance without any IPC. Returns 0 on success, 401 for a null snapshot, and 500001 while the
+ * cache is still empty; a fetch is then started in the background and registered callbacks are told when it lands.
+ */
+int32_t OH_UIAppearance_GetSnapshot(OH_UIAppearance_Snapshot* snapshot);
+
+/**
+ * Registers a change callback. The pair of callback and userData identifies the registration. Returns 0 on success,
+ * 401 for a null callback or a pair that is already registered.
+ */
+int32_t OH_UIAppearance_RegisterChangeCallback(OH_UIAppearance_ChangeCallback callback, void* userData);
+
+/**
+ * Unregisters a change callback. After a successful return the callback is not running and is not called again, so
+ * userData may be released; the exception is a callback unregistering itself, which may still be finishing.
+ * Returns 0 on success, 401 when the pair is not registered.
+ */
+int32_t OH_UIAppearance_UnregisterChangeCallback(OH_UIAppearance_ChangeCallback callback, void* userData);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // INTERFACE_KITS_NATIVE_INCLUDE_OH_UI_APPEARANCE_H
@@ -15,11 +15,36 @@
 
 #include "ui_appearance.h"
 
+#include <algorithm>
+#include <mutex>
+#include <vector>
+
+#include "oh_ui_appearance.h"
 #include "ui_appearance_ability_client.h"
+#include "ui_appearance_cache.h"
 
 namespace OHOS {
 namespace ArkUi {
 namespace UiAppearance {
+namespace {
+struct ChangeCallbackEntry {
+    OH_UIAppearance_ChangeCallback callback = nullptr;
+    void* userData = nullptr;
+    uint64_t listenerId = 0;
+};
+
+std::mutex g_changeCallbacksMutex;
+std::vector<ChangeCallbackEntry> g_changeCallbacks;
+
+void ToCSnapshot(const AppearanceSnapshot& snapshot, OH_UIAppearance_Snapshot& cSnapshot)
+{
+    cSnapshot.darkMode = snapshot.darkMode;
+    cSnapshot.fontScale = snapshot.fontScale;
+    cSnapshot.fontWeightScale = snapshot.fontWeightScale;
+    cSnapshot.version = snapshot.version;
+}
+} // namespace
+
 UIAppearance::SetDarkModeFunc UIAppearance::setDarkModeFunc_ = [](DarkMode mode) {
     return static_cast<UiAppearanceAbilityErrCode>(UiAppearanceAbilityClient::GetInstance()->SetDarkMode(mode));
 };
@@ -59,6 +84,63 @@ extern "C" __attribute__((visibility("default"))) int32_t OH_UIAppearance_SetSet
 {
     return UIAppearance::SetSettingData(std::string(key), std::string(value));
 }
+
+extern "C" __attribute__((visibility("default"))) int32_t OH_UIAppearance_GetSnapshot(
+    OH_UIAppearance_Snapshot* snapshot)
+{
+    if (snapshot == nullptr) {
+        return UiAppearanceAbilityErrCode::INVALID_ARG;
+    }
+    AppearanceSnapshot cached;
+    if (!UiAppearanceCache::GetInstance().PeekSnapshot(cached)) {
+        return UiAppearanceAbilityErrCode::SYS_ERR;
+    }
+    ToCSnapshot(cached, *snapshot);
+    return UiAppearanceAbilityErrCode::SUCCEEDED;
+}
+
+extern "C" __attribute__((visibility("default"))) int32_t OH_UIAppearance_RegisterChangeCallback(
+    OH_UIAppearance_ChangeCallback callback, void* userData)
+{
+    if (callback == nullptr) {
+        return UiAppearanceAbilityErrCode::INVALID_ARG;
+    }
+    std::lock_guard<std::mutex> guard(g_changeCallbacksMutex);
+    for (const auto& entry : g_changeCallbacks) {
+        if (entry.callback == callback && entry.userData == userData) {
+            return UiAppearanceAbilityErrCode::INVALID_ARG;
+        }
+    }
+    uint64_t listenerId = UiAppearanceCache::GetInstance().AddChangeListener(
+        [callback, userData](const AppearanceSnapshot& snapshot) {
+            OH_UIAppearance_Snapshot cSnapshot;
+            ToCSnapshot(snapshot, cSnapshot);
+            callback(&cSnapshot, userData);
+        });
+    g_changeCallbacks.push_back({ callback, userData, listenerId });
+    return UiAppearanceAbilityErrCode::SUCCEEDED;
+}
+
+extern "C" __attribute__((visibility("default"))) int32_t OH_UIAppearance_UnregisterChangeCallback(
+    OH_UIAppearance_ChangeCallback callback, void* userData)
+{
+    uint64_t listenerId = 0;
+    {
+        std::lock_guard<std::mutex> guard(g_changeCallbacksMutex);
+        auto iter = std::find_if(g_changeCallbacks.begin(), g_changeCallbacks.end(),
+            [callback, userData](const ChangeCallbackEntry& entry) {
+                return entry.callback == callback && entry.userData == userData;
+            });
+        if (iter == g_changeCallbacks.end()) {
+            return UiAppearanceAbilityErrCode::INVALID_ARG;
+        }
+        listenerId = iter->listenerId;
+        g_changeCallbacks.erase(iter);
+    }
+    // Outside g_changeCallbacksMutex: this may wait for a running callback, which may itself register or unregister.
+    UiAppearanceCache::GetInstance().RemoveChangeListener(listenerId);
+    return UiAppearanceAbilityErrCode::SUCCEEDED;
+}
 } // namespace UiAppearance
 } // namespace ArkUi
 } // namespace OHOS
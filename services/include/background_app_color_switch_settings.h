@@ -16,17 +16,42 @@
 #ifndef UI_APPEARANCE_BACKGROUND_APP_COLOR_SWICH_SETTINGS_H
 #define UI_APPEARANCE_BACKGROUND_APP_COLOR_SWICH_SETTINGS_H
 
-#include <mutex>
+#include <atomic>
 #include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_set>
 
+#include "debounce_task.h"
 #include "errors.h"
+#include "file_watcher.h"
 #include "nocopyable.h"
 
 namespace OHOS::ArkUi::UiAppearance {
 class BackGroundAppColorSwitchSettings final : public NoCopyable {
 public:
+    // Immutable once published; readers keep their snapshot alive while a reload swaps in a new one.
+    // allowSet views the strings owned by allowList, whose nodes never move, so Settings is move-only.
+    struct Settings {
+        Settings() = default;
+        Settings(Settings&&) = default;
+        Settings& operator=(Settings&&) = default;
+        Settings(const Settings&) = delete;
+        Settings& operator=(const Settings&) = delete;
+
+        bool isAllowListEnable = false;
+        std::list<std::string> allowList;
+        std::unordered_set<std::string_view> allowSet;
+        int32_t taskQuantity = -1;
+        int32_t durationMillisecond = -1;
+    };
+
     static BackGroundAppColorSwitchSettings& GetInstance();
 
+    std::shared_ptr<const Settings> GetSettings() const;
+
     bool IsSupportHotUpdate();
 
     ErrCode Initialize();
@@ -40,13 +65,25 @@ public:
     bool CheckInWhileList(const std::string& bundleName);
 
     std::list<std::string> GetWhileList();
+
+    // Parses configPath and publishes the result only if it is valid; the previous settings stay in effect otherwise.
+    // A hot reload reads the file into a buffer, since the file may be rewritten while it is parsed.
+    ErrCode Reload(const std::string& configPath, bool isHotReload = false);
+
+    uint64_t GetReloadCount() const;
+
+    uint64_t GetReloadFailureCount() const;
 private:
-    std::mutex policyMutex_;
-    bool isAllowListEnable_ = false;
+    void StartWatch(const std::string& configPath);
+
+    std::shared_ptr<const Settings> settings_ = std::make_shared<const Settings>();
+    std::atomic<uint64_t> reloadCount_ = 0;
+    std::atomic<uint64_t> reloadFailureCount_ = 0;
 
-    std::list<std::string> allowList_;
-    int32_t taskQuantity_ = -1;
-    int32_t durationMillisecond_ = -1;
+    std::mutex watchMutex_;
+    std::string configPath_;
+    std::unique_ptr<DebounceTask> reloadTask_;
+    std::unique_ptr<FileWatcher> fileWatcher_;
 };
 } // namespace OHOS::ArkUi::UiAppearance
 
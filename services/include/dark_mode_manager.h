@@ -16,18 +16,26 @@
 #ifndef UI_APPEARANCE_DARK_MODE_MANAGER_H
 #define UI_APPEARANCE_DARK_MODE_MANAGER_H
 
+#include <atomic>
 #include <functional>
 #include <list>
 #include <map>
 #include <memory>
 #include <mutex>
+#include <set>
+#include <vector>
 
 #include "account_context.h"
 #include "errors.h"
 #include "nocopyable.h"
 #include "alarm_timer_manager.h"
 #include "dark_mode_temp_state_manager.h"
+#include "dark_schedule.h"
+#include "debounce_task.h"
+#include "dump_buffer.h"
+#include "location_fetcher.h"
 #include "screen_switch_operator_manager.h"
+#include "state_snapshot.h"
 #include "sunrise_sunset_calc.h"
 
 namespace OHOS::Location {
@@ -39,6 +47,8 @@ constexpr int32_t HOUR_TO_MINUTE = 60;
 constexpr int32_t DAY_TO_MINUTE = 24 * 60;
 constexpr int32_t SUNSET_TIME_DEFAULT = 18 * HOUR_TO_MINUTE;
 constexpr int32_t SUNRISE_TIME_DEFAULT = 7 * HOUR_TO_MINUTE + DAY_TO_MINUTE;
+constexpr uint32_t RESTART_TIMER_DEBOUNCE_MS = 500;
+constexpr uint32_t LOCATION_FETCH_DEADLINE_MS = 2000;
 class DarkModeManager final : public NoCopyable {
 public:
     static DarkModeManager &GetInstance();
@@ -54,6 +64,23 @@ public:
 
     ErrCode OnSwitchUser(int32_t userId);
     ErrCode OnSwitchContext(const AccountContext& context);
+    // Switches to context while keeping every context in foregroundContexts active; only the contexts that left the
+    // foreground are deactivated.
+    ErrCode OnSwitchContext(const AccountContext& context, const std::vector<AccountContext>& foregroundContexts);
+
+    // An active context has live observers and timers. Deactivation only parks its timers; the observers stay
+    // registered so that activating it again needs no observer IPC. Activation applies nothing by itself: a context
+    // that NeedLoadUserSettingData reports is brought up to date by one LoadUserSettingData call.
+    ErrCode ActivateContext(const AccountContext& context);
+    void DeactivateContext(const AccountContext& context);
+    bool IsContextActive(const AccountContext& context);
+
+    // True until LoadUserSettingData has applied the context, and again after its timers were parked or a setting
+    // changed while it was inactive.
+    bool NeedLoadUserSettingData(const AccountContext& context);
+
+    // Unregisters the observers of inactive contexts that are not in contexts, e.g. users that left the foreground.
+    void RetainObservedContexts(const std::vector<AccountContext>& contexts);
 
     void ScreenOnCallback();
 
@@ -61,7 +88,15 @@ public:
 
     ErrCode RestartTimer();
 
-    void Dump();
+    // Coalesces bursts of time and timezone change events into a single RestartTimer call.
+    void RequestRestartTimer();
+
+    void Dump(DumpBuffer& out);
+
+    void CollectSnapshot(StateSnapshot::Records& records);
+
+    // Seeds contexts whose settings have not been loaded yet; LoadUserSettingData overwrites them later.
+    void RestoreSnapshot(const StateSnapshot::Records& records);
 
     bool GetSettingTime(const int32_t userId, int32_t& settingStartTime, int32_t& settingEndTime);
     bool GetSettingTime(const AccountContext& context, int32_t& settingStartTime, int32_t& settingEndTime);
@@ -74,8 +109,7 @@ public:
 
     static ErrCode GetCurrentTimeOfSeconds(int32_t &seconds);
 
-    static bool CheckCurrentTimeInDarkInterval(
-        const int32_t startTime, const int32_t endTime, const int32_t seconds);
+    static bool CheckCurrentTimeInDarkInterval(const DarkSchedule& schedule, const int32_t seconds);
 private:
     enum DarkModeMode {
         DARK_MODE_INVALID = -1,
@@ -86,7 +120,7 @@ private:
         DARK_MODE_SIZE,
     };
 
-    struct DarkModeState {
+    struct DarkModeSettings {
         DarkModeMode settingMode = DARK_MODE_INVALID;
         int32_t settingStartTime = -1;
         int32_t settingEndTime = -1;
@@ -94,11 +128,47 @@ private:
         int32_t settingSunriseTime = SUNRISE_TIME_DEFAULT; // Default sunrise time: 7am the next day
     };
 
+    // Inputs and result of the last sunrise/sunset calculation of a context, used to skip recalculations when the
+    // device has not moved.
+    struct SunriseSunsetFix {
+        bool valid = false;
+        double latitude = 0.0;
+        double longitude = 0.0;
+        int64_t localDay = 0;  // Days since the epoch in local time.
+        int64_t utcOffset = 0; // Seconds east of UTC.
+        int32_t sunsetTime = -1;
+        int32_t sunriseTime = -1;
+    };
+
+    // Per-context shard. The mutex only guards the fields and is never held across IPC; work is done on a copy.
+    // applyMutex serializes the applies of one context and is never taken while the settings are read.
+    struct DarkModeState : DarkModeSettings {
+        std::mutex mutex;
+        std::mutex applyMutex;
+        uint64_t version = 0; // Bumped on every settings change so overlapping applies can detect staleness.
+        SunriseSunsetFix sunriseSunsetFix;
+        std::shared_ptr<const DarkSchedule> schedule; // Compiled from the times the last timer callback checked.
+    };
+
     void LoadSettingDataObserversCallback();
 
-    ErrCode RegisterSettingDataObserversLocked(const AccountContext& context) const;
+    ErrCode RegisterSettingDataObservers(const AccountContext& context);
+
+    void UnregisterSettingDataObservers(const AccountContext& context);
+
+    DarkModeState& GetState(const AccountContext& context);
+
+    DarkModeState* FindState(const AccountContext& context);
+
+    static DarkModeSettings GetSettingsSnapshot(DarkModeState& state, uint64_t* version = nullptr);
 
-    void UnregisterSettingDataObserversLocked(const AccountContext& context) const;
+    // Returns the compiled schedule of the state, recompiling it only if the times differ from the cached one.
+    static std::shared_ptr<const DarkSchedule> GetSchedule(DarkModeState& state, int32_t startTime, int32_t endTime);
+
+    // Called with state.mutex held after any of the settings changed.
+    static void MarkSettingsChanged(DarkModeState& state);
+
+    void RegisterSnapshotCollector();
 
     void SettingDataDarkModeModeUpdateFunc(const std::string& key, const AccountContext& context);
 
@@ -110,13 +180,23 @@ private:
 
     void SettingDataDarkModeSunriseTimeUpdateFunc(const std::string& key, const AccountContext& context);
 
-    ErrCode OnStateChangeLocked(const AccountContext& context, bool needUpdateCallback, bool& isDarkMode,
+    std::vector<AccountContext> GetActiveContexts();
+
+    // Returns true and marks the settings of context for loading on activation if context is inactive.
+    bool DeferApplyIfInactive(const AccountContext& context);
+
+    ErrCode RestartTimerByContext(const AccountContext& context, bool& needRestart);
+
+    ErrCode OnStateChange(const AccountContext& context, bool needUpdateCallback, bool& isDarkMode,
         const bool resetTempColorModeFlag, const bool bootLoadFlag);
 
+    ErrCode ApplyStateChange(const AccountContext& context, const DarkModeSettings& settings,
+        bool needUpdateCallback, bool& isDarkMode, const bool resetTempColorModeFlag, const bool bootLoadFlag);
+
     ErrCode OnStateChangeToAllDayMode(const AccountContext& context, DarkModeMode darkMode, bool needUpdateCallback,
         bool& isDarkMode, const bool resetTempColorModeFlag, const bool bootLoadFlag);
 
-    ErrCode OnStateChangeToCustomAutoMode(const AccountContext& context, const DarkModeState& state,
+    ErrCode OnStateChangeToCustomAutoMode(const AccountContext& context, const DarkModeSettings& state,
         bool needUpdateCallback, bool& isDarkMode, const bool resetTempColorModeFlag, const bool bootLoadFlag);
 
     void OnChangeDarkMode(DarkModeMode mode, const AccountContext& context);
@@ -134,22 +214,45 @@ private:
 
     bool IsDarkModeSunsetSunrise(const AccountContext& context);
 
+    // Returns immediately; the times already in the settings stay in effect until the location arrives.
     void CalculateAndApplySunriseSunsetTimes(const AccountContext& context);
 
     std::unique_ptr<OHOS::Location::Location> GetCachedLocation(const AccountContext& context);
 
+    bool FetchLocation(const AccountContext& context, LocationFetcher::Coordinate& coordinate);
+
     void ApplySunriseSunsetTimes(double lat, double lon, const AccountContext& context);
 
+    SunriseSunsetResult LookupSunriseSunset(double lat, double lon, int64_t timestampMs);
+
+    static SunriseSunsetFix MakeSunriseSunsetFix(double lat, double lon, int64_t timestampMs);
+
+    bool IsSunriseSunsetFixCurrent(const AccountContext& context, const SunriseSunsetFix& fix);
+
+    void SaveSunriseSunsetFix(const AccountContext& context, SunriseSunsetFix fix, int32_t sunsetTime,
+        int32_t sunriseTime);
+
     void InitSunriseSunsetMode(const AccountContext& context);
 
     std::mutex settingDataObserversMutex_;
     std::list<std::pair<std::string, std::function<void(const std::string&, const AccountContext&)>>>
         settingDataObservers_;
+    // The context of the latest switch; other foreground contexts may be active at the same time.
     AccountContext settingDataObserversContext_ = AccountContextHelper::CreateBaseContext(-1);
     // Kept for legacy userId-only paths and tests; new logic should use settingDataObserversContext_.
     int32_t settingDataObserversUserId_ = -1;
+    std::set<AccountContext> activeContexts_;
+    std::set<AccountContext> observedContexts_;
+    // Contexts whose settings LoadUserSettingData applied and that have stayed up to date since.
+    std::set<AccountContext> loadedContexts_;
 
     AlarmTimerManager alarmTimerManager_;
+    // Shared by all contexts because the location belongs to the device, not to an account.
+    std::mutex sunriseSunsetTableMutex_;
+    SunriseSunsetTable sunriseSunsetTable_;
+    std::atomic<uint64_t> sunriseSunsetRecalcPerformed_ = 0;
+    std::atomic<uint64_t> sunriseSunsetRecalcSkipped_ = 0;
+    // Guards the map structure only; entries are never erased, so shard references stay valid after unlock.
     std::mutex darkModeStatesMutex_;
     std::map<AccountContext, DarkModeState> darkModeStates_;
 
@@ -157,6 +260,17 @@ private:
 
     TemporaryColorModeManager temporaryColorModeMgr_;
     ScreenSwitchOperatorManager screenSwitchOperatorMgr_;
+
+    // Declared last so that their worker threads are joined before the state they touch is destroyed.
+    DebounceTask restartTimerTask_ { "RestartTimer", RESTART_TIMER_DEBOUNCE_MS,
+        [this](uint32_t) { RestartTimer(); } };
+    LocationFetcher locationFetcher_ { LOCATION_FETCH_DEADLINE_MS,
+        [this](const AccountContext& context, LocationFetcher::Coordinate& coordinate) {
+            return FetchLocation(context, coordinate);
+        },
+        [this](const AccountContext& context, const LocationFetcher::Coordinate& coordinate) {
+            ApplySunriseSunsetTimes(coordinate.latitude, coordinate.longitude, context);
+        } };
 };
 } // namespace OHOS::ArkUi::UiAppearance
 
@@ -21,6 +21,8 @@
 #include "string"
 
 #include "account_context.h"
+#include "dump_buffer.h"
+#include "state_snapshot.h"
 
 namespace OHOS::ArkUi::UiAppearance {
 class TemporaryColorModeManager {
@@ -37,6 +39,10 @@ public:
     bool SetColorModeNormal(const AccountContext& context);
     bool CheckTemporaryStateEffective(const int32_t userId);
     bool CheckTemporaryStateEffective(const AccountContext& context);
+    void CollectSnapshot(StateSnapshot::Records& records);
+    void Dump(DumpBuffer& out);
+    // Fills in contexts that InitData has not loaded yet; InitData overwrites them later.
+    void RestoreSnapshot(const StateSnapshot::Records& records);
 
 private:
     std::string TemporaryColorModeAssignUser(const AccountContext& context);
@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef UI_APPEARANCE_FONT_SCALE_H
+#define UI_APPEARANCE_FONT_SCALE_H
+
+#include <cstdint>
+#include <string>
+
+namespace OHOS::ArkUi::UiAppearance {
+/**
+ * A validated font or font weight scale in (0, 5]. The number is kept in millionths and parsed or formatted only
+ * once, where the value enters the service; the text is what gets published to Configuration and persisted.
+ */
+class FontScale final {
+public:
+    static constexpr int32_t MICROS_PER_UNIT = 1000000;
+    static constexpr double MIN_VALUE = 0.0;
+    static constexpr double MAX_VALUE = 5.0;
+
+    FontScale();
+
+    // Accepts what strtod accepts for the whole string and keeps the text verbatim, so string round trips are exact.
+    static bool FromString(const std::string& text, FontScale& scale);
+
+    // Formats with six fractional digits, which is what callers used to produce with std::to_string.
+    static bool FromDouble(double value, FontScale& scale);
+
+    // In (0, 5] and still positive once rounded to millionths.
+    static bool IsValid(double value);
+
+    double ToDouble() const
+    {
+        return static_cast<double>(micros_) / MICROS_PER_UNIT;
+    }
+
+    int32_t GetMicros() const
+    {
+        return micros_;
+    }
+
+    const std::string& ToString() const
+    {
+        return text_;
+    }
+
+private:
+    int32_t micros_ = MICROS_PER_UNIT;
+    std::string text_;
+};
+} // namespace OHOS::ArkUi::UiAppearance
+#endif // UI_APPEARANCE_FONT_SCALE_H
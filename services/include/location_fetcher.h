@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef UI_APPEARANCE_LOCATION_FETCHER_H
+#define UI_APPEARANCE_LOCATION_FETCHER_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <thread>
+
+#include "account_context.h"
+#include "nocopyable.h"
+
+namespace OHOS::ArkUi::UiAppearance {
+/**
+ * Fetches the device location off the caller's thread. Request() only queues the context, so user switching and
+ * settings callbacks never wait for the locator; the result is delivered on the worker thread when it arrives.
+ * A context that is still waiting in the queue is not queued twice.
+ *
+ * Each fetch runs on its own call thread and the worker waits for it only until the deadline, so a locator that
+ * never answers does not stall the other contexts; the context keeps its last known times meanwhile. A fetch that
+ * answers after the deadline is still delivered, and a context is never fetched twice at once: requests made while
+ * its fetch is outstanding are served by one more fetch after it returns.
+ */
+class LocationFetcher final : public NoCopyable {
+public:
+    struct Coordinate {
+        double latitude = 0.0;
+        double longitude = 0.0;
+    };
+    // Runs on a call thread and may outlive the fetcher; returns false without a location.
+    using FetchFunc = std::function<bool(const AccountContext& context, Coordinate& coordinate)>;
+    using ResultFunc = std::function<void(const AccountContext& context, const Coordinate& coordinate)>;
+
+    LocationFetcher(uint32_t deadlineMs, const FetchFunc& fetch, const ResultFunc& onResult);
+
+    ~LocationFetcher() override;
+
+    void Request(const AccountContext& context);
+
+    // Waits until the queue is drained and no fetch is outstanding. Returns false if the timeout expires first.
+    bool WaitIdle(std::chrono::milliseconds timeout);
+
+    uint64_t GetRequestCount() const;
+
+    uint64_t GetCoalescedCount() const;
+
+    uint64_t GetFailureCount() const;
+
+    // Fetches still running at the deadline, or failed after running into it.
+    uint64_t GetTimeoutCount() const;
+
+private:
+    // Shared with the call threads, which may still be blocked in the locator when the fetcher is destroyed.
+    struct Sync {
+        std::mutex mutex;
+        std::condition_variable cv;
+    };
+
+    struct Call {
+        AccountContext context;
+        Coordinate coordinate;
+        std::chrono::milliseconds elapsed { 0 };
+        std::thread thread;
+        bool isFetched = false;
+        bool isDone = false;
+        bool isTimedOut = false;
+    };
+
+    void WorkLoop();
+
+    // Called with sync_->mutex held.
+    std::shared_ptr<Call> StartCall(const AccountContext& context);
+
+    bool HasFinishedCall() const;
+
+    // Called with sync_->mutex held; delivers the finished calls with the lock released.
+    void FinishCalls(std::unique_lock<std::mutex>& lock);
+
+    void FinishCall(Call& call);
+
+    std::chrono::milliseconds deadline_;
+    FetchFunc fetch_;
+    ResultFunc onResult_;
+
+    std::shared_ptr<Sync> sync_ = std::make_shared<Sync>();
+    std::condition_variable idleCv_;
+    std::thread worker_;
+    std::deque<AccountContext> queue_;
+    std::set<AccountContext> queuedContexts_;
+    std::map<AccountContext, std::shared_ptr<Call>> calls_;
+    std::set<AccountContext> refetchContexts_;
+    bool running_ = false;
+    bool stopped_ = false;
+
+    std::atomic<uint64_t> requestCount_ = 0;
+    std::atomic<uint64_t> coalescedCount_ = 0;
+    std::atomic<uint64_t> failureCount_ = 0;
+    std::atomic<uint64_t> timeoutCount_ = 0;
+};
+} // namespace OHOS::ArkUi::UiAppearance
+
+#endif // UI_APPEARANCE_LOCATION_FETCHER_H
@@ -0,0 +1,166 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef UI_APPEARANCE_SOLAR_EPHEMERIS_H
+#define UI_APPEARANCE_SOLAR_EPHEMERIS_H
+
+#include <cmath>
+#include <cstdint>
+
+/**
+ * NOAA solar ephemeris coefficients and the polynomial terms that need no transcendental functions.
+ * Everything here is constexpr, so the terms for a fixed date fold at compile time.
+ */
+namespace OHOS::ArkUi::UiAppearance::SolarEphemeris {
+// Conversion factors between degrees and radians.
+constexpr double DEG2RAD = M_PI / 180.0;
+constexpr double RAD2DEG = 180.0 / M_PI;
+
+/** Official sunrise and sunset zenith: 90°50', including refraction and the solar radius. */
+constexpr double ZENITH = 90.833;
+
+// UTC noon is 720 minutes after midnight, and Earth rotates one longitude degree every four minutes.
+constexpr double MINS_PER_HALF_DAY = 720.0;
+constexpr double MINS_PER_DEGREE_LON = 4.0;
+constexpr double HOURS_PER_DAY = 24.0;
+
+// Constants from the Gregorian calendar to Julian day conversion used by the NOAA algorithm.
+constexpr double J2000_JD = 2451545.0;
+constexpr double DAYS_PER_JULIAN_CENT = 36525.0;
+constexpr double JULIAN_DAYS_PER_YEAR = 365.25;
+constexpr double JULIAN_MONTH_COEFF = 30.6001;
+constexpr double JULIAN_YEAR_OFFSET = 4716.0;
+constexpr double JULIAN_DAY_OFFSET = 1524.5;
+
+// NOAA polynomial coefficients: mean longitude = A + B * t + C * t^2, in degrees.
+constexpr double MEAN_LONG_A = 280.46646;
+constexpr double MEAN_LONG_B = 36000.76983;
+constexpr double MEAN_LONG_C = 0.0003032;
+
+// NOAA polynomial coefficients: mean anomaly = A + B * t - C * t^2, in degrees.
+constexpr double MEAN_ANOM_A = 357.52911;
+constexpr double MEAN_ANOM_B = 35999.05029;
+constexpr double MEAN_ANOM_C = 0.0001537;
+
+// NOAA polynomial coefficients: orbital eccentricity = A - B * t - C * t^2.
+constexpr double ECC_A = 0.016708634;
+constexpr double ECC_B = 0.000042037;
+constexpr double ECC_C = 0.0000001267;
+
+// NOAA coefficients for the first three sine harmonics in the solar equation of center.
+constexpr double EQC_A0 = 1.914602;
+constexpr double EQC_A1 = 0.004817;
+constexpr double EQC_A2 = 0.000014;
+constexpr double EQC_B0 = 0.019993;
+constexpr double EQC_B1 = 0.000101;
+constexpr double EQC_C0 = 0.000289;
+
+// NOAA nutation and aberration coefficients used to correct the apparent solar longitude.
+constexpr double OMEGA_A = 125.04;
+constexpr double OMEGA_B = 1934.136;
+constexpr double ABERR_A = 0.00569;
+constexpr double ABERR_B = 0.00478;
+
+// NOAA polynomial coefficients for mean and corrected obliquity of the ecliptic.
+constexpr double OBLIQ_SEC_A = 21.448;
+constexpr double OBLIQ_SEC_B = 46.815;
+constexpr double OBLIQ_SEC_C = 0.00059;
+constexpr double OBLIQ_SEC_D = 0.001813;
+constexpr double OBLIQ_DEGREES = 23.0;
+constexpr double OBLIQ_MINUTES = 26.0;
+constexpr double OBLIQ_CORR_COEFF = 0.00256;
+
+// Multipliers from the NOAA equation-of-time expansion; the result is converted to minutes.
+constexpr double EOT_RAD2MIN = 4.0;
+constexpr double EOT_E_SINM_COEFF = 2.0;
+constexpr double EOT_EY_COEFF = 4.0;
+constexpr double EOT_Y2_COEFF = 0.5;
+constexpr double EOT_E2_COEFF = 1.25;
+
+/**
+ * floor() for values within the int64_t range, usable in constant expressions.
+ */
+constexpr double Floor(double x)
+{
+    const double truncated = static_cast<double>(static_cast<int64_t>(x));
+    return (x < truncated) ? truncated - 1.0 : truncated;
+}
+
+/**
+ * Calculates the Julian day.
+ */
+constexpr double CalcJulianDay(int year, int month, int day, double hour)
+{
+    // Treat January and February as months 13 and 14 of the previous year in the Julian day formula.
+    if (month <= 2) {
+        year -= 1;
+        month += 12;
+    }
+    // Apply the Gregorian century and leap-century correction.
+    int centuryDiv = year / 100;
+    int gregorianCorr = 2 - centuryDiv + centuryDiv / 4;
+    return Floor(JULIAN_DAYS_PER_YEAR * (year + JULIAN_YEAR_OFFSET)) + Floor(JULIAN_MONTH_COEFF * (month + 1)) + day +
+           hour / HOURS_PER_DAY + gregorianCorr - JULIAN_DAY_OFFSET;
+}
+
+/**
+ * Converts a Julian day to Julian centuries since J2000.0.
+ */
+constexpr double CalcJulianCent(double jd)
+{
+    return (jd - J2000_JD) / DAYS_PER_JULIAN_CENT;
+}
+
+/**
+ * Calculates the solar geometric mean longitude in degrees.
+ */
+constexpr double CalcMeanLong(double t)
+{
+    double meanLong = MEAN_LONG_A + MEAN_LONG_B * t + MEAN_LONG_C * t * t;
+    // Normalize longitude to one complete revolution in the range [0, 360).
+    return meanLong - 360.0 * Floor(meanLong / 360.0);
+}
+
+/**
+ * Calculates the solar geometric mean anomaly in degrees.
+ */
+constexpr double CalcMeanAnomaly(double t)
+{
+    return MEAN_ANOM_A + MEAN_ANOM_B * t - MEAN_ANOM_C * t * t;
+}
+
+/**
+ * Calculates the eccentricity of Earth's orbit.
+ */
+constexpr double CalcEccentricity(double t)
+{
+    return ECC_A - ECC_B * t - ECC_C * t * t;
+}
+
+/**
+ * Calculates the mean obliquity of the ecliptic in degrees.
+ */
+constexpr double CalcMeanObliq(double t)
+{
+    constexpr double secsPerMin = 60.0;
+    double sec = OBLIQ_SEC_A - t * (OBLIQ_SEC_B + t * (OBLIQ_SEC_C - t * OBLIQ_SEC_D));
+    return OBLIQ_DEGREES + (OBLIQ_MINUTES + sec / secsPerMin) / secsPerMin;
+}
+
+static_assert(CalcJulianDay(2000, 1, 1, 12.0) == J2000_JD, "J2000.0 is 2000-01-01T12:00:00 TT");
+static_assert(CalcJulianCent(J2000_JD) == 0.0, "Julian centuries are counted from J2000.0");
+} // namespace OHOS::ArkUi::UiAppearance::SolarEphemeris
+
+#endif // UI_APPEARANCE_SOLAR_EPHEMERIS_H
@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef UI_APPEARANCE_STATE_SNAPSHOT_H
+#define UI_APPEARANCE_STATE_SNAPSHOT_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "account_context.h"
+#include "debounce_task.h"
+#include "nocopyable.h"
+
+namespace OHOS::ArkUi::UiAppearance {
+constexpr uint32_t STATE_SNAPSHOT_WRITE_DELAY_MS = 200;
+/**
+ * Binary copy of the per-context service state, so a restarted SA can answer queries before system parameters and
+ * DataShare have been read again. The file is a fixed header followed by fixed-size records; it is replaced with
+ * write-temp-then-rename and read through mmap. Anything that fails validation is ignored, and the regular
+ * initialization still runs afterwards and overwrites whatever was restored.
+ */
+class StateSnapshot final : public NoCopyable {
+public:
+    static constexpr uint32_t MAGIC = 0x53414955; // "UIAS" in little endian
+    static constexpr uint32_t VERSION = 1;
+    static constexpr size_t SCALE_SIZE = 16;
+
+    enum RecordFlag : uint32_t {
+        HAS_APPEARANCE = 1U << 0,
+        HAS_DARK_MODE_SETTINGS = 1U << 1,
+        HAS_TEMP_COLOR_MODE = 1U << 2,
+    };
+
+    // Plain data only: records are copied to and from the file byte for byte. Bump VERSION when the layout changes.
+    struct Record {
+        int32_t userId = -1;
+        int32_t subProfileId = INVALID_SUB_PROFILE_ID;
+        uint32_t flags = 0;
+        int32_t darkMode = 0;
+        char fontScale[SCALE_SIZE] = { 0 };
+        char fontWeightScale[SCALE_SIZE] = { 0 };
+        int32_t settingMode = -1;
+        int32_t settingStartTime = -1;
+        int32_t settingEndTime = -1;
+        int32_t settingSunsetTime = -1;
+        int32_t settingSunriseTime = -1;
+        int32_t tempColorMode = 0;
+        int64_t tempStateStartTime = 0;
+        int64_t tempStateEndTime = 0;
+    };
+    using Records = std::map<AccountContext, Record>;
+    // Adds the owner's part of the state to the records; runs on the writer thread.
+    using Collector = std::function<void(Records& records)>;
+
+    static StateSnapshot& GetInstance();
+
+    explicit StateSnapshot(const std::string& path);
+
+    ~StateSnapshot() override = default;
+
+    void RegisterCollector(const std::string& name, const Collector& collector);
+
+    // Writes are requested from every state change, but only start once the service has loaded the previous file;
+    // until then a write could replace it with partial state.
+    void EnableWrite();
+
+    // Schedules a write; changes that arrive within STATE_SNAPSHOT_WRITE_DELAY_MS are merged into one write.
+    void RequestWrite();
+
+    // Collects and writes on the calling thread.
+    bool WriteNow();
+
+    bool Load(Records& records) const;
+
+    uint64_t GetWriteCount() const;
+
+    static Record& GetRecord(Records& records, const AccountContext& context);
+
+    // Returns false and leaves the field empty when the value does not fit.
+    static bool SetScale(char (&field)[SCALE_SIZE], const std::string& value);
+
+    static std::string GetScale(const char (&field)[SCALE_SIZE]);
+
+    static void Encode(const Records& records, std::vector<uint8_t>& buffer);
+
+    static bool Decode(const uint8_t* data, size_t size, Records& records);
+
+private:
+    struct Header {
+        uint32_t magic = MAGIC;
+        uint32_t version = VERSION;
+        uint32_t recordSize = sizeof(Record);
+        uint32_t recordCount = 0;
+        uint64_t checksum = 0;
+    };
+
+    static uint64_t CalcChecksum(const uint8_t* data, size_t size);
+
+    bool WriteFile(const std::vector<uint8_t>& buffer) const;
+
+    std::string path_;
+    std::mutex collectorsMutex_;
+    std::list<std::pair<std::string, Collector>> collectors_;
+    std::mutex writeMutex_;
+    std::atomic<bool> writeEnabled_ = false;
+    std::atomic<uint64_t> writeCount_ = 0;
+    // Declared last so that its worker thread is joined before the collectors it calls are destroyed.
+    DebounceTask writeTask_ { "StateSnapshotWrite", STATE_SNAPSHOT_WRITE_DELAY_MS, [this](uint32_t) { WriteNow(); } };
+};
+} // namespace OHOS::ArkUi::UiAppearance
+
+#endif // UI_APPEARANCE_STATE_SNAPSHOT_H
@@ -5,6 +5,8 @@
 #ifndef UI_APPEARANCE_SUNRISE_SUNSET_CALC_H
 #define UI_APPEARANCE_SUNRISE_SUNSET_CALC_H
 
+#include <array>
+#include <cstddef>
 #include <cstdint>
 #include <ctime>
 #include <string>
@@ -41,6 +43,7 @@ namespace SunriseSunsetUtils {
 /**
  * Uses two iterations for accuracy: the first starts at UTC noon, and the second
  * recalculates with a Julian day adjusted by the first result.
+ * When UI_APPEARANCE_FIXED_POINT_SUNRISE_SUNSET is defined, this is CalculateSunriseSunsetFixedPoint.
  * @param lat Latitude in the range [-90, 90].
  * @param lon Longitude in the range [-180, 180].
  * @param timestampMs Timestamp in milliseconds.
@@ -48,6 +51,44 @@ namespace SunriseSunsetUtils {
  */
 SunriseSunsetResult CalculateSunriseSunset(double lat, double lon, int64_t timestampMs);
 
+/**
+ * Maximum difference in seconds between CalculateSunriseSunsetFixedPoint and the floating-point path.
+ */
+constexpr double FIXED_POINT_MAX_ERROR_SEC = 60.0;
+
+/**
+ * Integer and fixed-point variant of CalculateSunriseSunset that needs no libm transcendental function:
+ * trigonometry uses a sine table generated at compile time and the series coefficients are folded into
+ * per-minute rates. See FIXED_POINT_MAX_ERROR_SEC for the accuracy.
+ * @param lat Latitude in the range [-90, 90].
+ * @param lon Longitude in the range [-180, 180].
+ * @param timestampMs Timestamp in milliseconds.
+ * @returns Sunrise and sunset in UTC seconds from 00:00; -1 for polar day or polar night.
+ */
+SunriseSunsetResult CalculateSunriseSunsetFixedPoint(double lat, double lon, int64_t timestampMs);
+
+/**
+ * Maximum difference in seconds between CalculateSunriseSunsetBatch and CalculateSunriseSunset for the same input.
+ * Both paths round to whole minutes, so an approximation error can only move a result by one rounding step.
+ * Within a few seconds of arc from the polar day and polar night boundaries the two paths may also disagree
+ * on whether the sun rises at all.
+ */
+constexpr double BATCH_MAX_ERROR_SEC = 60.0;
+
+/**
+ * Batch variant of CalculateSunriseSunset over structure-of-arrays inputs, for table precomputation and validation.
+ * Uses branch-free polynomial approximations of sin, cos and acos instead of libm calls so that the loop can be
+ * vectorized; see BATCH_MAX_ERROR_SEC for the accuracy against the scalar path.
+ * @param count Number of points.
+ * @param lats Latitudes in the range [-90, 90].
+ * @param lons Longitudes in the range [-180, 180].
+ * @param timestampsMs Timestamps in milliseconds.
+ * @param sunrises Receives sunrise in UTC seconds from 00:00; -1 for polar day, polar night or invalid coordinates.
+ * @param sunsets Receives sunset in UTC seconds from 00:00; -1 for polar day, polar night or invalid coordinates.
+ */
+void CalculateSunriseSunsetBatch(size_t count, const double* lats, const double* lons, const int64_t* timestampsMs,
+    double* sunrises, double* sunsets);
+
 /**
  * Formats UTC seconds as local time in HH:mm format, rounded to the nearest minute.
  * @param utcSec UTC seconds from 00:00; -1 for polar day or polar night.
@@ -84,6 +125,14 @@ public:
      */
     SunriseSunsetInfo(double lat, double lon, int64_t timestampMs);
 
+    /**
+     * Binds a precomputed result, for example from SunriseSunsetTable, to the date of the timestamp.
+     * The time zone offset is obtained from the system time zone.
+     * @param result Sunrise and sunset in UTC seconds from 00:00; -1 for polar day or polar night.
+     * @param timestampMs Timestamp in milliseconds.
+     */
+    SunriseSunsetInfo(const SunriseSunsetResult& result, int64_t timestampMs);
+
     /**
      * @param timestampMs Timestamp in milliseconds.
      * @returns true if the timestamp is during daytime; false otherwise.
@@ -146,6 +195,72 @@ private:
     static constexpr double POLAR_MARK = -1;
 };
 
+/**
+ * Sunrise and sunset of every UTC day of one year for a quantized location.
+ * Entries are stored as UTC minutes from 00:00, so a whole year takes about 1.5 KB and a lookup
+ * replaces the NOAA series until the location moves or the year rolls over.
+ */
+class SunriseSunsetTable {
+public:
+    /** Number of entries in the table; leap years use all of them. */
+    static constexpr int32_t DAYS_PER_TABLE = 366;
+    /** Step in degrees to which latitude and longitude are quantized before the table is built. */
+    static constexpr double QUANTIZATION_STEP_DEG = 0.1;
+    /** Distance in degrees from the quantized location beyond which the table is rebuilt. */
+    static constexpr double REBUILD_THRESHOLD_DEG = 0.1;
+
+    /**
+     * @param lat Latitude in the range [-90, 90].
+     * @param lon Longitude in the range [-180, 180].
+     * @param timestampMs Timestamp in milliseconds.
+     * @returns true if the table is empty, covers another UTC year, or was built for a location
+     *          more than REBUILD_THRESHOLD_DEG away; false otherwise.
+     */
+    bool NeedsRebuild(double lat, double lon, int64_t timestampMs) const;
+
+    /**
+     * Calculates every day of the UTC year of the timestamp for the quantized location.
+     * @param lat Latitude in the range [-90, 90].
+     * @param lon Longitude in the range [-180, 180].
+     * @param timestampMs Timestamp in milliseconds.
+     * @returns true on success; false if the coordinates or the timestamp are invalid, leaving the table empty.
+     */
+    bool Build(double lat, double lon, int64_t timestampMs);
+
+    /**
+     * @param timestampMs Timestamp in milliseconds.
+     * @param result Sunrise and sunset in UTC seconds from 00:00; -1 for polar day or polar night.
+     * @returns true if the table covers the UTC day of the timestamp; false otherwise.
+     */
+    bool Lookup(int64_t timestampMs, SunriseSunsetResult& result) const;
+
+    /**
+     * @returns Number of successful builds since construction.
+     */
+    uint32_t GetBuildCount() const;
+
+private:
+    /** Sunrise in UTC minutes from 00:00 per day of the year; POLAR_MINUTES for polar day or polar night. */
+    std::array<int16_t, DAYS_PER_TABLE> sunriseMinutes_ {};
+    /** Sunset in UTC minutes from 00:00 per day of the year; POLAR_MINUTES for polar day or polar night. */
+    std::array<int16_t, DAYS_PER_TABLE> sunsetMinutes_ {};
+    /** Quantized latitude the table was built for. */
+    double lat_ = 0.0;
+    /** Quantized longitude the table was built for. */
+    double lon_ = 0.0;
+    /** UTC year covered by the table, or EMPTY_YEAR before the first successful build. */
+    int32_t year_ = EMPTY_YEAR;
+    /** Number of days in year_. */
+    int32_t dayCount_ = 0;
+    /** Number of successful builds. */
+    uint32_t buildCount_ = 0;
+
+    /** Sentinel stored for a day without a sunrise or sunset. */
+    static constexpr int16_t POLAR_MINUTES = -1;
+    /** Marks a table that has not been built yet. */
+    static constexpr int32_t EMPTY_YEAR = -1;
+};
+
 } // namespace OHOS::ArkUi::UiAppearance
 
 #endif // UI_APPEARANCE_SUNRISE_SUNSET_CALC_H
@@ -17,6 +17,7 @@
 #define UI_APPEARANCE_ABILITY_H
 
 #include <atomic>
+#include <chrono>
 #include <cstdint>
 #include <functional>
 #include <list>
@@ -30,6 +31,10 @@
 #include "account_context.h"
 #include "appmgr/app_mgr_proxy.h"
 #include "common_event_manager.h"
+#include "dump_buffer.h"
+#include "font_scale.h"
+#include "latest_value_combiner.h"
+#include "state_snapshot.h"
 #include "system_ability.h"
 #include "ui_appearance_types.h"
 #include "ui_appearance_ability_stub.h"
@@ -61,8 +66,8 @@ public:
     struct UiAppearanceParam {
         UiAppearanceParam();
         DarkMode darkMode = DarkMode::ALWAYS_LIGHT;
-        std::string fontScale = "1";
-        std::string fontWeightScale = "1";
+        FontScale fontScale;
+        FontScale fontWeightScale;
     };
     UiAppearanceAbility(int32_t saId, bool runOnCreate);
     ~UiAppearanceAbility() = default;
@@ -74,6 +79,12 @@ public:
     ErrCode GetFontWeightScale(std::string& fontWeightScale, int32_t& funcResult) override;
     ErrCode SetFontWeightScale(const std::string& fontWeightScale, int32_t& funcResult) override;
     ErrCode SetSettingData(const std::string& key, const std::string& value, int32_t& funcResult) override;
+    ErrCode GetFontScaleValue(double& fontScale, int32_t& funcResult) override;
+    ErrCode SetFontScaleValue(double fontScale, int32_t& funcResult) override;
+    ErrCode GetFontWeightScaleValue(double& fontWeightScale, int32_t& funcResult) override;
+    ErrCode SetFontWeightScaleValue(double fontWeightScale, int32_t& funcResult) override;
+
+    int32_t Dump(int32_t fd, const std::vector<std::u16string>& args) override;
 
 protected:
     void OnStart() override;
@@ -83,6 +94,15 @@ protected:
     void OnRemoveSystemAbility(int32_t systemAbilityId, const std::string& deviceId) override;
 
 private:
+    // Setter requests of one context, merged per attribute so a burst pushes only its last value to AppMgr.
+    struct AppearanceSetters {
+        // A merged request no longer holds its binder thread past this; it is still applied and reported accepted.
+        static constexpr std::chrono::milliseconds MAX_MERGE_WAIT { 1000 };
+        LatestValueCombiner<DarkMode> darkMode { MAX_MERGE_WAIT, SUCCEEDED };
+        LatestValueCombiner<FontScale> fontScale { MAX_MERGE_WAIT, SUCCEEDED };
+        LatestValueCombiner<FontScale> fontWeightScale { MAX_MERGE_WAIT, SUCCEEDED };
+    };
+
     sptr<AppExecFwk::IAppMgr> GetAppManagerInstance();
     bool VerifyAccessToken(const std::string& permissionName);
     void Init();
@@ -100,14 +120,21 @@ private:
     void ApplyAppearanceContextToUser(const AccountContext& sourceContext, const AccountContext& targetContext);
     void AccountContextSwitchFunc(const AccountContext& context);
     void DoInitProcess();
+    void RestoreStateSnapshot();
+    void CollectStateSnapshot(StateSnapshot::Records& records);
 
     void UpdateCurrentUserConfiguration(const AccountContext& context, const bool isForceUpdate);
+    void DumpState(DumpBuffer& out);
+    std::shared_ptr<AppearanceSetters> GetAppearanceSetters(const AccountContext& context);
+    int32_t ApplyDarkMode(const AccountContext& context, DarkMode darkMode, uint32_t mergedCount);
+    int32_t SubmitFontScale(const AccountContext& context, const FontScale& fontScale);
+    int32_t SubmitFontWeightScale(const AccountContext& context, const FontScale& fontWeightScale);
     int32_t OnSetDarkMode(const AccountContext& context, DarkMode mode);
     DarkMode InitGetDarkMode(const AccountContext& context);
-    int32_t OnSetFontScale(const AccountContext& context, const std::string& fontScale);
-    int32_t OnSetFontWeightScale(const AccountContext& context, const std::string& fontWeightScale);
-    int32_t ConfigureFontScalePersistence(const AccountContext& context, const std::string& fontScale);
-    int32_t ConfigureFontWeightScalePersistence(const AccountContext& context, const std::string& fontWeightScale);
+    int32_t OnSetFontScale(const AccountContext& context, const FontScale& fontScale);
+    int32_t OnSetFontWeightScale(const AccountContext& context, const FontScale& fontWeightScale);
+    int32_t ConfigureFontScalePersistence(const AccountContext& context, const FontScale& fontScale);
+    int32_t ConfigureFontWeightScalePersistence(const AccountContext& context, const FontScale& fontWeightScale);
     std::string DarkNodeConfigurationAssignUser(const int32_t userId);
     std::string FontScaleConfigurationAssignUser(const int32_t userId);
     std::string FontWeightScaleConfigurationAssignUser(const int32_t userId);
@@ -124,6 +151,9 @@ private:
     std::vector<std::int32_t> GetMultipleUsers();
     void ConfigurePersistence(const bool isDarkMode, const AccountContext& context, const std::string& paramValue);
     int32_t ConfigurePersistence(const AccountContext& context, DarkMode mode, const std::string& paramValue);
+    // Tells client caches that the committed appearance changed, see UiAppearanceCache. Called once per change,
+    // after every user it covers is persisted.
+    void PublishAppearanceChange();
 
     std::shared_ptr<UiAppearanceEventSubscriber> uiAppearanceEventSubscriber_;
     std::mutex usersParamMutex_;
@@ -133,6 +163,9 @@ private:
     std::set<AccountContext> userSwitchUpdateConfigurationOnceFlag_;
     std::mutex userSwitchUpdateConfigurationOnceFlagMutex_;
     std::mutex settingMutex_;
+    std::mutex appearanceSettersMutex_;
+    std::map<AccountContext, std::shared_ptr<AppearanceSetters>> appearanceSetters_;
+    std::atomic<uint64_t> configGeneration_ = 0;
 };
 } // namespace ArkUi::UiAppearance
 } // namespace OHOS
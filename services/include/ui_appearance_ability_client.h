@@ -44,6 +44,11 @@ public:
     int32_t GetFontWeightScale(std::string& fontWeightScale);
     int32_t SetFontWeightScale(std::string& fontWeightScale);
     int32_t SetSettingData(std::string key, std::string value);
+    // Typed variants; the service validates and formats the scale once, so no string round trip is needed here.
+    int32_t GetFontScaleValue(double& fontScale);
+    int32_t SetFontScaleValue(double fontScale);
+    int32_t GetFontWeightScaleValue(double& fontWeightScale);
+    int32_t SetFontWeightScaleValue(double fontWeightScale);
     void OnRemoteSaDied(const wptr<IRemoteObject>& object);
 
 private:
@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef UI_APPEARANCE_CACHE_H
+#define UI_APPEARANCE_CACHE_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "debounce_task.h"
+#include "nocopyable.h"
+#include "ui_appearance_types.h"
+
+namespace OHOS::ArkUi::UiAppearance {
+// Bumped by the service after every committed appearance change; clients watch it instead of polling over IPC.
+constexpr const char* CONFIG_GENERATION_PARAM = "ui_appearance.config.generation";
+
+struct AppearanceSnapshot {
+    DarkMode darkMode = DarkMode::UNKNOWN;
+    double fontScale = 0;
+    double fontWeightScale = 0;
+    // Number of changes delivered to listeners in this process, so holders of a snapshot can tell it is outdated.
+    uint64_t version = 0;
+};
+
+/**
+ * Per-process copy of the calling user's dark mode, font scale and font weight scale, served from memory so that
+ * JS and ETS getters never make a binder call on the UI thread.
+ *
+ * Staleness contract: a change committed by the service is visible here one refresh after CONFIG_GENERATION_PARAM
+ * changes, which is one binder round trip off the calling thread. Until then getters keep returning the previous
+ * value. If no notification arrives, a value is never served more than MAX_STALENESS past its fetch without a
+ * refresh being scheduled. Only the very first read in a process, before any value was fetched, blocks on IPC.
+ * Refresh() fetches synchronously for callers that must observe the latest value.
+ */
+class __attribute__((visibility("default"))) UiAppearanceCache final : public NoCopyable {
+public:
+    static constexpr std::chrono::milliseconds MAX_STALENESS { 3000 };
+
+    using ChangeListener = std::function<void(const AppearanceSnapshot& snapshot)>;
+
+    static UiAppearanceCache& GetInstance();
+
+    ~UiAppearanceCache() override;
+
+    // Starts watching for change notifications and fetches in the background, so the first read is usually warm.
+    void Prefetch();
+
+    // Returns the dark mode, or an error code when no value has been fetched yet and the fetch failed.
+    int32_t GetDarkMode();
+    int32_t GetFontScale(double& fontScale);
+    int32_t GetFontWeightScale(double& fontWeightScale);
+
+    // Fetches all values on the calling thread; returns the first error, values that were fetched are still kept.
+    int32_t Refresh();
+
+    // Marks every value stale and schedules a background refresh.
+    void Invalidate();
+
+    // Copies the cached values without blocking. Returns false, and schedules a background fetch, while any value
+    // has not been fetched yet; listeners are told once the fetch completes.
+    bool PeekSnapshot(AppearanceSnapshot& snapshot);
+
+    // Listeners run on a cache worker thread, one change at a time, whenever a refresh or write-through changes any
+    // value. Returns the id to pass to RemoveChangeListener.
+    uint64_t AddChangeListener(const ChangeListener& listener);
+
+    // Once this returns the listener is not running and will not run again, unless called from the listener itself.
+    bool RemoveChangeListener(uint64_t id);
+
+    // Write-through of a set the service accepted, so the caller reads its own write before the notification lands.
+    void StoreDarkMode(DarkMode mode);
+    void StoreFontScale(double fontScale);
+    void StoreFontWeightScale(double fontWeightScale);
+
+private:
+    template<typename T>
+    struct Entry {
+        std::atomic<T> value {};
+        std::atomic<bool> isValid = false;
+    };
+
+    UiAppearanceCache() = default;
+
+    static void OnGenerationChanged(const char* key, const char* value, void* context);
+
+    static int64_t NowMs();
+
+    void EnsureWatching();
+    bool LoadSnapshot(AppearanceSnapshot& snapshot) const;
+    void ScheduleNotify();
+    void NotifyIfChanged();
+    bool IsStale() const;
+    void ScheduleRefreshIfStale();
+    int32_t FetchDarkMode();
+    int32_t FetchFontScale();
+    int32_t FetchFontWeightScale();
+
+    Entry<int32_t> darkMode_;
+    Entry<double> fontScale_;
+    Entry<double> fontWeightScale_;
+
+    // notifiedGeneration_ counts notifications; a refresh records the count it started from in fetchedGeneration_.
+    std::atomic<uint64_t> notifiedGeneration_ = 0;
+    std::atomic<uint64_t> fetchedGeneration_ = 0;
+    std::atomic<int64_t> fetchedTimeMs_ = 0;
+    std::atomic<bool> isRefreshScheduled_ = false;
+    std::atomic<bool> isWatching_ = false;
+
+    std::once_flag watchOnce_;
+    std::unique_ptr<DebounceTask> refreshTask_;
+
+    std::mutex listenersMutex_;
+    std::map<uint64_t, ChangeListener> listeners_;
+    uint64_t nextListenerId_ = 1;
+    AppearanceSnapshot notifiedSnapshot_;
+    bool hasNotifiedSnapshot_ = false;
+    std::atomic<bool> hasListeners_ = false;
+    // Held while listeners run, so RemoveChangeListener can wait for a running round to finish.
+    std::mutex notifyMutex_;
+    std::atomic<std::thread::id> notifyThreadId_;
+    std::unique_ptr<DebounceTask> notifyTask_;
+};
+} // namespace OHOS::ArkUi::UiAppearance
+#endif // UI_APPEARANCE_CACHE_H
@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef UI_APPEARANCE_TRACE_H
+#define UI_APPEARANCE_TRACE_H
+
+/**
+ * Scoped HiTrace spans for the dark mode switch pipeline. Spans are named "<stage> ctx:<userId>/<subProfileId>" so
+ * the stages of one account line up in the system trace. Without UI_APPEARANCE_HITRACE_ENABLE the macros expand to
+ * nothing and their arguments are not evaluated; with it, a span costs one tag check unless tracing is capturing.
+ */
+#ifdef UI_APPEARANCE_HITRACE_ENABLE
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+#include "hitrace_meter.h"
+#include "nocopyable.h"
+
+namespace OHOS::ArkUi::UiAppearance {
+class TraceScope final : public NoCopyable {
+public:
+    TraceScope(const char* stage, const int32_t userId, const int32_t subProfileId)
+    {
+        if (!IsTagEnabled(HITRACE_TAG_ACE)) {
+            return;
+        }
+        StartTrace(HITRACE_TAG_ACE, FormatName(stage, userId, subProfileId));
+        isStarted_ = true;
+    }
+
+    ~TraceScope() override
+    {
+        if (isStarted_) {
+            FinishTrace(HITRACE_TAG_ACE);
+        }
+    }
+
+    static std::string FormatName(const char* stage, const int32_t userId, const int32_t subProfileId)
+    {
+        char name[NAME_SIZE] = { 0 };
+        int32_t length = snprintf(name, sizeof(name), "%s ctx:%d/%d", stage, userId, subProfileId);
+        return length < 0 ? std::string(stage) : std::string(name);
+    }
+
+private:
+    static constexpr size_t NAME_SIZE = 96;
+    bool isStarted_ = false;
+};
+
+/**
+ * Async span on its own track for one whole switch. Every span gets a fresh task id, so overlapping switches of
+ * different accounts, or of the same account, never close each other's span.
+ */
+class TraceAsyncScope final : public NoCopyable {
+public:
+    TraceAsyncScope(const char* stage, const int32_t userId, const int32_t subProfileId)
+    {
+        if (!IsTagEnabled(HITRACE_TAG_ACE)) {
+            return;
+        }
+        name_ = TraceScope::FormatName(stage, userId, subProfileId);
+        taskId_ = nextTaskId_.fetch_add(1, std::memory_order_relaxed);
+        StartAsyncTrace(HITRACE_TAG_ACE, name_, taskId_);
+        isStarted_ = true;
+    }
+
+    ~TraceAsyncScope() override
+    {
+        if (isStarted_) {
+            FinishAsyncTrace(HITRACE_TAG_ACE, name_, taskId_);
+        }
+    }
+
+private:
+    static inline std::atomic<int32_t> nextTaskId_ = 1;
+    std::string name_;
+    int32_t taskId_ = 0;
+    bool isStarted_ = false;
+};
+} // namespace OHOS::ArkUi::UiAppearance
+
+#define UI_APPEARANCE_TRACE_SCOPE(stage, userId, subProfileId) \
+    OHOS::ArkUi::UiAppearance::TraceScope uiAppearanceTraceScope((stage), (userId), (subProfileId))
+#define UI_APPEARANCE_TRACE_ASYNC_SCOPE(stage, userId, subProfileId) \
+    OHOS::ArkUi::UiAppearance::TraceAsyncScope uiAppearanceTraceAsyncScope((stage), (userId), (subProfileId))
+#else
+#define UI_APPEARANCE_TRACE_SCOPE(stage, userId, subProfileId) ((void)0)
+#define UI_APPEARANCE_TRACE_ASYNC_SCOPE(stage, userId, subProfileId) ((void)0)
+#endif // UI_APPEARANCE_HITRACE_ENABLE
+
+#define UI_APPEARANCE_TRACE_CONTEXT_SCOPE(stage, context) \
+    UI_APPEARANCE_TRACE_SCOPE(stage, (context).userId, (context).subProfileId)
+
+#endif // UI_APPEARANCE_TRACE_H
@@ -16,7 +16,6 @@
 #include "ui_appearance_log.h"
 #include "background_app_color_switch_settings.h"
 #include "json_utils.h"
-#include <algorithm>
 
 namespace {
 constexpr const char* CONFIG_PATH = "/etc/dark_mode_whilelist.json";
@@ -25,106 +24,307 @@ constexpr const char* BUNDLE_NAME = "bundleName";
 constexpr const char* STRATEGY = "strategy";
 constexpr const char* DURATION = "duration";
 constexpr const char* PERTASK_NUMBER = "perTaskNumber";
+constexpr uint32_t RELOAD_DEBOUNCE_MS = 100;
 } // namespace
 
 namespace OHOS::ArkUi::UiAppearance {
-    BackGroundAppColorSwitchSettings &BackGroundAppColorSwitchSettings::GetInstance()
+namespace {
+/**
+ * Extracts whiteList[].bundleName and strategy.{duration,perTaskNumber} while the file streams by, so a large
+ * allow list never becomes a DOM. Duplicate keys resolve to the last occurrence, as they do in nlohmann::json.
+ */
+class AllowListSaxHandler final : public nlohmann::json_sax<nlohmann::json> {
+public:
+    bool null() override
+    {
+        return OnValue(ValueKind::OTHER);
+    }
+
+    bool boolean(bool) override
+    {
+        return OnValue(ValueKind::OTHER);
+    }
+
+    bool number_integer(number_integer_t val) override
+    {
+        return OnNumber(static_cast<int32_t>(val));
+    }
+
+    bool number_unsigned(number_unsigned_t val) override
+    {
+        return OnNumber(static_cast<int32_t>(val));
+    }
+
+    bool number_float(number_float_t val, const string_t&) override
+    {
+        return OnNumber(static_cast<int32_t>(val));
+    }
+
+    bool string(string_t& val) override
+    {
+        if (depth_ == FIELD_DEPTH && inAllowList_ && fieldKey_ == BUNDLE_NAME) {
+            pendingBundleName_ = val;
+            hasPendingBundleName_ = true;
+            return true;
+        }
+        return OnValue(ValueKind::OTHER);
+    }
+
+    bool binary(binary_t&) override
+    {
+        return OnValue(ValueKind::OTHER);
+    }
+
+    bool start_object(std::size_t) override
+    {
+        OnValue(ValueKind::OBJECT);
+        if (depth_ == ENTRY_DEPTH && inAllowList_) {
+            hasPendingBundleName_ = false;
+            fieldKey_.clear();
+        }
+        depth_++;
+        return true;
+    }
+
+    bool end_object() override
+    {
+        depth_--;
+        if (depth_ == ENTRY_DEPTH && inAllowList_ && hasPendingBundleName_) {
+            LOGD("insert allowList bundleName = %{public}s", pendingBundleName_.c_str());
+            settings_.allowList.push_back(pendingBundleName_);
+            hasPendingBundleName_ = false;
+        } else if (depth_ == TOP_LEVEL_DEPTH) {
+            inStrategy_ = false;
+        }
+        return true;
+    }
+
+    bool start_array(std::size_t) override
+    {
+        OnValue(ValueKind::ARRAY);
+        depth_++;
+        return true;
+    }
+
+    bool end_array() override
+    {
+        depth_--;
+        if (depth_ == TOP_LEVEL_DEPTH) {
+            inAllowList_ = false;
+        }
+        return true;
+    }
+
+    bool key(string_t& val) override
+    {
+        if (depth_ == TOP_LEVEL_DEPTH) {
+            topKey_ = val;
+        } else if ((depth_ == ENTRY_DEPTH && inStrategy_) || (depth_ == FIELD_DEPTH && inAllowList_)) {
+            fieldKey_ = val;
+        }
+        return true;
+    }
+
+    bool parse_error(std::size_t position, const std::string&, const nlohmann::detail::exception&) override
+    {
+        LOGW("BackGroundAppColorSwitchSettings parse error at %{public}zu", position);
+        return false;
+    }
+
+    ErrCode Build(BackGroundAppColorSwitchSettings::Settings& settings)
+    {
+        if (!isAllowListArray_) {
+            LOGW("BackGroundAppColorSwitchSettings unable to query white list");
+            return ERR_INVALID_VALUE;
+        }
+        if (!hasStrategy_) {
+            LOGW("BackGroundAppColorSwitchSettings unable to query strategy");
+            return ERR_NAME_NOT_FOUND;
+        }
+        if (!hasDuration_) {
+            LOGW("BackGroundAppColorSwitchSettings unable to query duration");
+            return ERR_INVALID_VALUE;
+        }
+        if (!hasTaskQuantity_) {
+            LOGW("BackGroundAppColorSwitchSettings unable to query perTaskNumber");
+            return ERR_INVALID_VALUE;
+        }
+        if (settings_.taskQuantity <= 0 || settings_.durationMillisecond <= 0) {
+            LOGW("settings error, taskQuantity:%{public}d durationMillisecond:%{public}d",
+                settings_.taskQuantity, settings_.durationMillisecond);
+            return ERR_INVALID_VALUE;
+        }
+        settings_.isAllowListEnable = true;
+        settings = std::move(settings_);
+        settings.allowSet.reserve(settings.allowList.size());
+        for (const std::string& bundleName : settings.allowList) {
+            settings.allowSet.insert(bundleName);
+        }
+        return ERR_OK;
+    }
+
+private:
+    enum class ValueKind { OTHER, NUMBER, OBJECT, ARRAY };
+
+    // Number of open containers: root members live at 1, whiteList entries and strategy members at 2, and the
+    // members of a whiteList entry at 3.
+    static constexpr int32_t TOP_LEVEL_DEPTH = 1;
+    static constexpr int32_t ENTRY_DEPTH = 2;
+    static constexpr int32_t FIELD_DEPTH = 3;
+
+    bool OnNumber(int32_t value)
+    {
+        OnValue(ValueKind::NUMBER);
+        if (depth_ == ENTRY_DEPTH && inStrategy_) {
+            if (fieldKey_ == DURATION) {
+                settings_.durationMillisecond = value;
+            } else if (fieldKey_ == PERTASK_NUMBER) {
+                settings_.taskQuantity = value;
+            }
+        }
+        return true;
+    }
+
+    // Records what a watched key was bound to; a later duplicate key overrides the earlier binding.
+    bool OnValue(ValueKind kind)
+    {
+        if (depth_ == TOP_LEVEL_DEPTH) {
+            if (topKey_ == ALLOW_LIST) {
+                isAllowListArray_ = kind == ValueKind::ARRAY;
+                inAllowList_ = isAllowListArray_;
+                settings_.allowList.clear();
+            } else if (topKey_ == STRATEGY) {
+                hasStrategy_ = true;
+                inStrategy_ = kind == ValueKind::OBJECT;
+                hasDuration_ = false;
+                hasTaskQuantity_ = false;
+            }
+        } else if (depth_ == ENTRY_DEPTH && inStrategy_) {
+            if (fieldKey_ == DURATION) {
+                hasDuration_ = kind == ValueKind::NUMBER;
+            } else if (fieldKey_ == PERTASK_NUMBER) {
+                hasTaskQuantity_ = kind == ValueKind::NUMBER;
+            }
+        } else if (depth_ == FIELD_DEPTH && inAllowList_ && fieldKey_ == BUNDLE_NAME) {
+            hasPendingBundleName_ = false;
+        }
+        return true;
+    }
+
+    BackGroundAppColorSwitchSettings::Settings settings_;
+    int32_t depth_ = 0;
+    std::string topKey_;
+    std::string fieldKey_;
+    std::string pendingBundleName_;
+    bool hasPendingBundleName_ = false;
+    bool inAllowList_ = false;
+    bool inStrategy_ = false;
+    bool isAllowListArray_ = false;
+    bool hasStrategy_ = false;
+    bool hasDuration_ = false;
+    bool hasTaskQuantity_ = false;
+};
+} // namespace
+
+BackGroundAppColorSwitchSettings &BackGroundAppColorSwitchSettings::GetInstance()
 {
     static BackGroundAppColorSwitchSettings instance;
     return instance;
 }
 
+std::shared_ptr<const BackGroundAppColorSwitchSettings::Settings> BackGroundAppColorSwitchSettings::GetSettings() const
+{
+    return std::atomic_load_explicit(&settings_, std::memory_order_acquire);
+}
+
 bool BackGroundAppColorSwitchSettings::IsSupportHotUpdate()
 {
-    std::lock_guard lock(policyMutex_);
-    return isAllowListEnable_;
+    return GetSettings()->isAllowListEnable;
 }
 
 ErrCode BackGroundAppColorSwitchSettings::Initialize()
 {
-    std::lock_guard lock(policyMutex_);
-    nlohmann::json object;
-    if (!JsonUtils::LoadConfiguration(CONFIG_PATH, object)) {
+    std::string configPath = JsonUtils::GetConfigPath(CONFIG_PATH, "");
+    if (configPath.empty()) {
         LOGW("BackGroundAppColorSwitchSettings read file failed");
         return ERR_NAME_NOT_FOUND;
     }
+    ErrCode ret = Reload(configPath);
+    StartWatch(configPath);
+    return ret;
+}
 
-    if (!object.contains(ALLOW_LIST) || !object.at(ALLOW_LIST).is_array()) {
-        LOGW("BackGroundAppColorSwitchSettings unable to query white list");
-        return ERR_INVALID_VALUE;
+ErrCode BackGroundAppColorSwitchSettings::Reload(const std::string& configPath, const bool isHotReload)
+{
+    AllowListSaxHandler handler;
+    auto settings = std::make_shared<Settings>();
+    ErrCode ret = ERR_NAME_NOT_FOUND;
+    if (JsonUtils::SaxParseFile(configPath, handler, isHotReload)) {
+        ret = handler.Build(*settings);
     }
-
-    for (auto &item : object.at(ALLOW_LIST).items()) {
-        const nlohmann::json& jsonObject = item.value();
-        if (!jsonObject.contains(BUNDLE_NAME) || !jsonObject.at(BUNDLE_NAME).is_string()) {
-            continue;
-        }
-        auto bundleName = jsonObject.at(BUNDLE_NAME).get<std::string>();
-        LOGI("insert allowList_ bundleName = %{public}s", bundleName.c_str());
-        allowList_.push_back(bundleName);
+    if (ret != ERR_OK) {
+        reloadFailureCount_.fetch_add(1, std::memory_order_relaxed);
+        LOGW("BackGroundAppColorSwitchSettings reload failed, keep previous settings, ret: %{public}d", ret);
+        return ret;
     }
+    LOGI("taskQuantity= %{public}d durationMillisecond= %{public}d allowList size= %{public}zu",
+        settings->taskQuantity, settings->durationMillisecond, settings->allowList.size());
+    std::atomic_store_explicit(&settings_, std::shared_ptr<const Settings>(std::move(settings)),
+        std::memory_order_release);
+    reloadCount_.fetch_add(1, std::memory_order_relaxed);
+    return ERR_OK;
+}
 
-    if (!object.contains(STRATEGY)) {
-        LOGW("BackGroundAppColorSwitchSettings unable to query strategy");
-        return ERR_NAME_NOT_FOUND;
+void BackGroundAppColorSwitchSettings::StartWatch(const std::string& configPath)
+{
+    std::lock_guard lock(watchMutex_);
+    if (fileWatcher_ != nullptr) {
+        return;
     }
-
-    auto strategy = object.at(STRATEGY);
-    if (!strategy.contains(DURATION) || !strategy.at(DURATION).is_number()) {
-        LOGW("BackGroundAppColorSwitchSettings unable to query duration");
-        return ERR_INVALID_VALUE;
+    configPath_ = configPath;
+    // Hot reloads read the file into a buffer, as it may be edited in place while it is parsed. Package updates may
+    // replace it several times in a row, so reload once per burst.
+    reloadTask_ = std::make_unique<DebounceTask>("AllowListReload", RELOAD_DEBOUNCE_MS,
+        [this](uint32_t) { Reload(configPath_, true); });
+    fileWatcher_ = std::make_unique<FileWatcher>(configPath, [this]() { reloadTask_->Post(); });
+    if (!fileWatcher_->Start()) {
+        LOGW("BackGroundAppColorSwitchSettings hot reload unavailable");
     }
-    durationMillisecond_ = strategy.at(DURATION).get<int32_t>();
+}
 
-    if (!strategy.contains(PERTASK_NUMBER) || !strategy.at(PERTASK_NUMBER).is_number()) {
-        LOGW("BackGroundAppColorSwitchSettings unable to query perTaskNumber");
-        return ERR_INVALID_VALUE;
-    }
-    taskQuantity_ = strategy.at(PERTASK_NUMBER).get<int32_t>();
-    if (taskQuantity_ <= 0 || durationMillisecond_ <= 0) {
-        LOGW("settings error, taskQuantity_:%{public}d durationMillisecond_:%{public}d",
-            taskQuantity_, durationMillisecond_);
-        return ERR_INVALID_VALUE;
-    }
-    isAllowListEnable_ = true;
-    
-    LOGI("taskQuantity_= %{public}d durationMillisecond_= %{public}d", taskQuantity_, durationMillisecond_);
-    return ERR_OK;
+uint64_t BackGroundAppColorSwitchSettings::GetReloadCount() const
+{
+    return reloadCount_.load(std::memory_order_relaxed);
+}
+
+uint64_t BackGroundAppColorSwitchSettings::GetReloadFailureCount() const
+{
+    return reloadFailureCount_.load(std::memory_order_relaxed);
 }
 
 int32_t BackGroundAppColorSwitchSettings::GetTaskQuantity()
 {
-    std::lock_guard lock(policyMutex_);
-    return taskQuantity_;
+    return GetSettings()->taskQuantity;
 }
 
 int32_t BackGroundAppColorSwitchSettings::GetDurationMillisecond()
 {
-    std::lock_guard lock(policyMutex_);
-    return durationMillisecond_;
+    return GetSettings()->durationMillisecond;
 }
 
 bool BackGroundAppColorSwitchSettings::CheckInWhileList(const std::string& bundleName)
 {
-    std::lock_guard lock(policyMutex_);
-    if (std::find(allowList_.begin(), allowList_.end(), bundleName) != allowList_.end()) {
-        return true;
-    }
-    return false;
+    auto settings = GetSettings();
+    return settings->allowSet.find(bundleName) != settings->allowSet.end();
 }
 
 void BackGroundAppColorSwitchSettings::Reset()
 {
-    std::lock_guard lock(policyMutex_);
-    allowList_.clear();
-    taskQuantity_ = -1;
-    durationMillisecond_ = -1;
-    isAllowListEnable_ = false;
+    std::atomic_store_explicit(&settings_, std::make_shared<const Settings>(), std::memory_order_release);
 }
 
 std::list<std::string> BackGroundAppColorSwitchSettings::GetWhileList()
 {
-    std::lock_guard lock(policyMutex_);
-    return allowList_;
+    return GetSettings()->allowList;
 }
 } // namespace OHOS::ArkUi::UiAppearance
@@ -15,16 +15,25 @@
 
 #include "dark_mode_manager.h"
 
-#include <chrono>
-
+#include <algorithm>
+#include <cinttypes>
+#include <cmath>
+#include <cstdlib>
+
+#include "alarm_clock.h"
+#include "dark_schedule.h"
+#include "event_trace.h"
 #include "iservice_registry.h"
 #include "message_option.h"
 #include "message_parcel.h"
 #include "system_ability_definition.h"
+#include "local_time_cache.h"
 #include "location.h"
 #include "parameter_wrap.h"
 #include "setting_data_manager.h"
+#include "state_snapshot.h"
 #include "ui_appearance_log.h"
+#include "ui_appearance_trace.h"
 
 namespace OHOS::ArkUi::UiAppearance {
 namespace {
@@ -35,10 +44,43 @@ const std::string SETTING_DARK_MODE_SUN_SET = "settings.display.sun_set";
 const std::string SETTING_DARK_MODE_SUN_RISE = "settings.display.sun_rise";
 const static int32_t USER100 = 100;
 constexpr int32_t MINUTE_TO_SECOND = 60;
+constexpr int32_t SECOND_TO_MILLI = 1000;
 constexpr int32_t OFFSET_SECONDS = 5;
 constexpr int32_t LOCATOR_SA_ID = 2802;
 constexpr uint32_t COMMAND_GET_CACHE_LOCATION = 5;
+constexpr int32_t LOCATION_FETCH_WAIT_TIME_SECONDS = static_cast<int32_t>(LOCATION_FETCH_DEADLINE_MS / SECOND_TO_MILLI);
 const std::u16string LOCATOR_INTERFACE_TOKEN = u"OHOS.Location.ILocatorService";
+// Sunrise/sunset is recalculated only when the device moved further than this many meters since the last calculation
+// of the same local day and time zone; 0 recalculates every time.
+const std::string SUNRISE_SUNSET_RECALC_DISTANCE = "persist.uiappearance.sunrise_sunset.recalc_distance";
+constexpr double SUNRISE_SUNSET_RECALC_DISTANCE_DEFAULT = 1000.0;
+constexpr double EARTH_RADIUS_METERS = 6371000.0;
+constexpr double DEGREE_TO_RADIAN = M_PI / 180.0;
+constexpr int64_t SECONDS_PER_DAY = 86400;
+
+double GetSunriseSunsetRecalcDistance()
+{
+    std::string value;
+    GetParameterWrap(SUNRISE_SUNSET_RECALC_DISTANCE, value, "");
+    if (value.empty()) {
+        return SUNRISE_SUNSET_RECALC_DISTANCE_DEFAULT;
+    }
+    char* end = nullptr;
+    double distance = std::strtod(value.c_str(), &end);
+    if (end == value.c_str() || *end != '\0' || !std::isfinite(distance) || distance < 0.0) {
+        LOGW("invalid %{public}s: %{public}s", SUNRISE_SUNSET_RECALC_DISTANCE.c_str(), value.c_str());
+        return SUNRISE_SUNSET_RECALC_DISTANCE_DEFAULT;
+    }
+    return distance;
+}
+
+// Equirectangular approximation, accurate to well under a meter at the distances that gate a recalculation.
+double GetDistanceMeters(double lat1, double lon1, double lat2, double lon2)
+{
+    const double x = (lon2 - lon1) * DEGREE_TO_RADIAN * std::cos((lat1 + lat2) / 2.0 * DEGREE_TO_RADIAN);
+    const double y = (lat2 - lat1) * DEGREE_TO_RADIAN;
+    return EARTH_RADIUS_METERS * std::sqrt(x * x + y * y);
+}
 }
 
 DarkModeManager &DarkModeManager::GetInstance()
@@ -51,6 +93,7 @@ ErrCode DarkModeManager::Initialize(const std::function<void(bool, int32_t)>& up
 {
     LoadSettingDataObserversCallback();
     updateCallback_ = updateCallback;
+    RegisterSnapshotCollector();
     return ERR_OK;
 }
 
@@ -64,6 +107,12 @@ ErrCode DarkModeManager::LoadUserSettingData(
 ErrCode DarkModeManager::LoadUserSettingData(
     const AccountContext& context, const bool needUpdateCallback, bool &isDarkMode, const bool bootLoadFlag)
 {
+    {
+        // Marked before the settings are read, so that a change racing with this load while the context is inactive
+        // still leaves it to be loaded again.
+        std::lock_guard lock(settingDataObserversMutex_);
+        loadedContexts_.insert(context);
+    }
     SettingDataManager& manager = SettingDataManager::GetInstance();
     auto getInt32Value = [&manager, &context](const std::string& baseKey, int32_t& value) {
         const std::string contextKey = AccountContextHelper::BuildSettingKey(baseKey, context);
@@ -93,27 +142,26 @@ ErrCode DarkModeManager::LoadUserSettingData(
     int32_t sunriseTime = SUNRISE_TIME_DEFAULT;
     getInt32Value(SETTING_DARK_MODE_SUN_RISE, sunriseTime);
 
-    DarkModeMode currentMode = DARK_MODE_INVALID;
-    ErrCode code = ERR_OK;
+    DarkModeMode currentMode = static_cast<DarkModeMode>(darkMode);
     {
-        std::lock_guard lock(darkModeStatesMutex_);
-        DarkModeState& state = darkModeStates_[context];
-        state.settingMode = static_cast<DarkModeMode>(darkMode);
+        DarkModeState& state = GetState(context);
+        std::lock_guard lock(state.mutex);
+        state.settingMode = currentMode;
         state.settingStartTime = startTime;
         state.settingEndTime = endTime;
         state.settingSunsetTime = sunsetTime;
         state.settingSunriseTime = sunriseTime;
-        LOGI("load user setting data, context: %{public}s, mode: %{public}d, start: %{public}d, end : %{public}d",
-            AccountContextHelper::ToString(context).c_str(), darkMode, startTime, endTime);
-        temporaryColorModeMgr_.InitData(context);
-        if (temporaryColorModeMgr_.IsColorModeTemporary(context) &&
-            temporaryColorModeMgr_.CheckTemporaryStateEffective(context) == false) {
-            temporaryColorModeMgr_.SetColorModeNormal(context);
-        }
-        screenSwitchOperatorMgr_.ResetScreenOffOperateInfo();
-        currentMode = state.settingMode;
-        code = OnStateChangeLocked(context, needUpdateCallback, isDarkMode, false, bootLoadFlag);
+        MarkSettingsChanged(state);
     }
+    LOGI("load user setting data, context: %{public}s, mode: %{public}d, start: %{public}d, end : %{public}d",
+        AccountContextHelper::ToString(context).c_str(), darkMode, startTime, endTime);
+    temporaryColorModeMgr_.InitData(context);
+    if (temporaryColorModeMgr_.IsColorModeTemporary(context) &&
+        temporaryColorModeMgr_.CheckTemporaryStateEffective(context) == false) {
+        temporaryColorModeMgr_.SetColorModeNormal(context);
+    }
+    screenSwitchOperatorMgr_.ResetScreenOffOperateInfo();
+    ErrCode code = OnStateChange(context, needUpdateCallback, isDarkMode, false, bootLoadFlag);
 
     if (currentMode == DARK_MODE_SUNRISE_SUNSET) {
         InitSunriseSunsetMode(context);
@@ -129,8 +177,7 @@ void DarkModeManager::NotifyDarkModeUpdate(const int32_t userId, const bool isDa
 void DarkModeManager::NotifyDarkModeUpdate(const AccountContext& context, const bool isDarkMode)
 {
     SettingDataManager& manager = SettingDataManager::GetInstance();
-    std::lock_guard lock(darkModeStatesMutex_);
-    const DarkModeState& state = darkModeStates_[context];
+    const DarkModeSettings state = GetSettingsSnapshot(GetState(context));
     const std::string key = AccountContextHelper::BuildSettingKey(SETTING_DARK_MODE_MODE, context);
     if (isDarkMode) {
         if (state.settingMode == DARK_MODE_ALWAYS_LIGHT || state.settingMode == DARK_MODE_INVALID) {
@@ -159,6 +206,7 @@ void DarkModeManager::ScreenOffCallback()
         bool switchToDark = false;
         int32_t userId = USER100;
         screenSwitchOperatorMgr_.GetScreenOffOperateInfo(switchToDark, userId);
+        UI_APPEARANCE_TRACE_ASYNC_SCOPE("DarkModeSwitch.ScreenOff", userId, INVALID_SUB_PROFILE_ID);
         OnChangeDarkMode(
             switchToDark == true ? DarkModeMode::DARK_MODE_ALWAYS_DARK : DarkModeMode::DARK_MODE_ALWAYS_LIGHT,
             AccountContextHelper::CreateBaseContext(userId));
@@ -172,6 +220,12 @@ ErrCode DarkModeManager::OnSwitchUser(const int32_t userId)
 }
 
 ErrCode DarkModeManager::OnSwitchContext(const AccountContext& context)
+{
+    return OnSwitchContext(context, { context });
+}
+
+ErrCode DarkModeManager::OnSwitchContext(
+    const AccountContext& context, const std::vector<AccountContext>& foregroundContexts)
 {
     SettingDataManager& manager = SettingDataManager::GetInstance();
     if (!manager.IsInitialized()) {
@@ -187,25 +241,143 @@ ErrCode DarkModeManager::OnSwitchContext(const AccountContext& context)
         return ERR_INVALID_OPERATION;
     }
 
-    std::lock_guard lock(settingDataObserversMutex_);
-    if (settingDataObserversContext_.userId == INVALID_USER_ID && settingDataObserversUserId_ != INVALID_USER_ID) {
-        settingDataObserversContext_ = AccountContextHelper::CreateBaseContext(settingDataObserversUserId_);
+    auto isForeground = [&context, &foregroundContexts](const AccountContext& other) {
+        return other == context ||
+            std::find(foregroundContexts.begin(), foregroundContexts.end(), other) != foregroundContexts.end();
+    };
+    std::vector<AccountContext> backgroundContexts;
+    {
+        std::lock_guard lock(settingDataObserversMutex_);
+        AccountContext previousContext = settingDataObserversContext_;
+        if (previousContext.userId == INVALID_USER_ID && settingDataObserversUserId_ != INVALID_USER_ID) {
+            previousContext = AccountContextHelper::CreateBaseContext(settingDataObserversUserId_);
+        }
+        settingDataObserversContext_ = context;
+        settingDataObserversUserId_ = context.userId;
+
+        if (previousContext.userId != INVALID_USER_ID && !isForeground(previousContext)) {
+            backgroundContexts.push_back(previousContext);
+        }
+        for (const auto& activeContext : activeContexts_) {
+            if (!(activeContext == previousContext) && !isForeground(activeContext)) {
+                backgroundContexts.push_back(activeContext);
+            }
+        }
     }
-    if (settingDataObserversContext_.userId != INVALID_USER_ID) {
-        LOGI("clear timers and unregister observers for context: %{public}s",
-            AccountContextHelper::ToString(settingDataObserversContext_).c_str());
-        alarmTimerManager_.ClearTimerByUserId(AccountContextHelper::BuildTimerKey(settingDataObserversContext_));
-        UnregisterSettingDataObserversLocked(settingDataObserversContext_);
-        settingDataObserversContext_ = AccountContextHelper::CreateBaseContext(INVALID_USER_ID);
-        settingDataObserversUserId_ = INVALID_USER_ID;
+
+    for (const auto& backgroundContext : backgroundContexts) {
+        DeactivateContext(backgroundContext);
+    }
+    for (const auto& foregroundContext : foregroundContexts) {
+        if (foregroundContext == context || foregroundContext.userId <= INVALID_USER_ID) {
+            continue;
+        }
+        ErrCode code = ActivateContext(foregroundContext);
+        if (code != ERR_OK) {
+            LOGE("activate foreground context failed: %{public}s, code: %{public}d",
+                AccountContextHelper::ToString(foregroundContext).c_str(), code);
+        }
     }
+    return ActivateContext(context);
+}
 
-    ErrCode code = RegisterSettingDataObserversLocked(context);
-    settingDataObserversContext_ = context;
-    settingDataObserversUserId_ = context.userId;
+ErrCode DarkModeManager::ActivateContext(const AccountContext& context)
+{
+    {
+        std::lock_guard lock(settingDataObserversMutex_);
+        activeContexts_.insert(context);
+        if (observedContexts_.find(context) != observedContexts_.end()) {
+            LOGI("activate context: %{public}s, observers already registered",
+                AccountContextHelper::ToString(context).c_str());
+            return ERR_OK;
+        }
+    }
+
+    LOGI("activate context: %{public}s, register observers", AccountContextHelper::ToString(context).c_str());
+    ErrCode code = RegisterSettingDataObservers(context);
+    if (code == ERR_OK) {
+        std::lock_guard lock(settingDataObserversMutex_);
+        observedContexts_.insert(context);
+    }
     return code;
 }
 
+void DarkModeManager::DeactivateContext(const AccountContext& context)
+{
+    {
+        std::lock_guard lock(settingDataObserversMutex_);
+        activeContexts_.erase(context);
+        // The timers are cleared below, so the context has to be loaded again on activation.
+        loadedContexts_.erase(context);
+    }
+    LOGI("deactivate context: %{public}s, clear timers", AccountContextHelper::ToString(context).c_str());
+    alarmTimerManager_.ClearRecalculationTimer(AccountContextHelper::BuildTimerKey(context));
+    alarmTimerManager_.ClearTimerByUserId(AccountContextHelper::BuildTimerKey(context));
+}
+
+bool DarkModeManager::DeferApplyIfInactive(const AccountContext& context)
+{
+    {
+        std::lock_guard lock(settingDataObserversMutex_);
+        if (activeContexts_.find(context) != activeContexts_.end()) {
+            return false;
+        }
+        loadedContexts_.erase(context);
+    }
+    LOGI("context inactive, apply deferred until activation, context: %{public}s",
+        AccountContextHelper::ToString(context).c_str());
+    return true;
+}
+
+bool DarkModeManager::NeedLoadUserSettingData(const AccountContext& context)
+{
+    std::lock_guard lock(settingDataObserversMutex_);
+    return loadedContexts_.find(context) == loadedContexts_.end();
+}
+
+bool DarkModeManager::IsContextActive(const AccountContext& context)
+{
+    std::lock_guard lock(settingDataObserversMutex_);
+    return activeContexts_.find(context) != activeContexts_.end();
+}
+
+void DarkModeManager::RetainObservedContexts(const std::vector<AccountContext>& contexts)
+{
+    std::vector<AccountContext> staleContexts;
+    {
+        std::lock_guard lock(settingDataObserversMutex_);
+        for (auto it = observedContexts_.begin(); it != observedContexts_.end();) {
+            if (activeContexts_.find(*it) == activeContexts_.end() &&
+                std::find(contexts.begin(), contexts.end(), *it) == contexts.end()) {
+                staleContexts.push_back(*it);
+                loadedContexts_.erase(*it);
+                it = observedContexts_.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+    for (const auto& context : staleContexts) {
+        LOGI("unregister observers for context: %{public}s", AccountContextHelper::ToString(context).c_str());
+        UnregisterSettingDataObservers(context);
+    }
+}
+
+std::vector<AccountContext> DarkModeManager::GetActiveContexts()
+{
+    std::lock_guard lock(settingDataObserversMutex_);
+    std::vector<AccountContext> contexts(activeContexts_.begin(), activeContexts_.end());
+    AccountContext currentContext = settingDataObserversContext_;
+    if (currentContext.userId == INVALID_USER_ID && settingDataObserversUserId_ != INVALID_USER_ID) {
+        currentContext = AccountContextHelper::CreateBaseContext(settingDataObserversUserId_);
+    }
+    if (currentContext.userId != INVALID_USER_ID &&
+        activeContexts_.find(currentContext) == activeContexts_.end()) {
+        contexts.push_back(currentContext);
+    }
+    return contexts;
+}
+
 void DarkModeManager::DoSwitchTemporaryColorMode(const int32_t userId, bool isDarkMode)
 {
     DoSwitchTemporaryColorMode(AccountContextHelper::CreateBaseContext(userId), isDarkMode);
@@ -234,6 +406,7 @@ void DarkModeManager::DoSwitchTemporaryColorMode(const AccountContext& context,
 void DarkModeManager::UpdateDarkModeSchedule(
     const DarkModeMode mode, const AccountContext& context, const bool resetTempColorModeFlag, const bool bootLoadFlag)
 {
+    UI_APPEARANCE_TRACE_CONTEXT_SCOPE("DarkMode.UpdateDarkModeSchedule", context);
     screenSwitchOperatorMgr_.ResetScreenOffOperateInfo();
     if (resetTempColorModeFlag == true) {
         OnChangeDarkMode(mode, context);
@@ -258,62 +431,58 @@ void DarkModeManager::UpdateDarkModeSchedule(
 
 ErrCode DarkModeManager::RestartTimer()
 {
-    AccountContext currentContext;
-    DarkModeMode mode;
-    int32_t startTime = -1;
-    int32_t endTime = -1;
-    {
-        std::lock_guard lock(darkModeStatesMutex_);
-        currentContext = settingDataObserversContext_;
-        if (currentContext.userId == INVALID_USER_ID && settingDataObserversUserId_ != INVALID_USER_ID) {
-            currentContext = AccountContextHelper::CreateBaseContext(settingDataObserversUserId_);
-        }
-        mode = darkModeStates_[currentContext].settingMode;
-        if (mode == DARK_MODE_SUNRISE_SUNSET) {
-            startTime = darkModeStates_[currentContext].settingSunsetTime;
-            endTime = darkModeStates_[currentContext].settingSunriseTime;
-        } else if (mode == DARK_MODE_CUSTOM_AUTO) {
-            startTime = darkModeStates_[currentContext].settingStartTime;
-            endTime = darkModeStates_[currentContext].settingEndTime;
-        } else {
-            LOGD("no need to restart timer.");
-            return ERR_OK;
-        }
+    bool needRestart = false;
+    for (const auto& context : GetActiveContexts()) {
+        bool contextNeedRestart = false;
+        RestartTimerByContext(context, contextNeedRestart);
+        needRestart = needRestart || contextNeedRestart;
     }
+    if (!needRestart) {
+        LOGD("no need to restart timer.");
+        return ERR_OK;
+    }
+    return alarmTimerManager_.RestartAllTimer();
+}
 
-    // Recalculate outside the lock to avoid recursive locking in CalculateAndApplySunriseSunsetTimes.
-    if (mode == DARK_MODE_SUNRISE_SUNSET) {
-        CalculateAndApplySunriseSunsetTimes(currentContext);
-        // Reacquire the lock because the recalculation may have updated the sunrise and sunset times.
-        std::lock_guard lock(darkModeStatesMutex_);
-        if (darkModeStates_[currentContext].settingMode == DARK_MODE_SUNRISE_SUNSET) {
-            startTime = darkModeStates_[currentContext].settingSunsetTime;
-            endTime = darkModeStates_[currentContext].settingSunriseTime;
-        } else {
-            // Another thread changed the mode, and SettingDataDarkModeModeUpdateFunc handled the timers.
-            return ERR_OK;
-        }
+ErrCode DarkModeManager::RestartTimerByContext(const AccountContext& context, bool& needRestart)
+{
+    needRestart = false;
+    DarkModeState& state = GetState(context);
+    DarkModeSettings settings = GetSettingsSnapshot(state);
+    if (settings.settingMode != DARK_MODE_SUNRISE_SUNSET && settings.settingMode != DARK_MODE_CUSTOM_AUTO) {
+        return ERR_OK;
+    }
+
+    if (settings.settingMode == DARK_MODE_SUNRISE_SUNSET) {
+        // The timers restart with the last known times; the sun_set/sun_rise observers reconcile them once the
+        // new location has been applied.
+        CalculateAndApplySunriseSunsetTimes(context);
+    }
+    int32_t startTime = settings.settingStartTime;
+    int32_t endTime = settings.settingEndTime;
+    if (settings.settingMode == DARK_MODE_SUNRISE_SUNSET) {
+        startTime = settings.settingSunsetTime;
+        endTime = settings.settingSunriseTime;
     }
 
     if (AlarmTimerManager::IsWithinTimeInterval(startTime, endTime)) {
-        UpdateDarkModeSchedule(DARK_MODE_ALWAYS_DARK, currentContext, false, false);
+        UpdateDarkModeSchedule(DARK_MODE_ALWAYS_DARK, context, false, false);
     } else {
-        UpdateDarkModeSchedule(DARK_MODE_ALWAYS_LIGHT, currentContext, false, false);
+        UpdateDarkModeSchedule(DARK_MODE_ALWAYS_LIGHT, context, false, false);
     }
-    return alarmTimerManager_.RestartAllTimer();
+    needRestart = true;
+    return ERR_OK;
 }
 
 bool DarkModeManager::IsDarkModeCustomAuto(const AccountContext& context)
 {
-    std::lock_guard lock(darkModeStatesMutex_);
-    return darkModeStates_[context].settingMode == DARK_MODE_CUSTOM_AUTO;
+    return GetSettingsSnapshot(GetState(context)).settingMode == DARK_MODE_CUSTOM_AUTO;
 }
 
 bool DarkModeManager::IsDarkModeSunsetSunrise(const AccountContext& context)
 {
-    std::lock_guard lock(darkModeStatesMutex_);
-    auto it = darkModeStates_.find(context);
-    return it != darkModeStates_.end() && it->second.settingMode == DARK_MODE_SUNRISE_SUNSET;
+    DarkModeState* state = FindState(context);
+    return state != nullptr && GetSettingsSnapshot(*state).settingMode == DARK_MODE_SUNRISE_SUNSET;
 }
 
 bool DarkModeManager::GetSettingTime(const int32_t userId, int32_t& settingStartTime, int32_t& settingEndTime)
@@ -323,19 +492,19 @@ bool DarkModeManager::GetSettingTime(const int32_t userId, int32_t& settingStart
 
 bool DarkModeManager::GetSettingTime(const AccountContext& context, int32_t& settingStartTime, int32_t& settingEndTime)
 {
-    std::lock_guard lock(darkModeStatesMutex_);
-    auto it = darkModeStates_.find(context);
-    if (it != darkModeStates_.end()) {
-        if (it->second.settingMode == DARK_MODE_CUSTOM_AUTO) {
-            settingStartTime = it->second.settingStartTime;
-            settingEndTime = it->second.settingEndTime;
-        } else {
-            settingStartTime = it->second.settingSunsetTime;
-            settingEndTime = it->second.settingSunriseTime;
-        }
-        return true;
+    DarkModeState* state = FindState(context);
+    if (state == nullptr) {
+        return false;
     }
-    return false;
+    const DarkModeSettings settings = GetSettingsSnapshot(*state);
+    if (settings.settingMode == DARK_MODE_CUSTOM_AUTO) {
+        settingStartTime = settings.settingStartTime;
+        settingEndTime = settings.settingEndTime;
+    } else {
+        settingStartTime = settings.settingSunsetTime;
+        settingEndTime = settings.settingSunriseTime;
+    }
+    return true;
 }
 
 bool DarkModeManager::IsColorModeNormal(const int32_t userId)
@@ -348,23 +517,53 @@ bool DarkModeManager::IsColorModeNormal(const AccountContext& context)
     return temporaryColorModeMgr_.IsColorModeNormal(context);
 }
 
-void DarkModeManager::Dump()
+void DarkModeManager::RequestRestartTimer()
+{
+    restartTimerTask_.Post();
+}
+
+void DarkModeManager::Dump(DumpBuffer& out)
 {
+    uint64_t recalcPerformed = sunriseSunsetRecalcPerformed_.load(std::memory_order_relaxed);
+    uint64_t recalcSkipped = sunriseSunsetRecalcSkipped_.load(std::memory_order_relaxed);
+    LocalTimeCache& localTimeCache = LocalTimeCache::GetInstance();
+    out.Append("restart timer: posted %" PRIu64 ", run %" PRIu64 "\n", restartTimerTask_.GetPostCount(),
+        restartTimerTask_.GetRunCount());
+    out.Append("caches: sunrise/sunset recalculation performed %" PRIu64 ", skipped %" PRIu64 "; local time hit %"
+        PRIu64 ", miss %" PRIu64 ", refresh %" PRIu64 "\n", recalcPerformed, recalcSkipped,
+        localTimeCache.GetHitCount(), localTimeCache.GetMissCount(), localTimeCache.GetRefreshCount());
+    // The fetch latency is in the metrics section.
+    out.Append("location fetch: requested %" PRIu64 ", coalesced %" PRIu64 ", failed %" PRIu64 ", timed out %" PRIu64
+        "\n", locationFetcher_.GetRequestCount(), locationFetcher_.GetCoalescedCount(),
+        locationFetcher_.GetFailureCount(), locationFetcher_.GetTimeoutCount());
     {
         std::lock_guard observersGuard(settingDataObserversMutex_);
-        LOGD("settingData observers size: %{public}zu, context: %{public}s",
-            settingDataObservers_.size(), AccountContextHelper::ToString(settingDataObserversContext_).c_str());
+        out.Append("setting data observers: %zu, context %s, active contexts %zu, observed contexts %zu\n",
+            settingDataObservers_.size(), AccountContextHelper::ToString(settingDataObserversContext_).c_str(),
+            activeContexts_.size(), observedContexts_.size());
     }
 
-    std::lock_guard stateGuard(darkModeStatesMutex_);
-    LOGD("darkModeStates size: %{public}zu", darkModeStates_.size());
-    for (const auto& state : darkModeStates_) {
-        LOGD("context: %{public}s, mode: %{public}d, start: %{public}d, end: %{public}d",
-            AccountContextHelper::ToString(state.first).c_str(), state.second.settingMode,
-            state.second.settingStartTime, state.second.settingEndTime);
+    // States are never erased, so their addresses stay valid after the map lock is released; each state is then
+    // read under its own lock only, and an IPC thread never waits behind the whole dump.
+    std::vector<std::pair<AccountContext, DarkModeState*>> states;
+    {
+        std::lock_guard stateGuard(darkModeStatesMutex_);
+        states.reserve(darkModeStates_.size());
+        for (auto& state : darkModeStates_) {
+            states.emplace_back(state.first, &state.second);
+        }
+    }
+    out.Append("dark mode states: %zu contexts\n", states.size());
+    for (const auto& [context, state] : states) {
+        uint64_t version = 0;
+        const DarkModeSettings settings = GetSettingsSnapshot(*state, &version);
+        out.Append("  context %s: mode %d, start %d, end %d, sunset %d, sunrise %d, version %" PRIu64 "\n",
+            AccountContextHelper::ToString(context).c_str(), settings.settingMode, settings.settingStartTime,
+            settings.settingEndTime, settings.settingSunsetTime, settings.settingSunriseTime, version);
     }
 
-    alarmTimerManager_.Dump();
+    temporaryColorModeMgr_.Dump(out);
+    alarmTimerManager_.Dump(out);
 }
 
 void DarkModeManager::LoadSettingDataObserversCallback()
@@ -393,18 +592,30 @@ void DarkModeManager::LoadSettingDataObserversCallback()
     });
 }
 
-ErrCode DarkModeManager::RegisterSettingDataObserversLocked(const AccountContext& context) const
+ErrCode DarkModeManager::RegisterSettingDataObservers(const AccountContext& context)
 {
+    decltype(settingDataObservers_) observers;
+    {
+        std::lock_guard lock(settingDataObserversMutex_);
+        observers = settingDataObservers_;
+    }
     SettingDataManager& manager = SettingDataManager::GetInstance();
     size_t count = 0;
-    for (const auto& observer : settingDataObservers_) {
+    int32_t index = 0;
+    for (const auto& observer : observers) {
         const std::string key = AccountContextHelper::BuildSettingKey(observer.first, context);
-        auto updateFunc = [observer, context](const std::string& updateKey, int32_t userId) {
+        auto updateFunc = [observer, context, index](const std::string& updateKey, int32_t userId) {
+            UI_APPEARANCE_TRACE_ASYNC_SCOPE("DarkModeSwitch.Setting", context.userId, context.subProfileId);
+            UI_APPEARANCE_TRACE_CONTEXT_SCOPE("DarkMode.SettingObserver", context);
+            // The value is the observer index: mode, start time, end time, sunset, sunrise.
+            EventTrace::GetInstance().Record(TraceEventType::SETTING_CHANGED, context.userId, context.subProfileId,
+                index);
             observer.second(updateKey, context);
         };
         if (manager.RegisterObserver(key, updateFunc, context.userId) != ERR_OK) {
             count++;
         }
+        index++;
     }
     if (count != 0) {
         LOGE("setting data observers are not all initialized");
@@ -414,10 +625,15 @@ ErrCode DarkModeManager::RegisterSettingDataObserversLocked(const AccountContext
     return ERR_OK;
 }
 
-void DarkModeManager::UnregisterSettingDataObserversLocked(const AccountContext& context) const
+void DarkModeManager::UnregisterSettingDataObservers(const AccountContext& context)
 {
+    decltype(settingDataObservers_) observers;
+    {
+        std::lock_guard lock(settingDataObserversMutex_);
+        observers = settingDataObservers_;
+    }
     SettingDataManager& manager = SettingDataManager::GetInstance();
-    for (const auto& observer : settingDataObservers_) {
+    for (const auto& observer : observers) {
         manager.UnregisterObserver(AccountContextHelper::BuildSettingKey(observer.first, context), context.userId);
     }
 }
@@ -440,14 +656,21 @@ void DarkModeManager::SettingDataDarkModeModeUpdateFunc(const std::string& key,
     }
 
     auto mode = static_cast<DarkModeMode>(value);
+    DarkModeMode oldMode = DARK_MODE_INVALID;
     {
-        std::lock_guard lock(darkModeStatesMutex_);
-        LOGI("dark mode change, key: %{public}s, context: %{public}s, from %{public}d to %{public}d",
-            key.c_str(), AccountContextHelper::ToString(context).c_str(), darkModeStates_[context].settingMode, value);
-        darkModeStates_[context].settingMode = mode;
-        bool isDarkMode = false;
-        OnStateChangeLocked(context, true, isDarkMode, true, false);
+        DarkModeState& state = GetState(context);
+        std::lock_guard lock(state.mutex);
+        oldMode = state.settingMode;
+        state.settingMode = mode;
+        MarkSettingsChanged(state);
     }
+    LOGI("dark mode change, key: %{public}s, context: %{public}s, from %{public}d to %{public}d",
+        key.c_str(), AccountContextHelper::ToString(context).c_str(), oldMode, value);
+    if (DeferApplyIfInactive(context)) {
+        return;
+    }
+    bool isDarkMode = false;
+    OnStateChange(context, true, isDarkMode, true, false);
 
     if (mode == DARK_MODE_SUNRISE_SUNSET) {
         InitSunriseSunsetMode(context);
@@ -461,13 +684,21 @@ void DarkModeManager::SettingDataDarkModeStartTimeUpdateFunc(const std::string&
     SettingDataManager& manager = SettingDataManager::GetInstance();
     int32_t value = -1;
     manager.GetInt32ValueStrictly(key, value, context.userId);
-    std::lock_guard lock(darkModeStatesMutex_);
+    int32_t oldValue = -1;
+    {
+        DarkModeState& state = GetState(context);
+        std::lock_guard lock(state.mutex);
+        oldValue = state.settingStartTime;
+        state.settingStartTime = value;
+        MarkSettingsChanged(state);
+    }
     LOGI("dark mode start time change, key: %{public}s, context: %{public}s, from %{public}d to %{public}d",
-        key.c_str(), AccountContextHelper::ToString(context).c_str(), darkModeStates_[context].settingStartTime,
-        value);
-    darkModeStates_[context].settingStartTime = value;
+        key.c_str(), AccountContextHelper::ToString(context).c_str(), oldValue, value);
+    if (DeferApplyIfInactive(context)) {
+        return;
+    }
     bool isDarkMode = false;
-    OnStateChangeLocked(context, true, isDarkMode, true, false);
+    OnStateChange(context, true, isDarkMode, true, false);
 }
 
 void DarkModeManager::SettingDataDarkModeEndTimeUpdateFunc(const std::string& key, const AccountContext& context)
@@ -475,12 +706,21 @@ void DarkModeManager::SettingDataDarkModeEndTimeUpdateFunc(const std::string& ke
     SettingDataManager& manager = SettingDataManager::GetInstance();
     int32_t value = -1;
     manager.GetInt32ValueStrictly(key, value, context.userId);
-    std::lock_guard lock(darkModeStatesMutex_);
+    int32_t oldValue = -1;
+    {
+        DarkModeState& state = GetState(context);
+        std::lock_guard lock(state.mutex);
+        oldValue = state.settingEndTime;
+        state.settingEndTime = value;
+        MarkSettingsChanged(state);
+    }
     LOGI("dark mode end time change, key: %{public}s, context: %{public}s, from %{public}d to %{public}d",
-        key.c_str(), AccountContextHelper::ToString(context).c_str(), darkModeStates_[context].settingEndTime, value);
-    darkModeStates_[context].settingEndTime = value;
+        key.c_str(), AccountContextHelper::ToString(context).c_str(), oldValue, value);
+    if (DeferApplyIfInactive(context)) {
+        return;
+    }
     bool isDarkMode = false;
-    OnStateChangeLocked(context, true, isDarkMode, true, false);
+    OnStateChange(context, true, isDarkMode, true, false);
 }
 
 void DarkModeManager::SettingDataDarkModeSunsetTimeUpdateFunc(const std::string& key, const AccountContext& context)
@@ -488,18 +728,26 @@ void DarkModeManager::SettingDataDarkModeSunsetTimeUpdateFunc(const std::string&
     SettingDataManager& manager = SettingDataManager::GetInstance();
     int32_t value = SUNSET_TIME_DEFAULT;
     manager.GetInt32ValueStrictly(key, value, context.userId);
-    std::lock_guard lock(darkModeStatesMutex_);
+    int32_t oldValue = SUNSET_TIME_DEFAULT;
+    {
+        DarkModeState& state = GetState(context);
+        std::lock_guard lock(state.mutex);
+        oldValue = state.settingSunsetTime;
+        if (value >= state.settingSunriseTime) {
+            state.settingSunsetTime = SUNSET_TIME_DEFAULT;
+            state.settingSunriseTime = SUNRISE_TIME_DEFAULT;
+        } else {
+            state.settingSunsetTime = value;
+        }
+        MarkSettingsChanged(state);
+    }
     LOGI("dark mode sunset time change, key: %{public}s, context: %{public}s, from %{public}d to %{public}d",
-        key.c_str(), AccountContextHelper::ToString(context).c_str(), darkModeStates_[context].settingSunsetTime,
-        value);
-    if (value >= darkModeStates_[context].settingSunriseTime) {
-        darkModeStates_[context].settingSunsetTime = SUNSET_TIME_DEFAULT;
-        darkModeStates_[context].settingSunriseTime = SUNRISE_TIME_DEFAULT;
-    } else {
-        darkModeStates_[context].settingSunsetTime = value;
+        key.c_str(), AccountContextHelper::ToString(context).c_str(), oldValue, value);
+    if (DeferApplyIfInactive(context)) {
+        return;
     }
     bool isDarkMode = false;
-    OnStateChangeLocked(context, true, isDarkMode, false, false);
+    OnStateChange(context, true, isDarkMode, false, false);
 }
 
 void DarkModeManager::SettingDataDarkModeSunriseTimeUpdateFunc(const std::string& key, const AccountContext& context)
@@ -507,34 +755,146 @@ void DarkModeManager::SettingDataDarkModeSunriseTimeUpdateFunc(const std::string
     SettingDataManager& manager = SettingDataManager::GetInstance();
     int32_t value = SUNRISE_TIME_DEFAULT;
     manager.GetInt32ValueStrictly(key, value, context.userId);
-    std::lock_guard lock(darkModeStatesMutex_);
+    int32_t oldValue = SUNRISE_TIME_DEFAULT;
+    {
+        DarkModeState& state = GetState(context);
+        std::lock_guard lock(state.mutex);
+        oldValue = state.settingSunriseTime;
+        if (value <= state.settingSunsetTime) {
+            state.settingSunsetTime = SUNSET_TIME_DEFAULT;
+            state.settingSunriseTime = SUNRISE_TIME_DEFAULT;
+        } else {
+            state.settingSunriseTime = value;
+        }
+        MarkSettingsChanged(state);
+    }
     LOGI("dark mode sunrise time change, key: %{public}s, context: %{public}s, from %{public}d to %{public}d",
-        key.c_str(), AccountContextHelper::ToString(context).c_str(), darkModeStates_[context].settingSunriseTime,
-        value);
-    if (value <= darkModeStates_[context].settingSunsetTime) {
-        darkModeStates_[context].settingSunsetTime = SUNSET_TIME_DEFAULT;
-        darkModeStates_[context].settingSunriseTime = SUNRISE_TIME_DEFAULT;
-    } else {
-        darkModeStates_[context].settingSunriseTime = value;
+        key.c_str(), AccountContextHelper::ToString(context).c_str(), oldValue, value);
+    if (DeferApplyIfInactive(context)) {
+        return;
     }
     bool isDarkMode = false;
-    OnStateChangeLocked(context, true, isDarkMode, false, false);
+    OnStateChange(context, true, isDarkMode, false, false);
+}
+
+DarkModeManager::DarkModeState& DarkModeManager::GetState(const AccountContext& context)
+{
+    std::lock_guard lock(darkModeStatesMutex_);
+    return darkModeStates_[context];
+}
+
+DarkModeManager::DarkModeState* DarkModeManager::FindState(const AccountContext& context)
+{
+    std::lock_guard lock(darkModeStatesMutex_);
+    auto it = darkModeStates_.find(context);
+    return it == darkModeStates_.end() ? nullptr : &it->second;
+}
+
+DarkModeManager::DarkModeSettings DarkModeManager::GetSettingsSnapshot(DarkModeState& state, uint64_t* version)
+{
+    std::lock_guard lock(state.mutex);
+    if (version != nullptr) {
+        *version = state.version;
+    }
+    return state;
+}
+
+std::shared_ptr<const DarkSchedule> DarkModeManager::GetSchedule(DarkModeState& state, const int32_t startTime,
+    const int32_t endTime)
+{
+    {
+        std::lock_guard lock(state.mutex);
+        if (state.schedule != nullptr && state.schedule->GetStartTime() == startTime &&
+            state.schedule->GetEndTime() == endTime) {
+            return state.schedule;
+        }
+    }
+    auto schedule = std::make_shared<const DarkSchedule>(startTime, endTime);
+    std::lock_guard lock(state.mutex);
+    state.schedule = schedule;
+    return schedule;
+}
+
+void DarkModeManager::MarkSettingsChanged(DarkModeState& state)
+{
+    state.version++;
+    StateSnapshot::GetInstance().RequestWrite();
+}
+
+void DarkModeManager::RegisterSnapshotCollector()
+{
+    StateSnapshot::GetInstance().RegisterCollector("DarkModeManager",
+        [this](StateSnapshot::Records& records) { CollectSnapshot(records); });
+}
+
+void DarkModeManager::CollectSnapshot(StateSnapshot::Records& records)
+{
+    {
+        std::lock_guard guard(darkModeStatesMutex_);
+        for (auto& item : darkModeStates_) {
+            const DarkModeSettings settings = GetSettingsSnapshot(item.second);
+            if (settings.settingMode == DARK_MODE_INVALID) {
+                continue;
+            }
+            StateSnapshot::Record& record = StateSnapshot::GetRecord(records, item.first);
+            record.flags |= StateSnapshot::HAS_DARK_MODE_SETTINGS;
+            record.settingMode = settings.settingMode;
+            record.settingStartTime = settings.settingStartTime;
+            record.settingEndTime = settings.settingEndTime;
+            record.settingSunsetTime = settings.settingSunsetTime;
+            record.settingSunriseTime = settings.settingSunriseTime;
+        }
+    }
+    temporaryColorModeMgr_.CollectSnapshot(records);
+}
+
+void DarkModeManager::RestoreSnapshot(const StateSnapshot::Records& records)
+{
+    for (const auto& item : records) {
+        const StateSnapshot::Record& record = item.second;
+        if ((record.flags & StateSnapshot::HAS_DARK_MODE_SETTINGS) == 0 ||
+            record.settingMode <= DARK_MODE_INVALID || record.settingMode >= DARK_MODE_SIZE) {
+            continue;
+        }
+        DarkModeState& state = GetState(item.first);
+        std::lock_guard lock(state.mutex);
+        if (state.version != 0) {
+            continue;
+        }
+        state.settingMode = static_cast<DarkModeMode>(record.settingMode);
+        state.settingStartTime = record.settingStartTime;
+        state.settingEndTime = record.settingEndTime;
+        state.settingSunsetTime = record.settingSunsetTime;
+        state.settingSunriseTime = record.settingSunriseTime;
+    }
+    temporaryColorModeMgr_.RestoreSnapshot(records);
+    RegisterSnapshotCollector();
 }
 
-ErrCode DarkModeManager::OnStateChangeLocked(const AccountContext& context, const bool needUpdateCallback,
+ErrCode DarkModeManager::OnStateChange(const AccountContext& context, const bool needUpdateCallback,
     bool& isDarkMode, const bool resetTempColorModeFlag, const bool bootLoadFlag)
+{
+    DarkModeState& state = GetState(context);
+    // The snapshot is taken after the previous apply finished, so the last apply of a context always sees the latest
+    // settings and each call applies once.
+    std::lock_guard applyLock(state.applyMutex);
+    const DarkModeSettings settings = GetSettingsSnapshot(state);
+    return ApplyStateChange(context, settings, needUpdateCallback, isDarkMode, resetTempColorModeFlag, bootLoadFlag);
+}
+
+ErrCode DarkModeManager::ApplyStateChange(const AccountContext& context, const DarkModeSettings& settings,
+    const bool needUpdateCallback, bool& isDarkMode, const bool resetTempColorModeFlag, const bool bootLoadFlag)
 {
     ErrCode code = ERR_OK;
-    DarkModeState& state = darkModeStates_[context];
-    switch (state.settingMode) {
+    switch (settings.settingMode) {
         case DARK_MODE_ALWAYS_LIGHT:
         case DARK_MODE_ALWAYS_DARK:
             code = OnStateChangeToAllDayMode(
-                context, state.settingMode, needUpdateCallback, isDarkMode, resetTempColorModeFlag, bootLoadFlag);
+                context, settings.settingMode, needUpdateCallback, isDarkMode, resetTempColorModeFlag, bootLoadFlag);
             break;
         case DARK_MODE_CUSTOM_AUTO:
         case DARK_MODE_SUNRISE_SUNSET:
-            code = OnStateChangeToCustomAutoMode(context, state, needUpdateCallback, isDarkMode,
+            code = OnStateChangeToCustomAutoMode(context, settings, needUpdateCallback, isDarkMode,
                 resetTempColorModeFlag, bootLoadFlag);
             break;
         default:
@@ -557,7 +917,7 @@ ErrCode DarkModeManager::OnStateChangeToAllDayMode(const AccountContext& context
     return ERR_OK;
 }
 
-ErrCode DarkModeManager::OnStateChangeToCustomAutoMode(const AccountContext& context, const DarkModeState& state,
+ErrCode DarkModeManager::OnStateChangeToCustomAutoMode(const AccountContext& context, const DarkModeSettings& state,
     const bool needUpdateCallback, bool& isDarkMode, const bool resetTempColorModeFlag, const bool bootLoadFlag)
 {
     int32_t startTime = -1;
@@ -592,6 +952,8 @@ ErrCode DarkModeManager::OnStateChangeToCustomAutoMode(const AccountContext& con
 
 void DarkModeManager::OnChangeDarkMode(const DarkModeMode mode, const AccountContext& context)
 {
+    UI_APPEARANCE_TRACE_CONTEXT_SCOPE("DarkMode.OnChangeDarkMode", context);
+    EventTrace::GetInstance().Record(TraceEventType::DARK_MODE_CHANGED, context.userId, context.subProfileId, mode);
     if (!updateCallback_) {
         LOGE("no update callback, mode: %{public}d, context: %{public}s", mode,
             AccountContextHelper::ToString(context).c_str());
@@ -606,10 +968,14 @@ void DarkModeManager::OnChangeDarkMode(const DarkModeMode mode, const AccountCon
 ErrCode DarkModeManager::CreateOrUpdateTimers(int32_t startTime, int32_t endTime, const AccountContext& context)
 {
     auto callbackSetColorMode = [startTime, endTime, context]() {
+        UI_APPEARANCE_TRACE_ASYNC_SCOPE("DarkModeSwitch.Timer", context.userId, context.subProfileId);
+        UI_APPEARANCE_TRACE_CONTEXT_SCOPE("DarkMode.TimerCallback", context);
         LOGI("timer callback, startTime: %{public}d, endTime: %{public}d, context: %{public}s",
             startTime, endTime, AccountContextHelper::ToString(context).c_str());
         DarkModeMode colorMode = DarkModeMode::DARK_MODE_ALWAYS_LIGHT;
         ErrCode code = GetInstance().CheckTimerCallbackParams(startTime, endTime, context, colorMode);
+        EventTrace::GetInstance().Record(TraceEventType::SCHEDULE_TIMER_FIRED, context.userId, context.subProfileId,
+            code);
         if (code != ERR_OK) {
             LOGE("timer callback, params check failed: %{public}d", code);
             return;
@@ -628,8 +994,8 @@ ErrCode DarkModeManager::CreateOrUpdateTimers(int32_t startTime, int32_t endTime
 ErrCode DarkModeManager::CheckTimerCallbackParams(
     const int32_t startTime, const int32_t endTime, const AccountContext& context, DarkModeMode &darkMode)
 {
-    std::lock_guard lock(darkModeStatesMutex_);
-    DarkModeState& state = darkModeStates_[context];
+    UI_APPEARANCE_TRACE_CONTEXT_SCOPE("DarkMode.CheckTimerCallbackParams", context);
+    const DarkModeSettings state = GetSettingsSnapshot(GetState(context));
     if (state.settingMode == DARK_MODE_CUSTOM_AUTO) {
         if (state.settingStartTime != startTime) {
             LOGE("timer callback, param wrong, startTime: %{public}d, setting: %{public}d",
@@ -663,7 +1029,8 @@ ErrCode DarkModeManager::CheckTimerCallbackParams(
         LOGE("GetCurrentTimeOfSeconds error: %{public}d", code);
         return code;
     }
-    bool inDarkIntervalFlag = CheckCurrentTimeInDarkInterval(startTime, endTime, currentTimeSeconds);
+    std::shared_ptr<const DarkSchedule> schedule = GetSchedule(GetState(context), startTime, endTime);
+    bool inDarkIntervalFlag = CheckCurrentTimeInDarkInterval(*schedule, currentTimeSeconds);
     darkMode = (inDarkIntervalFlag ? DarkModeMode::DARK_MODE_ALWAYS_DARK : DarkModeMode::DARK_MODE_ALWAYS_LIGHT);
     return ERR_OK;
 }
@@ -671,37 +1038,16 @@ ErrCode DarkModeManager::CheckTimerCallbackParams(
 
 ErrCode DarkModeManager::GetCurrentTimeOfSeconds(int32_t &seconds)
 {
-    std::time_t timestamp = std::time(nullptr);
-    if (timestamp == static_cast<std::time_t>(-1)) {
-        LOGE("fail to get timestamp");
-        return ERR_INVALID_OPERATION;
-    }
-    std::tm *nowTime = std::localtime(&timestamp);
-    if (nowTime == nullptr) {
-        LOGE("fail to get localtime");
-        return ERR_INVALID_OPERATION;
-    }
-    seconds = static_cast<int32_t>(
-        nowTime->tm_hour * HOUR_TO_MINUTE * MINUTE_TO_SECOND + nowTime->tm_min * MINUTE_TO_SECOND + nowTime->tm_sec);
+    std::shared_ptr<AlarmClock> clock = AlarmClock::GetInstance();
+    std::time_t timestamp = static_cast<std::time_t>(clock->GetCurrentTimestamp() / SECOND_TO_MILLI);
+    seconds = LocalTimeCache::GetInstance().GetSecondOfDay(*clock, timestamp);
     return ERR_OK;
 }
 
-bool DarkModeManager::CheckCurrentTimeInDarkInterval(
-    const int32_t startTime, const int32_t endTime, const int32_t currentTimeSeconds)
+bool DarkModeManager::CheckCurrentTimeInDarkInterval(const DarkSchedule& schedule, const int32_t currentTimeSeconds)
 {
-    //Due to 1-second offset in the timer trigger, so subtract OFFSET_SECONDS
-    if (endTime <= DAY_TO_MINUTE) {
-        if ((startTime * MINUTE_TO_SECOND - OFFSET_SECONDS < currentTimeSeconds) &&
-            (currentTimeSeconds < endTime * MINUTE_TO_SECOND - OFFSET_SECONDS)) {
-            return true;
-        }
-    } else {
-        if ((currentTimeSeconds < (endTime - DAY_TO_MINUTE) * MINUTE_TO_SECOND - OFFSET_SECONDS) ||
-            (currentTimeSeconds > startTime * MINUTE_TO_SECOND - OFFSET_SECONDS)) {
-            return true;
-        }
-    }
-    return false;
+    //Due to 1-second offset in the timer trigger, so add OFFSET_SECONDS
+    return schedule.IsDarkAtSecond(currentTimeSeconds + OFFSET_SECONDS);
 }
 
 std::unique_ptr<OHOS::Location::Location> DarkModeManager::GetCachedLocation(const AccountContext& context)
@@ -730,7 +1076,7 @@ std::unique_ptr<OHOS::Location::Location> DarkModeManager::GetCachedLocation(con
 
     MessageParcel data;
     MessageParcel reply;
-    MessageOption option(MessageOption::TF_SYNC);
+    MessageOption option(MessageOption::TF_SYNC, LOCATION_FETCH_WAIT_TIME_SECONDS);
     if (!data.WriteInterfaceToken(LOCATOR_INTERFACE_TOKEN)) {
         LOGW("WriteInterfaceToken failed, context: %{public}s",
             AccountContextHelper::ToString(context).c_str());
@@ -760,13 +1106,25 @@ std::unique_ptr<OHOS::Location::Location> DarkModeManager::GetCachedLocation(con
 
 void DarkModeManager::ApplySunriseSunsetTimes(double lat, double lon, const AccountContext& context)
 {
-    int64_t nowMs = std::chrono::duration_cast<std::chrono::milliseconds>(
-        std::chrono::system_clock::now().time_since_epoch()).count();
-    SunriseSunsetInfo info(lat, lon, nowMs);
+    int64_t nowMs = static_cast<int64_t>(AlarmClock::GetInstance()->GetCurrentTimestamp());
+    const SunriseSunsetFix fix = MakeSunriseSunsetFix(lat, lon, nowMs);
+    if (IsSunriseSunsetFixCurrent(context, fix)) {
+        uint64_t skipped = sunriseSunsetRecalcSkipped_.fetch_add(1, std::memory_order_relaxed) + 1;
+        LOGD("location and date unchanged, skip sunrise/sunset recalculation, skipped: %{public}" PRIu64
+            ", context: %{public}s", skipped, AccountContextHelper::ToString(context).c_str());
+        return;
+    }
+    sunriseSunsetRecalcPerformed_.fetch_add(1, std::memory_order_relaxed);
+    SunriseSunsetInfo info(LookupSunriseSunset(lat, lon, nowMs), nowMs);
 
     if (info.IsPolarDay() || info.IsPolarNight()) {
         LOGW("polar condition detected (day=%{public}d, night=%{public}d), keeping defaults, context: %{public}s",
             info.IsPolarDay(), info.IsPolarNight(), AccountContextHelper::ToString(context).c_str());
+        DarkModeState* state = FindState(context);
+        if (state != nullptr) {
+            const DarkModeSettings settings = GetSettingsSnapshot(*state);
+            SaveSunriseSunsetFix(context, fix, settings.settingSunsetTime, settings.settingSunriseTime);
+        }
         return;
     }
 
@@ -786,41 +1144,115 @@ void DarkModeManager::ApplySunriseSunsetTimes(double lat, double lon, const Acco
     const std::string sunsetKey = AccountContextHelper::BuildSettingKey(SETTING_DARK_MODE_SUN_SET, context);
     const std::string sunriseKey = AccountContextHelper::BuildSettingKey(SETTING_DARK_MODE_SUN_RISE, context);
 
-    {
-        std::lock_guard lock(darkModeStatesMutex_);
-        auto it = darkModeStates_.find(context);
-        if (it == darkModeStates_.end() || it->second.settingMode != DARK_MODE_SUNRISE_SUNSET) {
-            LOGD("skip sunrise/sunset update because mode changed, context: %{public}s",
-                AccountContextHelper::ToString(context).c_str());
-            return;
-        }
-        if (it->second.settingSunsetTime == newSunset && it->second.settingSunriseTime == newSunrise) {
-            LOGD("sunrise/sunset values unchanged, context: %{public}s",
-                AccountContextHelper::ToString(context).c_str());
-            return;
-        }
+    DarkModeState* state = FindState(context);
+    if (state == nullptr) {
+        LOGD("skip sunrise/sunset update because mode changed, context: %{public}s",
+            AccountContextHelper::ToString(context).c_str());
+        return;
+    }
+    const DarkModeSettings settings = GetSettingsSnapshot(*state);
+    if (settings.settingMode != DARK_MODE_SUNRISE_SUNSET) {
+        LOGD("skip sunrise/sunset update because mode changed, context: %{public}s",
+            AccountContextHelper::ToString(context).c_str());
+        return;
+    }
+    if (settings.settingSunsetTime == newSunset && settings.settingSunriseTime == newSunrise) {
+        LOGD("sunrise/sunset values unchanged, context: %{public}s",
+            AccountContextHelper::ToString(context).c_str());
+        SaveSunriseSunsetFix(context, fix, newSunset, newSunrise);
+        return;
     }
     ErrCode code = manager.SetInt32ValuePair(sunsetKey, newSunset, sunriseKey, newSunrise, context.userId);
     if (code != ERR_OK) {
         LOGW("failed to update sunrise/sunset settings, code: %{public}d", code);
+        return;
     }
+    SaveSunriseSunsetFix(context, fix, newSunset, newSunrise);
 }
 
-void DarkModeManager::CalculateAndApplySunriseSunsetTimes(const AccountContext& context)
+DarkModeManager::SunriseSunsetFix DarkModeManager::MakeSunriseSunsetFix(double lat, double lon, int64_t timestampMs)
+{
+    SunriseSunsetFix fix;
+    fix.latitude = lat;
+    fix.longitude = lon;
+    const std::time_t nowSeconds = static_cast<std::time_t>(timestampMs / SECOND_TO_MILLI);
+    std::tm localTime = {};
+    if (AlarmClock::GetInstance()->GetLocalTime(nowSeconds, localTime)) {
+        fix.utcOffset = localTime.tm_gmtoff;
+    }
+    const int64_t localSeconds = static_cast<int64_t>(nowSeconds) + fix.utcOffset;
+    fix.localDay = localSeconds / SECONDS_PER_DAY - ((localSeconds % SECONDS_PER_DAY < 0) ? 1 : 0);
+    fix.valid = true;
+    return fix;
+}
+
+bool DarkModeManager::IsSunriseSunsetFixCurrent(const AccountContext& context, const SunriseSunsetFix& fix)
+{
+    const double maxDistance = GetSunriseSunsetRecalcDistance();
+    DarkModeState* state = FindState(context);
+    if (state == nullptr) {
+        return false;
+    }
+    std::lock_guard lock(state->mutex);
+    const SunriseSunsetFix& last = state->sunriseSunsetFix;
+    // The settings are compared too, so that a value changed by someone else is recalculated.
+    if (!last.valid || last.localDay != fix.localDay || last.utcOffset != fix.utcOffset ||
+        last.sunsetTime != state->settingSunsetTime || last.sunriseTime != state->settingSunriseTime) {
+        return false;
+    }
+    return GetDistanceMeters(last.latitude, last.longitude, fix.latitude, fix.longitude) < maxDistance;
+}
+
+void DarkModeManager::SaveSunriseSunsetFix(const AccountContext& context, SunriseSunsetFix fix, int32_t sunsetTime,
+    int32_t sunriseTime)
+{
+    DarkModeState* state = FindState(context);
+    if (state == nullptr) {
+        return;
+    }
+    fix.sunsetTime = sunsetTime;
+    fix.sunriseTime = sunriseTime;
+    std::lock_guard lock(state->mutex);
+    state->sunriseSunsetFix = fix;
+}
+
+SunriseSunsetResult DarkModeManager::LookupSunriseSunset(double lat, double lon, int64_t timestampMs)
+{
+    std::lock_guard lock(sunriseSunsetTableMutex_);
+    if (sunriseSunsetTable_.NeedsRebuild(lat, lon, timestampMs)) {
+        if (!sunriseSunsetTable_.Build(lat, lon, timestampMs)) {
+            LOGW("failed to build sunrise/sunset table, fall back to direct calculation");
+            return SunriseSunsetUtils::CalculateSunriseSunset(lat, lon, timestampMs);
+        }
+        LOGI("sunrise/sunset table rebuilt, count: %{public}u", sunriseSunsetTable_.GetBuildCount());
+    }
+    SunriseSunsetResult result;
+    if (!sunriseSunsetTable_.Lookup(timestampMs, result)) {
+        return SunriseSunsetUtils::CalculateSunriseSunset(lat, lon, timestampMs);
+    }
+    return result;
+}
+
+bool DarkModeManager::FetchLocation(const AccountContext& context, LocationFetcher::Coordinate& coordinate)
 {
     std::unique_ptr<OHOS::Location::Location> loc = GetCachedLocation(context);
     if (loc == nullptr) {
-        return;
+        return false;
     }
-    ApplySunriseSunsetTimes(loc->GetLatitude(), loc->GetLongitude(), context);
+    coordinate.latitude = loc->GetLatitude();
+    coordinate.longitude = loc->GetLongitude();
+    return true;
+}
+
+void DarkModeManager::CalculateAndApplySunriseSunsetTimes(const AccountContext& context)
+{
+    locationFetcher_.Request(context);
 }
 
 void DarkModeManager::InitSunriseSunsetMode(const AccountContext& context)
 {
     CalculateAndApplySunriseSunsetTimes(context);
-    std::lock_guard lock(darkModeStatesMutex_);
-    auto it = darkModeStates_.find(context);
-    if (it == darkModeStates_.end() || it->second.settingMode != DARK_MODE_SUNRISE_SUNSET) {
+    if (!IsDarkModeSunsetSunrise(context)) {
         LOGD("skip recalculation timer because mode changed, context: %{public}s",
             AccountContextHelper::ToString(context).c_str());
         return;
@@ -828,7 +1260,10 @@ void DarkModeManager::InitSunriseSunsetMode(const AccountContext& context)
     alarmTimerManager_.SetRecalculationTimer(AccountContextHelper::BuildTimerKey(context),
         [context]() {
             DarkModeManager& manager = GetInstance();
-            if (!manager.IsDarkModeSunsetSunrise(context)) {
+            bool isSunriseSunset = manager.IsDarkModeSunsetSunrise(context);
+            EventTrace::GetInstance().Record(TraceEventType::RECALCULATION_TIMER_FIRED, context.userId,
+                context.subProfileId, isSunriseSunset);
+            if (!isSunriseSunset) {
                 LOGD("skip stale recalculation callback, context: %{public}s",
                     AccountContextHelper::ToString(context).c_str());
                 return;
@@ -18,7 +18,9 @@
 #include <ctime>
 #include <sys/time.h>
 #include <cinttypes>
+#include "alarm_clock.h"
 #include "dark_mode_manager.h"
+#include "local_time_cache.h"
 #include "parameter_wrap.h"
 #include "ui_appearance_log.h"
 
@@ -31,6 +33,12 @@ static const std::string TEMPORARY_STATE_END_TIME_PARAM_STRING = "persist.uiAppe
 static const std::string TEMPORARY_COLOR_MODE_TEMPORARY_STRING = "1";
 static const std::string TEMPORARY_COLOR_MODE_NORMAL_STRING = "0";
 constexpr int32_t MINUTE_TO_SECOND = 60;
+constexpr uint64_t SECOND_TO_MILLI = 1000;
+
+std::time_t GetCurrentTime()
+{
+    return static_cast<std::time_t>(AlarmClock::GetInstance()->GetCurrentTimestamp() / SECOND_TO_MILLI);
+}
 } // namespace
 
 void TemporaryColorModeManager::InitData(const int32_t userId)
@@ -142,11 +150,7 @@ bool TemporaryColorModeManager::CheckTemporaryStateEffective(const int32_t userI
 bool TemporaryColorModeManager::CheckTemporaryStateEffective(const AccountContext& context)
 {
     auto checkTempStateNoTimeout = [](const int64_t startTime, const int64_t endTime) {
-        std::time_t timestampNow = std::time(nullptr);
-        if (timestampNow == static_cast<std::time_t>(-1)) {
-            LOGE("fail to get timestamp");
-            return false;
-        }
+        std::time_t timestampNow = GetCurrentTime();
         if (startTime < timestampNow && timestampNow < endTime) {
             return true;
         }
@@ -164,6 +168,49 @@ bool TemporaryColorModeManager::CheckTemporaryStateEffective(const AccountContex
     return false;
 }
 
+void TemporaryColorModeManager::CollectSnapshot(StateSnapshot::Records& records)
+{
+    std::lock_guard guard(multiUserTempColorModeMapMutex_);
+    for (const auto& item : multiUserTempColorModeMap_) {
+        StateSnapshot::Record& record = StateSnapshot::GetRecord(records, item.first);
+        record.flags |= StateSnapshot::HAS_TEMP_COLOR_MODE;
+        record.tempColorMode = static_cast<int32_t>(item.second.tempColorMode);
+        record.tempStateStartTime = item.second.keepTemporaryStateStartTime;
+        record.tempStateEndTime = item.second.keepTemporaryStateEndTime;
+    }
+}
+
+void TemporaryColorModeManager::Dump(DumpBuffer& out)
+{
+    std::lock_guard guard(multiUserTempColorModeMapMutex_);
+    out.Append("temporary color mode: %zu contexts\n", multiUserTempColorModeMap_.size());
+    for (const auto& item : multiUserTempColorModeMap_) {
+        out.Append("  context %s: temporary %d, start %" PRId64 ", end %" PRId64 "\n",
+            AccountContextHelper::ToString(item.first).c_str(),
+            item.second.tempColorMode == TempColorModeType::ColorModeTemp, item.second.keepTemporaryStateStartTime,
+            item.second.keepTemporaryStateEndTime);
+    }
+}
+
+void TemporaryColorModeManager::RestoreSnapshot(const StateSnapshot::Records& records)
+{
+    std::lock_guard guard(multiUserTempColorModeMapMutex_);
+    for (const auto& item : records) {
+        const StateSnapshot::Record& record = item.second;
+        if ((record.flags & StateSnapshot::HAS_TEMP_COLOR_MODE) == 0 ||
+            multiUserTempColorModeMap_.find(item.first) != multiUserTempColorModeMap_.end()) {
+            continue;
+        }
+        TempColorModeInfo info;
+        info.tempColorMode = record.tempColorMode == static_cast<int32_t>(TempColorModeType::ColorModeTemp)
+                                 ? TempColorModeType::ColorModeTemp
+                                 : TempColorModeType::ColorModeNormal;
+        info.keepTemporaryStateStartTime = record.tempStateStartTime;
+        info.keepTemporaryStateEndTime = record.tempStateEndTime;
+        multiUserTempColorModeMap_[item.first] = info;
+    }
+}
+
 std::string TemporaryColorModeManager::TemporaryColorModeAssignUser(const AccountContext& context)
 {
     return AccountContextHelper::BuildUserParamKey(TEMPORARY_COLOR_MODE_PARAM_STRING, context);
@@ -183,23 +230,14 @@ void TemporaryColorModeManager::GetTempColorModeTimeInfo(const int32_t settingSt
     const int32_t settingEndTime, int64_t& tempStateStartTime, int64_t& tempStateEndTime)
 {
     auto calcEndTimestamp = [](const int32_t secondOffset, int64_t& endTimeStamp) {
-        std::time_t timestamp = std::time(nullptr);
-        if (timestamp == static_cast<std::time_t>(-1)) {
-            LOGE("fail to get timestamp");
-            return false;
-        }
-        std::tm* nowTime = std::localtime(&timestamp);
-        if (nowTime != nullptr) {
-            nowTime->tm_hour = 0;
-            nowTime->tm_min = 0;
-            nowTime->tm_sec = 0;
-        }
-        std::time_t midnightTime = std::mktime(nowTime);
+        std::shared_ptr<AlarmClock> clock = AlarmClock::GetInstance();
+        std::time_t timestamp = static_cast<std::time_t>(clock->GetCurrentTimestamp() / SECOND_TO_MILLI);
+        std::time_t midnightTime = LocalTimeCache::GetInstance().GetLocalTimestamp(*clock, timestamp, 0, 0);
         endTimeStamp = midnightTime + secondOffset - 1;
         return true;
     };
 
-    tempStateStartTime = static_cast<int64_t>(std::time(nullptr));
+    tempStateStartTime = static_cast<int64_t>(GetCurrentTime());
 
     if (settingEndTime > DAY_TO_MINUTE) {
         if (AlarmTimerManager::IsWithinTimeInterval(settingStartTime, settingEndTime) == false) {
@@ -264,16 +302,9 @@ void TemporaryColorModeManager::GetTempColorModeTimeInfo(const int32_t settingSt
 
 bool TemporaryColorModeManager::IsWithInPreInterval(const int32_t startTime, const int32_t endTime)
 {
-    std::time_t timestamp = std::time(nullptr);
-    if (timestamp == static_cast<std::time_t>(-1)) {
-        LOGE("fail to get timestamp");
-        return false;
-    }
-    std::tm* nowTime = std::localtime(&timestamp);
-    int32_t totalMinutes { 0 };
-    if (nowTime != nullptr) {
-        totalMinutes = static_cast<int32_t>(nowTime->tm_hour * HOUR_TO_MINUTE + nowTime->tm_min);
-    }
+    std::shared_ptr<AlarmClock> clock = AlarmClock::GetInstance();
+    std::time_t timestamp = static_cast<std::time_t>(clock->GetCurrentTimestamp() / SECOND_TO_MILLI);
+    int32_t totalMinutes = LocalTimeCache::GetInstance().GetSecondOfDay(*clock, timestamp) / MINUTE_TO_SECOND;
 
     if (totalMinutes <= startTime) {
         return true;
@@ -300,6 +331,7 @@ void TemporaryColorModeManager::SaveTempColorModeInfo(const AccountContext& cont
         LOGI("SaveTempColorModeInfo keepStartTime:%{public}" PRId64 ",keepEndTime:%{public}" PRId64,
             info.keepTemporaryStateStartTime, info.keepTemporaryStateEndTime);
     }
+    StateSnapshot::GetInstance().RequestWrite();
 }
 
 } // namespace OHOS::ArkUi::UiAppearance
@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "font_scale.h"
+
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
+
+namespace OHOS::ArkUi::UiAppearance {
+namespace {
+constexpr const char* BASE_SCALE = "1";
+constexpr int32_t FRACTION_DIGITS = 6;
+constexpr int32_t DECIMAL_BASE = 10;
+
+int32_t ToMicros(double value)
+{
+    return static_cast<int32_t>(std::llround(value * FontScale::MICROS_PER_UNIT));
+}
+} // namespace
+
+FontScale::FontScale() : text_(BASE_SCALE) {}
+
+bool FontScale::IsValid(double value)
+{
+    // Values below half a millionth would be kept as a zero scale.
+    return value > MIN_VALUE && value <= MAX_VALUE && ToMicros(value) > 0;
+}
+
+bool FontScale::FromString(const std::string& text, FontScale& scale)
+{
+    if (text.empty()) {
+        return false;
+    }
+    errno = 0;
+    char* endPtr = nullptr;
+    double value = std::strtod(text.c_str(), &endPtr);
+    if (endPtr == text.c_str() || endPtr == nullptr || *endPtr != '\0' || errno == ERANGE || !IsValid(value)) {
+        return false;
+    }
+    scale.micros_ = ToMicros(value);
+    scale.text_ = text;
+    return true;
+}
+
+bool FontScale::FromDouble(double value, FontScale& scale)
+{
+    if (!IsValid(value)) {
+        return false;
+    }
+    int32_t micros = ToMicros(value);
+    int32_t fraction = micros % MICROS_PER_UNIT;
+    std::string text = std::to_string(micros / MICROS_PER_UNIT);
+    text.push_back('.');
+    size_t fractionBegin = text.size();
+    text.append(FRACTION_DIGITS, '0');
+    for (size_t i = text.size(); i > fractionBegin && fraction > 0; --i) {
+        text[i - 1] = static_cast<char>('0' + fraction % DECIMAL_BASE);
+        fraction /= DECIMAL_BASE;
+    }
+    scale.micros_ = micros;
+    scale.text_ = std::move(text);
+    return true;
+}
+} // namespace OHOS::ArkUi::UiAppearance
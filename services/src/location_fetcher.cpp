@@ -0,0 +1,212 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "location_fetcher.h"
+
+#include <cinttypes>
+#include <vector>
+
+#include "metrics_registry.h"
+#include "ui_appearance_log.h"
+
+namespace OHOS::ArkUi::UiAppearance {
+LocationFetcher::LocationFetcher(const uint32_t deadlineMs, const FetchFunc& fetch, const ResultFunc& onResult)
+    : deadline_(deadlineMs), fetch_(fetch), onResult_(onResult)
+{}
+
+LocationFetcher::~LocationFetcher()
+{
+    {
+        std::lock_guard lock(sync_->mutex);
+        stopped_ = true;
+    }
+    sync_->cv.notify_all();
+    idleCv_.notify_all();
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+    std::lock_guard lock(sync_->mutex);
+    for (auto& item : calls_) {
+        // A call still blocked in the locator only touches its own Call and sync_, which it co-owns.
+        if (item.second->isDone) {
+            item.second->thread.join();
+        } else {
+            item.second->thread.detach();
+        }
+    }
+}
+
+void LocationFetcher::Request(const AccountContext& context)
+{
+    requestCount_.fetch_add(1, std::memory_order_relaxed);
+    std::lock_guard lock(sync_->mutex);
+    if (stopped_) {
+        return;
+    }
+    if (!queuedContexts_.insert(context).second) {
+        coalescedCount_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    queue_.push_back(context);
+    if (!worker_.joinable()) {
+        worker_ = std::thread([this]() { WorkLoop(); });
+    }
+    sync_->cv.notify_all();
+}
+
+bool LocationFetcher::WaitIdle(const std::chrono::milliseconds timeout)
+{
+    std::unique_lock lock(sync_->mutex);
+    return idleCv_.wait_for(lock, timeout,
+        [this]() { return stopped_ || (queue_.empty() && calls_.empty() && !running_); });
+}
+
+uint64_t LocationFetcher::GetRequestCount() const
+{
+    return requestCount_.load(std::memory_order_relaxed);
+}
+
+uint64_t LocationFetcher::GetCoalescedCount() const
+{
+    return coalescedCount_.load(std::memory_order_relaxed);
+}
+
+uint64_t LocationFetcher::GetFailureCount() const
+{
+    return failureCount_.load(std::memory_order_relaxed);
+}
+
+uint64_t LocationFetcher::GetTimeoutCount() const
+{
+    return timeoutCount_.load(std::memory_order_relaxed);
+}
+
+void LocationFetcher::WorkLoop()
+{
+    std::unique_lock lock(sync_->mutex);
+    while (!stopped_) {
+        FinishCalls(lock);
+        if (queue_.empty()) {
+            if (calls_.empty()) {
+                idleCv_.notify_all();
+            }
+            sync_->cv.wait(lock, [this]() { return stopped_ || !queue_.empty() || HasFinishedCall(); });
+            continue;
+        }
+        AccountContext context = queue_.front();
+        queue_.pop_front();
+        // Dequeue before fetching so that a request made during the fetch is served by a fresh one.
+        queuedContexts_.erase(context);
+        if (calls_.count(context) != 0) {
+            // The locator has not answered the previous fetch of this context yet.
+            refetchContexts_.insert(context);
+            continue;
+        }
+        std::shared_ptr<Call> call = StartCall(context);
+        if (!sync_->cv.wait_for(lock, deadline_, [this, &call]() { return stopped_ || call->isDone; })) {
+            call->isTimedOut = true;
+            timeoutCount_.fetch_add(1, std::memory_order_relaxed);
+            LOGW("location fetch still running after %{public}" PRId64 " ms, keeping the last known times, "
+                "context: %{public}s", static_cast<int64_t>(deadline_.count()),
+                AccountContextHelper::ToString(context).c_str());
+        }
+    }
+    idleCv_.notify_all();
+}
+
+std::shared_ptr<LocationFetcher::Call> LocationFetcher::StartCall(const AccountContext& context)
+{
+    auto call = std::make_shared<Call>();
+    call->context = context;
+    calls_[context] = call;
+    call->thread = std::thread([sync = sync_, call, fetch = fetch_]() {
+        Coordinate coordinate;
+        bool isFetched = false;
+        auto begin = std::chrono::steady_clock::now();
+        {
+            MetricScope metricScope(MetricId::LOCATION_FETCH);
+            isFetched = fetch && fetch(call->context, coordinate);
+            metricScope.SetFailed(!isFetched);
+        }
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - begin);
+        std::lock_guard lock(sync->mutex);
+        call->coordinate = coordinate;
+        call->elapsed = elapsed;
+        call->isFetched = isFetched;
+        call->isDone = true;
+        sync->cv.notify_all();
+    });
+    return call;
+}
+
+bool LocationFetcher::HasFinishedCall() const
+{
+    for (const auto& item : calls_) {
+        if (item.second->isDone) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void LocationFetcher::FinishCalls(std::unique_lock<std::mutex>& lock)
+{
+    std::vector<std::shared_ptr<Call>> finished;
+    for (auto it = calls_.begin(); it != calls_.end();) {
+        if (!it->second->isDone) {
+            ++it;
+            continue;
+        }
+        finished.push_back(it->second);
+        it = calls_.erase(it);
+    }
+    if (finished.empty()) {
+        return;
+    }
+    running_ = true;
+    lock.unlock();
+    for (const auto& call : finished) {
+        call->thread.join();
+        FinishCall(*call);
+    }
+    lock.lock();
+    running_ = false;
+    for (const auto& call : finished) {
+        if (refetchContexts_.erase(call->context) != 0 && queuedContexts_.insert(call->context).second) {
+            queue_.push_back(call->context);
+        }
+    }
+}
+
+void LocationFetcher::FinishCall(Call& call)
+{
+    if (!call.isFetched) {
+        failureCount_.fetch_add(1, std::memory_order_relaxed);
+        if (!call.isTimedOut && call.elapsed >= deadline_) {
+            timeoutCount_.fetch_add(1, std::memory_order_relaxed);
+            LOGW("location fetch timed out after %{public}" PRId64 " ms, context: %{public}s",
+                static_cast<int64_t>(call.elapsed.count()), AccountContextHelper::ToString(call.context).c_str());
+        }
+        return;
+    }
+    if (call.isTimedOut) {
+        LOGI("late location arrived after %{public}" PRId64 " ms, applying it, context: %{public}s",
+            static_cast<int64_t>(call.elapsed.count()), AccountContextHelper::ToString(call.context).c_str());
+    }
+    if (onResult_) {
+        onResult_(call.context, call.coordinate);
+    }
+}
+} // namespace OHOS::ArkUi::UiAppearance
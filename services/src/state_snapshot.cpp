@@ -0,0 +1,255 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "state_snapshot.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <iterator>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <type_traits>
+#include <unistd.h>
+
+#include "ui_appearance_log.h"
+
+namespace OHOS::ArkUi::UiAppearance {
+namespace {
+constexpr const char* SNAPSHOT_PATH = "/data/service/el1/public/ui_appearance/state_snapshot.bin";
+constexpr const char* TEMP_SUFFIX = ".tmp";
+constexpr mode_t SNAPSHOT_DIR_MODE = 0700;
+constexpr mode_t SNAPSHOT_FILE_MODE = 0600;
+constexpr uint64_t FNV_OFFSET_BASIS = 14695981039346656037ULL;
+constexpr uint64_t FNV_PRIME = 1099511628211ULL;
+// Far more contexts than a device can have; guards against mapping a corrupted count.
+constexpr uint32_t MAX_RECORD_COUNT = 1024;
+static_assert(std::is_trivially_copyable_v<StateSnapshot::Record>, "records are copied byte for byte");
+} // namespace
+
+StateSnapshot& StateSnapshot::GetInstance()
+{
+    static StateSnapshot instance(SNAPSHOT_PATH);
+    return instance;
+}
+
+StateSnapshot::StateSnapshot(const std::string& path) : path_(path) {}
+
+void StateSnapshot::RegisterCollector(const std::string& name, const Collector& collector)
+{
+    std::lock_guard lock(collectorsMutex_);
+    for (auto& item : collectors_) {
+        if (item.first == name) {
+            item.second = collector;
+            return;
+        }
+    }
+    collectors_.emplace_back(name, collector);
+}
+
+void StateSnapshot::EnableWrite()
+{
+    writeEnabled_.store(true, std::memory_order_release);
+}
+
+void StateSnapshot::RequestWrite()
+{
+    if (!writeEnabled_.load(std::memory_order_acquire)) {
+        return;
+    }
+    writeTask_.Post();
+}
+
+bool StateSnapshot::WriteNow()
+{
+    std::list<std::pair<std::string, Collector>> collectors;
+    {
+        std::lock_guard lock(collectorsMutex_);
+        collectors = collectors_;
+    }
+    Records records;
+    for (const auto& item : collectors) {
+        if (item.second) {
+            item.second(records);
+        }
+    }
+    std::vector<uint8_t> buffer;
+    Encode(records, buffer);
+    std::lock_guard lock(writeMutex_);
+    if (!WriteFile(buffer)) {
+        return false;
+    }
+    writeCount_.fetch_add(1, std::memory_order_relaxed);
+    LOGD("state snapshot written, records: %{public}zu", records.size());
+    return true;
+}
+
+bool StateSnapshot::Load(Records& records) const
+{
+    int fd = open(path_.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        LOGI("no state snapshot, errno: %{public}d", errno);
+        return false;
+    }
+    struct stat fileStat = {};
+    if (fstat(fd, &fileStat) != 0 || fileStat.st_size < static_cast<off_t>(sizeof(Header))) {
+        LOGW("state snapshot too small");
+        close(fd);
+        return false;
+    }
+    size_t size = static_cast<size_t>(fileStat.st_size);
+    void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        LOGE("mmap state snapshot failed, errno: %{public}d", errno);
+        return false;
+    }
+    bool decoded = Decode(static_cast<const uint8_t*>(data), size, records);
+    munmap(data, size);
+    if (!decoded) {
+        LOGW("state snapshot rejected");
+        return false;
+    }
+    return true;
+}
+
+uint64_t StateSnapshot::GetWriteCount() const
+{
+    return writeCount_.load(std::memory_order_relaxed);
+}
+
+StateSnapshot::Record& StateSnapshot::GetRecord(Records& records, const AccountContext& context)
+{
+    auto it = records.find(context);
+    if (it == records.end()) {
+        it = records.emplace(context, Record()).first;
+        it->second.userId = context.userId;
+        it->second.subProfileId = context.subProfileId;
+    }
+    return it->second;
+}
+
+bool StateSnapshot::SetScale(char (&field)[SCALE_SIZE], const std::string& value)
+{
+    std::fill(std::begin(field), std::end(field), '\0');
+    if (value.size() >= SCALE_SIZE) {
+        return false;
+    }
+    std::copy(value.begin(), value.end(), field);
+    return true;
+}
+
+std::string StateSnapshot::GetScale(const char (&field)[SCALE_SIZE])
+{
+    return std::string(field, strnlen(field, SCALE_SIZE));
+}
+
+void StateSnapshot::Encode(const Records& records, std::vector<uint8_t>& buffer)
+{
+    Header header;
+    header.recordCount = static_cast<uint32_t>(records.size());
+    buffer.assign(sizeof(Header) + records.size() * sizeof(Record), 0);
+    uint8_t* cursor = buffer.data() + sizeof(Header);
+    for (const auto& item : records) {
+        std::memcpy(cursor, &item.second, sizeof(Record));
+        cursor += sizeof(Record);
+    }
+    header.checksum = CalcChecksum(buffer.data() + sizeof(Header), buffer.size() - sizeof(Header));
+    std::memcpy(buffer.data(), &header, sizeof(Header));
+}
+
+bool StateSnapshot::Decode(const uint8_t* data, const size_t size, Records& records)
+{
+    if (data == nullptr || size < sizeof(Header)) {
+        return false;
+    }
+    Header header;
+    std::memcpy(&header, data, sizeof(Header));
+    if (header.magic != MAGIC || header.version != VERSION || header.recordSize != sizeof(Record)) {
+        LOGW("state snapshot version mismatch: %{public}u", header.version);
+        return false;
+    }
+    if (header.recordCount > MAX_RECORD_COUNT || size != sizeof(Header) + header.recordCount * sizeof(Record)) {
+        return false;
+    }
+    const uint8_t* payload = data + sizeof(Header);
+    if (CalcChecksum(payload, size - sizeof(Header)) != header.checksum) {
+        return false;
+    }
+    records.clear();
+    for (uint32_t i = 0; i < header.recordCount; ++i) {
+        Record record;
+        std::memcpy(&record, payload + i * sizeof(Record), sizeof(Record));
+        record.fontScale[SCALE_SIZE - 1] = '\0';
+        record.fontWeightScale[SCALE_SIZE - 1] = '\0';
+        records[AccountContext(record.userId, record.subProfileId)] = record;
+    }
+    return true;
+}
+
+uint64_t StateSnapshot::CalcChecksum(const uint8_t* data, const size_t size)
+{
+    uint64_t hash = FNV_OFFSET_BASIS;
+    for (size_t i = 0; i < size; ++i) {
+        hash = (hash ^ data[i]) * FNV_PRIME;
+    }
+    return hash;
+}
+
+bool StateSnapshot::WriteFile(const std::vector<uint8_t>& buffer) const
+{
+    size_t separator = path_.rfind('/');
+    if (separator != std::string::npos && separator > 0 &&
+        mkdir(path_.substr(0, separator).c_str(), SNAPSHOT_DIR_MODE) != 0 && errno != EEXIST) {
+        LOGE("create snapshot dir failed, errno: %{public}d", errno);
+        return false;
+    }
+    const std::string tempPath = path_ + TEMP_SUFFIX;
+    int fd = open(tempPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, SNAPSHOT_FILE_MODE);
+    if (fd < 0) {
+        LOGE("open snapshot temp file failed, errno: %{public}d", errno);
+        return false;
+    }
+    size_t written = 0;
+    while (written < buffer.size()) {
+        ssize_t ret = write(fd, buffer.data() + written, buffer.size() - written);
+        if (ret < 0 && errno == EINTR) {
+            continue;
+        }
+        if (ret <= 0) {
+            LOGE("write snapshot failed, errno: %{public}d", errno);
+            close(fd);
+            unlink(tempPath.c_str());
+            return false;
+        }
+        written += static_cast<size_t>(ret);
+    }
+    // The data must be on disk before the rename publishes it, or a power loss could leave an empty file behind.
+    if (fsync(fd) != 0) {
+        LOGE("fsync snapshot failed, errno: %{public}d", errno);
+        close(fd);
+        unlink(tempPath.c_str());
+        return false;
+    }
+    close(fd);
+    if (rename(tempPath.c_str(), path_.c_str()) != 0) {
+        LOGE("rename snapshot failed, errno: %{public}d", errno);
+        unlink(tempPath.c_str());
+        return false;
+    }
+    return true;
+}
+} // namespace OHOS::ArkUi::UiAppearance
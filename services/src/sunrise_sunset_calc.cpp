@@ -4,82 +4,79 @@
 
 #include "sunrise_sunset_calc.h"
 
+#include <algorithm>
+#include <array>
 #include <chrono>
 #include <cmath>
 #include <iomanip>
+#include <iterator>
 #include <sstream>
 
+#include "solar_ephemeris.h"
+
 namespace OHOS::ArkUi::UiAppearance {
 namespace {
-
-// Conversion factors between degrees and radians.
-constexpr double DEG2RAD = M_PI / 180.0;
-constexpr double RAD2DEG = 180.0 / M_PI;
-
-/** Official sunrise and sunset zenith: 90°50', including refraction and the solar radius. */
-constexpr double ZENITH = 90.833;
-
-// UTC noon is 720 minutes after midnight, and Earth rotates one longitude degree every four minutes.
-constexpr double MINS_PER_HALF_DAY = 720.0;
-constexpr double MINS_PER_DEGREE_LON = 4.0;
-constexpr double HOURS_PER_DAY = 24.0;
-
-// Constants from the Gregorian calendar to Julian day conversion used by the NOAA algorithm.
-constexpr double J2000_JD = 2451545.0;
-constexpr double DAYS_PER_JULIAN_CENT = 36525.0;
-constexpr double JULIAN_DAYS_PER_YEAR = 365.25;
-constexpr double JULIAN_MONTH_COEFF = 30.6001;
-constexpr double JULIAN_YEAR_OFFSET = 4716.0;
-constexpr double JULIAN_DAY_OFFSET = 1524.5;
-
-// NOAA polynomial coefficients: mean longitude = A + B * t + C * t^2, in degrees.
-constexpr double MEAN_LONG_A = 280.46646;
-constexpr double MEAN_LONG_B = 36000.76983;
-constexpr double MEAN_LONG_C = 0.0003032;
-
-// NOAA polynomial coefficients: mean anomaly = A + B * t - C * t^2, in degrees.
-constexpr double MEAN_ANOM_A = 357.52911;
-constexpr double MEAN_ANOM_B = 35999.05029;
-constexpr double MEAN_ANOM_C = 0.0001537;
-
-// NOAA polynomial coefficients: orbital eccentricity = A - B * t - C * t^2.
-constexpr double ECC_A = 0.016708634;
-constexpr double ECC_B = 0.000042037;
-constexpr double ECC_C = 0.0000001267;
-
-// NOAA coefficients for the first three sine harmonics in the solar equation of center.
-constexpr double EQC_A0 = 1.914602;
-constexpr double EQC_A1 = 0.004817;
-constexpr double EQC_A2 = 0.000014;
-constexpr double EQC_B0 = 0.019993;
-constexpr double EQC_B1 = 0.000101;
-constexpr double EQC_C0 = 0.000289;
-
-// NOAA nutation and aberration coefficients used to correct the apparent solar longitude.
-constexpr double OMEGA_A = 125.04;
-constexpr double OMEGA_B = 1934.136;
-constexpr double ABERR_A = 0.00569;
-constexpr double ABERR_B = 0.00478;
-
-// NOAA polynomial coefficients for mean and corrected obliquity of the ecliptic.
-constexpr double OBLIQ_SEC_A = 21.448;
-constexpr double OBLIQ_SEC_B = 46.815;
-constexpr double OBLIQ_SEC_C = 0.00059;
-constexpr double OBLIQ_SEC_D = 0.001813;
-constexpr double OBLIQ_DEGREES = 23.0;
-constexpr double OBLIQ_MINUTES = 26.0;
-constexpr double OBLIQ_CORR_COEFF = 0.00256;
-
-// Multipliers from the NOAA equation-of-time expansion; the result is converted to minutes.
-constexpr double EOT_RAD2MIN = 4.0;
-constexpr double EOT_E_SINM_COEFF = 2.0;
-constexpr double EOT_EY_COEFF = 4.0;
-constexpr double EOT_Y2_COEFF = 0.5;
-constexpr double EOT_E2_COEFF = 1.25;
+using namespace SolarEphemeris;
 
 // Sentinel for dates without a sunrise or sunset, and the stable UTC-noon iteration base.
 constexpr double POLAR_MARK = -1.0;
 constexpr double UTC_NOON_HOUR = 12.0;
+constexpr int TM_YEAR_BASE = 1900;
+
+// Julian day of 1970-01-01T12:00:00Z, the UTC noon of the Unix epoch day.
+constexpr double UNIX_EPOCH_NOON_JD = 2440588.0;
+
+// Constants of the polynomial approximations used by the batch path.
+constexpr double HALF_PI = M_PI / 2.0;
+constexpr double TWO_PI = 2.0 * M_PI;
+constexpr double ROUND_HALF = 0.5;
+// Taylor coefficients of sin(x) on [-pi/2, pi/2]; the truncation error is below 6e-8.
+constexpr double SIN_C3 = -1.0 / 6.0;
+constexpr double SIN_C5 = 1.0 / 120.0;
+constexpr double SIN_C7 = -1.0 / 5040.0;
+constexpr double SIN_C9 = 1.0 / 362880.0;
+constexpr double SIN_C11 = -1.0 / 39916800.0;
+constexpr double SIN_C13 = 1.0 / 6227020800.0;
+// Abramowitz and Stegun 4.4.46: acos(x) = sqrt(1 - x) * P(x) on [0, 1] with an error below 2e-8.
+constexpr double ACOS_A0 = 1.5707963050;
+constexpr double ACOS_A1 = -0.2145988016;
+constexpr double ACOS_A2 = 0.0889789874;
+constexpr double ACOS_A3 = -0.0501743046;
+constexpr double ACOS_A4 = 0.0308918810;
+constexpr double ACOS_A5 = -0.0170881256;
+constexpr double ACOS_A6 = 0.0066700901;
+constexpr double ACOS_A7 = -0.0012624911;
+// Direction of the hour angle from solar noon.
+constexpr double SUNRISE_DIRECTION = -1.0;
+constexpr double SUNSET_DIRECTION = 1.0;
+// Points per chunk of the batch path; the Julian days of one chunk live on the stack.
+constexpr size_t BATCH_CHUNK_SIZE = 256;
+
+// Formats of the fixed-point path. Angles are binary angles where 2^32 is one turn, so that unsigned overflow wraps
+// them; fine angles carry FINE_ANGLE_FRAC_BITS more fraction bits. Ratios are Q30 and times are Q16 minutes.
+constexpr double DEGREES_PER_TURN = 360.0;
+constexpr double DEGREES_PER_QUARTER_TURN = 90.0;
+constexpr double BINARY_ANGLE_PER_TURN = 4294967296.0;
+constexpr int32_t FINE_ANGLE_FRAC_BITS = 16;
+constexpr int32_t QUARTER_TURN_BITS = 30;
+constexpr uint32_t QUARTER_TURN = 1u << QUARTER_TURN_BITS;
+constexpr int32_t Q30_BITS = 30;
+constexpr int64_t Q30_ONE = 1LL << Q30_BITS;
+constexpr int32_t Q16_BITS = 16;
+constexpr int64_t Q16_ONE = 1LL << Q16_BITS;
+constexpr int32_t UINT64_BITS = 64;
+// Quarter-wave sine table with linear interpolation; the interpolation error is below 3e-7.
+constexpr int32_t SIN_TABLE_BITS = 10;
+constexpr int32_t SIN_TABLE_SIZE = 1 << SIN_TABLE_BITS;
+constexpr int32_t SIN_TABLE_FRAC_BITS = QUARTER_TURN_BITS - SIN_TABLE_BITS;
+// Terms of the compile-time sine series; the next term is below 1e-20 on [0, pi/2].
+constexpr int32_t CONSTEXPR_SIN_TERMS = 12;
+// Abramowitz and Stegun 4.4.45: acos(x) = sqrt(1 - x) * P(x) on [0, 1] with an error below 7e-5, which is 0.02 minutes
+// of hour angle.
+constexpr double ACOS_B0 = 1.5707288;
+constexpr double ACOS_B1 = -0.2121144;
+constexpr double ACOS_B2 = 0.0742610;
+constexpr double ACOS_B3 = -0.0187293;
 
 int32_t NormalizeRoundedMinutes(double seconds)
 {
@@ -88,57 +85,8 @@ int32_t NormalizeRoundedMinutes(double seconds)
            DarkModeConstants::MINS_PER_DAY;
 }
 
-/**
- * Calculates the Julian day.
- */
-double CalcJulianDay(int year, int month, int day, double hour)
-{
-    // Treat January and February as months 13 and 14 of the previous year in the Julian day formula.
-    if (month <= 2) {
-        year -= 1;
-        month += 12;
-    }
-    // Apply the Gregorian century and leap-century correction.
-    int centuryDiv = year / 100;
-    int gregorianCorr = 2 - centuryDiv + centuryDiv / 4;
-    return floor(JULIAN_DAYS_PER_YEAR * (year + JULIAN_YEAR_OFFSET)) + floor(JULIAN_MONTH_COEFF * (month + 1)) + day +
-           hour / HOURS_PER_DAY + gregorianCorr - JULIAN_DAY_OFFSET;
-}
-
-/**
- * Converts a Julian day to Julian centuries since J2000.0.
- */
-double CalcJulianCent(double jd)
-{
-    return (jd - J2000_JD) / DAYS_PER_JULIAN_CENT;
-}
-
-/**
- * Calculates the solar geometric mean longitude in degrees.
- */
-double CalcMeanLong(double t)
-{
-    double meanLong = MEAN_LONG_A + MEAN_LONG_B * t + MEAN_LONG_C * t * t;
-    // Normalize longitude to one complete revolution in the range [0, 360).
-    return fmod(fmod(meanLong, 360.0) + 360.0, 360.0);
-}
-
-/**
- * Calculates the solar geometric mean anomaly in degrees.
- */
-double CalcMeanAnomaly(double t)
-{
-    return MEAN_ANOM_A + MEAN_ANOM_B * t - MEAN_ANOM_C * t * t;
-}
-
-/**
- * Calculates the eccentricity of Earth's orbit.
- */
-double CalcEccentricity(double t)
-{
-    return ECC_A - ECC_B * t - ECC_C * t * t;
-}
-
+#ifndef UI_APPEARANCE_FIXED_POINT_SUNRISE_SUNSET
+// The scalar double-precision path; fixed-point builds use CalcFixedSunriseSunset instead.
 /**
  * Calculates the solar equation of center.
  */
@@ -158,15 +106,6 @@ double CalcAppLong(double t, double lTrue)
     return lTrue - ABERR_A - ABERR_B * sin(omega * DEG2RAD);
 }
 
-/**
- * Calculates the mean obliquity of the ecliptic in degrees.
- */
-double CalcMeanObliq(double t)
-{
-    double sec = OBLIQ_SEC_A - t * (OBLIQ_SEC_B + t * (OBLIQ_SEC_C - t * OBLIQ_SEC_D));
-    return OBLIQ_DEGREES + (OBLIQ_MINUTES + sec / DarkModeConstants::SECS_PER_MIN) / DarkModeConstants::SECS_PER_MIN;
-}
-
 /**
  * Calculates the corrected obliquity in degrees, including nutation correction.
  */
@@ -257,25 +196,476 @@ double CalcSunTimeMin(double lat, double lon, double jd, bool isSunrise)
         return solarNoon + ha * MINS_PER_DEGREE_LON;
     }
 }
+#endif // UI_APPEARANCE_FIXED_POINT_SUNRISE_SUNSET
 
-} // anonymous namespace
+bool IsValidCoordinate(double lat, double lon)
+{
+    return std::isfinite(lat) && std::isfinite(lon) && lat >= -90.0 && lat <= 90.0 && lon >= -180.0 && lon <= 180.0;
+}
 
-namespace SunriseSunsetUtils {
+#ifndef UI_APPEARANCE_FIXED_POINT_SUNRISE_SUNSET
+/**
+ * Converts sunrise or sunset in UTC minutes to UTC seconds from 00:00, rounded to the nearest minute.
+ */
+double ToUtcSeconds(double utcMin)
+{
+    if (utcMin == POLAR_MARK) {
+        return POLAR_MARK;
+    }
+    double adjustedMin = fmod(
+        fmod(utcMin, static_cast<double>(DarkModeConstants::MINS_PER_DAY)) + DarkModeConstants::MINS_PER_DAY,
+        DarkModeConstants::MINS_PER_DAY);
+    return NormalizeRoundedMinutes(adjustedMin * DarkModeConstants::SECS_PER_MIN) * DarkModeConstants::SECS_PER_MIN;
+}
+#endif // UI_APPEARANCE_FIXED_POINT_SUNRISE_SUNSET
 
-SunriseSunsetResult CalculateSunriseSunset(double lat, double lon, int64_t timestampMs)
+/**
+ * Branch-free sin(x) for any finite x: reduces to [-pi/2, pi/2] and evaluates the Taylor polynomial.
+ */
+inline double FastSin(double x)
 {
-    if (!std::isfinite(lat) || !std::isfinite(lon) || lat < -90.0 || lat > 90.0 || lon < -180.0 || lon > 180.0) {
-        return { POLAR_MARK, POLAR_MARK };
+    x -= TWO_PI * floor(x / TWO_PI + ROUND_HALF);
+    // sin(x) = sin(pi - x) folds [pi/2, pi] and [-pi, -pi/2] back into [-pi/2, pi/2].
+    x = (x > HALF_PI) ? (M_PI - x) : x;
+    x = (x < -HALF_PI) ? (-M_PI - x) : x;
+    double x2 = x * x;
+    return x * (1.0 + x2 * (SIN_C3 + x2 * (SIN_C5 + x2 * (SIN_C7 + x2 * (SIN_C9 + x2 * (SIN_C11 + x2 * SIN_C13))))));
+}
+
+inline double FastCos(double x)
+{
+    return FastSin(x + HALF_PI);
+}
+
+/**
+ * Branch-free acos(x) for x in [-1, 1].
+ */
+inline double FastAcos(double x)
+{
+    double ax = fabs(x);
+    double poly = ACOS_A0 + ax * (ACOS_A1 + ax * (ACOS_A2 + ax * (ACOS_A3 + ax * (ACOS_A4 + ax * (ACOS_A5 +
+        ax * (ACOS_A6 + ax * ACOS_A7))))));
+    double result = sqrt(1.0 - ax) * poly;
+    return (x < 0.0) ? (M_PI - result) : result;
+}
+
+/**
+ * Branch-free counterpart of ToUtcSeconds for results that are not polar.
+ */
+inline double FastToUtcSeconds(double utcMin)
+{
+    double adjustedMin = utcMin - DarkModeConstants::MINS_PER_DAY * floor(utcMin / DarkModeConstants::MINS_PER_DAY);
+    double roundedMin = floor(adjustedMin + ROUND_HALF);
+    roundedMin = (roundedMin >= DarkModeConstants::MINS_PER_DAY) ? roundedMin - DarkModeConstants::MINS_PER_DAY :
+        roundedMin;
+    return roundedMin * DarkModeConstants::SECS_PER_MIN;
+}
+
+/**
+ * Solar position terms that the batch path needs for one Julian day.
+ */
+struct FastSolarPosition {
+    double sinDec;
+    double cosDec;
+    /** Equation of time in minutes. */
+    double eqTime;
+};
+
+/**
+ * Counterpart of the solar position part of CalcSunTimeMin built on the polynomial approximations.
+ * The mean longitude and the apparent longitude only feed periodic functions, so they are not normalized.
+ */
+inline FastSolarPosition CalcFastSolarPosition(double jd)
+{
+    double t = CalcJulianCent(jd);
+    double meanLongRad = (MEAN_LONG_A + MEAN_LONG_B * t + MEAN_LONG_C * t * t) * DEG2RAD;
+    double meanAnomalyRad = CalcMeanAnomaly(t) * DEG2RAD;
+    double e = CalcEccentricity(t);
+    double sinMeanAnomaly = FastSin(meanAnomalyRad);
+    double eqOfCenter = (EQC_A0 - EQC_A1 * t - EQC_A2 * t * t) * sinMeanAnomaly +
+        (EQC_B0 - EQC_B1 * t) * FastSin(2.0 * meanAnomalyRad) + EQC_C0 * FastSin(3.0 * meanAnomalyRad);
+    double omegaRad = (OMEGA_A - OMEGA_B * t) * DEG2RAD;
+    double appLongRad = meanLongRad + (eqOfCenter - ABERR_A - ABERR_B * FastSin(omegaRad)) * DEG2RAD;
+    double obliqCorrRad = (CalcMeanObliq(t) + OBLIQ_CORR_COEFF * FastCos(omegaRad)) * DEG2RAD;
+
+    FastSolarPosition position;
+    position.sinDec = FastSin(obliqCorrRad) * FastSin(appLongRad);
+    // The declination lies in [-90, 90], so its cosine is the non-negative root.
+    position.cosDec = sqrt(1.0 - position.sinDec * position.sinDec);
+
+    // tan^2(x / 2) = (1 - cos(x)) / (1 + cos(x)).
+    double cosObliq = FastCos(obliqCorrRad);
+    double y = (1.0 - cosObliq) / (1.0 + cosObliq);
+    position.eqTime = EOT_RAD2MIN * RAD2DEG *
+                      (y * FastSin(2.0 * meanLongRad) - EOT_E_SINM_COEFF * e * sinMeanAnomaly +
+                          EOT_EY_COEFF * e * y * sinMeanAnomaly * FastCos(2.0 * meanLongRad) -
+                          EOT_Y2_COEFF * y * y * FastSin(4.0 * meanLongRad) -
+                          EOT_E2_COEFF * e * e * FastSin(2.0 * meanAnomalyRad));
+    return position;
+}
+
+/**
+ * Counterpart of CalcHourAngle built on the polynomial approximations.
+ * @returns The hour angle in minutes of time, or POLAR_MARK for polar day or polar night.
+ */
+inline double CalcFastHourAngleMin(double lat, const FastSolarPosition& position, double cosZenith)
+{
+    double latRad = lat * DEG2RAD;
+    double cosH = (cosZenith - FastSin(latRad) * position.sinDec) / (FastCos(latRad) * position.cosDec);
+    // Written so that NaN and infinity are also reported as polar.
+    bool polar = !(cosH >= -1.0 && cosH <= 1.0);
+    double ha = FastAcos(polar ? 0.0 : cosH) * RAD2DEG * MINS_PER_DEGREE_LON;
+    return polar ? POLAR_MARK : ha;
+}
+
+/**
+ * Counterpart of the refining iteration of CalculateSunriseSunset for one point of the batch.
+ * @param result Holds POLAR_MARK if the first iteration found no sunrise or sunset; receives the UTC seconds.
+ */
+inline void RefineFastSunTime(double lat, double lon, double jd, double direction, double cosZenith, double& result)
+{
+    FastSolarPosition position = CalcFastSolarPosition(jd);
+    double ha = CalcFastHourAngleMin(lat, position, cosZenith);
+    double utcMin = MINS_PER_HALF_DAY - MINS_PER_DEGREE_LON * lon - position.eqTime + direction * ha;
+    // Comparisons with NaN are false, so this also rejects non-finite coordinates.
+    bool valid = lat >= -90.0 && lat <= 90.0 && lon >= -180.0 && lon <= 180.0;
+    result = (valid && result != POLAR_MARK && ha != POLAR_MARK) ? FastToUtcSeconds(utcMin) : POLAR_MARK;
+}
+
+
+/**
+ * Julian day of the UTC noon of the timestamp's date, matching gmtime_r in CalculateSunriseSunset:
+ * truncate to seconds, then floor to days.
+ */
+inline double CalcUtcNoonJulianDay(int64_t timestampMs)
+{
+    const int64_t seconds = timestampMs / DarkModeConstants::MS_PER_SEC;
+    int64_t days = seconds / DarkModeConstants::SECS_PER_DAY;
+    if (seconds % DarkModeConstants::SECS_PER_DAY < 0) {
+        --days;
     }
-    time_t rawTime = static_cast<time_t>(timestampMs / DarkModeConstants::MS_PER_SEC);
-    struct tm utcTm;
-    if (gmtime_r(&rawTime, &utcTm) == nullptr) {
-        return { POLAR_MARK, POLAR_MARK };
+    return static_cast<double>(days) + UNIX_EPOCH_NOON_JD;
+}
+
+/**
+ * Counterpart of the first iteration of CalculateSunriseSunset for one point of the batch. Sunrise and sunset share
+ * the solar position of the UTC noon.
+ * @param riseJd Receives the Julian day refined by the sunrise.
+ * @param setJd Receives the Julian day refined by the sunset.
+ * @param sunrise Receives POLAR_MARK for polar day or polar night.
+ * @param sunset Receives POLAR_MARK for polar day or polar night.
+ */
+inline void CalcFastFirstIteration(double lat, double lon, double jd, double cosZenith, double& riseJd,
+    double& setJd, double& sunrise, double& sunset)
+{
+    FastSolarPosition position = CalcFastSolarPosition(jd);
+    double ha = CalcFastHourAngleMin(lat, position, cosZenith);
+    bool polar = ha == POLAR_MARK;
+    double solarNoon = MINS_PER_HALF_DAY - MINS_PER_DEGREE_LON * lon - position.eqTime;
+    riseJd = jd + (polar ? 0.0 : (solarNoon - ha) / DarkModeConstants::MINS_PER_DAY);
+    setJd = jd + (polar ? 0.0 : (solarNoon + ha) / DarkModeConstants::MINS_PER_DAY);
+    sunrise = polar ? POLAR_MARK : 0.0;
+    sunset = polar ? POLAR_MARK : 0.0;
+}
+
+/**
+ * sin(x) for x in [0, pi/2] in a constant expression, used to generate SIN_TABLE at compile time.
+ */
+constexpr double ConstexprSin(double x)
+{
+    double term = x;
+    double sum = x;
+    for (int32_t n = 1; n < CONSTEXPR_SIN_TERMS; ++n) {
+        term *= -x * x / ((2.0 * n) * (2.0 * n + 1.0));
+        sum += term;
     }
+    return sum;
+}
 
-    // tm_year is relative to 1900 and tm_mon is zero-based; use UTC noon as the Julian day base.
-    double jd = CalcJulianDay(utcTm.tm_year + 1900, utcTm.tm_mon + 1, utcTm.tm_mday, UTC_NOON_HOUR);
+constexpr int64_t ToQ30(double value)
+{
+    return static_cast<int64_t>(value * Q30_ONE + (value < 0.0 ? -ROUND_HALF : ROUND_HALF));
+}
+
+constexpr int64_t ToQ16(double value)
+{
+    return static_cast<int64_t>(value * Q16_ONE + (value < 0.0 ? -ROUND_HALF : ROUND_HALF));
+}
+
+/**
+ * Converts degrees to a binary angle, where BINARY_ANGLE_PER_TURN is one full turn.
+ */
+constexpr int64_t ToBinaryAngle(double degrees)
+{
+    double angle = degrees / DEGREES_PER_TURN * BINARY_ANGLE_PER_TURN;
+    return static_cast<int64_t>(angle + (angle < 0.0 ? -ROUND_HALF : ROUND_HALF));
+}
+
+/**
+ * Converts degrees to a binary angle with FINE_ANGLE_FRAC_BITS extra fraction bits, for rates and epoch values
+ * that are multiplied by millions of minutes.
+ */
+constexpr int64_t ToFineAngle(double degrees)
+{
+    double angle = degrees / DEGREES_PER_TURN * BINARY_ANGLE_PER_TURN * (1LL << FINE_ANGLE_FRAC_BITS);
+    return static_cast<int64_t>(angle + (angle < 0.0 ? -ROUND_HALF : ROUND_HALF));
+}
+
+constexpr std::array<int32_t, SIN_TABLE_SIZE + 1> MakeSinTable()
+{
+    std::array<int32_t, SIN_TABLE_SIZE + 1> table {};
+    for (int32_t i = 0; i <= SIN_TABLE_SIZE; ++i) {
+        table[i] = static_cast<int32_t>(ToQ30(ConstexprSin(HALF_PI * i / SIN_TABLE_SIZE)));
+    }
+    return table;
+}
+
+// Q30 sine of the first quadrant, generated at compile time.
+constexpr std::array<int32_t, SIN_TABLE_SIZE + 1> SIN_TABLE = MakeSinTable();
+
+// Epoch values and per-minute rates of the NOAA series, folded at compile time. The quadratic terms of the series
+// stay below 1e-4 degrees within a century of J2000.0 and are dropped.
+constexpr int64_t MINS_PER_JULIAN_CENT = static_cast<int64_t>(DAYS_PER_JULIAN_CENT) * DarkModeConstants::MINS_PER_DAY;
+constexpr int64_t MEAN_LONG_FINE = ToFineAngle(MEAN_LONG_A);
+constexpr int64_t MEAN_LONG_RATE_FINE = ToFineAngle(MEAN_LONG_B / MINS_PER_JULIAN_CENT);
+constexpr int64_t MEAN_ANOM_FINE = ToFineAngle(MEAN_ANOM_A);
+constexpr int64_t MEAN_ANOM_RATE_FINE = ToFineAngle(MEAN_ANOM_B / MINS_PER_JULIAN_CENT);
+constexpr int64_t OMEGA_FINE = ToFineAngle(OMEGA_A);
+constexpr int64_t OMEGA_RATE_FINE = ToFineAngle(OMEGA_B / MINS_PER_JULIAN_CENT);
+constexpr int64_t EQC_A0_ANGLE = ToBinaryAngle(EQC_A0);
+constexpr int64_t EQC_A1_ANGLE = ToBinaryAngle(EQC_A1);
+constexpr int64_t EQC_B0_ANGLE = ToBinaryAngle(EQC_B0);
+constexpr int64_t EQC_C0_ANGLE = ToBinaryAngle(EQC_C0);
+constexpr int64_t ABERR_A_ANGLE = ToBinaryAngle(ABERR_A);
+constexpr int64_t ABERR_B_ANGLE = ToBinaryAngle(ABERR_B);
+constexpr int64_t MEAN_OBLIQ_ANGLE = ToBinaryAngle(CalcMeanObliq(0.0));
+constexpr int64_t MEAN_OBLIQ_CENT_ANGLE = ToBinaryAngle(CalcMeanObliq(0.0) - CalcMeanObliq(1.0));
+constexpr int64_t OBLIQ_CORR_ANGLE = ToBinaryAngle(OBLIQ_CORR_COEFF);
+constexpr int64_t ECC_A_Q30 = ToQ30(ECC_A);
+constexpr int64_t ECC_B_Q30 = ToQ30(ECC_B);
+constexpr int64_t EOT_E_SINM_Q30 = ToQ30(EOT_E_SINM_COEFF);
+constexpr int64_t EOT_EY_Q30 = ToQ30(EOT_EY_COEFF);
+constexpr int64_t EOT_Y2_Q30 = ToQ30(EOT_Y2_COEFF);
+constexpr int64_t EOT_E2_Q30 = ToQ30(EOT_E2_COEFF);
+constexpr int64_t COS_ZENITH_Q30 = ToQ30(-ConstexprSin((ZENITH - DEGREES_PER_QUARTER_TURN) * DEG2RAD));
+constexpr int64_t PI_Q30 = ToQ30(M_PI);
+constexpr int64_t ACOS_B0_Q30 = ToQ30(ACOS_B0);
+constexpr int64_t ACOS_B1_Q30 = ToQ30(ACOS_B1);
+constexpr int64_t ACOS_B2_Q30 = ToQ30(ACOS_B2);
+constexpr int64_t ACOS_B3_Q30 = ToQ30(ACOS_B3);
+// Minutes of time per radian of equation of time and of hour angle, in Q16.
+constexpr int64_t EOT_MINS_PER_RAD_Q16 = ToQ16(EOT_RAD2MIN * RAD2DEG);
+constexpr int64_t HA_MINS_PER_RAD_Q16 = ToQ16(MINS_PER_DEGREE_LON * RAD2DEG);
+constexpr int64_t MINS_PER_HALF_DAY_Q16 = static_cast<int64_t>(MINS_PER_HALF_DAY) * Q16_ONE;
+
+static_assert(SIN_TABLE[SIN_TABLE_SIZE] == Q30_ONE, "the sine table must end at exactly one");
+static_assert(COS_ZENITH_Q30 < 0, "the sunrise zenith is below the horizon");
+
+inline int64_t MulQ30(int64_t lhs, int64_t rhs)
+{
+    return (lhs * rhs) >> Q30_BITS;
+}
+
+/**
+ * Integer square root, rounded down. Newton's method from a power of two above the root decreases monotonically,
+ * so it stops as soon as an iteration no longer improves.
+ */
+uint64_t SqrtU64(uint64_t value)
+{
+    if (value == 0) {
+        return 0;
+    }
+    const int32_t bitWidth = UINT64_BITS - __builtin_clzll(value);
+    uint64_t root = 1ULL << ((bitWidth + 1) / 2);
+    while (true) {
+        const uint64_t next = (root + value / root) >> 1;
+        if (next >= root) {
+            return root;
+        }
+        root = next;
+    }
+}
+
+/**
+ * Q30 square root of a non-negative Q30 value.
+ */
+inline int64_t SqrtQ30(int64_t value)
+{
+    return static_cast<int64_t>(SqrtU64(static_cast<uint64_t>(value) << Q30_BITS));
+}
+
+/**
+ * Q30 sine of a binary angle, interpolated linearly between the entries of SIN_TABLE.
+ */
+int64_t FixedSin(uint32_t angle)
+{
+    const uint32_t quadrant = angle >> QUARTER_TURN_BITS;
+    uint32_t offset = angle & (QUARTER_TURN - 1);
+    // The second and fourth quadrants mirror the first one.
+    if ((quadrant & 1u) != 0) {
+        offset = QUARTER_TURN - offset;
+    }
+    const uint32_t index = offset >> SIN_TABLE_FRAC_BITS;
+    int64_t value = SIN_TABLE[index];
+    if (index < SIN_TABLE_SIZE) {
+        const int64_t fraction = offset & ((1u << SIN_TABLE_FRAC_BITS) - 1);
+        value += ((SIN_TABLE[index + 1] - value) * fraction) >> SIN_TABLE_FRAC_BITS;
+    }
+    return (quadrant >= 2) ? -value : value;
+}
+
+inline int64_t FixedCos(uint32_t angle)
+{
+    return FixedSin(angle + QUARTER_TURN);
+}
+
+/**
+ * Q30 arc cosine in radians of a Q30 value in [-1, 1], using Abramowitz and Stegun 4.4.45.
+ */
+int64_t FixedAcos(int64_t x)
+{
+    const int64_t absX = (x < 0) ? -x : x;
+    int64_t poly = ACOS_B3_Q30;
+    poly = ACOS_B2_Q30 + MulQ30(poly, absX);
+    poly = ACOS_B1_Q30 + MulQ30(poly, absX);
+    poly = ACOS_B0_Q30 + MulQ30(poly, absX);
+    const int64_t result = MulQ30(SqrtQ30(Q30_ONE - absX), poly);
+    return (x < 0) ? PI_Q30 - result : result;
+}
+
+/**
+ * Truncates a fine angle to a binary angle; the conversion to unsigned wraps it into one turn.
+ */
+inline uint32_t ToTurnAngle(int64_t fineAngle)
+{
+    return static_cast<uint32_t>(static_cast<uint64_t>(fineAngle) >> FINE_ANGLE_FRAC_BITS);
+}
 
+/**
+ * Fixed-point counterpart of the solar position part of CalcSunTimeMin.
+ */
+struct FixedSolarPosition {
+    /** Q30 sine of the declination. */
+    int64_t sinDec;
+    /** Q30 cosine of the declination. */
+    int64_t cosDec;
+    /** Equation of time in Q16 minutes. */
+    int64_t eqTime;
+};
+
+FixedSolarPosition CalcFixedSolarPosition(int64_t minutes)
+{
+    const uint32_t meanLong = ToTurnAngle(MEAN_LONG_FINE + MEAN_LONG_RATE_FINE * minutes);
+    const uint32_t meanAnomaly = ToTurnAngle(MEAN_ANOM_FINE + MEAN_ANOM_RATE_FINE * minutes);
+    const uint32_t omega = ToTurnAngle(OMEGA_FINE - OMEGA_RATE_FINE * minutes);
+    const int64_t sinMeanAnomaly = FixedSin(meanAnomaly);
+    const int64_t sin2MeanAnomaly = FixedSin(2u * meanAnomaly);
+
+    const int64_t eqcA = EQC_A0_ANGLE - EQC_A1_ANGLE * minutes / MINS_PER_JULIAN_CENT;
+    const int64_t eqOfCenter = (eqcA * sinMeanAnomaly + EQC_B0_ANGLE * sin2MeanAnomaly +
+        EQC_C0_ANGLE * FixedSin(3u * meanAnomaly)) >> Q30_BITS;
+    const int64_t aberration = ABERR_A_ANGLE + MulQ30(ABERR_B_ANGLE, FixedSin(omega));
+    const uint32_t appLong = meanLong + static_cast<uint32_t>(eqOfCenter - aberration);
+    const uint32_t obliqCorr = static_cast<uint32_t>(MEAN_OBLIQ_ANGLE -
+        MEAN_OBLIQ_CENT_ANGLE * minutes / MINS_PER_JULIAN_CENT + MulQ30(OBLIQ_CORR_ANGLE, FixedCos(omega)));
+
+    FixedSolarPosition position;
+    position.sinDec = MulQ30(FixedSin(obliqCorr), FixedSin(appLong));
+    position.cosDec = SqrtQ30(Q30_ONE - MulQ30(position.sinDec, position.sinDec));
+
+    // tan^2(x / 2) = (1 - cos(x)) / (1 + cos(x)).
+    const int64_t cosObliq = FixedCos(obliqCorr);
+    const int64_t y = (Q30_ONE - cosObliq) * Q30_ONE / (Q30_ONE + cosObliq);
+    const int64_t e = ECC_A_Q30 - ECC_B_Q30 * minutes / MINS_PER_JULIAN_CENT;
+    const int64_t eqTimeRad = MulQ30(y, FixedSin(2u * meanLong)) -
+        MulQ30(EOT_E_SINM_Q30, MulQ30(e, sinMeanAnomaly)) +
+        MulQ30(EOT_EY_Q30, MulQ30(MulQ30(MulQ30(e, y), sinMeanAnomaly), FixedCos(2u * meanLong))) -
+        MulQ30(EOT_Y2_Q30, MulQ30(MulQ30(y, y), FixedSin(4u * meanLong))) -
+        MulQ30(EOT_E2_Q30, MulQ30(MulQ30(e, e), sin2MeanAnomaly));
+    position.eqTime = MulQ30(eqTimeRad, EOT_MINS_PER_RAD_Q16);
+    return position;
+}
+
+/**
+ * Fixed-point counterpart of CalcHourAngle.
+ * @param haMinutes Receives the hour angle in Q16 minutes of time.
+ * @returns false for polar day or polar night.
+ */
+bool CalcFixedHourAngle(int64_t sinLat, int64_t cosLat, const FixedSolarPosition& position, int64_t& haMinutes)
+{
+    const int64_t numerator = COS_ZENITH_Q30 - MulQ30(sinLat, position.sinDec);
+    const int64_t denominator = MulQ30(cosLat, position.cosDec);
+    if (denominator <= 0 || numerator > denominator || numerator < -denominator) {
+        return false;
+    }
+    haMinutes = MulQ30(FixedAcos(numerator * Q30_ONE / denominator), HA_MINS_PER_RAD_Q16);
+    return true;
+}
+
+/**
+ * Rounds Q16 UTC minutes to the nearest minute and converts them to UTC seconds from 00:00.
+ */
+double FixedToUtcSeconds(int64_t utcMinutes)
+{
+    int64_t roundedMinutes = (utcMinutes + Q16_ONE / 2) >> Q16_BITS;
+    roundedMinutes %= DarkModeConstants::MINS_PER_DAY;
+    if (roundedMinutes < 0) {
+        roundedMinutes += DarkModeConstants::MINS_PER_DAY;
+    }
+    return static_cast<double>(roundedMinutes * DarkModeConstants::SECS_PER_MIN);
+}
+
+/**
+ * Converts the Julian day of a UTC noon to minutes since J2000.0.
+ */
+inline int64_t ToMinutesSinceJ2000(double jd)
+{
+    return static_cast<int64_t>(Floor(jd - J2000_JD + ROUND_HALF)) * DarkModeConstants::MINS_PER_DAY;
+}
+
+/**
+ * Fixed-point counterpart of CalcSunriseSunsetForJulianDay; needs no libm transcendental function.
+ * @param noonMinutes Minutes from J2000.0 to the UTC noon of the date.
+ */
+SunriseSunsetResult CalcFixedSunriseSunset(double lat, double lon, int64_t noonMinutes)
+{
+    SunriseSunsetResult result = { POLAR_MARK, POLAR_MARK };
+    const uint32_t latAngle = static_cast<uint32_t>(ToBinaryAngle(lat));
+    const int64_t sinLat = FixedSin(latAngle);
+    const int64_t cosLat = FixedCos(latAngle);
+    const int64_t lonMinutes = static_cast<int64_t>(lon * MINS_PER_DEGREE_LON * Q16_ONE);
+
+    // First iteration at the UTC noon, shared by sunrise and sunset.
+    FixedSolarPosition position = CalcFixedSolarPosition(noonMinutes);
+    int64_t haMinutes = 0;
+    if (!CalcFixedHourAngle(sinLat, cosLat, position, haMinutes)) {
+        return result;
+    }
+    const int64_t solarNoon = MINS_PER_HALF_DAY_Q16 - lonMinutes - position.eqTime;
+    const int64_t firstTimes[] = { solarNoon - haMinutes, solarNoon + haMinutes };
+    double* results[] = { &result.sunrise, &result.sunset };
+    const int64_t directions[] = { -1, 1 };
+    // Refine each with the solar position at the time found by the first iteration.
+    for (size_t i = 0; i < std::size(firstTimes); ++i) {
+        const int64_t refinedMinutes = noonMinutes + ((firstTimes[i] + Q16_ONE / 2) >> Q16_BITS);
+        position = CalcFixedSolarPosition(refinedMinutes);
+        if (CalcFixedHourAngle(sinLat, cosLat, position, haMinutes)) {
+            *results[i] = FixedToUtcSeconds(MINS_PER_HALF_DAY_Q16 - lonMinutes - position.eqTime +
+                directions[i] * haMinutes);
+        }
+    }
+    return result;
+}
+
+/**
+ * Calculates sunrise and sunset for the Julian day of a UTC noon.
+ * Uses the fixed-point path when UI_APPEARANCE_FIXED_POINT_SUNRISE_SUNSET is defined.
+ */
+SunriseSunsetResult CalcSunriseSunsetForJulianDay(double lat, double lon, double jd)
+{
+#ifdef UI_APPEARANCE_FIXED_POINT_SUNRISE_SUNSET
+    return CalcFixedSunriseSunset(lat, lon, ToMinutesSinceJ2000(jd));
+#else
     // First iteration.
     double sunriseMin = CalcSunTimeMin(lat, lon, jd, true);
     double sunsetMin = CalcSunTimeMin(lat, lon, jd, false);
@@ -289,27 +679,73 @@ SunriseSunsetResult CalculateSunriseSunset(double lat, double lon, int64_t times
         double jdSet = jd + sunsetMin / DarkModeConstants::MINS_PER_DAY;
         sunsetMin = CalcSunTimeMin(lat, lon, jdSet, false);
     }
+    return { ToUtcSeconds(sunriseMin), ToUtcSeconds(sunsetMin) };
+#endif
+}
 
-    // Convert the results to UTC seconds.
-    double sunriseSec = POLAR_MARK;
-    if (sunriseMin != POLAR_MARK) {
-        double adjustedMin = fmod(
-            fmod(sunriseMin, static_cast<double>(DarkModeConstants::MINS_PER_DAY)) + DarkModeConstants::MINS_PER_DAY,
-            DarkModeConstants::MINS_PER_DAY);
-        sunriseSec =
-            NormalizeRoundedMinutes(adjustedMin * DarkModeConstants::SECS_PER_MIN) * DarkModeConstants::SECS_PER_MIN;
+} // anonymous namespace
+
+namespace SunriseSunsetUtils {
+
+SunriseSunsetResult CalculateSunriseSunset(double lat, double lon, int64_t timestampMs)
+{
+    if (!IsValidCoordinate(lat, lon)) {
+        return { POLAR_MARK, POLAR_MARK };
+    }
+    time_t rawTime = static_cast<time_t>(timestampMs / DarkModeConstants::MS_PER_SEC);
+    struct tm utcTm;
+    if (gmtime_r(&rawTime, &utcTm) == nullptr) {
+        return { POLAR_MARK, POLAR_MARK };
     }
 
-    double sunsetSec = POLAR_MARK;
-    if (sunsetMin != POLAR_MARK) {
-        double adjustedMin = fmod(
-            fmod(sunsetMin, static_cast<double>(DarkModeConstants::MINS_PER_DAY)) + DarkModeConstants::MINS_PER_DAY,
-            DarkModeConstants::MINS_PER_DAY);
-        sunsetSec =
-            NormalizeRoundedMinutes(adjustedMin * DarkModeConstants::SECS_PER_MIN) * DarkModeConstants::SECS_PER_MIN;
+    // tm_year is relative to 1900 and tm_mon is zero-based; use UTC noon as the Julian day base.
+    double jd = CalcJulianDay(utcTm.tm_year + TM_YEAR_BASE, utcTm.tm_mon + 1, utcTm.tm_mday, UTC_NOON_HOUR);
+    return CalcSunriseSunsetForJulianDay(lat, lon, jd);
+}
+
+SunriseSunsetResult CalculateSunriseSunsetFixedPoint(double lat, double lon, int64_t timestampMs)
+{
+    if (!IsValidCoordinate(lat, lon)) {
+        return { POLAR_MARK, POLAR_MARK };
     }
+    return CalcFixedSunriseSunset(lat, lon, ToMinutesSinceJ2000(CalcUtcNoonJulianDay(timestampMs)));
+}
 
-    return { sunriseSec, sunsetSec };
+void CalculateSunriseSunsetBatch(size_t count, const double* lats, const double* lons, const int64_t* timestampsMs,
+    double* sunrises, double* sunsets)
+{
+    if (count == 0 || lats == nullptr || lons == nullptr || timestampsMs == nullptr || sunrises == nullptr ||
+        sunsets == nullptr) {
+        return;
+    }
+    const double cosZenith = cos(ZENITH * DEG2RAD);
+    double julianDays[BATCH_CHUNK_SIZE];
+    double riseJulianDays[BATCH_CHUNK_SIZE];
+    double setJulianDays[BATCH_CHUNK_SIZE];
+    for (size_t offset = 0; offset < count; offset += BATCH_CHUNK_SIZE) {
+        const size_t chunkSize = std::min(count - offset, BATCH_CHUNK_SIZE);
+        const double* chunkLats = lats + offset;
+        const double* chunkLons = lons + offset;
+        double* chunkSunrises = sunrises + offset;
+        double* chunkSunsets = sunsets + offset;
+        // Each stage is a separate loop with a small body and no calls or branches, so it can be vectorized;
+        // the integer day split stays out of them.
+        for (size_t i = 0; i < chunkSize; ++i) {
+            julianDays[i] = CalcUtcNoonJulianDay(timestampsMs[offset + i]);
+        }
+        for (size_t i = 0; i < chunkSize; ++i) {
+            CalcFastFirstIteration(chunkLats[i], chunkLons[i], julianDays[i], cosZenith, riseJulianDays[i],
+                setJulianDays[i], chunkSunrises[i], chunkSunsets[i]);
+        }
+        for (size_t i = 0; i < chunkSize; ++i) {
+            RefineFastSunTime(chunkLats[i], chunkLons[i], riseJulianDays[i], SUNRISE_DIRECTION, cosZenith,
+                chunkSunrises[i]);
+        }
+        for (size_t i = 0; i < chunkSize; ++i) {
+            RefineFastSunTime(chunkLats[i], chunkLons[i], setJulianDays[i], SUNSET_DIRECTION, cosZenith,
+                chunkSunsets[i]);
+        }
+    }
 }
 
 std::string FormatTimeFromSec(double utcSec, int timezoneOffset)
@@ -339,6 +775,10 @@ std::string FormatTimeFromSec(double utcSec, int timezoneOffset)
 // ============================================================
 
 SunriseSunsetInfo::SunriseSunsetInfo(double lat, double lon, int64_t timestampMs)
+    : SunriseSunsetInfo(SunriseSunsetUtils::CalculateSunriseSunset(lat, lon, timestampMs), timestampMs)
+{}
+
+SunriseSunsetInfo::SunriseSunsetInfo(const SunriseSunsetResult& result, int64_t timestampMs)
     : sunrise_(POLAR_MARK), sunset_(POLAR_MARK), timezoneOffset_(0), condition_(SunCondition::POLAR_NIGHT)
 {
     // Obtain the offset from the system time zone.
@@ -348,7 +788,6 @@ SunriseSunsetInfo::SunriseSunsetInfo(double lat, double lon, int64_t timestampMs
         timezoneOffset_ = -localTm.tm_gmtoff / DarkModeConstants::SECS_PER_MIN;
     }
 
-    auto result = SunriseSunsetUtils::CalculateSunriseSunset(lat, lon, timestampMs);
     sunrise_ = result.sunrise;
     sunset_ = result.sunset;
 
@@ -444,4 +883,81 @@ std::string SunriseSunsetInfo::GetSunriseStr() const
     return std::to_string(totalMinutes);
 }
 
+// ============================================================
+// SunriseSunsetTable implementation
+// ============================================================
+
+bool SunriseSunsetTable::NeedsRebuild(double lat, double lon, int64_t timestampMs) const
+{
+    if (year_ == EMPTY_YEAR) {
+        return true;
+    }
+    if (fabs(lat - lat_) > REBUILD_THRESHOLD_DEG || fabs(lon - lon_) > REBUILD_THRESHOLD_DEG) {
+        return true;
+    }
+    time_t rawTime = static_cast<time_t>(timestampMs / DarkModeConstants::MS_PER_SEC);
+    struct tm utcTm;
+    if (gmtime_r(&rawTime, &utcTm) == nullptr) {
+        return true;
+    }
+    return utcTm.tm_year + TM_YEAR_BASE != year_;
+}
+
+bool SunriseSunsetTable::Build(double lat, double lon, int64_t timestampMs)
+{
+    year_ = EMPTY_YEAR;
+    dayCount_ = 0;
+    if (!IsValidCoordinate(lat, lon)) {
+        return false;
+    }
+    time_t rawTime = static_cast<time_t>(timestampMs / DarkModeConstants::MS_PER_SEC);
+    struct tm utcTm;
+    if (gmtime_r(&rawTime, &utcTm) == nullptr) {
+        return false;
+    }
+    const int32_t year = utcTm.tm_year + TM_YEAR_BASE;
+    const bool isLeapYear = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+    lat_ = round(lat / QUANTIZATION_STEP_DEG) * QUANTIZATION_STEP_DEG;
+    lon_ = round(lon / QUANTIZATION_STEP_DEG) * QUANTIZATION_STEP_DEG;
+    dayCount_ = isLeapYear ? DAYS_PER_TABLE : DAYS_PER_TABLE - 1;
+
+    // Julian days of consecutive UTC noons differ by exactly one, so a single base covers the whole year.
+    const double firstDayJd = CalcJulianDay(year, 1, 1, UTC_NOON_HOUR);
+    for (int32_t day = 0; day < dayCount_; ++day) {
+        SunriseSunsetResult result = CalcSunriseSunsetForJulianDay(lat_, lon_, firstDayJd + day);
+        sunriseMinutes_[day] = (result.sunrise == POLAR_MARK) ? POLAR_MINUTES :
+            static_cast<int16_t>(result.sunrise / DarkModeConstants::SECS_PER_MIN);
+        sunsetMinutes_[day] = (result.sunset == POLAR_MARK) ? POLAR_MINUTES :
+            static_cast<int16_t>(result.sunset / DarkModeConstants::SECS_PER_MIN);
+    }
+    year_ = year;
+    ++buildCount_;
+    return true;
+}
+
+bool SunriseSunsetTable::Lookup(int64_t timestampMs, SunriseSunsetResult& result) const
+{
+    if (year_ == EMPTY_YEAR) {
+        return false;
+    }
+    time_t rawTime = static_cast<time_t>(timestampMs / DarkModeConstants::MS_PER_SEC);
+    struct tm utcTm;
+    if (gmtime_r(&rawTime, &utcTm) == nullptr || utcTm.tm_year + TM_YEAR_BASE != year_ ||
+        utcTm.tm_yday < 0 || utcTm.tm_yday >= dayCount_) {
+        return false;
+    }
+    const int16_t sunriseMinutes = sunriseMinutes_[utcTm.tm_yday];
+    const int16_t sunsetMinutes = sunsetMinutes_[utcTm.tm_yday];
+    result.sunrise = (sunriseMinutes == POLAR_MINUTES) ? POLAR_MARK :
+        static_cast<double>(sunriseMinutes) * DarkModeConstants::SECS_PER_MIN;
+    result.sunset = (sunsetMinutes == POLAR_MINUTES) ? POLAR_MARK :
+        static_cast<double>(sunsetMinutes) * DarkModeConstants::SECS_PER_MIN;
+    return true;
+}
+
+uint32_t SunriseSunsetTable::GetBuildCount() const
+{
+    return buildCount_;
+}
+
 } // namespace OHOS::ArkUi::UiAppearance
@@ -15,33 +15,44 @@
 
 #include "ui_appearance_ability.h"
 
+#include <algorithm>
+#include <cerrno>
+#include <cinttypes>
 #include <cstdlib>
 #include <string>
+#include <unistd.h>
 #include <utility>
 
 #include "accesstoken_kit.h"
 #include "common_event_manager.h"
 #include "common_event_support.h"
 #include "dark_mode_manager.h"
+#include "event_trace.h"
 #include "global_configuration_key.h"
 #include "ipc_skeleton.h"
 #include "iservice_registry.h"
+#include "local_time_cache.h"
 #include "matching_skills.h"
+#include "metrics_registry.h"
 #include "os_account_manager.h"
 #include "smart_gesture_manager.h"
+#include "state_snapshot.h"
 #include "system_ability_definition.h"
 #include "ui_appearance_log.h"
+#include "ui_appearance_trace.h"
 #include "parameter_wrap.h"
 #include "background_app_color_switch_settings.h"
 #include "background_app_info.h"
 #include "configuration_policy.h"
 #include "setting_data_manager.h"
 #include "tokenid_kit.h"
+#include "ui_appearance_cache.h"
 
 namespace {
 static const std::string LIGHT = "light";
 static const std::string DARK = "dark";
 static const std::string BASE_SCALE = "1";
+constexpr double BASE_SCALE_VALUE = 1.0;
 static const std::string STANDARD_FONT_WEIGHT = "const.standard_font_weight";
 static const std::string PERSIST_DARKMODE_KEY = "persist.ace.darkmode";
 static const std::string PERMISSION_UPDATE_CONFIGURATION = "ohos.permission.UPDATE_CONFIGURATION";
@@ -53,6 +64,12 @@ static const std::string PERSIST_DARKMODE_KEY_FOR_NONE = "persist.ace.darkmode."
 static const std::string FONT_SCAL_FOR_NONE = "persist.sys.font_scale_for_user.";
 static const std::string FONT_WEIGHT_SCAL_FOR_NONE = "persist.sys.font_wght_scale_for_user.";
 
+static const std::u16string DUMP_ARG_HELP = u"-h";
+static const std::u16string DUMP_ARG_STATE = u"-state";
+static const std::u16string DUMP_ARG_DARK_MODE = u"-darkmode";
+static const std::u16string DUMP_ARG_METRICS = u"-metrics";
+static const std::u16string DUMP_ARG_TRACE = u"-trace";
+
 static const std::string FIRST_INITIALIZATION = "persist.uiAppearance.first_initialization";
 const static int32_t USER100 = 100;
 const static int32_t USER0 = 0;
@@ -69,31 +86,14 @@ constexpr const char* SUB_PROFILE_TO_PROFILE_ID_KEY = "toSubProfileId";
 namespace OHOS {
 namespace ArkUi::UiAppearance {
 namespace {
-static constexpr double MIN_FONT_SCALE = 0.0;
-static constexpr double MAX_FONT_SCALE = 5.0;
-
-bool IsValidFontWeightScaleString(const std::string& value)
-{
-    if (value.empty()) {
-        return false;
-    }
-
-    errno = 0;
-    char* endPtr = nullptr;
-    double fontWeightScale = std::strtod(value.c_str(), &endPtr);
-    if (endPtr == value.c_str() || endPtr == nullptr || *endPtr != '\0' || errno == ERANGE) {
-        return false;
-    }
-    return fontWeightScale > MIN_FONT_SCALE && fontWeightScale <= MAX_FONT_SCALE;
-}
-
 std::string GetDefaultFontWeightScaleValue(const std::string& defaultValue)
 {
     std::string defaultFontWeightScale = defaultValue;
     if (GetParameterWrap(STANDARD_FONT_WEIGHT, defaultFontWeightScale)) {
         LOGI("get default fontWeightScale from %{public}s, value:%{public}s", STANDARD_FONT_WEIGHT.c_str(),
             defaultFontWeightScale.c_str());
-        if (!IsValidFontWeightScaleString(defaultFontWeightScale)) {
+        FontScale scale;
+        if (!FontScale::FromString(defaultFontWeightScale, scale)) {
             LOGW("invalid %{public}s value:%{public}s, fallback to defaultValue:%{public}s",
                 STANDARD_FONT_WEIGHT.c_str(), defaultFontWeightScale.c_str(), defaultValue.c_str());
             return defaultValue;
@@ -101,10 +101,22 @@ std::string GetDefaultFontWeightScaleValue(const std::string& defaultValue)
     }
     return defaultFontWeightScale;
 }
+
+// Parses a persisted scale once at load time; a value that no longer validates falls back to fallback.
+FontScale LoadFontScale(const std::string& value, const FontScale& fallback)
+{
+    FontScale scale;
+    if (!FontScale::FromString(value, scale)) {
+        LOGW("invalid persisted scale:%{public}s, fallback to %{public}s", value.c_str(),
+            fallback.ToString().c_str());
+        return fallback;
+    }
+    return scale;
+}
 } // namespace
 
 UiAppearanceAbility::UiAppearanceParam::UiAppearanceParam()
-    : fontWeightScale(GetDefaultFontWeightScaleValue(BASE_SCALE))
+    : fontWeightScale(LoadFontScale(GetDefaultFontWeightScaleValue(BASE_SCALE), FontScale()))
 {}
 
 UiAppearanceEventSubscriber::UiAppearanceEventSubscriber(const EventFwk::CommonEventSubscribeInfo& subscriberInfo,
@@ -120,25 +132,34 @@ void UiAppearanceEventSubscriber::OnReceiveEvent(const EventFwk::CommonEventData
     std::string action = want.GetAction();
     LOGI("action:%{public}s", action.c_str());
 
+    EventTrace& trace = EventTrace::GetInstance();
     if (action == EventFwk::CommonEventSupport::COMMON_EVENT_USER_SWITCHED) {
+        trace.Record(TraceEventType::USER_SWITCHED, data.GetCode());
         if (userSwitchCallback_ != nullptr) {
             userSwitchCallback_(data.GetCode());
         }
     } else if (action == EventFwk::CommonEventSupport::COMMON_EVENT_TIME_CHANGED) {
+        trace.Record(TraceEventType::TIME_CHANGED);
         TimeChangeCallback();
     } else if (action == EventFwk::CommonEventSupport::COMMON_EVENT_TIMEZONE_CHANGED) {
+        trace.Record(TraceEventType::TIMEZONE_CHANGED);
+        LocalTimeCache::GetInstance().Invalidate();
         TimeChangeCallback();
     } else if (action == EventFwk::CommonEventSupport::COMMON_EVENT_BOOT_COMPLETED) {
+        trace.Record(TraceEventType::BOOT_COMPLETED);
         BootCompetedCallback();
     } else if (action == EventFwk::CommonEventSupport::COMMON_EVENT_SCREEN_OFF) {
+        trace.Record(TraceEventType::SCREEN_OFF);
         DarkModeManager::GetInstance().ScreenOffCallback();
     } else if (action == EventFwk::CommonEventSupport::COMMON_EVENT_SCREEN_ON) {
+        trace.Record(TraceEventType::SCREEN_ON);
         DarkModeManager::GetInstance().ScreenOnCallback();
     } else if (action == EventFwk::CommonEventSupport::COMMON_EVENT_OS_ACCOUNT_SUB_PROFILE_SWITCHED) {
 #ifdef ENABLE_MULTIPLE_OS_ACCOUNT_SUBSPACE
         if (subProfileSwitchCallback_ != nullptr) {
             int32_t userId = want.GetIntParam(SUB_PROFILE_USER_ID_KEY, INVALID_USER_ID);
             int32_t subProfileId = want.GetIntParam(SUB_PROFILE_TO_PROFILE_ID_KEY, INVALID_SUB_PROFILE_ID);
+            trace.Record(TraceEventType::SUB_PROFILE_SWITCHED, userId, subProfileId);
             subProfileSwitchCallback_(userId, subProfileId);
         }
 #endif
@@ -147,7 +168,7 @@ void UiAppearanceEventSubscriber::OnReceiveEvent(const EventFwk::CommonEventData
 
 void UiAppearanceEventSubscriber::TimeChangeCallback()
 {
-    DarkModeManager::GetInstance().RestartTimer();
+    DarkModeManager::GetInstance().RequestRestartTimer();
 }
 
 void UiAppearanceEventSubscriber::BootCompetedCallback()
@@ -213,12 +234,20 @@ bool UiAppearanceAbility::VerifyAccessToken(const std::string& permissionName)
 
 void UiAppearanceAbility::OnStart()
 {
+    RestoreStateSnapshot();
     bool res = Publish(this); // SA registers with SAMGR
     if (!res) {
         LOGE("publish failed.");
         return;
     }
 
+    // Keep counting from the previous instance so that clients connected to it see a new value and drop their cache.
+    std::string generation;
+    if (GetParameterWrap(CONFIG_GENERATION_PARAM, generation)) {
+        configGeneration_.store(std::strtoull(generation.c_str(), nullptr, 10), std::memory_order_relaxed);
+    }
+    PublishAppearanceChange();
+
     LOGI("AddSystemAbilityListener start.");
     AddSystemAbilityListener(APP_MGR_SERVICE_ID);
     return;
@@ -229,6 +258,128 @@ void UiAppearanceAbility::OnStop()
     LOGI("UiAppearanceAbility SA stop.");
 }
 
+int32_t UiAppearanceAbility::Dump(int32_t fd, const std::vector<std::u16string>& args)
+{
+    bool dumpAll = args.empty();
+    auto hasArg = [&args](const std::u16string& arg) {
+        return std::find(args.begin(), args.end(), arg) != args.end();
+    };
+    DumpBuffer out;
+    bool dumpTrace = false;
+    if (hasArg(DUMP_ARG_HELP)) {
+        out.Append("usage: hidumper -s %d -a \"[-h] [-state] [-darkmode] [-metrics] [-trace]\"\n"
+            "  no option dumps every section\n", ARKUI_UI_APPEARANCE_SERVICE_ID);
+    } else {
+        if (dumpAll || hasArg(DUMP_ARG_STATE)) {
+            DumpState(out);
+        }
+        if (dumpAll || hasArg(DUMP_ARG_DARK_MODE)) {
+            DarkModeManager::GetInstance().Dump(out);
+        }
+        if (dumpAll || hasArg(DUMP_ARG_METRICS)) {
+            MetricsRegistry::GetInstance().Dump(out);
+        }
+        dumpTrace = dumpAll || hasArg(DUMP_ARG_TRACE);
+    }
+    if (!out.WriteTo(fd)) {
+        LOGE("write dump failed, errno: %{public}d", errno);
+        return ERR_INVALID_OPERATION;
+    }
+    if (dumpTrace) {
+        // A full ring does not fit into the default capacity, so the trace gets a buffer sized for it.
+        DumpBuffer traceOut(EventTrace::DUMP_CAPACITY);
+        EventTrace::GetInstance().Dump(traceOut);
+        if (!traceOut.WriteTo(fd)) {
+            LOGE("write trace dump failed, errno: %{public}d", errno);
+            return ERR_INVALID_OPERATION;
+        }
+    }
+    return ERR_OK;
+}
+
+void UiAppearanceAbility::DumpState(DumpBuffer& out)
+{
+    // Copy under each lock in turn and format afterwards, so an IPC thread waits at most for one copy.
+    std::vector<std::pair<AccountContext, UiAppearanceParam>> usersParam;
+    {
+        std::lock_guard<std::mutex> guard(usersParamMutex_);
+        usersParam.reserve(usersParam_.size());
+        for (const auto& item : usersParam_) {
+            usersParam.emplace_back(item);
+        }
+    }
+    std::vector<std::pair<AccountContext, std::shared_ptr<AppearanceSetters>>> setters;
+    {
+        std::lock_guard<std::mutex> guard(appearanceSettersMutex_);
+        setters.assign(appearanceSetters_.begin(), appearanceSetters_.end());
+    }
+
+    out.Append("config generation: %" PRIu64 "\n", configGeneration_.load(std::memory_order_relaxed));
+    out.Append("users param: %zu contexts\n", usersParam.size());
+    for (const auto& [context, param] : usersParam) {
+        out.Append("  context %s: dark mode %d, font scale %s, font weight scale %s\n",
+            AccountContextHelper::ToString(context).c_str(), static_cast<int32_t>(param.darkMode),
+            param.fontScale.ToString().c_str(), param.fontWeightScale.ToString().c_str());
+    }
+    out.Append("setter requests (submitted/applied/timed out): %zu contexts\n", setters.size());
+    for (const auto& [context, setter] : setters) {
+        out.Append("  context %s: dark mode %" PRIu64 "/%" PRIu64 "/%" PRIu64 ", font scale %" PRIu64 "/%" PRIu64
+            "/%" PRIu64 ", font weight scale %" PRIu64 "/%" PRIu64 "/%" PRIu64 "\n",
+            AccountContextHelper::ToString(context).c_str(), setter->darkMode.GetSubmitCount(),
+            setter->darkMode.GetApplyCount(), setter->darkMode.GetTimeoutCount(), setter->fontScale.GetSubmitCount(),
+            setter->fontScale.GetApplyCount(), setter->fontScale.GetTimeoutCount(),
+            setter->fontWeightScale.GetSubmitCount(), setter->fontWeightScale.GetApplyCount(),
+            setter->fontWeightScale.GetTimeoutCount());
+    }
+}
+
+void UiAppearanceAbility::RestoreStateSnapshot()
+{
+    StateSnapshot& snapshot = StateSnapshot::GetInstance();
+    snapshot.RegisterCollector("UiAppearanceAbility",
+        [this](StateSnapshot::Records& records) { CollectStateSnapshot(records); });
+    StateSnapshot::Records records;
+    if (snapshot.Load(records)) {
+        {
+            std::lock_guard<std::mutex> guard(usersParamMutex_);
+            for (const auto& item : records) {
+                const StateSnapshot::Record& record = item.second;
+                if ((record.flags & StateSnapshot::HAS_APPEARANCE) == 0 ||
+                    usersParam_.find(item.first) != usersParam_.end()) {
+                    continue;
+                }
+                UiAppearanceParam param;
+                param.darkMode = record.darkMode == DarkMode::ALWAYS_DARK ? DarkMode::ALWAYS_DARK
+                                                                          : DarkMode::ALWAYS_LIGHT;
+                param.fontScale = LoadFontScale(StateSnapshot::GetScale(record.fontScale), param.fontScale);
+                param.fontWeightScale =
+                    LoadFontScale(StateSnapshot::GetScale(record.fontWeightScale), param.fontWeightScale);
+                usersParam_[item.first] = param;
+            }
+        }
+        DarkModeManager::GetInstance().RestoreSnapshot(records);
+        LOGI("state snapshot restored, records: %{public}zu", records.size());
+    }
+    // DoInitProcess and the user switch reload everything from parameters and DataShare once AppMgr is up.
+    snapshot.EnableWrite();
+}
+
+void UiAppearanceAbility::CollectStateSnapshot(StateSnapshot::Records& records)
+{
+    std::lock_guard<std::mutex> guard(usersParamMutex_);
+    for (const auto& item : usersParam_) {
+        StateSnapshot::Record& record = StateSnapshot::GetRecord(records, item.first);
+        if (!StateSnapshot::SetScale(record.fontScale, item.second.fontScale.ToString()) ||
+            !StateSnapshot::SetScale(record.fontWeightScale, item.second.fontWeightScale.ToString())) {
+            LOGW("font scale too long for snapshot, context:%{public}s",
+                AccountContextHelper::ToString(item.first).c_str());
+            continue;
+        }
+        record.flags |= StateSnapshot::HAS_APPEARANCE;
+        record.darkMode = item.second.darkMode;
+    }
+}
+
 std::list<int32_t> UiAppearanceAbility::GetUserIds()
 {
     std::vector<AccountSA::OsAccountInfo> infos;
@@ -325,8 +476,8 @@ void UiAppearanceAbility::DoInitProcess()
 
         UiAppearanceParam tmpParam;
         tmpParam.darkMode = darkValue == DARK ? DarkMode::ALWAYS_DARK : DarkMode::ALWAYS_LIGHT;
-        tmpParam.fontScale = fontSize;
-        tmpParam.fontWeightScale = fontWeight;
+        tmpParam.fontScale = LoadFontScale(fontSize, tmpParam.fontScale);
+        tmpParam.fontWeightScale = LoadFontScale(fontWeight, tmpParam.fontWeightScale);
         {
             std::lock_guard<std::mutex> guard(usersParamMutex_);
             usersParam_[context] = tmpParam;
@@ -335,6 +486,7 @@ void UiAppearanceAbility::DoInitProcess()
             AccountContextHelper::ToString(context).c_str(), darkValue.c_str(), fontSize.c_str(),
             fontWeight.c_str());
     }
+    StateSnapshot::GetInstance().RequestWrite();
     isInitializationFinished_ = true;
 }
 
@@ -348,8 +500,8 @@ void UiAppearanceAbility::UpdateCurrentUserConfiguration(const AccountContext& c
     AppExecFwk::Configuration config;
     config.AddItem(
         AAFwk::GlobalConfigurationKey::SYSTEM_COLORMODE, tmpParam.darkMode == DarkMode::ALWAYS_DARK ? DARK : LIGHT);
-    config.AddItem(AAFwk::GlobalConfigurationKey::SYSTEM_FONT_SIZE_SCALE, tmpParam.fontScale);
-    config.AddItem(AAFwk::GlobalConfigurationKey::SYSTEM_FONT_WEIGHT_SCALE, tmpParam.fontWeightScale);
+    config.AddItem(AAFwk::GlobalConfigurationKey::SYSTEM_FONT_SIZE_SCALE, tmpParam.fontScale.ToString());
+    config.AddItem(AAFwk::GlobalConfigurationKey::SYSTEM_FONT_WEIGHT_SCALE, tmpParam.fontWeightScale.ToString());
 
     auto appManagerInstance = GetAppManagerInstance();
     if (!appManagerInstance) {
@@ -372,8 +524,9 @@ void UiAppearanceAbility::UpdateCurrentUserConfiguration(const AccountContext& c
     }
 
     SetParameterWrap(PERSIST_DARKMODE_KEY, tmpParam.darkMode == DarkMode::ALWAYS_DARK ? DARK : LIGHT);
-    SetParameterWrap(FONT_SCAL_FOR_USER0, tmpParam.fontScale);
-    SetParameterWrap(FONT_Weight_SCAL_FOR_USER0, tmpParam.fontWeightScale);
+    SetParameterWrap(FONT_SCAL_FOR_USER0, tmpParam.fontScale.ToString());
+    SetParameterWrap(FONT_Weight_SCAL_FOR_USER0, tmpParam.fontWeightScale.ToString());
+    PublishAppearanceChange();
 }
 
 void UiAppearanceAbility::UserSwitchFunc(const int32_t userId)
@@ -401,17 +554,18 @@ void UiAppearanceAbility::ApplyAppearanceContextToUser(
         sourceParam = it->second;
         usersParam_[targetContext] = sourceParam;
     }
+    StateSnapshot::GetInstance().RequestWrite();
 
     if (!SetParameterWrap(DarkModeParamAssignUser(targetContext),
         sourceParam.darkMode == DarkMode::ALWAYS_DARK ? DARK : LIGHT)) {
         LOGE("set dark mode parameter failed, context:%{public}s",
             AccountContextHelper::ToString(targetContext).c_str());
     }
-    if (!SetParameterWrap(FontScaleParamAssignUser(targetContext), sourceParam.fontScale)) {
+    if (!SetParameterWrap(FontScaleParamAssignUser(targetContext), sourceParam.fontScale.ToString())) {
         LOGE("set font scale parameter failed, context:%{public}s",
             AccountContextHelper::ToString(targetContext).c_str());
     }
-    if (!SetParameterWrap(FontWeightScaleParamAssignUser(targetContext), sourceParam.fontWeightScale)) {
+    if (!SetParameterWrap(FontWeightScaleParamAssignUser(targetContext), sourceParam.fontWeightScale.ToString())) {
         LOGE("set font weight scale parameter failed, context:%{public}s",
             AccountContextHelper::ToString(targetContext).c_str());
     }
@@ -421,7 +575,23 @@ void UiAppearanceAbility::ApplyAppearanceContextToUser(
 void UiAppearanceAbility::AccountContextSwitchFunc(const AccountContext& context)
 {
     DarkModeManager& manager = DarkModeManager::GetInstance();
-    manager.OnSwitchContext(context);
+    // Every foreground context stays active and keeps its observers; only the contexts that left the foreground are
+    // deactivated and dropped.
+    std::vector<AccountContext> foregroundContexts = { context };
+    for (const int32_t effectiveUserId : GetMultipleUsers()) {
+        foregroundContexts.push_back(GetForegroundAccountContext(effectiveUserId));
+    }
+    manager.OnSwitchContext(context, foregroundContexts);
+    manager.RetainObservedContexts(foregroundContexts);
+    // The other foreground contexts are loaded once and then kept up to date by their observers; a context that was
+    // parked or changed while inactive is loaded again here, which is its only apply.
+    for (const auto& foregroundContext : foregroundContexts) {
+        if (foregroundContext == context || !manager.NeedLoadUserSettingData(foregroundContext)) {
+            continue;
+        }
+        bool isForegroundDarkMode = false;
+        manager.LoadUserSettingData(foregroundContext, true, isForegroundDarkMode, false);
+    }
     bool isDarkMode = false;
     int32_t code = manager.LoadUserSettingData(context, false, isDarkMode, false);
 
@@ -439,6 +609,7 @@ void UiAppearanceAbility::AccountContextSwitchFunc(const AccountContext& context
         if (usersParam_[context].darkMode != darkMode) {
             usersParam_[context].darkMode = darkMode;
             isForceUpdate = true;
+            StateSnapshot::GetInstance().RequestWrite();
         }
     }
     // Sub-profiles under the same OS account share the AppMgr userId dimension but have distinct
@@ -611,13 +782,16 @@ std::string UiAppearanceAbility::FontWeightScaleParamAssignUser(const AccountCon
 
 bool UiAppearanceAbility::BackGroundAppColorSwitch(sptr<AppExecFwk::IAppMgr> appManagerInstance, const int32_t userId)
 {
-    if (!BackGroundAppColorSwitchSettings::GetInstance().IsSupportHotUpdate()) {
+    UI_APPEARANCE_TRACE_SCOPE("UiAppearance.BackGroundAppColorSwitch", userId, INVALID_SUB_PROFILE_ID);
+    // One snapshot per switch so that a concurrent reload cannot mix two versions of the allow list.
+    auto settings = BackGroundAppColorSwitchSettings::GetInstance().GetSettings();
+    if (!settings->isAllowListEnable) {
         LOGI("not Support BackGround App Color Switch");
         return false;
     }
 
     std::vector<AppExecFwk::BackgroundAppInfo> backgroundAppInfoVe;
-    for (const auto& whiteListItem : BackGroundAppColorSwitchSettings::GetInstance().GetWhileList()) {
+    for (const auto& whiteListItem : settings->allowList) {
         AppExecFwk::BackgroundAppInfo appInfo;
         appInfo.bandleName = whiteListItem;
         appInfo.appIndex = 0;
@@ -630,11 +804,10 @@ bool UiAppearanceAbility::BackGroundAppColorSwitch(sptr<AppExecFwk::IAppMgr> app
     }
 
     AppExecFwk::ConfigurationPolicy policy;
-    policy.maxCountPerBatch  = BackGroundAppColorSwitchSettings::GetInstance().GetTaskQuantity();
-    policy.intervalTime = BackGroundAppColorSwitchSettings::GetInstance().GetDurationMillisecond();
+    policy.maxCountPerBatch = settings->taskQuantity;
+    policy.intervalTime = settings->durationMillisecond;
     LOGI("BackGroundAppColorSwitch settings maxCountPerBatch :%{public}d intervalTime :%{public}d.",
-        BackGroundAppColorSwitchSettings::GetInstance().GetTaskQuantity(),
-        BackGroundAppColorSwitchSettings::GetInstance().GetDurationMillisecond());
+        settings->taskQuantity, settings->durationMillisecond);
     auto result = appManagerInstance->UpdateConfigurationForBackgroundApp(backgroundAppInfoVe, policy, userId);
     if (!result) {
         LOGE("UpdateConfigurationForBackgroundApp fail result :%{public}d.", result);
@@ -646,6 +819,10 @@ bool UiAppearanceAbility::BackGroundAppColorSwitch(sptr<AppExecFwk::IAppMgr> app
 bool UiAppearanceAbility::UpdateConfiguration(const AppExecFwk::Configuration& configuration, const int32_t userId,
     const std::vector<std::int32_t>& effectiveUserIds)
 {
+    UI_APPEARANCE_TRACE_SCOPE("UiAppearance.UpdateConfiguration", userId, INVALID_SUB_PROFILE_ID);
+    // Counted as failed unless it gets to the end.
+    MetricScope metricScope(MetricId::UPDATE_CONFIGURATION);
+    metricScope.SetFailed(true);
     auto appManagerInstance = GetAppManagerInstance();
     if (appManagerInstance == nullptr) {
         LOGE("Get app manager proxy failed.");
@@ -661,6 +838,7 @@ bool UiAppearanceAbility::UpdateConfiguration(const AppExecFwk::Configuration& c
             userId, configuration.GetName().c_str());
         errcode = appManagerInstance->UpdateConfiguration(configuration, userId);
     }
+    EventTrace::GetInstance().Record(TraceEventType::UPDATE_CONFIGURATION, userId, INVALID_SUB_PROFILE_ID, errcode);
 
     if (errcode != 0) {
         AppExecFwk::Configuration config;
@@ -688,6 +866,7 @@ bool UiAppearanceAbility::UpdateConfiguration(const AppExecFwk::Configuration& c
             BackGroundAppColorSwitch(appManagerInstance, userId);
         }
     }
+    metricScope.SetFailed(false);
     return true;
 }
 
@@ -726,20 +905,27 @@ int32_t UiAppearanceAbility::OnSetDarkMode(const AccountContext& context, DarkMo
 
     if (effectiveUserIds.size() > 1) {
         SetParameterWrap(PERSIST_DARKMODE_KEY, paramValue);
+        int32_t result = SUCCEEDED;
         for (const int32_t effectiveUserId : effectiveUserIds) {
             if (ConfigurePersistence(GetForegroundAccountContext(effectiveUserId), mode, paramValue) != SUCCEEDED) {
-                return SYS_ERR;
+                result = SYS_ERR;
+                break;
             }
         }
-        return SUCCEEDED;
+        // One generation bump per change, once every user it covers is persisted.
+        PublishAppearanceChange();
+        return result;
     }
 
     SetParameterWrap(PERSIST_DARKMODE_KEY, paramValue);
-    return ConfigurePersistence(context, mode, paramValue);
+    int32_t result = ConfigurePersistence(context, mode, paramValue);
+    PublishAppearanceChange();
+    return result;
 }
 
 ErrCode UiAppearanceAbility::SetDarkMode(int32_t mode, int32_t& funcResult)
 {
+    MetricScope metricScope(MetricId::IPC_SET_DARK_MODE, &funcResult);
     // Verify permissions
     DarkMode darkMode = static_cast<DarkMode>(mode);
     auto isCallingPerm = VerifyAccessToken(PERMISSION_UPDATE_CONFIGURATION);
@@ -748,8 +934,22 @@ ErrCode UiAppearanceAbility::SetDarkMode(int32_t mode, int32_t& funcResult)
         funcResult = PERMISSION_ERR;
         return SUCCEEDED;
     }
+    if (darkMode != DarkMode::ALWAYS_DARK && darkMode != DarkMode::ALWAYS_LIGHT) {
+        LOGE("invalid dark mode: %{public}d", mode);
+        funcResult = INVALID_ARG;
+        return SUCCEEDED;
+    }
 
     auto context = GetCallingAccountContext();
+    funcResult = GetAppearanceSetters(context)->darkMode.Submit(darkMode,
+        [this, &context](const DarkMode& latestMode, const uint32_t mergedCount) {
+            return ApplyDarkMode(context, latestMode, mergedCount);
+        });
+    return SUCCEEDED;
+}
+
+int32_t UiAppearanceAbility::ApplyDarkMode(const AccountContext& context, DarkMode darkMode, uint32_t mergedCount)
+{
     DarkMode currentDarkMode = DarkMode::ALWAYS_LIGHT;
     {
         std::lock_guard<std::mutex> guard(usersParamMutex_);
@@ -759,13 +959,40 @@ ErrCode UiAppearanceAbility::SetDarkMode(int32_t mode, int32_t& funcResult)
         }
     }
     if (darkMode != currentDarkMode) {
-        funcResult = OnSetDarkMode(context, darkMode);
-        return SUCCEEDED;
-    } else {
-        LOGW("current color mode is %{public}d, no need to change", darkMode);
-        funcResult = SYS_ERR;
-        return SUCCEEDED;
+        return OnSetDarkMode(context, darkMode);
+    }
+    LOGW("current color mode is %{public}d, no need to change, merged: %{public}u", darkMode, mergedCount);
+    return SYS_ERR;
+}
+
+std::shared_ptr<UiAppearanceAbility::AppearanceSetters> UiAppearanceAbility::GetAppearanceSetters(
+    const AccountContext& context)
+{
+    std::lock_guard<std::mutex> guard(appearanceSettersMutex_);
+    auto& setters = appearanceSetters_[context];
+    if (setters == nullptr) {
+        setters = std::make_shared<AppearanceSetters>();
     }
+    return setters;
+}
+
+int32_t UiAppearanceAbility::SubmitFontScale(const AccountContext& context, const FontScale& fontScale)
+{
+    return GetAppearanceSetters(context)->fontScale.Submit(fontScale,
+        [this, &context](const FontScale& latestScale, const uint32_t mergedCount) {
+            LOGD("apply font scale:%{public}s, merged: %{public}u", latestScale.ToString().c_str(), mergedCount);
+            return OnSetFontScale(context, latestScale);
+        });
+}
+
+int32_t UiAppearanceAbility::SubmitFontWeightScale(const AccountContext& context, const FontScale& fontWeightScale)
+{
+    return GetAppearanceSetters(context)->fontWeightScale.Submit(fontWeightScale,
+        [this, &context](const FontScale& latestScale, const uint32_t mergedCount) {
+            LOGD("apply font weight scale:%{public}s, merged: %{public}u", latestScale.ToString().c_str(),
+                mergedCount);
+            return OnSetFontWeightScale(context, latestScale);
+        });
 }
 
 DarkMode UiAppearanceAbility::InitGetDarkMode(const AccountContext& context)
@@ -789,6 +1016,8 @@ DarkMode UiAppearanceAbility::InitGetDarkMode(const AccountContext& context)
 
 ErrCode UiAppearanceAbility::GetDarkMode(int32_t& funcResult)
 {
+    // funcResult carries the mode here, not an error code.
+    MetricScope metricScope(MetricId::IPC_GET_DARK_MODE);
     {
         std::lock_guard<std::mutex> guard(usersParamMutex_);
         auto it = usersParam_.find(GetCallingAccountContext());
@@ -802,13 +1031,14 @@ ErrCode UiAppearanceAbility::GetDarkMode(int32_t& funcResult)
     return SUCCEEDED;
 }
 
-int32_t UiAppearanceAbility::OnSetFontScale(const AccountContext& context, const std::string& fontScale)
+int32_t UiAppearanceAbility::OnSetFontScale(const AccountContext& context, const FontScale& fontScale)
 {
+    const std::string& fontScaleText = fontScale.ToString();
     bool ret = false;
     AppExecFwk::Configuration config;
-    ret = config.AddItem(AAFwk::GlobalConfigurationKey::SYSTEM_FONT_SIZE_SCALE, fontScale);
+    ret = config.AddItem(AAFwk::GlobalConfigurationKey::SYSTEM_FONT_SIZE_SCALE, fontScaleText);
     if (!ret) {
-        LOGE("AddItem failed, fontScale = %{public}s", fontScale.c_str());
+        LOGE("AddItem failed, fontScale = %{public}s", fontScaleText.c_str());
         return INVALID_ARG;
     }
 
@@ -818,13 +1048,16 @@ int32_t UiAppearanceAbility::OnSetFontScale(const AccountContext& context, const
         if (!UpdateConfiguration(config, context.userId, effectiveUserIds)) {
             return SYS_ERR;
         }
-        SetParameterWrap(FONT_SCAL_FOR_USER0, fontScale);
+        SetParameterWrap(FONT_SCAL_FOR_USER0, fontScaleText);
+        int32_t result = SUCCEEDED;
         for (const int32_t effectiveUserId : effectiveUserIds) {
             if (ConfigureFontScalePersistence(GetForegroundAccountContext(effectiveUserId), fontScale) != SUCCEEDED) {
-                return SYS_ERR;
+                result = SYS_ERR;
+                break;
             }
         }
-        return SUCCEEDED;
+        PublishAppearanceChange();
+        return result;
     }
 #endif
 
@@ -832,19 +1065,22 @@ int32_t UiAppearanceAbility::OnSetFontScale(const AccountContext& context, const
         return SYS_ERR;
     }
 
-    SetParameterWrap(FONT_SCAL_FOR_USER0, fontScale);
-    return ConfigureFontScalePersistence(context, fontScale);
+    SetParameterWrap(FONT_SCAL_FOR_USER0, fontScaleText);
+    int32_t result = ConfigureFontScalePersistence(context, fontScale);
+    PublishAppearanceChange();
+    return result;
 }
 
-int32_t UiAppearanceAbility::ConfigureFontScalePersistence(const AccountContext& context, const std::string& fontScale)
+int32_t UiAppearanceAbility::ConfigureFontScalePersistence(const AccountContext& context, const FontScale& fontScale)
 {
     {
         std::lock_guard<std::mutex> guard(usersParamMutex_);
         usersParam_[context].fontScale = fontScale;
     }
+    StateSnapshot::GetInstance().RequestWrite();
 
     // persist to file: etc/para/ui_appearance.para
-    auto isSetPara = SetParameterWrap(FontScaleParamAssignUser(context), fontScale);
+    auto isSetPara = SetParameterWrap(FontScaleParamAssignUser(context), fontScale.ToString());
     if (!isSetPara) {
         LOGE("set parameter failed");
         return SYS_ERR;
@@ -854,6 +1090,7 @@ int32_t UiAppearanceAbility::ConfigureFontScalePersistence(const AccountContext&
 
 ErrCode UiAppearanceAbility::SetFontScale(const std::string& fontScale, int32_t& funcResult)
 {
+    MetricScope metricScope(MetricId::IPC_SET_FONT_SCALE, &funcResult);
     // Verify permissions
     auto isCallingPerm = VerifyAccessToken(PERMISSION_UPDATE_CONFIGURATION);
     if (!isCallingPerm) {
@@ -861,23 +1098,49 @@ ErrCode UiAppearanceAbility::SetFontScale(const std::string& fontScale, int32_t&
         funcResult = PERMISSION_ERR;
         return SUCCEEDED;
     }
-    if (!fontScale.empty()) {
-        funcResult = OnSetFontScale(GetCallingAccountContext(), fontScale);
-        return SUCCEEDED;
-    } else {
+    if (fontScale.empty()) {
         LOGE("current fontScale is empty!");
+        funcResult = SYS_ERR;
+        return SUCCEEDED;
+    }
+    FontScale scale;
+    if (!FontScale::FromString(fontScale, scale)) {
+        LOGE("invalid fontScale:%{public}s", fontScale.c_str());
+        funcResult = INVALID_ARG;
+        return SUCCEEDED;
+    }
+    funcResult = SubmitFontScale(GetCallingAccountContext(), scale);
+    return SUCCEEDED;
+}
+
+ErrCode UiAppearanceAbility::SetFontScaleValue(double fontScale, int32_t& funcResult)
+{
+    MetricScope metricScope(MetricId::IPC_SET_FONT_SCALE_VALUE, &funcResult);
+    // Verify permissions
+    auto isCallingPerm = VerifyAccessToken(PERMISSION_UPDATE_CONFIGURATION);
+    if (!isCallingPerm) {
+        LOGE("permission verification failed");
+        funcResult = PERMISSION_ERR;
+        return SUCCEEDED;
+    }
+    FontScale scale;
+    if (!FontScale::FromDouble(fontScale, scale)) {
+        LOGE("invalid fontScale:%{public}f", fontScale);
+        funcResult = INVALID_ARG;
+        return SUCCEEDED;
     }
-    funcResult = SYS_ERR;
+    funcResult = SubmitFontScale(GetCallingAccountContext(), scale);
     return SUCCEEDED;
 }
 
 ErrCode UiAppearanceAbility::GetFontScale(std::string& fontScale, int32_t& funcResult)
 {
+    MetricScope metricScope(MetricId::IPC_GET_FONT_SCALE, &funcResult);
     {
         std::lock_guard<std::mutex> guard(usersParamMutex_);
         auto it = usersParam_.find(GetCallingAccountContext());
         if (it != usersParam_.end()) {
-            fontScale = it->second.fontScale;
+            fontScale = it->second.fontScale.ToString();
         } else {
             fontScale = BASE_SCALE;
         }
@@ -887,13 +1150,27 @@ ErrCode UiAppearanceAbility::GetFontScale(std::string& fontScale, int32_t& funcR
     return SUCCEEDED;
 }
 
-int32_t UiAppearanceAbility::OnSetFontWeightScale(const AccountContext& context, const std::string& fontWeightScale)
+ErrCode UiAppearanceAbility::GetFontScaleValue(double& fontScale, int32_t& funcResult)
+{
+    MetricScope metricScope(MetricId::IPC_GET_FONT_SCALE_VALUE, &funcResult);
+    {
+        std::lock_guard<std::mutex> guard(usersParamMutex_);
+        auto it = usersParam_.find(GetCallingAccountContext());
+        fontScale = it != usersParam_.end() ? it->second.fontScale.ToDouble() : BASE_SCALE_VALUE;
+    }
+    LOGD("get font scale :%{public}f", fontScale);
+    funcResult = SUCCEEDED;
+    return SUCCEEDED;
+}
+
+int32_t UiAppearanceAbility::OnSetFontWeightScale(const AccountContext& context, const FontScale& fontWeightScale)
 {
+    const std::string& fontWeightScaleText = fontWeightScale.ToString();
     bool ret = false;
     AppExecFwk::Configuration config;
-    ret = config.AddItem(AAFwk::GlobalConfigurationKey::SYSTEM_FONT_WEIGHT_SCALE, fontWeightScale);
+    ret = config.AddItem(AAFwk::GlobalConfigurationKey::SYSTEM_FONT_WEIGHT_SCALE, fontWeightScaleText);
     if (!ret) {
-        LOGE("AddItem failed, fontWeightScale = %{public}s", fontWeightScale.c_str());
+        LOGE("AddItem failed, fontWeightScale = %{public}s", fontWeightScaleText.c_str());
         return INVALID_ARG;
     }
 
@@ -903,14 +1180,17 @@ int32_t UiAppearanceAbility::OnSetFontWeightScale(const AccountContext& context,
         if (!UpdateConfiguration(config, context.userId, effectiveUserIds)) {
             return SYS_ERR;
         }
-        SetParameterWrap(FONT_Weight_SCAL_FOR_USER0, fontWeightScale);
+        SetParameterWrap(FONT_Weight_SCAL_FOR_USER0, fontWeightScaleText);
+        int32_t result = SUCCEEDED;
         for (const int32_t effectiveUserId : effectiveUserIds) {
             if (ConfigureFontWeightScalePersistence(
                 GetForegroundAccountContext(effectiveUserId), fontWeightScale) != SUCCEEDED) {
-                return SYS_ERR;
+                result = SYS_ERR;
+                break;
             }
         }
-        return SUCCEEDED;
+        PublishAppearanceChange();
+        return result;
     }
 #endif
 
@@ -918,20 +1198,23 @@ int32_t UiAppearanceAbility::OnSetFontWeightScale(const AccountContext& context,
         return SYS_ERR;
     }
 
-    SetParameterWrap(FONT_Weight_SCAL_FOR_USER0, fontWeightScale);
-    return ConfigureFontWeightScalePersistence(context, fontWeightScale);
+    SetParameterWrap(FONT_Weight_SCAL_FOR_USER0, fontWeightScaleText);
+    int32_t result = ConfigureFontWeightScalePersistence(context, fontWeightScale);
+    PublishAppearanceChange();
+    return result;
 }
 
 int32_t UiAppearanceAbility::ConfigureFontWeightScalePersistence(
-    const AccountContext& context, const std::string& fontWeightScale)
+    const AccountContext& context, const FontScale& fontWeightScale)
 {
     {
         std::lock_guard<std::mutex> guard(usersParamMutex_);
         usersParam_[context].fontWeightScale = fontWeightScale;
     }
+    StateSnapshot::GetInstance().RequestWrite();
 
     // persist to file: etc/para/ui_appearance.para
-    auto isSetPara = SetParameterWrap(FontWeightScaleParamAssignUser(context), fontWeightScale);
+    auto isSetPara = SetParameterWrap(FontWeightScaleParamAssignUser(context), fontWeightScale.ToString());
     if (!isSetPara) {
         LOGE("set parameter failed");
         return SYS_ERR;
@@ -941,6 +1224,7 @@ int32_t UiAppearanceAbility::ConfigureFontWeightScalePersistence(
 
 ErrCode UiAppearanceAbility::SetFontWeightScale(const std::string& fontWeightScale, int32_t& funcResult)
 {
+    MetricScope metricScope(MetricId::IPC_SET_FONT_WEIGHT_SCALE, &funcResult);
     // Verify permissions
     auto isCallingPerm = VerifyAccessToken(PERMISSION_UPDATE_CONFIGURATION);
     if (!isCallingPerm) {
@@ -948,23 +1232,49 @@ ErrCode UiAppearanceAbility::SetFontWeightScale(const std::string& fontWeightSca
         funcResult = PERMISSION_ERR;
         return SUCCEEDED;
     }
-    if (!fontWeightScale.empty()) {
-        funcResult = OnSetFontWeightScale(GetCallingAccountContext(), fontWeightScale);
-        return SUCCEEDED;
-    } else {
+    if (fontWeightScale.empty()) {
         LOGE("current fontWeightScale is empty!");
+        funcResult = SYS_ERR;
+        return SUCCEEDED;
     }
-    funcResult = SYS_ERR;
+    FontScale scale;
+    if (!FontScale::FromString(fontWeightScale, scale)) {
+        LOGE("invalid fontWeightScale:%{public}s", fontWeightScale.c_str());
+        funcResult = INVALID_ARG;
+        return SUCCEEDED;
+    }
+    funcResult = SubmitFontWeightScale(GetCallingAccountContext(), scale);
+    return SUCCEEDED;
+}
+
+ErrCode UiAppearanceAbility::SetFontWeightScaleValue(double fontWeightScale, int32_t& funcResult)
+{
+    MetricScope metricScope(MetricId::IPC_SET_FONT_WEIGHT_SCALE_VALUE, &funcResult);
+    // Verify permissions
+    auto isCallingPerm = VerifyAccessToken(PERMISSION_UPDATE_CONFIGURATION);
+    if (!isCallingPerm) {
+        LOGE("permission verification failed");
+        funcResult = PERMISSION_ERR;
+        return SUCCEEDED;
+    }
+    FontScale scale;
+    if (!FontScale::FromDouble(fontWeightScale, scale)) {
+        LOGE("invalid fontWeightScale:%{public}f", fontWeightScale);
+        funcResult = INVALID_ARG;
+        return SUCCEEDED;
+    }
+    funcResult = SubmitFontWeightScale(GetCallingAccountContext(), scale);
     return SUCCEEDED;
 }
 
 ErrCode UiAppearanceAbility::GetFontWeightScale(std::string& fontWeightScale, int32_t& funcResult)
 {
+    MetricScope metricScope(MetricId::IPC_GET_FONT_WEIGHT_SCALE, &funcResult);
     {
         std::lock_guard<std::mutex> guard(usersParamMutex_);
         auto it = usersParam_.find(GetCallingAccountContext());
         if (it != usersParam_.end()) {
-            fontWeightScale = it->second.fontWeightScale;
+            fontWeightScale = it->second.fontWeightScale.ToString();
         } else {
             fontWeightScale = BASE_SCALE;
         }
@@ -975,8 +1285,22 @@ ErrCode UiAppearanceAbility::GetFontWeightScale(std::string& fontWeightScale, in
     return SUCCEEDED;
 }
 
+ErrCode UiAppearanceAbility::GetFontWeightScaleValue(double& fontWeightScale, int32_t& funcResult)
+{
+    MetricScope metricScope(MetricId::IPC_GET_FONT_WEIGHT_SCALE_VALUE, &funcResult);
+    {
+        std::lock_guard<std::mutex> guard(usersParamMutex_);
+        auto it = usersParam_.find(GetCallingAccountContext());
+        fontWeightScale = it != usersParam_.end() ? it->second.fontWeightScale.ToDouble() : BASE_SCALE_VALUE;
+    }
+    LOGD("get font weight scale :%{public}f", fontWeightScale);
+    funcResult = SUCCEEDED;
+    return SUCCEEDED;
+}
+
 ErrCode UiAppearanceAbility::SetSettingData(const std::string& key, const std::string& value, int32_t& funcResult)
 {
+    MetricScope metricScope(MetricId::IPC_SET_SETTING_DATA, &funcResult);
     auto selfToken = IPCSkeleton::GetCallingFullTokenID();
     if (!Security::AccessToken::TokenIdKit::IsSystemAppByFullTokenID(selfToken)) {
         return UiAppearanceAbilityErrCode::NOT_SYSTEM_APP;
@@ -1013,6 +1337,7 @@ void UiAppearanceAbility::UpdateSmartGestureModeCallback(bool isAutoMode, int32_
 void UiAppearanceAbility::UpdateDarkModeCallback(const bool isDarkMode, const int32_t userId)
 {
     AccountContext context = GetForegroundAccountContext(userId);
+    UI_APPEARANCE_TRACE_CONTEXT_SCOPE("UiAppearance.UpdateDarkModeCallback", context);
     bool ret = false;
     std::string paramValue;
     AppExecFwk::Configuration config;
@@ -1039,11 +1364,21 @@ void UiAppearanceAbility::UpdateDarkModeCallback(const bool isDarkMode, const in
         for (const int32_t effectiveUserId : effectiveUserIds) {
             ConfigurePersistence(isDarkMode, GetForegroundAccountContext(effectiveUserId), paramValue);
         }
+        PublishAppearanceChange();
         return;
     }
 
     SetParameterWrap(PERSIST_DARKMODE_KEY, paramValue);
     ConfigurePersistence(isDarkMode, context, paramValue);
+    PublishAppearanceChange();
+}
+
+void UiAppearanceAbility::PublishAppearanceChange()
+{
+    uint64_t generation = configGeneration_.fetch_add(1, std::memory_order_relaxed) + 1;
+    if (!SetParameterWrap(CONFIG_GENERATION_PARAM, std::to_string(generation))) {
+        LOGE("publish appearance change failed, generation:%{public}" PRIu64, generation);
+    }
 }
 
 std::vector<std::int32_t> UiAppearanceAbility::GetMultipleUsers()
@@ -1066,6 +1401,7 @@ void UiAppearanceAbility::ConfigurePersistence(
         std::lock_guard<std::mutex> guard(usersParamMutex_);
         usersParam_[context].darkMode = isDarkMode ? ALWAYS_DARK : ALWAYS_LIGHT;
     }
+    StateSnapshot::GetInstance().RequestWrite();
 
     if (!SetParameterWrap(DarkModeParamAssignUser(context), paramValue)) {
         LOGE("set parameter failed");
@@ -1080,6 +1416,7 @@ int32_t UiAppearanceAbility::ConfigurePersistence(
         std::lock_guard<std::mutex> guard(usersParamMutex_);
         usersParam_[context].darkMode = mode;
     }
+    StateSnapshot::GetInstance().RequestWrite();
 
     // persist to file: etc/para/ui_appearance.para
     auto isSetPara = SetParameterWrap(DarkModeParamAssignUser(context), paramValue);
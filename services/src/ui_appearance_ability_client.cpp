@@ -19,6 +19,7 @@
 #include "iservice_registry.h"
 #include "system_ability_definition.h"
 #include "ui_appearance_ability_proxy.h"
+#include "ui_appearance_cache.h"
 #include "ui_appearance_log.h"
 #include "xcollie/xcollie.h"
 #include "xcollie/xcollie_define.h"
@@ -59,6 +60,9 @@ int32_t UiAppearanceAbilityClient::SetDarkMode(DarkMode mode)
     if (res != ERR_OK) {
         return UiAppearanceAbilityErrCode::SYS_ERR;
     }
+    if (funcRes == UiAppearanceAbilityErrCode::SUCCEEDED) {
+        UiAppearanceCache::GetInstance().StoreDarkMode(mode);
+    }
     return funcRes;
 }
 
@@ -87,6 +91,9 @@ int32_t UiAppearanceAbilityClient::SetFontScale(std::string &fontScale)
     if (res != ERR_OK) {
         return UiAppearanceAbilityErrCode::SYS_ERR;
     }
+    if (funcRes == UiAppearanceAbilityErrCode::SUCCEEDED) {
+        UiAppearanceCache::GetInstance().Invalidate();
+    }
     return funcRes;
 }
 
@@ -118,6 +125,9 @@ int32_t UiAppearanceAbilityClient::SetFontWeightScale(std::string &fontWeightSca
     if (res != ERR_OK) {
         return UiAppearanceAbilityErrCode::SYS_ERR;
     }
+    if (funcRes == UiAppearanceAbilityErrCode::SUCCEEDED) {
+        UiAppearanceCache::GetInstance().Invalidate();
+    }
     return funcRes;
 }
 
@@ -149,6 +159,70 @@ int32_t UiAppearanceAbilityClient::SetSettingData(std::string key, std::string v
     return funcRes;
 }
 
+int32_t UiAppearanceAbilityClient::GetFontScaleValue(double& fontScale)
+{
+    if (!GetUiAppearanceServiceProxy()) {
+        LOGE("GetFontScaleValue quit because redoing CreateUiAppearanceServiceProxy failed.");
+        return UiAppearanceAbilityErrCode::SYS_ERR;
+    }
+    int id = HiviewDFX::XCollie::GetInstance().SetTimer(
+        "GetFontScaleValue", 10, nullptr, nullptr, HiviewDFX::XCOLLIE_FLAG_LOG);
+    int32_t funcRes = -1;
+    auto res = GetUiAppearanceServiceProxy()->GetFontScaleValue(fontScale, funcRes);
+    HiviewDFX::XCollie::GetInstance().CancelTimer(id);
+    if (res != ERR_OK) {
+        return UiAppearanceAbilityErrCode::SYS_ERR;
+    }
+    return funcRes;
+}
+
+int32_t UiAppearanceAbilityClient::SetFontScaleValue(double fontScale)
+{
+    if (!GetUiAppearanceServiceProxy()) {
+        LOGE("SetFontScaleValue quit because redoing CreateUiAppearanceServiceProxy failed.");
+        return UiAppearanceAbilityErrCode::SYS_ERR;
+    }
+    int32_t funcRes = -1;
+    auto res = GetUiAppearanceServiceProxy()->SetFontScaleValue(fontScale, funcRes);
+    if (res != ERR_OK) {
+        return UiAppearanceAbilityErrCode::SYS_ERR;
+    }
+    if (funcRes == UiAppearanceAbilityErrCode::SUCCEEDED) {
+        UiAppearanceCache::GetInstance().StoreFontScale(fontScale);
+    }
+    return funcRes;
+}
+
+int32_t UiAppearanceAbilityClient::GetFontWeightScaleValue(double& fontWeightScale)
+{
+    if (!GetUiAppearanceServiceProxy()) {
+        LOGE("GetFontWeightScaleValue quit because redoing CreateUiAppearanceServiceProxy failed.");
+        return UiAppearanceAbilityErrCode::SYS_ERR;
+    }
+    int32_t funcRes = -1;
+    auto res = GetUiAppearanceServiceProxy()->GetFontWeightScaleValue(fontWeightScale, funcRes);
+    if (res != ERR_OK) {
+        return UiAppearanceAbilityErrCode::SYS_ERR;
+    }
+    return funcRes;
+}
+
+int32_t UiAppearanceAbilityClient::SetFontWeightScaleValue(double fontWeightScale)
+{
+    if (!GetUiAppearanceServiceProxy()) {
+        LOGE("SetFontWeightScaleValue quit because redoing CreateUiAppearanceServiceProxy failed.");
+        return UiAppearanceAbilityErrCode::SYS_ERR;
+    }
+    int32_t funcRes = -1;
+    auto res = GetUiAppearanceServiceProxy()->SetFontWeightScaleValue(fontWeightScale, funcRes);
+    if (res != ERR_OK) {
+        return UiAppearanceAbilityErrCode::SYS_ERR;
+    }
+    if (funcRes == UiAppearanceAbilityErrCode::SUCCEEDED) {
+        UiAppearanceCache::GetInstance().StoreFontWeightScale(fontWeightScale);
+    }
+    return funcRes;
+}
 
 sptr<IUiAppearanceAbility> UiAppearanceAbilityClient::CreateUiAppearanceServiceProxy()
 {
@@ -180,8 +254,12 @@ sptr<IUiAppearanceAbility> UiAppearanceAbilityClient::CreateUiAppearanceServiceP
 void UiAppearanceAbilityClient::OnRemoteSaDied(const wptr<IRemoteObject>& remote)
 {
     // Used for new connections after the service may be disconnected.
-    std::lock_guard guard(serviceProxyLock_);
-    uiAppearanceServiceProxy_ = CreateUiAppearanceServiceProxy();
+    {
+        std::lock_guard guard(serviceProxyLock_);
+        uiAppearanceServiceProxy_ = CreateUiAppearanceServiceProxy();
+    }
+    // The restarted service may have missed changes, and its notification may predate the reconnection.
+    UiAppearanceCache::GetInstance().Invalidate();
 }
 
 void UiAppearanceDeathRecipient::OnRemoteDied(const wptr<IRemoteObject>& object)
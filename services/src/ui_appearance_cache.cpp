@@ -0,0 +1,337 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ui_appearance_cache.h"
+
+#include <cinttypes>
+#include <vector>
+
+#include "font_scale.h"
+#include "syspara/parameter.h"
+#include "ui_appearance_ability_client.h"
+#include "ui_appearance_log.h"
+
+namespace OHOS::ArkUi::UiAppearance {
+namespace {
+// Merges the notifications of one multi-user change into a single refresh.
+constexpr uint32_t REFRESH_DEBOUNCE_MS = 10;
+// A refresh stores three values one by one; a short window delivers them to listeners as one change.
+constexpr uint32_t NOTIFY_DEBOUNCE_MS = 5;
+} // namespace
+
+UiAppearanceCache& UiAppearanceCache::GetInstance()
+{
+    static UiAppearanceCache instance;
+    return instance;
+}
+
+UiAppearanceCache::~UiAppearanceCache()
+{
+    RemoveParameterWatcher(CONFIG_GENERATION_PARAM, OnGenerationChanged, this);
+}
+
+void UiAppearanceCache::Prefetch()
+{
+    EnsureWatching();
+    Invalidate();
+}
+
+int32_t UiAppearanceCache::GetDarkMode()
+{
+    EnsureWatching();
+    if (!darkMode_.isValid.load(std::memory_order_acquire)) {
+        int32_t ret = FetchDarkMode();
+        if (ret != SUCCEEDED) {
+            return ret;
+        }
+    }
+    ScheduleRefreshIfStale();
+    return darkMode_.value.load(std::memory_order_relaxed);
+}
+
+int32_t UiAppearanceCache::GetFontScale(double& fontScale)
+{
+    EnsureWatching();
+    if (!fontScale_.isValid.load(std::memory_order_acquire)) {
+        int32_t ret = FetchFontScale();
+        if (ret != SUCCEEDED) {
+            return ret;
+        }
+    }
+    ScheduleRefreshIfStale();
+    fontScale = fontScale_.value.load(std::memory_order_relaxed);
+    return SUCCEEDED;
+}
+
+int32_t UiAppearanceCache::GetFontWeightScale(double& fontWeightScale)
+{
+    EnsureWatching();
+    if (!fontWeightScale_.isValid.load(std::memory_order_acquire)) {
+        int32_t ret = FetchFontWeightScale();
+        if (ret != SUCCEEDED) {
+            return ret;
+        }
+    }
+    ScheduleRefreshIfStale();
+    fontWeightScale = fontWeightScale_.value.load(std::memory_order_relaxed);
+    return SUCCEEDED;
+}
+
+int32_t UiAppearanceCache::Refresh()
+{
+    EnsureWatching();
+    uint64_t generation = notifiedGeneration_.load(std::memory_order_acquire);
+    int32_t darkModeRet = FetchDarkMode();
+    int32_t fontScaleRet = FetchFontScale();
+    int32_t fontWeightScaleRet = FetchFontWeightScale();
+    // A failed fetch is retried on the next notification or after MAX_STALENESS, not on every read.
+    fetchedGeneration_.store(generation, std::memory_order_release);
+    fetchedTimeMs_.store(NowMs(), std::memory_order_release);
+    ScheduleNotify();
+    if (darkModeRet != SUCCEEDED) {
+        return darkModeRet;
+    }
+    return fontScaleRet != SUCCEEDED ? fontScaleRet : fontWeightScaleRet;
+}
+
+void UiAppearanceCache::Invalidate()
+{
+    notifiedGeneration_.fetch_add(1, std::memory_order_acq_rel);
+    // Processes that never read through the cache get no worker; the next read sees the bumped generation anyway.
+    if (!isWatching_.load(std::memory_order_acquire)) {
+        return;
+    }
+    if (!isRefreshScheduled_.exchange(true, std::memory_order_acq_rel)) {
+        refreshTask_->Post();
+    }
+}
+
+bool UiAppearanceCache::PeekSnapshot(AppearanceSnapshot& snapshot)
+{
+    EnsureWatching();
+    if (!LoadSnapshot(snapshot)) {
+        Invalidate();
+        return false;
+    }
+    ScheduleRefreshIfStale();
+    std::lock_guard<std::mutex> guard(listenersMutex_);
+    snapshot.version = notifiedSnapshot_.version;
+    return true;
+}
+
+uint64_t UiAppearanceCache::AddChangeListener(const ChangeListener& listener)
+{
+    EnsureWatching();
+    uint64_t id = 0;
+    {
+        std::lock_guard<std::mutex> guard(listenersMutex_);
+        // Values already cached are not a change for a new listener; it reads them through PeekSnapshot. Without
+        // listeners nothing was compared against notifiedSnapshot_, so it is rebased on the first one.
+        if (listeners_.empty() || !hasNotifiedSnapshot_) {
+            hasNotifiedSnapshot_ = LoadSnapshot(notifiedSnapshot_);
+        }
+        id = nextListenerId_++;
+        listeners_.emplace(id, listener);
+        hasListeners_.store(true, std::memory_order_release);
+    }
+    ScheduleRefreshIfStale();
+    return id;
+}
+
+bool UiAppearanceCache::RemoveChangeListener(const uint64_t id)
+{
+    {
+        std::lock_guard<std::mutex> guard(listenersMutex_);
+        if (listeners_.erase(id) == 0) {
+            return false;
+        }
+        hasListeners_.store(!listeners_.empty(), std::memory_order_release);
+    }
+    if (notifyThreadId_.load(std::memory_order_acquire) != std::this_thread::get_id()) {
+        // Wait out a round that may have copied this listener before it was erased.
+        std::lock_guard<std::mutex> guard(notifyMutex_);
+    }
+    return true;
+}
+
+void UiAppearanceCache::StoreDarkMode(const DarkMode mode)
+{
+    darkMode_.value.store(mode, std::memory_order_relaxed);
+    darkMode_.isValid.store(true, std::memory_order_release);
+    ScheduleNotify();
+}
+
+void UiAppearanceCache::StoreFontScale(const double fontScale)
+{
+    // Keep what the service keeps, which is the scale rounded to millionths.
+    FontScale scale;
+    if (!FontScale::FromDouble(fontScale, scale)) {
+        return;
+    }
+    fontScale_.value.store(scale.ToDouble(), std::memory_order_relaxed);
+    fontScale_.isValid.store(true, std::memory_order_release);
+    ScheduleNotify();
+}
+
+void UiAppearanceCache::StoreFontWeightScale(const double fontWeightScale)
+{
+    FontScale scale;
+    if (!FontScale::FromDouble(fontWeightScale, scale)) {
+        return;
+    }
+    fontWeightScale_.value.store(scale.ToDouble(), std::memory_order_relaxed);
+    fontWeightScale_.isValid.store(true, std::memory_order_release);
+    ScheduleNotify();
+}
+
+void UiAppearanceCache::OnGenerationChanged(const char* key, const char* value, void* context)
+{
+    auto* cache = static_cast<UiAppearanceCache*>(context);
+    if (cache == nullptr) {
+        return;
+    }
+    LOGD("appearance changed, generation:%{public}s", value == nullptr ? "" : value);
+    cache->Invalidate();
+}
+
+int64_t UiAppearanceCache::NowMs()
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void UiAppearanceCache::EnsureWatching()
+{
+    std::call_once(watchOnce_, [this]() {
+        refreshTask_ = std::make_unique<DebounceTask>("AppearanceCacheRefresh", REFRESH_DEBOUNCE_MS,
+            [this](uint32_t) {
+                isRefreshScheduled_.store(false, std::memory_order_release);
+                Refresh();
+            });
+        notifyTask_ = std::make_unique<DebounceTask>("AppearanceCacheNotify", NOTIFY_DEBOUNCE_MS,
+            [this](uint32_t) { NotifyIfChanged(); });
+        int32_t ret = WatchParameter(CONFIG_GENERATION_PARAM, OnGenerationChanged, this);
+        if (ret != 0) {
+            LOGW("watch %{public}s failed: %{public}d, staleness falls back to %{public}lld ms",
+                CONFIG_GENERATION_PARAM, ret, static_cast<long long>(MAX_STALENESS.count()));
+        }
+        isWatching_.store(true, std::memory_order_release);
+    });
+}
+
+bool UiAppearanceCache::LoadSnapshot(AppearanceSnapshot& snapshot) const
+{
+    if (!darkMode_.isValid.load(std::memory_order_acquire) || !fontScale_.isValid.load(std::memory_order_acquire) ||
+        !fontWeightScale_.isValid.load(std::memory_order_acquire)) {
+        return false;
+    }
+    snapshot.darkMode = static_cast<DarkMode>(darkMode_.value.load(std::memory_order_relaxed));
+    snapshot.fontScale = fontScale_.value.load(std::memory_order_relaxed);
+    snapshot.fontWeightScale = fontWeightScale_.value.load(std::memory_order_relaxed);
+    return true;
+}
+
+void UiAppearanceCache::ScheduleNotify()
+{
+    // hasListeners_ is only set after EnsureWatching, so notifyTask_ exists whenever it reads true.
+    if (hasListeners_.load(std::memory_order_acquire)) {
+        notifyTask_->Post();
+    }
+}
+
+void UiAppearanceCache::NotifyIfChanged()
+{
+    std::lock_guard<std::mutex> notifyGuard(notifyMutex_);
+    AppearanceSnapshot snapshot;
+    std::vector<ChangeListener> listeners;
+    {
+        std::lock_guard<std::mutex> guard(listenersMutex_);
+        if (!LoadSnapshot(snapshot)) {
+            return;
+        }
+        if (hasNotifiedSnapshot_ && snapshot.darkMode == notifiedSnapshot_.darkMode &&
+            snapshot.fontScale == notifiedSnapshot_.fontScale &&
+            snapshot.fontWeightScale == notifiedSnapshot_.fontWeightScale) {
+            return;
+        }
+        snapshot.version = notifiedSnapshot_.version + 1;
+        notifiedSnapshot_ = snapshot;
+        hasNotifiedSnapshot_ = true;
+        listeners.reserve(listeners_.size());
+        for (const auto& [id, listener] : listeners_) {
+            listeners.push_back(listener);
+        }
+    }
+    LOGI("appearance change %{public}" PRIu64 " to %{public}zu listeners", snapshot.version, listeners.size());
+    notifyThreadId_.store(std::this_thread::get_id(), std::memory_order_release);
+    for (const auto& listener : listeners) {
+        listener(snapshot);
+    }
+    notifyThreadId_.store(std::thread::id(), std::memory_order_release);
+}
+
+bool UiAppearanceCache::IsStale() const
+{
+    if (notifiedGeneration_.load(std::memory_order_acquire) != fetchedGeneration_.load(std::memory_order_acquire)) {
+        return true;
+    }
+    return NowMs() - fetchedTimeMs_.load(std::memory_order_acquire) > MAX_STALENESS.count();
+}
+
+void UiAppearanceCache::ScheduleRefreshIfStale()
+{
+    if (!IsStale() || isRefreshScheduled_.exchange(true, std::memory_order_acq_rel)) {
+        return;
+    }
+    refreshTask_->Post();
+}
+
+int32_t UiAppearanceCache::FetchDarkMode()
+{
+    int32_t mode = UiAppearanceAbilityClient::GetInstance()->GetDarkMode();
+    if (mode != DarkMode::ALWAYS_DARK && mode != DarkMode::ALWAYS_LIGHT) {
+        LOGE("fetch dark mode failed: %{public}d", mode);
+        return mode == DarkMode::UNKNOWN ? SYS_ERR : mode;
+    }
+    StoreDarkMode(static_cast<DarkMode>(mode));
+    return SUCCEEDED;
+}
+
+int32_t UiAppearanceCache::FetchFontScale()
+{
+    double fontScale = 0;
+    int32_t ret = UiAppearanceAbilityClient::GetInstance()->GetFontScaleValue(fontScale);
+    if (ret != SUCCEEDED) {
+        LOGE("fetch font scale failed: %{public}d", ret);
+        return ret;
+    }
+    fontScale_.value.store(fontScale, std::memory_order_relaxed);
+    fontScale_.isValid.store(true, std::memory_order_release);
+    return SUCCEEDED;
+}
+
+int32_t UiAppearanceCache::FetchFontWeightScale()
+{
+    double fontWeightScale = 0;
+    int32_t ret = UiAppearanceAbilityClient::GetInstance()->GetFontWeightScaleValue(fontWeightScale);
+    if (ret != SUCCEEDED) {
+        LOGE("fetch font weight scale failed: %{public}d", ret);
+        return ret;
+    }
+    fontWeightScale_.value.store(fontWeightScale, std::memory_order_relaxed);
+    fontWeightScale_.isValid.store(true, std::memory_order_release);
+    return SUCCEEDED;
+}
+} // namespace OHOS::ArkUi::UiAppearance
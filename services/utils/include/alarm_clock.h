@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef UI_APPEARANCE_UTILS_ALARM_CLOCK_H
+#define UI_APPEARANCE_UTILS_ALARM_CLOCK_H
+
+#include <cstdint>
+#include <ctime>
+#include <memory>
+
+namespace OHOS::ArkUi::UiAppearance {
+/**
+ * Wall clock and local time conversion used by the dark mode schedule. The system implementation is used unless a
+ * test replaces it, which lets the schedule be replayed against simulated time, DST rules and time zones.
+ */
+class AlarmClock {
+public:
+    virtual ~AlarmClock() = default;
+
+    // Milliseconds since the epoch.
+    virtual uint64_t GetCurrentTimestamp() const = 0;
+
+    virtual bool GetLocalTime(std::time_t time, std::tm& localTime) const = 0;
+
+    // Same contract as std::mktime: fields are normalized and tm_isdst < 0 lets the clock resolve DST.
+    virtual std::time_t MakeTime(std::tm& localTime) const = 0;
+
+    static std::shared_ptr<AlarmClock> GetInstance();
+
+    // Passing nullptr restores the system clock.
+    static void SetInstance(const std::shared_ptr<AlarmClock>& clock);
+};
+
+class SystemAlarmClock final : public AlarmClock {
+public:
+    uint64_t GetCurrentTimestamp() const override;
+
+    bool GetLocalTime(std::time_t time, std::tm& localTime) const override;
+
+    std::time_t MakeTime(std::tm& localTime) const override;
+};
+} // namespace OHOS::ArkUi::UiAppearance
+#endif // UI_APPEARANCE_UTILS_ALARM_CLOCK_H
@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef UI_APPEARANCE_UTILS_ALARM_TIMER_BACKEND_H
+#define UI_APPEARANCE_UTILS_ALARM_TIMER_BACKEND_H
+
+#include <cstdint>
+#include <functional>
+#include <string>
+
+namespace OHOS::ArkUi::UiAppearance {
+/**
+ * One-shot wall clock alarms used by AlarmTimerManager. A timer id of 0 means failure.
+ */
+class AlarmTimerBackend {
+public:
+    virtual ~AlarmTimerBackend() = default;
+
+    virtual uint64_t CreateTimer(const std::function<void()>& callback, const std::string& timerName) = 0;
+
+    // triggerTime is in milliseconds since the epoch.
+    virtual bool StartTimer(uint64_t timerId, uint64_t triggerTime) = 0;
+
+    virtual bool StopTimer(uint64_t timerId) = 0;
+
+    virtual bool DestroyTimer(uint64_t timerId) = 0;
+};
+
+class TimeServiceTimerBackend final : public AlarmTimerBackend {
+public:
+    uint64_t CreateTimer(const std::function<void()>& callback, const std::string& timerName) override;
+
+    bool StartTimer(uint64_t timerId, uint64_t triggerTime) override;
+
+    bool StopTimer(uint64_t timerId) override;
+
+    bool DestroyTimer(uint64_t timerId) override;
+};
+} // namespace OHOS::ArkUi::UiAppearance
+#endif // UI_APPEARANCE_UTILS_ALARM_TIMER_BACKEND_H
@@ -19,18 +19,39 @@
 #include <array>
 #include <map>
 #include <cstdint>
-
-#include "alarm_timer.h"
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "alarm_clock.h"
+#include "alarm_timer_backend.h"
+#include "dump_buffer.h"
 #include "errors.h"
 
 namespace OHOS::ArkUi::UiAppearance {
 constexpr uint32_t TRIGGER_ARRAY_SIZE = 2;
 
+enum class AlarmTaskType : uint8_t {
+    START = 0,
+    END,
+    RECALCULATION,
+    COUNT,
+};
+
+/**
+ * Multiplexes the start, end and recalculation timers of every user onto a single TimeService alarm. Tasks are kept
+ * in a min-heap ordered by trigger time; only the earliest deadline is armed in TimeService, and due tasks are
+ * dispatched locally when it fires. All tasks repeat daily, like the TimeService timers they replace.
+ * Wall clock reads go through AlarmClock and alarms through AlarmTimerBackend, so both can be simulated.
+ */
 class AlarmTimerManager {
 public:
-    AlarmTimerManager() = default;
+    AlarmTimerManager();
 
-    virtual ~AlarmTimerManager() = default;
+    explicit AlarmTimerManager(const std::shared_ptr<AlarmTimerBackend>& backend);
+
+    virtual ~AlarmTimerManager();
 
     ErrCode SetScheduleTime(uint64_t startTime, uint64_t endTime, uint64_t userId,
         const std::function<void()>& startCallback, const std::function<void()>& endCallback);
@@ -46,30 +67,73 @@ public:
     static void SetTimerTriggerTime(uint64_t startTime, uint64_t endTime,
         std::array<uint64_t, TRIGGER_ARRAY_SIZE>& triggerTimeInterval);
 
+    // Trigger times relative to curTimestamp (ms) in the local time of clock, resolving DST per day.
+    static void SetTimerTriggerTime(const AlarmClock& clock, uint64_t curTimestamp, uint64_t startTime,
+        uint64_t endTime, std::array<uint64_t, TRIGGER_ARRAY_SIZE>& triggerTimeInterval);
+
     void SetRecalculationTimer(uint64_t userId, const std::function<void()>& callback);
 
     void ClearRecalculationTimer(uint64_t userId);
 
-    void Dump();
+    void Dump(DumpBuffer& out);
 
 private:
-    std::map<uint64_t, std::array<uint64_t, TRIGGER_ARRAY_SIZE>> timerIdMap_;
+    static constexpr size_t TASK_TYPE_COUNT = static_cast<size_t>(AlarmTaskType::COUNT);
+
+    struct ScheduledTask {
+        uint64_t triggerTime = 0;
+        uint64_t sequence = 0;
+        std::function<void()> callback;
+    };
+
+    // A heap node is stale once its task has been cleared or rescheduled, i.e. the sequence no longer matches.
+    struct HeapNode {
+        uint64_t triggerTime = 0;
+        uint64_t sequence = 0;
+        uint64_t userId = 0;
+        AlarmTaskType type = AlarmTaskType::START;
+
+        bool operator>(const HeapNode& other) const
+        {
+            return triggerTime != other.triggerTime ? triggerTime > other.triggerTime : sequence > other.sequence;
+        }
+    };
+
+    std::shared_ptr<AlarmTimerBackend> backend_;
+    std::map<uint64_t, std::array<ScheduledTask, TASK_TYPE_COUNT>> scheduledTaskMap_;
     std::map<uint64_t, std::array<uint64_t, TRIGGER_ARRAY_SIZE>> initialSetupTimeMap_;
-    std::map<uint64_t, uint64_t> recalculationTimerIdMap_;
+    std::vector<HeapNode> taskHeap_;
+    size_t scheduledTaskCount_ = 0;
+    uint64_t nextSequence_ = 0;
+    uint64_t systemTimerId_ = 0;
+    uint64_t armedTriggerTime_ = 0;
+    uint64_t armCount_ = 0;
+    uint64_t dispatchCount_ = 0;
     std::mutex timerMapMutex_;
 
-    static void RestartTimerByTimerId(uint64_t timerId, uint64_t time);
-
-    static uint64_t InitTimer(uint64_t time, const std::function<void()>& callback, const std::string timerName);
+    void ClearTimer(uint64_t id);
 
-    static uint64_t UpdateTimer(uint64_t id, uint64_t time,
-        const std::function<void()>& callback, const std::string timerName);
+    static uint64_t GetCurrentTimestamp();
 
-    static void ClearTimer(uint64_t id);
+    uint64_t GetNextTriggerTime(uint64_t userId, AlarmTaskType type, const ScheduledTask& task, uint64_t dueTime);
 
     void RecordInitialSetupTime(uint64_t startTime, uint64_t endTime, uint64_t userId);
 
-    void SetTimer(int8_t index, uint64_t userId, uint64_t time, const std::function<void()>& callback);
+    void SetTask(uint64_t userId, AlarmTaskType type, uint64_t time, const std::function<void()>& callback);
+
+    void RemoveTask(uint64_t userId, AlarmTaskType type);
+
+    bool HasTask(uint64_t userId, AlarmTaskType type);
+
+    bool IsStaleNode(const HeapNode& node) const;
+
+    void RebuildHeap();
+
+    bool ArmEarliestTask();
+
+    void OnAlarmTrigger();
+
+    void CollectDueTasks(uint64_t now, std::vector<std::function<void()>>& callbacks);
 
     bool RestartTimerByUserId(uint64_t userId);
 };
@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef UI_APPEARANCE_UTILS_DARK_SCHEDULE_H
+#define UI_APPEARANCE_UTILS_DARK_SCHEDULE_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace OHOS::ArkUi::UiAppearance {
+/**
+ * A dark-mode day compiled into one bit per minute since local midnight. Compiling walks the day once; afterwards
+ * "is it dark" is a bit lookup and the wrap-around arithmetic lives only in IsDarkMinute. Each context keeps its own
+ * compiled schedule next to its settings and recompiles it only when the times change.
+ */
+class DarkSchedule final {
+public:
+    static constexpr int32_t MINUTES_PER_DAY = 24 * 60;
+    static constexpr int32_t SECONDS_PER_MINUTE = 60;
+
+    // Uses the settings encoding: minutes since midnight, an endTime above MINUTES_PER_DAY ends on the next day.
+    DarkSchedule(int64_t startTime, int64_t endTime);
+
+    // The interval rule itself, for one-off checks that do not keep a compiled schedule.
+    static bool IsDarkMinute(int64_t startTime, int64_t endTime, int32_t minuteOfDay);
+
+    static uint64_t GetCompileCount();
+
+    bool IsDark(int32_t minuteOfDay) const;
+
+    // An instant exactly on a minute boundary is dark only if the minutes on both sides are dark, so it is light
+    // at the very second the schedule flips either way.
+    bool IsDarkAtSecond(int32_t secondOfDay) const;
+
+    int64_t GetStartTime() const;
+
+    int64_t GetEndTime() const;
+
+private:
+    static constexpr int32_t BITS_PER_WORD = 64;
+    static constexpr int32_t WORD_COUNT = (MINUTES_PER_DAY + BITS_PER_WORD - 1) / BITS_PER_WORD;
+
+    static int32_t NormalizeMinute(int32_t minute);
+
+    void SetDark(int32_t minuteOfDay);
+
+    int64_t startTime_ = 0;
+    int64_t endTime_ = 0;
+    std::array<uint64_t, WORD_COUNT> darkBits_ {};
+
+    static std::atomic<uint64_t> compileCount_;
+};
+} // namespace OHOS::ArkUi::UiAppearance
+#endif // UI_APPEARANCE_UTILS_DARK_SCHEDULE_H
@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef UI_APPEARANCE_UTILS_DEBOUNCE_TASK_H
+#define UI_APPEARANCE_UTILS_DEBOUNCE_TASK_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "nocopyable.h"
+
+namespace OHOS::ArkUi::UiAppearance {
+/**
+ * Runs a task once for every burst of Post() calls. The first Post() opens a window of delayMs; every Post()
+ * that arrives before the window closes is merged into the same run. The task receives the number of merged posts.
+ */
+class DebounceTask final : public NoCopyable {
+public:
+    using TaskFunc = std::function<void(uint32_t mergedCount)>;
+
+    DebounceTask(const std::string& name, uint32_t delayMs, const TaskFunc& task);
+
+    ~DebounceTask() override;
+
+    void Post();
+
+    // Runs the pending task on the calling thread without waiting for the window to close. Waits for a run that is
+    // already in progress first, so it must not be called from the task itself.
+    void Flush();
+
+    uint64_t GetPostCount() const;
+
+    uint64_t GetRunCount() const;
+
+private:
+    void WorkLoop();
+
+    void RunTask(uint32_t mergedCount);
+
+    std::string name_;
+    std::chrono::milliseconds delay_;
+    TaskFunc task_;
+
+    // Held across taking the pending posts and running the task, by both the worker and Flush. Taken before mutex_.
+    std::mutex runMutex_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::thread worker_;
+    std::chrono::steady_clock::time_point deadline_;
+    uint32_t pendingCount_ = 0;
+    bool stopped_ = false;
+
+    std::atomic<uint64_t> postCount_ = 0;
+    std::atomic<uint64_t> runCount_ = 0;
+};
+} // namespace OHOS::ArkUi::UiAppearance
+#endif // UI_APPEARANCE_UTILS_DEBOUNCE_TASK_H
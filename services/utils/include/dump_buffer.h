@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef UI_APPEARANCE_UTILS_DUMP_BUFFER_H
+#define UI_APPEARANCE_UTILS_DUMP_BUFFER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "nocopyable.h"
+
+namespace OHOS::ArkUi::UiAppearance {
+/**
+ * Fixed-size text buffer for hidumper output. The whole capacity is allocated up front and never grows, so
+ * formatting a dump does not allocate; output that does not fit is cut off and the dump ends with a truncation note.
+ */
+class DumpBuffer final : public NoCopyable {
+public:
+    static constexpr size_t DEFAULT_CAPACITY = 32 * 1024;
+
+    explicit DumpBuffer(size_t capacity = DEFAULT_CAPACITY);
+
+    ~DumpBuffer() override = default;
+
+    void Append(const char* format, ...) __attribute__((__format__(__printf__, 2, 3)));
+
+    const char* GetData() const;
+
+    size_t GetSize() const;
+
+    bool IsTruncated() const;
+
+    // Writes everything appended so far, retrying partial writes. Returns false when the fd rejects the write.
+    bool WriteTo(int32_t fd) const;
+
+private:
+    std::vector<char> data_;
+    size_t size_ = 0;
+    bool isTruncated_ = false;
+};
+} // namespace OHOS::ArkUi::UiAppearance
+#endif // UI_APPEARANCE_UTILS_DUMP_BUFFER_H
@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef UI_APPEARANCE_UTILS_EVENT_TRACE_H
+#define UI_APPEARANCE_UTILS_EVENT_TRACE_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "dump_buffer.h"
+#include "nocopyable.h"
+
+namespace OHOS::ArkUi::UiAppearance {
+enum class TraceEventType : uint16_t {
+    USER_SWITCHED = 0,
+    SUB_PROFILE_SWITCHED,
+    BOOT_COMPLETED,
+    TIME_CHANGED,
+    TIMEZONE_CHANGED,
+    SCREEN_ON,
+    SCREEN_OFF,
+    SETTING_CHANGED,
+    ALARM_TRIGGERED,
+    SCHEDULE_TIMER_FIRED,
+    RECALCULATION_TIMER_FIRED,
+    DARK_MODE_CHANGED,
+    UPDATE_CONFIGURATION,
+    COUNT,
+};
+
+struct TraceEvent {
+    uint64_t sequence = 0;
+    // steady_clock, so the order survives wall clock and time zone changes.
+    uint64_t timestampNs = 0;
+    TraceEventType type = TraceEventType::COUNT;
+    int32_t userId = -1;
+    int32_t subProfileId = -1;
+    int32_t value = 0;
+};
+
+/**
+ * Process-wide ring buffer of the last CAPACITY appearance events. Record() claims a slot with one fetch_add and
+ * publishes it with a per-slot sequence, so writers never lock or allocate; readers skip slots that are being
+ * written or were overwritten while being read. A writer stalled for a whole lap of the ring may still leave a
+ * mixed record behind, which is acceptable for a diagnostic trace.
+ */
+class EventTrace final : public NoCopyable {
+public:
+    static constexpr size_t CAPACITY = 512;
+    // Upper bounds of the Dump header and of one event line, so that a DumpBuffer of DUMP_CAPACITY holds a full ring.
+    static constexpr size_t DUMP_HEADER_MAX = 64;
+    static constexpr size_t DUMP_LINE_MAX = 128;
+    static constexpr size_t DUMP_CAPACITY = DUMP_HEADER_MAX + CAPACITY * DUMP_LINE_MAX;
+
+    static EventTrace& GetInstance();
+
+    void Record(TraceEventType type, int32_t userId = -1, int32_t subProfileId = -1, int32_t value = 0);
+
+    uint64_t GetRecordCount() const;
+
+    // Oldest first; at most CAPACITY events.
+    std::vector<TraceEvent> GetEvents() const;
+
+    // Appends the events oldest first, stamped with steady_clock seconds like the kernel log. Use a buffer of at
+    // least DUMP_CAPACITY to dump a full ring without truncation.
+    void Dump(DumpBuffer& out) const;
+
+    void Reset();
+
+    static const char* GetName(TraceEventType type);
+
+private:
+    struct Slot {
+        std::atomic<uint64_t> sequence = 0;
+        std::atomic<uint64_t> timestampNs = 0;
+        std::atomic<uint64_t> context = 0;
+        std::atomic<uint64_t> data = 0;
+    };
+
+    EventTrace() = default;
+
+    ~EventTrace() override = default;
+
+    template<typename Visitor>
+    void ForEach(const Visitor& visitor) const;
+
+    static_assert((CAPACITY & (CAPACITY - 1)) == 0, "CAPACITY must be a power of two");
+    std::array<Slot, CAPACITY> slots_;
+    std::atomic<uint64_t> next_ = 0;
+};
+} // namespace OHOS::ArkUi::UiAppearance
+#endif // UI_APPEARANCE_UTILS_EVENT_TRACE_H
@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef UI_APPEARANCE_UTILS_FILE_WATCHER_H
+#define UI_APPEARANCE_UTILS_FILE_WATCHER_H
+
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "nocopyable.h"
+
+namespace OHOS::ArkUi::UiAppearance {
+/**
+ * Watches one file through inotify on its parent directory, so that replacing the file by rename is seen as well as
+ * rewriting it in place, which is reported once the writer closes it. The file may still change while the callback
+ * reads it, so it must be read into a buffer, not mapped. The callback runs on the watcher thread, once per batch of
+ * events that touch the file.
+ */
+class FileWatcher final : public NoCopyable {
+public:
+    using Callback = std::function<void()>;
+
+    FileWatcher(const std::string& filePath, const Callback& callback);
+
+    ~FileWatcher() override;
+
+    bool Start();
+
+    void Stop();
+
+private:
+    void WatchLoop();
+
+    bool HandleEvents();
+
+    std::string directory_;
+    std::string fileName_;
+    Callback callback_;
+
+    std::mutex mutex_;
+    std::thread worker_;
+    int inotifyFd_ = -1;
+    int wakeFd_ = -1;
+};
+} // namespace OHOS::ArkUi::UiAppearance
+#endif // UI_APPEARANCE_UTILS_FILE_WATCHER_H
@@ -30,7 +30,13 @@ public:
     static bool LoadConfiguration(const std::string& path, nlohmann::json& jsonBuf,
         const std::string& defaultPath = "");
     static std::string GetConfigPath(const std::string& path, const std::string& defaultPath);
+    // Parses the file straight from a read-only mapping, without copying it into an intermediate buffer.
     static bool ReadFileInfoJson(const std::string &filePath, nlohmann::json &jsonBuf);
+    // Streams the mapped file through handler, so only the values the handler keeps are materialized. Set isMutable
+    // for a file that may change while it is parsed: it is then read into a buffer instead, because touching a mapping
+    // of a file truncated in place raises SIGBUS.
+    static bool SaxParseFile(const std::string &filePath, nlohmann::json_sax<nlohmann::json> &handler,
+        bool isMutable = false);
     static bool ReadFileToBuffer(const std::string &filePath, std::string &dataBuffer);
 };
 } // namespace OHOS::ArkUi::UiAppearance
@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef UI_APPEARANCE_UTILS_LATEST_VALUE_COMBINER_H
+#define UI_APPEARANCE_UTILS_LATEST_VALUE_COMBINER_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+#include "nocopyable.h"
+
+namespace OHOS::ArkUi::UiAppearance {
+/**
+ * Applies concurrent requests for one setting one at a time, latest value wins. A request that arrives while another
+ * is being applied waits; all requests that wait together are merged and only the last value among them is applied,
+ * once, by one of the waiting callers. Every caller returns the result of the apply that covered its request.
+ *
+ * When constructed with a maximum wait, a caller that is still waiting after it returns timeoutResult instead; its
+ * request stays merged and is applied anyway, by the next waiting caller or by the caller that was applying.
+ */
+template<typename T>
+class LatestValueCombiner final : public NoCopyable {
+public:
+    using ApplyFunc = std::function<int32_t(const T& value, uint32_t mergedCount)>;
+
+    LatestValueCombiner() = default;
+
+    LatestValueCombiner(std::chrono::milliseconds maxWait, int32_t timeoutResult)
+        : isWaitBounded_(true), maxWait_(maxWait), timeoutResult_(timeoutResult)
+    {}
+
+    ~LatestValueCombiner() override = default;
+
+    int32_t Submit(const T& value, const ApplyFunc& apply)
+    {
+        std::unique_lock lock(mutex_);
+        if (pending_ == nullptr) {
+            pending_ = std::make_shared<Batch>();
+        }
+        pending_->value = value;
+        ++pending_->mergedCount;
+        ++pending_->waiterCount;
+        submitCount_.fetch_add(1, std::memory_order_relaxed);
+        std::shared_ptr<Batch> batch = pending_;
+        auto isReady = [this, &batch]() { return batch->isDone || !isApplying_; };
+        if (!isWaitBounded_) {
+            cv_.wait(lock, isReady);
+        } else if (!cv_.wait_for(lock, maxWait_, isReady)) {
+            --batch->waiterCount;
+            timeoutCount_.fetch_add(1, std::memory_order_relaxed);
+            return timeoutResult_;
+        }
+        if (batch->isDone) {
+            return batch->result;
+        }
+        // Nobody is applying and this batch has not been taken, so this caller applies it for everyone in it.
+        isApplying_ = true;
+        int32_t result = ApplyPending(lock, apply);
+        // Batches whose callers all stopped waiting have nobody else to apply them.
+        while (pending_ != nullptr && pending_->waiterCount == 0) {
+            ApplyPending(lock, apply);
+        }
+        isApplying_ = false;
+        cv_.notify_all();
+        return result;
+    }
+
+    uint64_t GetSubmitCount() const
+    {
+        return submitCount_.load(std::memory_order_relaxed);
+    }
+
+    uint64_t GetApplyCount() const
+    {
+        return applyCount_.load(std::memory_order_relaxed);
+    }
+
+    uint64_t GetTimeoutCount() const
+    {
+        return timeoutCount_.load(std::memory_order_relaxed);
+    }
+
+private:
+    struct Batch {
+        T value {};
+        uint32_t mergedCount = 0;
+        uint32_t waiterCount = 0;
+        int32_t result = 0;
+        bool isDone = false;
+    };
+
+    // Called with mutex_ held and isApplying_ set; applies and completes the pending batch.
+    int32_t ApplyPending(std::unique_lock<std::mutex>& lock, const ApplyFunc& apply)
+    {
+        std::shared_ptr<Batch> batch = pending_;
+        pending_ = nullptr;
+        T latest = batch->value;
+        uint32_t mergedCount = batch->mergedCount;
+        lock.unlock();
+        int32_t result = apply(latest, mergedCount);
+        applyCount_.fetch_add(1, std::memory_order_relaxed);
+        lock.lock();
+        batch->result = result;
+        batch->isDone = true;
+        cv_.notify_all();
+        return result;
+    }
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::shared_ptr<Batch> pending_;
+    bool isApplying_ = false;
+    const bool isWaitBounded_ = false;
+    const std::chrono::milliseconds maxWait_ { 0 };
+    const int32_t timeoutResult_ = 0;
+
+    std::atomic<uint64_t> submitCount_ = 0;
+    std::atomic<uint64_t> applyCount_ = 0;
+    std::atomic<uint64_t> timeoutCount_ = 0;
+};
+} // namespace OHOS::ArkUi::UiAppearance
+#endif // UI_APPEARANCE_UTILS_LATEST_VALUE_COMBINER_H
@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef UI_APPEARANCE_UTILS_LOCAL_TIME_CACHE_H
+#define UI_APPEARANCE_UTILS_LOCAL_TIME_CACHE_H
+
+#include <atomic>
+#include <cstdint>
+#include <ctime>
+#include <mutex>
+
+#include "alarm_clock.h"
+#include "nocopyable.h"
+
+namespace OHOS::ArkUi::UiAppearance {
+/**
+ * Caches the start of the current local day and whether the UTC offset is constant around it, so schedule math
+ * turns into integer arithmetic instead of a tzfile lookup per call. Readers never block: the snapshot is published
+ * with a sequence counter, and a reader that races a refresh falls back to the reentrant clock calls.
+ * Days with a DST switch nearby always take the clock path. Invalidate() must be called on TIMEZONE_CHANGED.
+ */
+class LocalTimeCache final : public NoCopyable {
+public:
+    static LocalTimeCache& GetInstance();
+
+    // Wall clock seconds since local midnight.
+    int32_t GetSecondOfDay(const AlarmClock& clock, std::time_t time);
+
+    // The instant of local midnight of the day dayOffset days away from time, plus minutes of wall clock time.
+    std::time_t GetLocalTimestamp(const AlarmClock& clock, std::time_t time, int32_t dayOffset, int64_t minutes);
+
+    void Invalidate();
+
+    uint64_t GetRefreshCount() const;
+
+    // A hit is a read served from the snapshot; a miss refreshes it first.
+    uint64_t GetHitCount() const;
+
+    uint64_t GetMissCount() const;
+
+private:
+    LocalTimeCache() = default;
+
+    struct Snapshot {
+        std::time_t dayStart = 0;
+        std::time_t nextDayStart = 0;
+        std::time_t uniformFrom = 0;
+        std::time_t uniformUntil = 0;
+        bool uniform = false;
+    };
+
+    void Load(const AlarmClock& clock, std::time_t time, Snapshot& snapshot);
+
+    bool TryLoad(std::time_t time, Snapshot& snapshot) const;
+
+    void Refresh(const AlarmClock& clock, std::time_t time);
+
+    static std::time_t MakeLocalTime(const AlarmClock& clock, const std::tm& localTime, int32_t dayOffset,
+        int64_t minutes);
+
+    static bool GetUtcOffset(const AlarmClock& clock, std::time_t time, int64_t& utcOffset);
+
+    std::atomic<uint32_t> sequence_ = 0;
+    std::atomic<bool> valid_ = false;
+    std::atomic<std::time_t> dayStart_ = 0;
+    std::atomic<std::time_t> nextDayStart_ = 0;
+    std::atomic<std::time_t> uniformFrom_ = 0;
+    std::atomic<std::time_t> uniformUntil_ = 0;
+    std::atomic<bool> uniform_ = false;
+    std::atomic<uint64_t> refreshCount_ = 0;
+    std::atomic<uint64_t> hitCount_ = 0;
+    std::atomic<uint64_t> missCount_ = 0;
+    std::mutex refreshMutex_;
+};
+} // namespace OHOS::ArkUi::UiAppearance
+#endif // UI_APPEARANCE_UTILS_LOCAL_TIME_CACHE_H
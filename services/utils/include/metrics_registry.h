@@ -0,0 +1,160 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef UI_APPEARANCE_UTILS_METRICS_REGISTRY_H
+#define UI_APPEARANCE_UTILS_METRICS_REGISTRY_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#include "dump_buffer.h"
+#include "nocopyable.h"
+
+namespace OHOS::ArkUi::UiAppearance {
+enum class MetricId : uint32_t {
+    IPC_SET_DARK_MODE = 0,
+    IPC_GET_DARK_MODE,
+    IPC_SET_FONT_SCALE,
+    IPC_GET_FONT_SCALE,
+    IPC_SET_FONT_WEIGHT_SCALE,
+    IPC_GET_FONT_WEIGHT_SCALE,
+    IPC_SET_SETTING_DATA,
+    IPC_SET_FONT_SCALE_VALUE,
+    IPC_GET_FONT_SCALE_VALUE,
+    IPC_SET_FONT_WEIGHT_SCALE_VALUE,
+    IPC_GET_FONT_WEIGHT_SCALE_VALUE,
+    UPDATE_CONFIGURATION,
+    SETTING_DATA_GET,
+    SETTING_DATA_SET,
+    SETTING_DATA_SET_PAIR,
+    SETTING_DATA_REGISTER_OBSERVER,
+    SETTING_DATA_UNREGISTER_OBSERVER,
+    LOCATION_FETCH,
+    ALARM_TIMER_CALLBACK,
+    COUNT,
+};
+
+/**
+ * Lock-free log-linear latency histogram in microseconds, in the style of HdrHistogram: values below 8us get exact
+ * buckets, above that every power of two is split into 8 linear sub-buckets, so a bucket is never wider than 12.5%
+ * of its values. Values beyond the last power of two land in the last bucket; the exact maximum is kept separately.
+ */
+class MetricHistogram final : public NoCopyable {
+public:
+    static constexpr uint32_t SUB_BUCKET_BITS = 3;
+    static constexpr uint64_t SUB_BUCKET_COUNT = 1ULL << SUB_BUCKET_BITS;
+    // 2^27us is about 134s, far beyond any latency the service should see.
+    static constexpr uint32_t MAX_EXPONENT = 26;
+    static constexpr size_t BUCKET_COUNT = SUB_BUCKET_COUNT + (MAX_EXPONENT - SUB_BUCKET_BITS + 1) * SUB_BUCKET_COUNT;
+
+    MetricHistogram() = default;
+
+    ~MetricHistogram() override = default;
+
+    void Record(uint64_t latencyUs);
+
+    uint64_t GetCount() const;
+
+    uint64_t GetMaxLatency() const;
+
+    uint64_t GetTotalLatency() const;
+
+    // Upper bound of the bucket holding the given percentile (0 to 100], capped at the recorded maximum.
+    uint64_t GetPercentile(double percentile) const;
+
+    void Reset();
+
+    static size_t GetBucketIndex(uint64_t latencyUs);
+
+    // Largest value that falls into the bucket.
+    static uint64_t GetBucketUpperBound(size_t index);
+
+private:
+    std::array<std::atomic<uint64_t>, BUCKET_COUNT> buckets_ {};
+    std::atomic<uint64_t> count_ = 0;
+    std::atomic<uint64_t> totalUs_ = 0;
+    std::atomic<uint64_t> maxUs_ = 0;
+};
+
+/**
+ * Process-wide counters and latency histograms for the service's IPC methods and its calls into other services.
+ * Every metric is preallocated and indexed by MetricId, so recording never allocates or locks.
+ */
+class MetricsRegistry final : public NoCopyable {
+public:
+    static MetricsRegistry& GetInstance();
+
+    void Record(MetricId id, uint64_t latencyUs, bool isFailed);
+
+    uint64_t GetCount(MetricId id) const;
+
+    uint64_t GetFailureCount(MetricId id) const;
+
+    const MetricHistogram& GetHistogram(MetricId id) const;
+
+    // Appends one line per metric: name, calls, failures, mean, p50, p90, p99 and max in microseconds.
+    void Dump(DumpBuffer& out) const;
+
+    void Reset();
+
+    static const char* GetName(MetricId id);
+
+private:
+    struct Metric {
+        MetricHistogram histogram;
+        std::atomic<uint64_t> failureCount = 0;
+    };
+
+    MetricsRegistry() = default;
+
+    ~MetricsRegistry() override = default;
+
+    std::array<Metric, static_cast<size_t>(MetricId::COUNT)> metrics_;
+};
+
+/**
+ * Records the time until the end of the scope. With a result pointer the call counts as failed when the result is
+ * not SUCCEEDED at that point; otherwise only SetFailed marks it.
+ */
+class MetricScope final : public NoCopyable {
+public:
+    explicit MetricScope(MetricId id, const int32_t* result = nullptr)
+        : id_(id), result_(result), begin_(std::chrono::steady_clock::now())
+    {}
+
+    ~MetricScope() override
+    {
+        auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - begin_);
+        bool isFailed = isFailed_ || (result_ != nullptr && *result_ != 0);
+        MetricsRegistry::GetInstance().Record(id_, static_cast<uint64_t>(elapsed.count()), isFailed);
+    }
+
+    void SetFailed(bool isFailed)
+    {
+        isFailed_ = isFailed;
+    }
+
+private:
+    MetricId id_;
+    const int32_t* result_ = nullptr;
+    std::chrono::steady_clock::time_point begin_;
+    bool isFailed_ = false;
+};
+} // namespace OHOS::ArkUi::UiAppearance
+#endif // UI_APPEARANCE_UTILS_METRICS_REGISTRY_H
@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef UI_APPEARANCE_UTILS_THREAD_LOCAL_FREE_LIST_H
+#define UI_APPEARANCE_UTILS_THREAD_LOCAL_FREE_LIST_H
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <vector>
+
+namespace OHOS::ArkUi::UiAppearance {
+/**
+ * Recycles up to CAPACITY objects per thread. JS and ETS bindings allocate and release their request contexts on the
+ * thread that owns the env, so a thread-local list is a per-env list that needs no lock. T must provide Reset(),
+ * which is called on release and has to drop everything that refers to the previous request.
+ */
+template<typename T, size_t CAPACITY>
+class ThreadLocalFreeList final {
+public:
+    // Returns a recycled object when this thread has one, otherwise a new one; nullptr when out of memory.
+    static T* Acquire()
+    {
+        auto& list = GetList();
+        if (list.empty()) {
+            return new (std::nothrow) T();
+        }
+        T* object = list.back().release();
+        list.pop_back();
+        return object;
+    }
+
+    // Must run on the thread that acquired the object.
+    static void Release(T* object)
+    {
+        if (object == nullptr) {
+            return;
+        }
+        object->Reset();
+        auto& list = GetList();
+        if (list.size() >= CAPACITY) {
+            delete object;
+            return;
+        }
+        list.emplace_back(object);
+    }
+
+    static size_t GetCachedCount()
+    {
+        return GetList().size();
+    }
+
+private:
+    static std::vector<std::unique_ptr<T>>& GetList()
+    {
+        // Reserved up front so that Release never allocates.
+        thread_local std::vector<std::unique_ptr<T>> list = []() {
+            std::vector<std::unique_ptr<T>> reserved;
+            reserved.reserve(CAPACITY);
+            return reserved;
+        }();
+        return list;
+    }
+};
+} // namespace OHOS::ArkUi::UiAppearance
+#endif // UI_APPEARANCE_UTILS_THREAD_LOCAL_FREE_LIST_H
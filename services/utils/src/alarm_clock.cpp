@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "alarm_clock.h"
+
+#include <chrono>
+
+#include "local_time_cache.h"
+
+namespace OHOS::ArkUi::UiAppearance {
+namespace {
+std::shared_ptr<AlarmClock> g_alarmClock;
+
+std::shared_ptr<AlarmClock> GetSystemAlarmClock()
+{
+    static std::shared_ptr<AlarmClock> systemClock = std::make_shared<SystemAlarmClock>();
+    return systemClock;
+}
+} // namespace
+
+std::shared_ptr<AlarmClock> AlarmClock::GetInstance()
+{
+    std::shared_ptr<AlarmClock> clock = std::atomic_load(&g_alarmClock);
+    return clock != nullptr ? clock : GetSystemAlarmClock();
+}
+
+void AlarmClock::SetInstance(const std::shared_ptr<AlarmClock>& clock)
+{
+    std::atomic_store(&g_alarmClock, clock);
+    LocalTimeCache::GetInstance().Invalidate();
+}
+
+uint64_t SystemAlarmClock::GetCurrentTimestamp() const
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count());
+}
+
+bool SystemAlarmClock::GetLocalTime(const std::time_t time, std::tm& localTime) const
+{
+    return localtime_r(&time, &localTime) != nullptr;
+}
+
+std::time_t SystemAlarmClock::MakeTime(std::tm& localTime) const
+{
+    return std::mktime(&localTime);
+}
+} // namespace OHOS::ArkUi::UiAppearance
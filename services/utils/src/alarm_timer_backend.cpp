@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "alarm_timer_backend.h"
+
+#include <cinttypes>
+
+#include "alarm_timer.h"
+#include "ui_appearance_log.h"
+
+namespace OHOS::ArkUi::UiAppearance {
+namespace {
+constexpr int32_t TIMER_TYPE_EXACT = 2 | 4;
+}
+
+uint64_t TimeServiceTimerBackend::CreateTimer(const std::function<void()>& callback, const std::string& timerName)
+{
+    auto timerInfo = std::make_shared<AlarmTimer>();
+    timerInfo->SetType(TIMER_TYPE_EXACT);
+    timerInfo->SetRepeat(false);
+    timerInfo->SetCallbackInfo(callback);
+    timerInfo->SetName(timerName);
+    uint64_t id = static_cast<uint64_t>(MiscServices::TimeServiceClient::GetInstance()->CreateTimer(timerInfo));
+    if (id <= 0) {
+        LOGE("fail to create timer %{public}" PRIu64, id);
+        return 0;
+    }
+    LOGI("success to CreateTimer timer %{public}" PRIu64, id);
+    return id;
+}
+
+bool TimeServiceTimerBackend::StartTimer(const uint64_t timerId, const uint64_t triggerTime)
+{
+    return MiscServices::TimeServiceClient::GetInstance()->StartTimer(timerId, triggerTime);
+}
+
+bool TimeServiceTimerBackend::StopTimer(const uint64_t timerId)
+{
+    return MiscServices::TimeServiceClient::GetInstance()->StopTimer(timerId);
+}
+
+bool TimeServiceTimerBackend::DestroyTimer(const uint64_t timerId)
+{
+    return MiscServices::TimeServiceClient::GetInstance()->DestroyTimer(timerId);
+}
+} // namespace OHOS::ArkUi::UiAppearance
@@ -15,12 +15,16 @@
 
 #include "alarm_timer_manager.h"
 
+#include <algorithm>
 #include <array>
-#include <chrono>
 #include <cstdint>
 #include <ctime>
 #include <sys/time.h>
 #include <cinttypes>
+#include "dark_schedule.h"
+#include "event_trace.h"
+#include "local_time_cache.h"
+#include "metrics_registry.h"
 #include "ui_appearance_log.h"
 
 namespace OHOS {
@@ -28,14 +32,24 @@ namespace ArkUi::UiAppearance {
 constexpr int32_t DAY_TO_SECOND = 24 * 60 * 60;
 constexpr int32_t DAY_TO_MINUTE = 24 * 60;
 constexpr int32_t SECOND_TO_MILLI = 1000;
-constexpr int32_t HOUR_TO_MINUTE = 60;
 constexpr int32_t MINUTE_TO_SECOND = 60;
-constexpr int32_t TIMER_TYPE_EXACT = 2 | 4;
 constexpr int32_t START_INDEX = 0;
 constexpr int32_t END_INDEX = 1;
-const std::string START_TIMER_NAME = "dark_mode_start_timer";
-const std::string END_TIMER_NAME = "dark_mode_end_timer";
-const std::string RECALCULATION_TIMER_NAME = "dark_mode_recalculation_timer";
+constexpr uint64_t DISPATCH_TOLERANCE_MILLI = 1000;
+constexpr size_t HEAP_COMPACT_FACTOR = 2;
+constexpr size_t HEAP_COMPACT_SLACK = 16;
+const std::string ALARM_TIMER_NAME = "dark_mode_alarm_timer";
+
+AlarmTimerManager::AlarmTimerManager() : AlarmTimerManager(std::make_shared<TimeServiceTimerBackend>()) {}
+
+AlarmTimerManager::AlarmTimerManager(const std::shared_ptr<AlarmTimerBackend>& backend) : backend_(backend) {}
+
+AlarmTimerManager::~AlarmTimerManager()
+{
+    std::lock_guard<std::mutex> lock(timerMapMutex_);
+    ClearTimer(systemTimerId_);
+    systemTimerId_ = 0;
+}
 
 ErrCode AlarmTimerManager::SetScheduleTime(const uint64_t startTime, const uint64_t endTime,
     const uint64_t userId, const std::function<void()>& startCallback, const std::function<void()>& endCallback)
@@ -52,15 +66,13 @@ ErrCode AlarmTimerManager::SetScheduleTime(const uint64_t startTime, const uint6
     LOGI("userId: %{public}" PRIu64 ", in %{public}" PRIu64 " %{public}" PRIu64 ", trigger %{public}" PRIu64
          " %{public}" PRIu64, userId, startTime, endTime, triggerTimeInterval[START_INDEX],
         triggerTimeInterval[END_INDEX]);
-    SetTimer(0, userId, triggerTimeInterval[START_INDEX], startCallback);
-    SetTimer(1, userId, triggerTimeInterval[END_INDEX], endCallback);
-    if (timerIdMap_[userId][START_INDEX] == 0 || timerIdMap_[userId][END_INDEX] == 0) {
-        LOGE("set timer fail, timerId: %{public}" PRIu64 " %{public}" PRIu64,
-            timerIdMap_[userId][START_INDEX], timerIdMap_[userId][END_INDEX]);
+    SetTask(userId, AlarmTaskType::START, triggerTimeInterval[START_INDEX], startCallback);
+    SetTask(userId, AlarmTaskType::END, triggerTimeInterval[END_INDEX], endCallback);
+    if (!ArmEarliestTask()) {
+        LOGE("set timer fail, userId: %{public}" PRIu64, userId);
         return ERR_INVALID_OPERATION;
     }
-    LOGI("set timer success, timerId: %{public}" PRIu64 " %{public}" PRIu64,
-        timerIdMap_[userId][START_INDEX], timerIdMap_[userId][END_INDEX]);
+    LOGI("set timer success, userId: %{public}" PRIu64 ", armed: %{public}" PRIu64, userId, armedTriggerTime_);
     return ERR_OK;
 }
 
@@ -87,161 +99,257 @@ bool AlarmTimerManager::IsValidScheduleTime(const uint64_t startTime, const uint
 void AlarmTimerManager::SetTimerTriggerTime(const uint64_t startTime, const uint64_t endTime,
     std::array<uint64_t, TRIGGER_ARRAY_SIZE>& triggerTimeInterval)
 {
-    std::time_t timestamp = std::time(nullptr);
-    if (timestamp == static_cast<std::time_t>(-1)) {
-        LOGE("fail to get timestamp");
-    }
-    std::tm* nowTime = std::localtime(&timestamp);
-    if (nowTime != nullptr) {
-        nowTime->tm_hour = 0;
-        nowTime->tm_min = 0;
-        nowTime->tm_sec = 0;
-    }
-    std::time_t now_zero = std::mktime(nowTime);
-    uint64_t curTimestamp = static_cast<uint64_t>(timestamp * SECOND_TO_MILLI);
-    uint64_t zeroTimestamp = static_cast<uint64_t>(now_zero * SECOND_TO_MILLI);
-    uint64_t startTimestamp = zeroTimestamp + startTime * MINUTE_TO_SECOND * SECOND_TO_MILLI;
-    uint64_t endTimestamp = zeroTimestamp + endTime * MINUTE_TO_SECOND * SECOND_TO_MILLI;
-
-    uint64_t step = DAY_TO_SECOND * SECOND_TO_MILLI;
+    std::shared_ptr<AlarmClock> clock = AlarmClock::GetInstance();
+    uint64_t curTimestamp = clock->GetCurrentTimestamp() / SECOND_TO_MILLI * SECOND_TO_MILLI;
+    SetTimerTriggerTime(*clock, curTimestamp, startTime, endTime, triggerTimeInterval);
+}
+
+void AlarmTimerManager::SetTimerTriggerTime(const AlarmClock& clock, const uint64_t curTimestamp,
+    const uint64_t startTime, const uint64_t endTime, std::array<uint64_t, TRIGGER_ARRAY_SIZE>& triggerTimeInterval)
+{
+    // Each day is resolved in local time, so a DST switch between today and tomorrow is honored.
+    const std::time_t now = static_cast<std::time_t>(curTimestamp / SECOND_TO_MILLI);
+    auto getTimestamp = [&clock, now](int32_t dayOffset, uint64_t minutes) {
+        return static_cast<uint64_t>(LocalTimeCache::GetInstance().GetLocalTimestamp(clock, now, dayOffset,
+            static_cast<int64_t>(minutes))) * SECOND_TO_MILLI;
+    };
+    uint64_t startTimestamp = getTimestamp(0, startTime);
+    uint64_t endTimestamp = getTimestamp(0, endTime);
+
     if (curTimestamp <= startTimestamp) {
-        if (curTimestamp < endTimestamp - step) {
-            triggerTimeInterval = { startTimestamp, endTimestamp - step };
+        uint64_t lastEndTimestamp = getTimestamp(-1, endTime);
+        if (curTimestamp < lastEndTimestamp) {
+            triggerTimeInterval = { startTimestamp, lastEndTimestamp };
         } else {
             triggerTimeInterval = { startTimestamp, endTimestamp };
         }
     } else if (curTimestamp >= endTimestamp) {
-        triggerTimeInterval = { startTimestamp + step, endTimestamp + step };
+        triggerTimeInterval = { getTimestamp(1, startTime), getTimestamp(1, endTime) };
     } else {
-        triggerTimeInterval = { startTimestamp + step, endTimestamp };
+        triggerTimeInterval = { getTimestamp(1, startTime), endTimestamp };
     }
 }
 
-void AlarmTimerManager::Dump()
+void AlarmTimerManager::Dump(DumpBuffer& out)
 {
+    // Formatting into the preallocated buffer does not allocate, so the lock is held only for a few microseconds.
     std::lock_guard<std::mutex> lock(timerMapMutex_);
-    LOGD("timerIdMap size: %{public}zu", timerIdMap_.size());
-    for (const auto& it : timerIdMap_) {
-        LOGD("userId:%{public}" PRIu64 ", start %{public}" PRIu64 ", end %{public}" PRIu64,
-            it.first, it.second[0], it.second[1]);
+    out.Append("alarm timer: system timer %" PRIu64 ", armed at %" PRIu64 ", arm count %" PRIu64
+        ", dispatch count %" PRIu64 ", tasks %zu, heap %zu\n", systemTimerId_, armedTriggerTime_, armCount_,
+        dispatchCount_, scheduledTaskCount_, taskHeap_.size());
+    for (const auto& it : scheduledTaskMap_) {
+        out.Append("  userId %" PRIu64 ": start %" PRIu64 ", end %" PRIu64 ", recalculation %" PRIu64 "\n", it.first,
+            it.second[static_cast<size_t>(AlarmTaskType::START)].triggerTime,
+            it.second[static_cast<size_t>(AlarmTaskType::END)].triggerTime,
+            it.second[static_cast<size_t>(AlarmTaskType::RECALCULATION)].triggerTime);
     }
-    LOGD("initialSetupTimeMap size: %{public}zu", initialSetupTimeMap_.size());
     for (const auto& it : initialSetupTimeMap_) {
-        LOGD("userId:%{public}" PRIu64 ", start %{public}" PRIu64 ", end %{public}" PRIu64,
-            it.first, it.second[0], it.second[1]);
+        out.Append("  userId %" PRIu64 ": initial start %" PRIu64 ", initial end %" PRIu64 "\n", it.first,
+            it.second[0], it.second[1]);
     }
 }
 
-void AlarmTimerManager::SetTimer(const int8_t index, const uint64_t userId, const uint64_t time,
+void AlarmTimerManager::SetTask(const uint64_t userId, const AlarmTaskType type, const uint64_t time,
     const std::function<void()>& callback)
 {
-    LOGD("SetTimer %{public}d %{public}" PRIu64 " %{public}" PRIu64, index, userId, time);
-    if (timerIdMap_.find(userId) == timerIdMap_.end()) {
-        LOGW("timerIdMap_ find userId null");
-        std::array<uint64_t, TRIGGER_ARRAY_SIZE> timerIds = { 0, 0 };
-        timerIdMap_[userId] = timerIds;
+    LOGD("SetTask %{public}d %{public}" PRIu64 " %{public}" PRIu64, static_cast<int32_t>(type), userId, time);
+    ScheduledTask& task = scheduledTaskMap_[userId][static_cast<size_t>(type)];
+    if (task.sequence == 0) {
+        scheduledTaskCount_++;
     }
+    task.triggerTime = time;
+    task.sequence = ++nextSequence_;
+    task.callback = callback;
+    taskHeap_.push_back({ time, task.sequence, userId, type });
+    std::push_heap(taskHeap_.begin(), taskHeap_.end(), std::greater<HeapNode>());
+}
 
-    if (timerIdMap_[userId][index] > 0) {
-        timerIdMap_[userId][index] =
-            UpdateTimer(timerIdMap_[userId][index], time, callback, index == 0 ? START_TIMER_NAME : END_TIMER_NAME);
-    } else {
-        timerIdMap_[userId][index] = InitTimer(time, callback, index == 0 ? START_TIMER_NAME : END_TIMER_NAME);
+void AlarmTimerManager::RemoveTask(const uint64_t userId, const AlarmTaskType type)
+{
+    auto it = scheduledTaskMap_.find(userId);
+    if (it == scheduledTaskMap_.end()) {
+        return;
+    }
+    ScheduledTask& task = it->second[static_cast<size_t>(type)];
+    if (task.sequence != 0) {
+        task = ScheduledTask();
+        scheduledTaskCount_--;
+    }
+    bool empty = std::all_of(it->second.begin(), it->second.end(),
+        [](const ScheduledTask& item) { return item.sequence == 0; });
+    if (empty) {
+        scheduledTaskMap_.erase(it);
     }
 }
 
-uint64_t AlarmTimerManager::InitTimer(const uint64_t time, const std::function<void()>& callback,
-    const std::string timerName)
+bool AlarmTimerManager::HasTask(const uint64_t userId, const AlarmTaskType type)
 {
-    auto timerInfo = std::make_shared<AlarmTimer>();
-    timerInfo->SetType(TIMER_TYPE_EXACT);
-    timerInfo->SetRepeat(true);
-    timerInfo->SetInterval(DAY_TO_SECOND * SECOND_TO_MILLI);
-    timerInfo->SetCallbackInfo(callback);
-    timerInfo->SetName(timerName);
-    uint64_t id = static_cast<uint64_t>(MiscServices::TimeServiceClient::GetInstance()->CreateTimer(timerInfo));
-    if (id <= 0) {
-        LOGE("fail to create timer %{public}" PRIu64, id);
-        return 0;
+    auto it = scheduledTaskMap_.find(userId);
+    return it != scheduledTaskMap_.end() && it->second[static_cast<size_t>(type)].sequence != 0;
+}
+
+bool AlarmTimerManager::IsStaleNode(const HeapNode& node) const
+{
+    auto it = scheduledTaskMap_.find(node.userId);
+    return it == scheduledTaskMap_.end() || it->second[static_cast<size_t>(node.type)].sequence != node.sequence;
+}
+
+void AlarmTimerManager::RebuildHeap()
+{
+    taskHeap_.clear();
+    for (const auto& [userId, tasks] : scheduledTaskMap_) {
+        for (size_t index = 0; index < TASK_TYPE_COUNT; ++index) {
+            if (tasks[index].sequence != 0) {
+                taskHeap_.push_back(
+                    { tasks[index].triggerTime, tasks[index].sequence, userId, static_cast<AlarmTaskType>(index) });
+            }
+        }
     }
-    bool ret = MiscServices::TimeServiceClient::GetInstance()->StartTimer(id, time);
-    if (!ret) {
-        LOGE("fail to StartTimer timer %{public}" PRIu64, id);
-        ClearTimer(id);
-        return 0;
+    std::make_heap(taskHeap_.begin(), taskHeap_.end(), std::greater<HeapNode>());
+}
+
+bool AlarmTimerManager::ArmEarliestTask()
+{
+    if (taskHeap_.size() > scheduledTaskCount_ * HEAP_COMPACT_FACTOR + HEAP_COMPACT_SLACK) {
+        RebuildHeap();
+    }
+    while (!taskHeap_.empty() && IsStaleNode(taskHeap_.front())) {
+        std::pop_heap(taskHeap_.begin(), taskHeap_.end(), std::greater<HeapNode>());
+        taskHeap_.pop_back();
+    }
+    if (taskHeap_.empty()) {
+        if (armedTriggerTime_ != 0) {
+            backend_->StopTimer(systemTimerId_);
+            armedTriggerTime_ = 0;
+        }
+        return true;
+    }
+    uint64_t earliest = taskHeap_.front().triggerTime;
+    if (earliest == armedTriggerTime_) {
+        return true;
+    }
+    if (systemTimerId_ == 0) {
+        systemTimerId_ = backend_->CreateTimer([this]() { OnAlarmTrigger(); }, ALARM_TIMER_NAME);
+        if (systemTimerId_ == 0) {
+            return false;
+        }
+    } else if (armedTriggerTime_ != 0) {
+        backend_->StopTimer(systemTimerId_);
+    }
+    armedTriggerTime_ = 0;
+    if (!backend_->StartTimer(systemTimerId_, earliest)) {
+        LOGE("fail to StartTimer timer %{public}" PRIu64 " at %{public}" PRIu64, systemTimerId_, earliest);
+        return false;
     }
-    LOGI("success to StartTimer timer %{public}" PRIu64, id);
-    return id;
+    armedTriggerTime_ = earliest;
+    armCount_++;
+    LOGD("armed timer %{public}" PRIu64 " at %{public}" PRIu64, systemTimerId_, earliest);
+    return true;
+}
+
+void AlarmTimerManager::OnAlarmTrigger()
+{
+    std::vector<std::function<void()>> callbacks;
+    {
+        std::lock_guard<std::mutex> lock(timerMapMutex_);
+        armedTriggerTime_ = 0;
+        CollectDueTasks(GetCurrentTimestamp(), callbacks);
+        ArmEarliestTask();
+    }
+    EventTrace::GetInstance().Record(TraceEventType::ALARM_TRIGGERED, -1, -1, static_cast<int32_t>(callbacks.size()));
+    // Run outside the lock, callbacks may reschedule their own timers.
+    for (const auto& callback : callbacks) {
+        if (callback) {
+            MetricScope metricScope(MetricId::ALARM_TIMER_CALLBACK);
+            callback();
+        }
+    }
+}
+
+void AlarmTimerManager::CollectDueTasks(const uint64_t now, std::vector<std::function<void()>>& callbacks)
+{
+    const uint64_t dueTime = now + DISPATCH_TOLERANCE_MILLI;
+    while (!taskHeap_.empty() && taskHeap_.front().triggerTime <= dueTime) {
+        HeapNode node = taskHeap_.front();
+        std::pop_heap(taskHeap_.begin(), taskHeap_.end(), std::greater<HeapNode>());
+        taskHeap_.pop_back();
+        if (IsStaleNode(node)) {
+            continue;
+        }
+        ScheduledTask& task = scheduledTaskMap_[node.userId][static_cast<size_t>(node.type)];
+        callbacks.push_back(task.callback);
+        dispatchCount_++;
+        SetTask(node.userId, node.type, GetNextTriggerTime(node.userId, node.type, task, dueTime), task.callback);
+    }
+}
+
+uint64_t AlarmTimerManager::GetNextTriggerTime(const uint64_t userId, const AlarmTaskType type,
+    const ScheduledTask& task, const uint64_t dueTime)
+{
+    auto setupIt = initialSetupTimeMap_.find(userId);
+    if (type != AlarmTaskType::RECALCULATION && setupIt != initialSetupTimeMap_.end()) {
+        // Recompute from the local schedule instead of adding a day, which would drift across DST switches.
+        std::array<uint64_t, TRIGGER_ARRAY_SIZE> triggerTimeInterval = { 0, 0 };
+        SetTimerTriggerTime(*AlarmClock::GetInstance(), dueTime + 1, setupIt->second[START_INDEX],
+            setupIt->second[END_INDEX], triggerTimeInterval);
+        uint64_t nextTime = triggerTimeInterval[type == AlarmTaskType::START ? START_INDEX : END_INDEX];
+        if (nextTime > dueTime) {
+            return nextTime;
+        }
+    }
+    // Skip the periods missed while the device was asleep, a daily task fires at most once per dispatch.
+    const uint64_t step = DAY_TO_SECOND * SECOND_TO_MILLI;
+    uint64_t nextTime = task.triggerTime + step;
+    if (nextTime <= dueTime) {
+        nextTime += (dueTime - nextTime) / step * step + step;
+    }
+    return nextTime;
 }
 
 void AlarmTimerManager::ClearTimer(const uint64_t id)
 {
     if (id <= 0) {
-        LOGE("id <= 0: %{public}" PRIu64, id);
+        LOGD("id <= 0: %{public}" PRIu64, id);
         return;
     }
 
-    bool ret = MiscServices::TimeServiceClient::GetInstance()->DestroyTimer(id);
+    bool ret = backend_->DestroyTimer(id);
     if (!ret) {
         LOGE("fail to DestroyTimer timer %{public}" PRIu64, id);
     }
     LOGI("success to DestroyTimer timer %{public}" PRIu64, id);
 }
 
-uint64_t AlarmTimerManager::UpdateTimer(const uint64_t id, const uint64_t time,
-    const std::function<void()>& callback, const std::string timerName)
+uint64_t AlarmTimerManager::GetCurrentTimestamp()
 {
-    ClearTimer(id);
-    return InitTimer(time, callback, timerName);
+    return AlarmClock::GetInstance()->GetCurrentTimestamp();
 }
 
 void AlarmTimerManager::ClearTimerByUserId(const uint64_t userId)
 {
     std::lock_guard<std::mutex> lock(timerMapMutex_);
-    auto timerIt = timerIdMap_.find(userId);
-    if (timerIt != timerIdMap_.end()) {
-        ClearTimer(timerIt->second[START_INDEX]);
-        ClearTimer(timerIt->second[END_INDEX]);
-        timerIdMap_.erase(timerIt);
-    } else {
-        LOGD("timerIdMap_ has no entry for userId: %{public}" PRIu64, userId);
+    if (scheduledTaskMap_.find(userId) == scheduledTaskMap_.end()) {
+        LOGD("scheduledTaskMap_ has no entry for userId: %{public}" PRIu64, userId);
     }
-    // Clear the recalculation timer in the current critical section to avoid reacquiring timerMapMutex_.
-    auto recalculationTimerIt = recalculationTimerIdMap_.find(userId);
-    if (recalculationTimerIt != recalculationTimerIdMap_.end()) {
-        ClearTimer(recalculationTimerIt->second);
-        recalculationTimerIdMap_.erase(recalculationTimerIt);
+    // The recalculation task is cleared in the same critical section to avoid reacquiring timerMapMutex_.
+    for (size_t index = 0; index < TASK_TYPE_COUNT; ++index) {
+        RemoveTask(userId, static_cast<AlarmTaskType>(index));
     }
-
     if (initialSetupTimeMap_.find(userId) == initialSetupTimeMap_.end()) {
         LOGD("initialSetupTimeMap_ has no entry for userId: %{public}" PRIu64, userId);
     }
     initialSetupTimeMap_.erase(userId);
+    ArmEarliestTask();
 }
 
 bool AlarmTimerManager::IsWithinTimeInterval(const uint64_t startTime, const uint64_t endTime)
 {
     LOGI("IsWithinTimeInterval startTime: %{public}" PRIu64 " endTime: %{public}" PRIu64,
         startTime, endTime);
-    std::time_t timestamp = std::time(nullptr);
-    if (timestamp == static_cast<std::time_t>(-1)) {
-        LOGE("fail to get timestamp");
-        return false;
-    }
-    std::tm* nowTime = std::localtime(&timestamp);
-    uint32_t totalMinutes{ 0 };
-    if (nowTime != nullptr) {
-        totalMinutes = static_cast<uint32_t>(nowTime->tm_hour * HOUR_TO_MINUTE + nowTime->tm_min);
-    }
-
-    if (endTime <= DAY_TO_MINUTE) {
-        return (startTime <= totalMinutes && totalMinutes < endTime);
-    } else {
-        if ((endTime - DAY_TO_MINUTE) <= totalMinutes && totalMinutes < startTime) {
-            return false;
-        }
-        return true;
-    }
+    std::shared_ptr<AlarmClock> clock = AlarmClock::GetInstance();
+    std::time_t timestamp = static_cast<std::time_t>(clock->GetCurrentTimestamp() / SECOND_TO_MILLI);
+    int32_t totalMinutes = LocalTimeCache::GetInstance().GetSecondOfDay(*clock, timestamp) / MINUTE_TO_SECOND;
+    return DarkSchedule::IsDarkMinute(static_cast<int64_t>(startTime), static_cast<int64_t>(endTime), totalMinutes);
 }
 
 void AlarmTimerManager::RecordInitialSetupTime(const uint64_t startTime, const uint64_t endTime,
@@ -258,9 +366,9 @@ bool AlarmTimerManager::RestartTimerByUserId(const uint64_t userId)
         return false;
     }
 
-    if (timerIdMap_.find(userId) == timerIdMap_.end()
+    if (!HasTask(userId, AlarmTaskType::START) || !HasTask(userId, AlarmTaskType::END)
         || initialSetupTimeMap_.find(userId) == initialSetupTimeMap_.end()) {
-        LOGE("initialSetupTimeMap_ or timerIdMap_ fail to find Timer: %{public}" PRIu64, userId);
+        LOGE("initialSetupTimeMap_ or scheduledTaskMap_ fail to find Timer: %{public}" PRIu64, userId);
         return false;
     }
 
@@ -269,68 +377,60 @@ bool AlarmTimerManager::RestartTimerByUserId(const uint64_t userId)
     SetTimerTriggerTime(initialSetupTimeMap_[userId][START_INDEX],
         initialSetupTimeMap_[userId][END_INDEX], triggerTimeInterval);
 
-    RestartTimerByTimerId(timerIdMap_[userId][START_INDEX], triggerTimeInterval[START_INDEX]);
-    RestartTimerByTimerId(timerIdMap_[userId][END_INDEX], triggerTimeInterval[END_INDEX]);
-
+    auto& tasks = scheduledTaskMap_[userId];
+    const size_t startIndex = static_cast<size_t>(AlarmTaskType::START);
+    const size_t endIndex = static_cast<size_t>(AlarmTaskType::END);
+    tasks[startIndex].triggerTime = triggerTimeInterval[START_INDEX];
+    tasks[startIndex].sequence = ++nextSequence_;
+    tasks[endIndex].triggerTime = triggerTimeInterval[END_INDEX];
+    tasks[endIndex].sequence = ++nextSequence_;
     return true;
 }
 
-void AlarmTimerManager::RestartTimerByTimerId(const uint64_t timerId, const uint64_t time)
-{
-    LOGI("RestartTimerByTimerId timerId: %{public}" PRIu64 " timer: %{public}" PRIu64, timerId, time);
-    MiscServices::TimeServiceClient::GetInstance()->StopTimer(timerId);
-    MiscServices::TimeServiceClient::GetInstance()->StartTimer(timerId, time);
-}
-
 bool AlarmTimerManager::RestartAllTimer()
 {
     std::lock_guard<std::mutex> lock(timerMapMutex_);
     bool res = true;
-    for (const auto& pair : timerIdMap_) {
+    for (const auto& pair : initialSetupTimeMap_) {
         uint64_t userId = pair.first;
         if (userId == 0) {
             LOGE("userId == 0: %{public}" PRIu64, userId);
             continue;
         }
-        res = res && RestartTimerByUserId(userId);
+        res = RestartTimerByUserId(userId) && res;
     }
-
-    return res;
+    // Trigger times were rewritten in place, so rebuild the heap once; at most one alarm IPC follows.
+    RebuildHeap();
+    return ArmEarliestTask() && res;
 }
 
 void AlarmTimerManager::SetRecalculationTimer(uint64_t userId, const std::function<void()>& callback)
 {
     std::lock_guard<std::mutex> lock(timerMapMutex_);
-    auto it = recalculationTimerIdMap_.find(userId);
-    if (it != recalculationTimerIdMap_.end() && it->second > 0) {
+    if (HasTask(userId, AlarmTaskType::RECALCULATION)) {
         LOGD("recalculation timer already running for userId: %{public}" PRIu64, userId);
         return;
     }
 
-    uint64_t triggerTime = static_cast<uint64_t>(
-        std::chrono::duration_cast<std::chrono::milliseconds>(
-            std::chrono::system_clock::now().time_since_epoch()).count()) +
-        DAY_TO_SECOND * SECOND_TO_MILLI;
-
-    uint64_t timerId = InitTimer(triggerTime, callback, RECALCULATION_TIMER_NAME);
-    if (timerId == 0) {
-        LOGE("fail to create recalculation timer for userId: %{public}" PRIu64, userId);
+    uint64_t triggerTime = GetCurrentTimestamp() + DAY_TO_SECOND * SECOND_TO_MILLI;
+    SetTask(userId, AlarmTaskType::RECALCULATION, triggerTime, callback);
+    if (!ArmEarliestTask()) {
+        LOGE("fail to arm recalculation timer for userId: %{public}" PRIu64, userId);
+        RemoveTask(userId, AlarmTaskType::RECALCULATION);
         return;
     }
-
-    recalculationTimerIdMap_[userId] = timerId;
-    LOGI("recalculation timer started, id: %{public}" PRIu64 ", userId: %{public}" PRIu64, timerId, userId);
+    LOGI("recalculation timer started, trigger: %{public}" PRIu64 ", userId: %{public}" PRIu64, triggerTime, userId);
 }
 
 void AlarmTimerManager::ClearRecalculationTimer(uint64_t userId)
 {
-    // This independent entry protects recalculationTimerIdMap_ with timerMapMutex_.
+    // This independent entry protects scheduledTaskMap_ with timerMapMutex_.
     std::lock_guard<std::mutex> lock(timerMapMutex_);
-    auto it = recalculationTimerIdMap_.find(userId);
-    if (it != recalculationTimerIdMap_.end()) {
-        ClearTimer(it->second);
-        recalculationTimerIdMap_.erase(it);
+    if (!HasTask(userId, AlarmTaskType::RECALCULATION)) {
+        return;
     }
+    RemoveTask(userId, AlarmTaskType::RECALCULATION);
+    ArmEarliestTask();
 }
 } // namespace ArkUi::UiAppearance
 } // namespace OHOS
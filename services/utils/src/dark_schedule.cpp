@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "dark_schedule.h"
+
+namespace OHOS::ArkUi::UiAppearance {
+std::atomic<uint64_t> DarkSchedule::compileCount_ = 0;
+
+DarkSchedule::DarkSchedule(const int64_t startTime, const int64_t endTime) : startTime_(startTime), endTime_(endTime)
+{
+    compileCount_.fetch_add(1, std::memory_order_relaxed);
+    for (int32_t minute = 0; minute < MINUTES_PER_DAY; ++minute) {
+        if (IsDarkMinute(startTime, endTime, minute)) {
+            SetDark(minute);
+        }
+    }
+}
+
+bool DarkSchedule::IsDarkMinute(const int64_t startTime, const int64_t endTime, const int32_t minuteOfDay)
+{
+    int32_t minute = NormalizeMinute(minuteOfDay);
+    if (endTime <= MINUTES_PER_DAY) {
+        return startTime <= minute && minute < endTime;
+    }
+    return !(endTime - MINUTES_PER_DAY <= minute && minute < startTime);
+}
+
+uint64_t DarkSchedule::GetCompileCount()
+{
+    return compileCount_.load(std::memory_order_relaxed);
+}
+
+bool DarkSchedule::IsDark(const int32_t minuteOfDay) const
+{
+    int32_t minute = NormalizeMinute(minuteOfDay);
+    return (darkBits_[minute / BITS_PER_WORD] >> (minute % BITS_PER_WORD)) & 1;
+}
+
+bool DarkSchedule::IsDarkAtSecond(const int32_t secondOfDay) const
+{
+    int32_t minute = secondOfDay / SECONDS_PER_MINUTE;
+    if (secondOfDay % SECONDS_PER_MINUTE == 0) {
+        return IsDark(minute) && IsDark(minute - 1);
+    }
+    return IsDark(minute);
+}
+
+int64_t DarkSchedule::GetStartTime() const
+{
+    return startTime_;
+}
+
+int64_t DarkSchedule::GetEndTime() const
+{
+    return endTime_;
+}
+
+int32_t DarkSchedule::NormalizeMinute(const int32_t minute)
+{
+    int32_t normalized = minute % MINUTES_PER_DAY;
+    return normalized < 0 ? normalized + MINUTES_PER_DAY : normalized;
+}
+
+void DarkSchedule::SetDark(const int32_t minuteOfDay)
+{
+    darkBits_[minuteOfDay / BITS_PER_WORD] |= uint64_t(1) << (minuteOfDay % BITS_PER_WORD);
+}
+} // namespace OHOS::ArkUi::UiAppearance
@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "debounce_task.h"
+
+#include <cinttypes>
+
+#include "ui_appearance_log.h"
+
+namespace OHOS::ArkUi::UiAppearance {
+DebounceTask::DebounceTask(const std::string& name, const uint32_t delayMs, const TaskFunc& task)
+    : name_(name), delay_(delayMs), task_(task)
+{}
+
+DebounceTask::~DebounceTask()
+{
+    {
+        std::lock_guard lock(mutex_);
+        stopped_ = true;
+    }
+    cv_.notify_all();
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+}
+
+void DebounceTask::Post()
+{
+    postCount_.fetch_add(1, std::memory_order_relaxed);
+    std::lock_guard lock(mutex_);
+    if (stopped_) {
+        return;
+    }
+    if (pendingCount_++ > 0) {
+        return;
+    }
+    deadline_ = std::chrono::steady_clock::now() + delay_;
+    if (!worker_.joinable()) {
+        worker_ = std::thread([this]() { WorkLoop(); });
+    }
+    cv_.notify_one();
+}
+
+void DebounceTask::Flush()
+{
+    // Waits for a run the worker has already started, so the task never runs twice at once.
+    std::lock_guard runLock(runMutex_);
+    uint32_t mergedCount = 0;
+    {
+        std::lock_guard lock(mutex_);
+        mergedCount = pendingCount_;
+        pendingCount_ = 0;
+    }
+    if (mergedCount > 0) {
+        RunTask(mergedCount);
+    }
+}
+
+uint64_t DebounceTask::GetPostCount() const
+{
+    return postCount_.load(std::memory_order_relaxed);
+}
+
+uint64_t DebounceTask::GetRunCount() const
+{
+    return runCount_.load(std::memory_order_relaxed);
+}
+
+void DebounceTask::WorkLoop()
+{
+    std::unique_lock lock(mutex_);
+    while (!stopped_) {
+        if (pendingCount_ == 0) {
+            cv_.wait(lock, [this]() { return stopped_ || pendingCount_ > 0; });
+            continue;
+        }
+        if (cv_.wait_until(lock, deadline_, [this]() { return stopped_; })) {
+            break;
+        }
+        lock.unlock();
+        std::lock_guard runLock(runMutex_);
+        lock.lock();
+        // A Flush that got in first has already run the posts of this window.
+        uint32_t mergedCount = pendingCount_;
+        pendingCount_ = 0;
+        if (mergedCount == 0) {
+            continue;
+        }
+        lock.unlock();
+        RunTask(mergedCount);
+        lock.lock();
+    }
+}
+
+void DebounceTask::RunTask(const uint32_t mergedCount)
+{
+    uint64_t runCount = runCount_.fetch_add(1, std::memory_order_relaxed) + 1;
+    LOGI("%{public}s run: %{public}" PRIu64 ", merged: %{public}u, posted: %{public}" PRIu64,
+        name_.c_str(), runCount, mergedCount, GetPostCount());
+    if (task_) {
+        task_(mergedCount);
+    }
+}
+} // namespace OHOS::ArkUi::UiAppearance
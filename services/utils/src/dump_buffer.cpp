@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "dump_buffer.h"
+
+#include <cerrno>
+#include <cstdarg>
+#include <cstdio>
+#include <unistd.h>
+
+namespace OHOS::ArkUi::UiAppearance {
+namespace {
+constexpr char TRUNCATED_NOTE[] = "\n... dump truncated\n";
+
+bool WriteFully(const int32_t fd, const char* data, size_t size)
+{
+    while (size > 0) {
+        ssize_t written = write(fd, data, size);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        data += written;
+        size -= static_cast<size_t>(written);
+    }
+    return true;
+}
+} // namespace
+
+DumpBuffer::DumpBuffer(const size_t capacity) : data_(capacity > 0 ? capacity : 1, '\0') {}
+
+void DumpBuffer::Append(const char* format, ...)
+{
+    if (isTruncated_ || format == nullptr) {
+        return;
+    }
+    // Keep one byte for the terminator vsnprintf always writes.
+    size_t remaining = data_.size() - size_;
+    va_list args;
+    va_start(args, format);
+    int len = vsnprintf(data_.data() + size_, remaining, format, args);
+    va_end(args);
+    if (len < 0) {
+        return;
+    }
+    if (static_cast<size_t>(len) >= remaining) {
+        size_ = data_.size() - 1;
+        isTruncated_ = true;
+        return;
+    }
+    size_ += static_cast<size_t>(len);
+}
+
+const char* DumpBuffer::GetData() const
+{
+    return data_.data();
+}
+
+size_t DumpBuffer::GetSize() const
+{
+    return size_;
+}
+
+bool DumpBuffer::IsTruncated() const
+{
+    return isTruncated_;
+}
+
+bool DumpBuffer::WriteTo(const int32_t fd) const
+{
+    if (!WriteFully(fd, data_.data(), size_)) {
+        return false;
+    }
+    return !isTruncated_ || WriteFully(fd, TRUNCATED_NOTE, sizeof(TRUNCATED_NOTE) - 1);
+}
+} // namespace OHOS::ArkUi::UiAppearance
@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "event_trace.h"
+
+#include <chrono>
+#include <cinttypes>
+
+namespace OHOS::ArkUi::UiAppearance {
+namespace {
+constexpr std::array<const char*, static_cast<size_t>(TraceEventType::COUNT)> EVENT_NAMES = {
+    "event.UserSwitched",
+    "event.SubProfileSwitched",
+    "event.BootCompleted",
+    "event.TimeChanged",
+    "event.TimezoneChanged",
+    "event.ScreenOn",
+    "event.ScreenOff",
+    "settingdata.Changed",
+    "alarm.Triggered",
+    "alarm.ScheduleFired",
+    "alarm.RecalculationFired",
+    "darkmode.Changed",
+    "appmgr.UpdateConfiguration",
+};
+static_assert(EVENT_NAMES.back() != nullptr, "every TraceEventType needs a name");
+constexpr uint32_t BITS_PER_U32 = 32;
+constexpr uint64_t LOW_32_MASK = 0xFFFFFFFFULL;
+constexpr uint64_t NANO_PER_SECOND = 1000000000ULL;
+constexpr uint64_t NANO_PER_MICRO = 1000ULL;
+
+// A slot holds 2 * ticket + 1 while its writer fills it and 2 * ticket + 2 once the event is published.
+constexpr uint64_t WritingSequence(const uint64_t ticket)
+{
+    return 2 * ticket + 1;
+}
+
+constexpr uint64_t PublishedSequence(const uint64_t ticket)
+{
+    return 2 * ticket + 2;
+}
+
+constexpr uint64_t Pack(const uint32_t high, const uint32_t low)
+{
+    return (static_cast<uint64_t>(high) << BITS_PER_U32) | low;
+}
+} // namespace
+
+EventTrace& EventTrace::GetInstance()
+{
+    static EventTrace instance;
+    return instance;
+}
+
+void EventTrace::Record(const TraceEventType type, const int32_t userId, const int32_t subProfileId,
+    const int32_t value)
+{
+    uint64_t timestampNs = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+    uint64_t ticket = next_.fetch_add(1, std::memory_order_relaxed);
+    Slot& slot = slots_[ticket & (CAPACITY - 1)];
+    slot.sequence.store(WritingSequence(ticket), std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.timestampNs.store(timestampNs, std::memory_order_relaxed);
+    slot.context.store(Pack(static_cast<uint32_t>(userId), static_cast<uint32_t>(subProfileId)),
+        std::memory_order_relaxed);
+    slot.data.store(Pack(static_cast<uint32_t>(type), static_cast<uint32_t>(value)), std::memory_order_relaxed);
+    slot.sequence.store(PublishedSequence(ticket), std::memory_order_release);
+}
+
+uint64_t EventTrace::GetRecordCount() const
+{
+    return next_.load(std::memory_order_relaxed);
+}
+
+template<typename Visitor>
+void EventTrace::ForEach(const Visitor& visitor) const
+{
+    uint64_t end = next_.load(std::memory_order_acquire);
+    uint64_t begin = end > CAPACITY ? end - CAPACITY : 0;
+    for (uint64_t ticket = begin; ticket < end; ++ticket) {
+        const Slot& slot = slots_[ticket & (CAPACITY - 1)];
+        uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+        if (sequence != PublishedSequence(ticket)) {
+            continue;
+        }
+        TraceEvent event;
+        event.sequence = ticket;
+        event.timestampNs = slot.timestampNs.load(std::memory_order_relaxed);
+        uint64_t context = slot.context.load(std::memory_order_relaxed);
+        uint64_t data = slot.data.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.sequence.load(std::memory_order_relaxed) != sequence) {
+            continue;
+        }
+        event.userId = static_cast<int32_t>(static_cast<uint32_t>(context >> BITS_PER_U32));
+        event.subProfileId = static_cast<int32_t>(static_cast<uint32_t>(context & LOW_32_MASK));
+        event.type = static_cast<TraceEventType>(data >> BITS_PER_U32);
+        event.value = static_cast<int32_t>(static_cast<uint32_t>(data & LOW_32_MASK));
+        visitor(event);
+    }
+}
+
+std::vector<TraceEvent> EventTrace::GetEvents() const
+{
+    std::vector<TraceEvent> events;
+    events.reserve(CAPACITY);
+    ForEach([&events](const TraceEvent& event) { events.push_back(event); });
+    return events;
+}
+
+void EventTrace::Dump(DumpBuffer& out) const
+{
+    out.Append("event trace: recorded %" PRIu64 ", capacity %zu\n", GetRecordCount(), CAPACITY);
+    ForEach([&out](const TraceEvent& event) {
+        // At most 125 bytes: 11-digit seconds, 20-digit sequence, 28-column name and three 11-character integers.
+        out.Append("  [%6" PRIu64 ".%06" PRIu64 "] #%" PRIu64 " %-28s context %d/%d, value %d\n",
+            event.timestampNs / NANO_PER_SECOND, event.timestampNs % NANO_PER_SECOND / NANO_PER_MICRO,
+            event.sequence, GetName(event.type), event.userId, event.subProfileId, event.value);
+    });
+}
+
+void EventTrace::Reset()
+{
+    for (auto& slot : slots_) {
+        slot.sequence.store(0, std::memory_order_relaxed);
+    }
+    next_.store(0, std::memory_order_release);
+}
+
+const char* EventTrace::GetName(const TraceEventType type)
+{
+    if (type >= TraceEventType::COUNT) {
+        return "unknown";
+    }
+    return EVENT_NAMES[static_cast<size_t>(type)];
+}
+} // namespace OHOS::ArkUi::UiAppearance
@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "file_watcher.h"
+
+#include <cerrno>
+#include <cstdint>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+#include "ui_appearance_log.h"
+
+namespace OHOS::ArkUi::UiAppearance {
+namespace {
+// A file renamed into place, or written in place and closed. Edits in place can race the reader, so consumers must
+// read the file into a buffer rather than map it.
+constexpr uint32_t WATCH_MASK = IN_MOVED_TO | IN_CLOSE_WRITE;
+constexpr size_t EVENT_BUFFER_SIZE = 4096;
+constexpr nfds_t POLL_FD_COUNT = 2;
+} // namespace
+
+FileWatcher::FileWatcher(const std::string& filePath, const Callback& callback) : callback_(callback)
+{
+    size_t separator = filePath.rfind('/');
+    if (separator == std::string::npos) {
+        directory_ = ".";
+        fileName_ = filePath;
+    } else {
+        directory_ = separator == 0 ? "/" : filePath.substr(0, separator);
+        fileName_ = filePath.substr(separator + 1);
+    }
+}
+
+FileWatcher::~FileWatcher()
+{
+    Stop();
+}
+
+bool FileWatcher::Start()
+{
+    std::lock_guard lock(mutex_);
+    if (worker_.joinable()) {
+        return true;
+    }
+    inotifyFd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotifyFd_ < 0) {
+        LOGE("inotify_init1 failed, errno: %{public}d", errno);
+        return false;
+    }
+    if (inotify_add_watch(inotifyFd_, directory_.c_str(), WATCH_MASK) < 0) {
+        LOGE("inotify_add_watch failed, errno: %{public}d", errno);
+        close(inotifyFd_);
+        inotifyFd_ = -1;
+        return false;
+    }
+    wakeFd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wakeFd_ < 0) {
+        LOGE("eventfd failed, errno: %{public}d", errno);
+        close(inotifyFd_);
+        inotifyFd_ = -1;
+        return false;
+    }
+    worker_ = std::thread([this]() { WatchLoop(); });
+    return true;
+}
+
+void FileWatcher::Stop()
+{
+    std::lock_guard lock(mutex_);
+    if (worker_.joinable()) {
+        uint64_t value = 1;
+        if (write(wakeFd_, &value, sizeof(value)) < 0) {
+            LOGW("wake watcher failed, errno: %{public}d", errno);
+        }
+        worker_.join();
+    }
+    if (inotifyFd_ >= 0) {
+        close(inotifyFd_);
+        inotifyFd_ = -1;
+    }
+    if (wakeFd_ >= 0) {
+        close(wakeFd_);
+        wakeFd_ = -1;
+    }
+}
+
+void FileWatcher::WatchLoop()
+{
+    struct pollfd fds[POLL_FD_COUNT] = {
+        { .fd = inotifyFd_, .events = POLLIN, .revents = 0 },
+        { .fd = wakeFd_, .events = POLLIN, .revents = 0 },
+    };
+    while (true) {
+        int ret = poll(fds, POLL_FD_COUNT, -1);
+        if (ret < 0 && errno == EINTR) {
+            continue;
+        }
+        if (ret < 0 || (fds[1].revents & POLLIN) != 0) {
+            return;
+        }
+        if ((fds[0].revents & POLLIN) != 0 && HandleEvents() && callback_) {
+            callback_();
+        }
+    }
+}
+
+bool FileWatcher::HandleEvents()
+{
+    alignas(struct inotify_event) char buffer[EVENT_BUFFER_SIZE];
+    bool touched = false;
+    while (true) {
+        ssize_t length = read(inotifyFd_, buffer, sizeof(buffer));
+        if (length <= 0) {
+            break;
+        }
+        for (char* cursor = buffer; cursor < buffer + length;) {
+            auto event = reinterpret_cast<struct inotify_event*>(cursor);
+            if (event->len > 0 && fileName_ == event->name) {
+                touched = true;
+            }
+            cursor += sizeof(struct inotify_event) + event->len;
+        }
+    }
+    return touched;
+}
+} // namespace OHOS::ArkUi::UiAppearance
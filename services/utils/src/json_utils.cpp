@@ -14,12 +14,94 @@
  */
 
 #include "json_utils.h"
+#include <fcntl.h>
 #include <unistd.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include "config_policy_utils.h"
+#include "nocopyable.h"
 #include "ui_appearance_log.h"
 
 namespace OHOS::ArkUi::UiAppearance {
+namespace {
+class MappedFile final : public NoCopyable {
+public:
+    explicit MappedFile(const char* path)
+    {
+        int fd = open(path, O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            LOGE("open fail, errno: %{public}d", errno);
+            return;
+        }
+        struct stat statbuf;
+        if (fstat(fd, &statbuf) != 0) {
+            LOGE("fstat fail, errno: %{public}d", errno);
+            close(fd);
+            return;
+        }
+        size_ = static_cast<size_t>(statbuf.st_size);
+        if (size_ > 0) {
+            void* addr = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (addr == MAP_FAILED) {
+                LOGE("mmap fail, errno: %{public}d", errno);
+                close(fd);
+                return;
+            }
+            data_ = static_cast<const char*>(addr);
+            (void)madvise(addr, size_, MADV_SEQUENTIAL);
+        }
+        close(fd);
+        valid_ = true;
+    }
+
+    ~MappedFile() override
+    {
+        if (data_ != nullptr) {
+            (void)munmap(const_cast<char*>(data_), size_);
+        }
+    }
+
+    bool IsValid() const
+    {
+        return valid_;
+    }
+
+    const char* Begin() const
+    {
+        return data_;
+    }
+
+    const char* End() const
+    {
+        return data_ + size_;
+    }
+
+private:
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+    bool valid_ = false;
+};
+
+bool ResolveRealPath(const std::string &filePath, char (&path)[PATH_MAX])
+{
+    if (filePath.empty()) {
+        LOGE("filePath empty");
+        return false;
+    }
+
+    if (access(filePath.c_str(), F_OK) != 0) {
+        LOGE("deepLink config not exist");
+        return false;
+    }
+
+    if (realpath(filePath.c_str(), path) == nullptr) {
+        LOGE("realpath error, errno: %{public}d", errno);
+        return false;
+    }
+    return true;
+}
+} // namespace
+
 bool JsonUtils::LoadConfiguration(const std::string& path, nlohmann::json& jsonBuf,
     const std::string& defaultPath)
 {
@@ -43,34 +125,55 @@ std::string JsonUtils::GetConfigPath(const std::string& path, const std::string&
 
 bool JsonUtils::ReadFileInfoJson(const std::string &filePath, nlohmann::json &jsonBuf)
 {
-    if (filePath.empty()) {
-        LOGE("filePath empty");
+    char path[PATH_MAX] = {0};
+    if (!ResolveRealPath(filePath, path)) {
         return false;
     }
 
-    if (access(filePath.c_str(), F_OK) != 0) {
-        LOGE("deepLink config not exist");
+    MappedFile file(path);
+    if (!file.IsValid()) {
+        LOGE("map file failed");
+        return false;
+    }
+    jsonBuf = nlohmann::json::parse(file.Begin(), file.End(), nullptr, false);
+    if (jsonBuf.is_discarded()) {
+        LOGE("bad profile file");
         return false;
     }
 
+    return true;
+}
+
+bool JsonUtils::SaxParseFile(const std::string &filePath, nlohmann::json_sax<nlohmann::json> &handler,
+    const bool isMutable)
+{
     char path[PATH_MAX] = {0};
-    if (realpath(filePath.c_str(), path) == nullptr) {
-        LOGE("realpath error, errno: %{public}d", errno);
+    if (!ResolveRealPath(filePath, path)) {
         return false;
     }
 
-    std::string dataBuffer;
-    bool res = ReadFileToBuffer(path, dataBuffer);
-    if (!res) {
-        LOGE("ReadFileToBuffer failed");
+    if (isMutable) {
+        std::string dataBuffer;
+        if (!ReadFileToBuffer(path, dataBuffer)) {
+            LOGE("read file failed");
+            return false;
+        }
+        if (!nlohmann::json::sax_parse(dataBuffer, &handler)) {
+            LOGE("bad profile file");
+            return false;
+        }
+        return true;
+    }
+
+    MappedFile file(path);
+    if (!file.IsValid()) {
+        LOGE("map file failed");
         return false;
     }
-    jsonBuf = nlohmann::json::parse(dataBuffer, nullptr, false);
-    if (jsonBuf.is_discarded()) {
+    if (!nlohmann::json::sax_parse(file.Begin(), file.End(), &handler)) {
         LOGE("bad profile file");
         return false;
     }
-
     return true;
 }
 
@@ -0,0 +1,177 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "local_time_cache.h"
+
+#include "ui_appearance_log.h"
+
+namespace OHOS::ArkUi::UiAppearance {
+namespace {
+constexpr int32_t DAY_TO_SECOND = 24 * 60 * 60;
+constexpr int32_t HOUR_TO_SECOND = 60 * 60;
+constexpr int32_t MINUTE_TO_SECOND = 60;
+}
+
+LocalTimeCache& LocalTimeCache::GetInstance()
+{
+    static LocalTimeCache instance;
+    return instance;
+}
+
+int32_t LocalTimeCache::GetSecondOfDay(const AlarmClock& clock, const std::time_t time)
+{
+    Snapshot snapshot;
+    Load(clock, time, snapshot);
+    if (snapshot.uniform) {
+        return static_cast<int32_t>(time - snapshot.dayStart);
+    }
+    std::tm localTime = {};
+    if (!clock.GetLocalTime(time, localTime)) {
+        LOGE("fail to get localtime");
+        return 0;
+    }
+    return localTime.tm_hour * HOUR_TO_SECOND + localTime.tm_min * MINUTE_TO_SECOND + localTime.tm_sec;
+}
+
+std::time_t LocalTimeCache::GetLocalTimestamp(const AlarmClock& clock, const std::time_t time,
+    const int32_t dayOffset, const int64_t minutes)
+{
+    Snapshot snapshot;
+    Load(clock, time, snapshot);
+    if (snapshot.uniform) {
+        std::time_t result = snapshot.dayStart + static_cast<std::time_t>(dayOffset) * DAY_TO_SECOND +
+            static_cast<std::time_t>(minutes) * MINUTE_TO_SECOND;
+        if (snapshot.uniformFrom <= result && result < snapshot.uniformUntil) {
+            return result;
+        }
+    }
+    std::tm localTime = {};
+    if (!clock.GetLocalTime(time, localTime)) {
+        LOGE("fail to get localtime");
+    }
+    return MakeLocalTime(clock, localTime, dayOffset, minutes);
+}
+
+void LocalTimeCache::Invalidate()
+{
+    std::lock_guard guard(refreshMutex_);
+    sequence_.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    valid_.store(false, std::memory_order_relaxed);
+    sequence_.fetch_add(1, std::memory_order_release);
+}
+
+uint64_t LocalTimeCache::GetRefreshCount() const
+{
+    return refreshCount_.load(std::memory_order_relaxed);
+}
+
+uint64_t LocalTimeCache::GetHitCount() const
+{
+    return hitCount_.load(std::memory_order_relaxed);
+}
+
+uint64_t LocalTimeCache::GetMissCount() const
+{
+    return missCount_.load(std::memory_order_relaxed);
+}
+
+void LocalTimeCache::Load(const AlarmClock& clock, const std::time_t time, Snapshot& snapshot)
+{
+    if (TryLoad(time, snapshot)) {
+        hitCount_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    missCount_.fetch_add(1, std::memory_order_relaxed);
+    Refresh(clock, time);
+    TryLoad(time, snapshot);
+}
+
+bool LocalTimeCache::TryLoad(const std::time_t time, Snapshot& snapshot) const
+{
+    uint32_t begin = sequence_.load(std::memory_order_acquire);
+    if ((begin & 1) != 0) {
+        snapshot = Snapshot();
+        return false;
+    }
+    bool valid = valid_.load(std::memory_order_relaxed);
+    snapshot.dayStart = dayStart_.load(std::memory_order_relaxed);
+    snapshot.nextDayStart = nextDayStart_.load(std::memory_order_relaxed);
+    snapshot.uniformFrom = uniformFrom_.load(std::memory_order_relaxed);
+    snapshot.uniformUntil = uniformUntil_.load(std::memory_order_relaxed);
+    snapshot.uniform = uniform_.load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (sequence_.load(std::memory_order_relaxed) != begin || !valid ||
+        time < snapshot.dayStart || time >= snapshot.nextDayStart) {
+        snapshot = Snapshot();
+        return false;
+    }
+    return true;
+}
+
+void LocalTimeCache::Refresh(const AlarmClock& clock, const std::time_t time)
+{
+    std::tm localTime = {};
+    if (!clock.GetLocalTime(time, localTime)) {
+        LOGE("fail to get localtime");
+        return;
+    }
+    std::time_t lastDayStart = MakeLocalTime(clock, localTime, -1, 0);
+    std::time_t dayStart = MakeLocalTime(clock, localTime, 0, 0);
+    std::time_t nextDayStart = MakeLocalTime(clock, localTime, 1, 0);
+    std::time_t dayAfterNextStart = MakeLocalTime(clock, localTime, 2, 0);
+    int64_t offsets[] = { 0, 0, 0, 0 };
+    bool uniform = nextDayStart - dayStart == DAY_TO_SECOND &&
+        GetUtcOffset(clock, lastDayStart, offsets[0]) && GetUtcOffset(clock, dayStart, offsets[1]) &&
+        GetUtcOffset(clock, nextDayStart, offsets[2]) && GetUtcOffset(clock, dayAfterNextStart - 1, offsets[3]) &&
+        offsets[0] == offsets[1] && offsets[1] == offsets[2] && offsets[2] == offsets[3];
+
+    std::lock_guard guard(refreshMutex_);
+    sequence_.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    dayStart_.store(dayStart, std::memory_order_relaxed);
+    nextDayStart_.store(nextDayStart, std::memory_order_relaxed);
+    uniformFrom_.store(lastDayStart, std::memory_order_relaxed);
+    uniformUntil_.store(dayAfterNextStart, std::memory_order_relaxed);
+    uniform_.store(uniform, std::memory_order_relaxed);
+    valid_.store(true, std::memory_order_relaxed);
+    sequence_.fetch_add(1, std::memory_order_release);
+    uint64_t refreshCount = refreshCount_.fetch_add(1, std::memory_order_relaxed) + 1;
+    LOGD("local day refreshed: %{public}lld, uniform: %{public}d, count: %{public}llu",
+        static_cast<long long>(dayStart), uniform, static_cast<unsigned long long>(refreshCount));
+}
+
+std::time_t LocalTimeCache::MakeLocalTime(const AlarmClock& clock, const std::tm& localTime,
+    const int32_t dayOffset, const int64_t minutes)
+{
+    std::tm time = localTime;
+    time.tm_mday += dayOffset;
+    time.tm_hour = 0;
+    time.tm_min = static_cast<int32_t>(minutes);
+    time.tm_sec = 0;
+    time.tm_isdst = -1;
+    return clock.MakeTime(time);
+}
+
+bool LocalTimeCache::GetUtcOffset(const AlarmClock& clock, const std::time_t time, int64_t& utcOffset)
+{
+    std::tm localTime = {};
+    if (!clock.GetLocalTime(time, localTime)) {
+        return false;
+    }
+    utcOffset = static_cast<int64_t>(timegm(&localTime) - time);
+    return true;
+}
+} // namespace OHOS::ArkUi::UiAppearance
@@ -0,0 +1,205 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "metrics_registry.h"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cmath>
+
+namespace OHOS::ArkUi::UiAppearance {
+namespace {
+constexpr std::array<const char*, static_cast<size_t>(MetricId::COUNT)> METRIC_NAMES = {
+    "ipc.SetDarkMode",
+    "ipc.GetDarkMode",
+    "ipc.SetFontScale",
+    "ipc.GetFontScale",
+    "ipc.SetFontWeightScale",
+    "ipc.GetFontWeightScale",
+    "ipc.SetSettingData",
+    "ipc.SetFontScaleValue",
+    "ipc.GetFontScaleValue",
+    "ipc.SetFontWeightScaleValue",
+    "ipc.GetFontWeightScaleValue",
+    "appmgr.UpdateConfiguration",
+    "settingdata.Get",
+    "settingdata.Set",
+    "settingdata.SetPair",
+    "settingdata.RegisterObserver",
+    "settingdata.UnregisterObserver",
+    "location.Fetch",
+    "alarm.Callback",
+};
+static_assert(METRIC_NAMES.back() != nullptr, "every MetricId needs a name");
+constexpr double PERCENTILE_50 = 50.0;
+constexpr double PERCENTILE_90 = 90.0;
+constexpr double PERCENTILE_99 = 99.0;
+constexpr double PERCENTILE_MAX = 100.0;
+constexpr uint32_t BITS_PER_U64 = 64;
+} // namespace
+
+void MetricHistogram::Record(const uint64_t latencyUs)
+{
+    buckets_[GetBucketIndex(latencyUs)].fetch_add(1, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+    totalUs_.fetch_add(latencyUs, std::memory_order_relaxed);
+    uint64_t currentMax = maxUs_.load(std::memory_order_relaxed);
+    while (latencyUs > currentMax &&
+        !maxUs_.compare_exchange_weak(currentMax, latencyUs, std::memory_order_relaxed)) {}
+}
+
+uint64_t MetricHistogram::GetCount() const
+{
+    return count_.load(std::memory_order_relaxed);
+}
+
+uint64_t MetricHistogram::GetMaxLatency() const
+{
+    return maxUs_.load(std::memory_order_relaxed);
+}
+
+uint64_t MetricHistogram::GetTotalLatency() const
+{
+    return totalUs_.load(std::memory_order_relaxed);
+}
+
+uint64_t MetricHistogram::GetPercentile(const double percentile) const
+{
+    // Buckets are read one by one while writers keep going; rank against their sum, not count_, to stay in range.
+    std::array<uint64_t, BUCKET_COUNT> counts {};
+    uint64_t total = 0;
+    for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+        counts[i] = buckets_[i].load(std::memory_order_relaxed);
+        total += counts[i];
+    }
+    if (total == 0) {
+        return 0;
+    }
+    double clamped = std::clamp(percentile, 0.0, PERCENTILE_MAX);
+    uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(clamped / PERCENTILE_MAX * total)));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+        seen += counts[i];
+        if (seen >= rank) {
+            return std::min(GetBucketUpperBound(i), GetMaxLatency());
+        }
+    }
+    return GetMaxLatency();
+}
+
+void MetricHistogram::Reset()
+{
+    for (auto& bucket : buckets_) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    count_.store(0, std::memory_order_relaxed);
+    totalUs_.store(0, std::memory_order_relaxed);
+    maxUs_.store(0, std::memory_order_relaxed);
+}
+
+size_t MetricHistogram::GetBucketIndex(const uint64_t latencyUs)
+{
+    if (latencyUs < SUB_BUCKET_COUNT) {
+        return static_cast<size_t>(latencyUs);
+    }
+    uint32_t exponent = BITS_PER_U64 - 1 - static_cast<uint32_t>(__builtin_clzll(latencyUs));
+    if (exponent > MAX_EXPONENT) {
+        return BUCKET_COUNT - 1;
+    }
+    uint32_t shift = exponent - SUB_BUCKET_BITS;
+    uint64_t subBucket = (latencyUs >> shift) - SUB_BUCKET_COUNT;
+    return static_cast<size_t>(SUB_BUCKET_COUNT + shift * SUB_BUCKET_COUNT + subBucket);
+}
+
+uint64_t MetricHistogram::GetBucketUpperBound(const size_t index)
+{
+    if (index < SUB_BUCKET_COUNT) {
+        return index;
+    }
+    uint64_t shift = (index - SUB_BUCKET_COUNT) / SUB_BUCKET_COUNT;
+    uint64_t subBucket = (index - SUB_BUCKET_COUNT) % SUB_BUCKET_COUNT;
+    return ((SUB_BUCKET_COUNT + subBucket + 1) << shift) - 1;
+}
+
+MetricsRegistry& MetricsRegistry::GetInstance()
+{
+    static MetricsRegistry instance;
+    return instance;
+}
+
+void MetricsRegistry::Record(const MetricId id, const uint64_t latencyUs, const bool isFailed)
+{
+    if (id >= MetricId::COUNT) {
+        return;
+    }
+    Metric& metric = metrics_[static_cast<size_t>(id)];
+    metric.histogram.Record(latencyUs);
+    if (isFailed) {
+        metric.failureCount.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+uint64_t MetricsRegistry::GetCount(const MetricId id) const
+{
+    return GetHistogram(id).GetCount();
+}
+
+uint64_t MetricsRegistry::GetFailureCount(const MetricId id) const
+{
+    if (id >= MetricId::COUNT) {
+        return 0;
+    }
+    return metrics_[static_cast<size_t>(id)].failureCount.load(std::memory_order_relaxed);
+}
+
+const MetricHistogram& MetricsRegistry::GetHistogram(const MetricId id) const
+{
+    // COUNT is never recorded, so clamping it onto the last metric only matters for callers passing bad ids.
+    size_t index = std::min(static_cast<size_t>(id), metrics_.size() - 1);
+    return metrics_[index].histogram;
+}
+
+void MetricsRegistry::Dump(DumpBuffer& out) const
+{
+    out.Append("%-32s %10s %8s %10s %10s %10s %10s %10s\n", "metric(us)", "calls", "failed", "mean", "p50", "p90",
+        "p99", "max");
+    for (size_t i = 0; i < metrics_.size(); ++i) {
+        const Metric& metric = metrics_[i];
+        uint64_t count = metric.histogram.GetCount();
+        uint64_t mean = count == 0 ? 0 : metric.histogram.GetTotalLatency() / count;
+        out.Append(
+            "%-32s %10" PRIu64 " %8" PRIu64 " %10" PRIu64 " %10" PRIu64 " %10" PRIu64 " %10" PRIu64 " %10" PRIu64 "\n",
+            METRIC_NAMES[i], count, metric.failureCount.load(std::memory_order_relaxed), mean,
+            metric.histogram.GetPercentile(PERCENTILE_50), metric.histogram.GetPercentile(PERCENTILE_90),
+            metric.histogram.GetPercentile(PERCENTILE_99), metric.histogram.GetMaxLatency());
+    }
+}
+
+void MetricsRegistry::Reset()
+{
+    for (auto& metric : metrics_) {
+        metric.histogram.Reset();
+        metric.failureCount.store(0, std::memory_order_relaxed);
+    }
+}
+
+const char* MetricsRegistry::GetName(const MetricId id)
+{
+    if (id >= MetricId::COUNT) {
+        return "unknown";
+    }
+    return METRIC_NAMES[static_cast<size_t>(id)];
+}
+} // namespace OHOS::ArkUi::UiAppearance
@@ -17,10 +17,13 @@
 
 #include <charconv>
 
+#include "account_context.h"
 #include "ipc_skeleton_utils.h"
 #include "iservice_registry.h"
+#include "metrics_registry.h"
 #include "system_ability_definition.h"
 #include "ui_appearance_log.h"
+#include "ui_appearance_trace.h"
 
 namespace OHOS::ArkUi::UiAppearance {
 namespace {
@@ -72,6 +75,7 @@ bool SettingDataManager::IsInitialized() const
 ErrCode SettingDataManager::RegisterObserver(const std::string& key, const SettingDataObserver::UpdateFunc& updateFunc,
     const int32_t userId)
 {
+    MetricScope metricScope(MetricId::SETTING_DATA_REGISTER_OBSERVER);
     if (!isInitialized_) {
         LOGE("SettingDataManager not initialized");
         return ERR_NO_INIT;
@@ -88,6 +92,7 @@ ErrCode SettingDataManager::RegisterObserver(const std::string& key, const Setti
     sptr<SettingDataObserver> observer = CreateObserver(key, updateFunc, userId);
     ErrCode code = RegisterObserverInner(observer);
     if (code != ERR_OK) {
+        metricScope.SetFailed(true);
         return code;
     }
     observers_.emplace(observerName, observer);
@@ -96,6 +101,7 @@ ErrCode SettingDataManager::RegisterObserver(const std::string& key, const Setti
 
 ErrCode SettingDataManager::UnregisterObserver(const std::string& key, const int32_t userId)
 {
+    MetricScope metricScope(MetricId::SETTING_DATA_UNREGISTER_OBSERVER);
     const std::string observerName = GenerateObserverName(key, userId);
     std::lock_guard guard(observersMutex_);
     const auto& iter = observers_.find(observerName);
@@ -111,11 +117,15 @@ ErrCode SettingDataManager::UnregisterObserver(const std::string& key, const int
 
     ErrCode code = UnregisterObserverInner(iter->second);
     observers_.erase(iter);
+    metricScope.SetFailed(code != ERR_OK);
     return code;
 }
 
 ErrCode SettingDataManager::GetStringValue(const std::string& key, std::string& value, const int32_t userId) const
 {
+    // Counted as failed unless the value is found; a missing key is a miss worth seeing too.
+    MetricScope metricScope(MetricId::SETTING_DATA_GET);
+    metricScope.SetFailed(true);
     std::string uriString;
     ResetCallingIdentityScope scope;
     std::shared_ptr<DataShare::DataShareHelper> helper;
@@ -152,6 +162,7 @@ ErrCode SettingDataManager::GetStringValue(const std::string& key, std::string&
     }
     result->Close();
     LOGD("Get key: %{public}s, userId: %{public}d, value: %{public}s", key.c_str(), userId, value.c_str());
+    metricScope.SetFailed(false);
     return ERR_OK;
 }
 
@@ -218,6 +229,9 @@ ErrCode SettingDataManager::GetBoolValue(const std::string& key, bool& value, co
 ErrCode SettingDataManager::SetStringValue(const std::string& key, const std::string& value, int32_t userId,
     bool needNotify) const
 {
+    UI_APPEARANCE_TRACE_SCOPE("SettingData.SetStringValue", userId, INVALID_SUB_PROFILE_ID);
+    MetricScope metricScope(MetricId::SETTING_DATA_SET);
+    metricScope.SetFailed(true);
     std::string uriString;
     ResetCallingIdentityScope scope;
     std::shared_ptr<DataShare::DataShareHelper> helper;
@@ -251,6 +265,7 @@ ErrCode SettingDataManager::SetStringValue(const std::string& key, const std::st
     }
     ReleaseDataShareHelper(helper);
     LOGD("put key: %{public}s, userId: %{public}d, value: %{public}s", key.c_str(), userId, value.c_str());
+    metricScope.SetFailed(false);
     return ERR_OK;
 }
 
@@ -264,6 +279,8 @@ ErrCode SettingDataManager::SetInt32Value(const std::string& key, const int32_t
 ErrCode SettingDataManager::SetInt32ValuePair(const std::string& firstKey, const int32_t firstValue,
     const std::string& secondKey, const int32_t secondValue, const int32_t userId) const
 {
+    MetricScope metricScope(MetricId::SETTING_DATA_SET_PAIR);
+    metricScope.SetFailed(true);
     int32_t oldFirstValue = 0;
     const bool canRollbackFirst = GetInt32Value(firstKey, oldFirstValue, userId) == ERR_OK;
     std::string firstUriString;
@@ -315,6 +332,7 @@ ErrCode SettingDataManager::SetInt32ValuePair(const std::string& firstKey, const
     secondHelper->NotifyChange(secondUri);
     ReleaseDataShareHelper(firstHelper);
     ReleaseDataShareHelper(secondHelper);
+    metricScope.SetFailed(false);
     return ERR_OK;
 }
 
@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <array>
+
+#include <benchmark/benchmark.h>
+
+// mock
+#include "simulated_alarm_timer.h"
+
+#define private public
+#include "alarm_timer_manager.h"
+#undef private
+#include "local_time_cache.h"
+
+namespace OHOS::ArkUi::UiAppearance {
+namespace {
+constexpr uint64_t SECOND_TO_MILLI = 1000;
+constexpr uint64_t HOUR_TO_MILLI = 60 * 60 * SECOND_TO_MILLI;
+constexpr uint64_t DAY_TO_MILLI = 24 * HOUR_TO_MILLI;
+constexpr uint64_t DAYS_OF_YEAR = 365;
+constexpr std::time_t YEAR_START = 1767225600;
+constexpr std::time_t DST_START = 1774746000;
+constexpr std::time_t DST_END = 1792890000;
+constexpr int32_t CET_OFFSET = 3600;
+constexpr int32_t DST_OFFSET = 3600;
+constexpr uint64_t BASE_USER_ID = 100;
+constexpr uint64_t SCHEDULE_START = 1200;
+constexpr uint64_t SCHEDULE_END = 1860;
+} // namespace
+
+// Replays a year of start, end and recalculation transitions for state.range(0) users on simulated time and reports
+// the cost and the backend calls (TimeService IPCs on a device) per dispatched transition.
+static void BM_ReplayYearTransitions(benchmark::State& state)
+{
+    const uint64_t userCount = static_cast<uint64_t>(state.range(0));
+    uint64_t transitions = 0;
+    uint64_t backendCalls = 0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto clock = std::make_shared<SimulatedAlarmClock>(YEAR_START * SECOND_TO_MILLI, CET_OFFSET);
+        clock->AddDstPeriod(DST_START, DST_END, DST_OFFSET);
+        AlarmClock::SetInstance(clock);
+        auto backend = std::make_shared<SimulatedAlarmTimerBackend>(clock);
+        {
+            AlarmTimerManager manager(backend);
+            for (uint64_t userId = BASE_USER_ID; userId < BASE_USER_ID + userCount; ++userId) {
+                manager.SetScheduleTime(SCHEDULE_START, SCHEDULE_END, userId, []() {}, []() {});
+                manager.SetRecalculationTimer(userId, []() {});
+            }
+            uint64_t callCount = backend->GetCallCount();
+            uint64_t fireCount = backend->GetFireCount();
+            state.ResumeTiming();
+
+            backend->AdvanceTo(YEAR_START * SECOND_TO_MILLI + DAYS_OF_YEAR * DAY_TO_MILLI);
+
+            state.PauseTiming();
+            transitions += manager.dispatchCount_;
+            backendCalls += backend->GetCallCount() - callCount;
+            benchmark::DoNotOptimize(backend->GetFireCount() - fireCount);
+        }
+        AlarmClock::SetInstance(nullptr);
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(transitions));
+    state.counters["calls_per_transition"] = transitions > 0 ?
+        static_cast<double>(backendCalls) / static_cast<double>(transitions) : 0.0;
+}
+BENCHMARK(BM_ReplayYearTransitions)->RangeMultiplier(4)->Range(1, 64)->Unit(benchmark::kMillisecond);
+
+// A time or time zone change rewrites every user schedule; the system alarm is re-armed at most once.
+static void BM_RestartAllTimer(benchmark::State& state)
+{
+    const uint64_t userCount = static_cast<uint64_t>(state.range(0));
+    auto clock = std::make_shared<SimulatedAlarmClock>(YEAR_START * SECOND_TO_MILLI, CET_OFFSET);
+    AlarmClock::SetInstance(clock);
+    auto backend = std::make_shared<SimulatedAlarmTimerBackend>(clock);
+    {
+        AlarmTimerManager manager(backend);
+        for (uint64_t userId = BASE_USER_ID; userId < BASE_USER_ID + userCount; ++userId) {
+            manager.SetScheduleTime(SCHEDULE_START, SCHEDULE_END, userId, []() {}, []() {});
+        }
+        uint64_t callCount = backend->GetCallCount();
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(manager.RestartAllTimer());
+        }
+        state.counters["calls_per_restart"] = benchmark::Counter(
+            static_cast<double>(backend->GetCallCount() - callCount), benchmark::Counter::kAvgIterations);
+    }
+    AlarmClock::SetInstance(nullptr);
+}
+BENCHMARK(BM_RestartAllTimer)->RangeMultiplier(4)->Range(1, 64);
+
+// Computes the next start and end trigger times from a timestamp that moves by one hour per iteration, so a year of
+// days, including both DST switch days, is covered every 8760 iterations.
+static void BM_SetTimerTriggerTime(benchmark::State& state)
+{
+    SimulatedAlarmClock clock(YEAR_START * SECOND_TO_MILLI, CET_OFFSET);
+    clock.AddDstPeriod(DST_START, DST_END, DST_OFFSET);
+    const uint64_t yearEnd = YEAR_START * SECOND_TO_MILLI + DAYS_OF_YEAR * DAY_TO_MILLI;
+    uint64_t timestamp = YEAR_START * SECOND_TO_MILLI;
+    std::array<uint64_t, TRIGGER_ARRAY_SIZE> triggerTimeInterval = { 0, 0 };
+    // The cached local day belongs to whichever clock ran before.
+    LocalTimeCache::GetInstance().Invalidate();
+    for (auto _ : state) {
+        AlarmTimerManager::SetTimerTriggerTime(clock, timestamp, SCHEDULE_START, SCHEDULE_END, triggerTimeInterval);
+        benchmark::DoNotOptimize(triggerTimeInterval);
+        timestamp = timestamp + HOUR_TO_MILLI < yearEnd ? timestamp + HOUR_TO_MILLI : YEAR_START * SECOND_TO_MILLI;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SetTimerTriggerTime);
+} // namespace OHOS::ArkUi::UiAppearance
+
+BENCHMARK_MAIN();
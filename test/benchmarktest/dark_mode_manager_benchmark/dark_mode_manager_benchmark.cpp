@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <chrono>
+
+#include <benchmark/benchmark.h>
+#include <gmock/gmock.h>
+
+// mock
+#include "alarm_timer_manager.h"
+#include "setting_data_manager.h"
+
+#define private public
+#include "dark_mode_manager.h"
+#undef private
+
+using namespace testing;
+
+namespace OHOS::ArkUi::UiAppearance {
+namespace {
+const std::string SETTING_DARK_MODE_MODE = "settings.uiappearance.darkmode_mode";
+const std::string SETTING_DARK_MODE_START_TIME = "settings.uiappearance.darkmode_starttime";
+const std::string SETTING_DARK_MODE_END_TIME = "settings.uiappearance.darkmode_endtime";
+constexpr int32_t BASE_USER_ID = 100;
+constexpr int32_t MAX_CONTEXTS = 16;
+constexpr int32_t SCHEDULE_START = 20 * 60;
+constexpr int32_t SCHEDULE_END = 7 * 60 + 24 * 60;
+constexpr std::chrono::microseconds SIMULATED_IPC_COST(50);
+
+void SimulateIpc()
+{
+    auto end = std::chrono::steady_clock::now() + SIMULATED_IPC_COST;
+    while (std::chrono::steady_clock::now() < end) {}
+}
+
+void SetUpDarkModeManager()
+{
+    GMOCK_FLAG(verbose) = "error";
+    DarkModeManager& manager = DarkModeManager::GetInstance();
+    manager.Initialize([](bool, int32_t) {});
+    ON_CALL(manager.alarmTimerManager_, SetScheduleTime(_, _, _, _, _)).WillByDefault(Invoke(
+        [](Unused, Unused, Unused, Unused, Unused) {
+            SimulateIpc();
+            return ERR_OK;
+        }));
+    ON_CALL(SettingDataManager::GetInstance(), MockGetInt32ValueStrictly(_, _, _)).WillByDefault(Invoke(
+        [](Unused, int32_t& value, Unused) {
+            value = 1;
+            return ERR_OK;
+        }));
+    for (int32_t i = 0; i < MAX_CONTEXTS; ++i) {
+        manager.activeContexts_.insert(BASE_USER_ID + i);
+        DarkModeManager::DarkModeState& state = manager.GetState(BASE_USER_ID + i);
+        state.settingMode = DarkModeManager::DARK_MODE_CUSTOM_AUTO;
+        state.settingStartTime = 0;
+    }
+}
+} // namespace
+
+// Each thread owns one AccountContext and keeps updating its schedule, which goes through a simulated timer IPC.
+// With per-context state the throughput scales with the number of contexts instead of serializing on one lock.
+static void BM_ConcurrentContextScheduleUpdate(benchmark::State& state)
+{
+    if (state.thread_index() == 0) {
+        SetUpDarkModeManager();
+    }
+    DarkModeManager& manager = DarkModeManager::GetInstance();
+    const AccountContext context = AccountContextHelper::CreateBaseContext(BASE_USER_ID + state.thread_index());
+    for (auto _ : state) {
+        manager.SettingDataDarkModeEndTimeUpdateFunc(SETTING_DARK_MODE_END_TIME, context);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ConcurrentContextScheduleUpdate)->ThreadRange(1, MAX_CONTEXTS)->UseRealTime();
+
+static void BM_ConcurrentContextGetSettingTime(benchmark::State& state)
+{
+    if (state.thread_index() == 0) {
+        SetUpDarkModeManager();
+    }
+    DarkModeManager& manager = DarkModeManager::GetInstance();
+    const AccountContext context = AccountContextHelper::CreateBaseContext(BASE_USER_ID + state.thread_index());
+    int32_t startTime = 0;
+    int32_t endTime = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(manager.GetSettingTime(context, startTime, endTime));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ConcurrentContextGetSettingTime)->ThreadRange(1, MAX_CONTEXTS)->UseRealTime();
+
+// Reloads one context's five settings and applies them; state.range(0) is the stored mode. Custom auto also rebuilds
+// the schedule, which goes through the simulated timer IPC.
+static void BM_LoadUserSettingData(benchmark::State& state)
+{
+    SetUpDarkModeManager();
+    const int32_t mode = static_cast<int32_t>(state.range(0));
+    ON_CALL(SettingDataManager::GetInstance(), MockGetInt32ValueStrictly(_, _, _)).WillByDefault(Invoke(
+        [mode](const std::string& key, int32_t& value, Unused) {
+            if (key.find(SETTING_DARK_MODE_MODE) != std::string::npos) {
+                value = mode;
+            } else if (key.find(SETTING_DARK_MODE_START_TIME) != std::string::npos) {
+                value = SCHEDULE_START;
+            } else if (key.find(SETTING_DARK_MODE_END_TIME) != std::string::npos) {
+                value = SCHEDULE_END;
+            } else {
+                return ERR_INVALID_VALUE;
+            }
+            return ERR_OK;
+        }));
+    DarkModeManager& manager = DarkModeManager::GetInstance();
+    const AccountContext context = AccountContextHelper::CreateBaseContext(BASE_USER_ID);
+    bool isDarkMode = false;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(manager.LoadUserSettingData(context, false, isDarkMode, false));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_LoadUserSettingData)
+    ->Arg(DarkModeManager::DARK_MODE_ALWAYS_DARK)
+    ->Arg(DarkModeManager::DARK_MODE_CUSTOM_AUTO);
+} // namespace OHOS::ArkUi::UiAppearance
+
+BENCHMARK_MAIN();
@@ -0,0 +1,167 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "js_ui_appearance.h"
+
+namespace OHOS::ArkUi::UiAppearance {
+namespace {
+constexpr std::chrono::microseconds SIMULATED_IPC_COST(50);
+const std::string PERMISSION_ERR_MSG =
+    "An attempt was made to update configuration forbidden by permission: ohos.permission.UPDATE_CONFIGURATION.";
+
+void SimulateIpc()
+{
+    auto end = std::chrono::steady_clock::now() + SIMULATED_IPC_COST;
+    while (std::chrono::steady_clock::now() < end) {}
+}
+
+// Stands in for the async work pool: executes queued contexts and hands them back to the JS thread to complete.
+class SimulatedWorker final {
+public:
+    SimulatedWorker() : thread_([this]() { Run(); }) {}
+
+    ~SimulatedWorker()
+    {
+        {
+            std::lock_guard lock(mutex_);
+            stopped_ = true;
+        }
+        cv_.notify_all();
+        thread_.join();
+    }
+
+    void Queue(AsyncContext* asyncContext)
+    {
+        {
+            std::lock_guard lock(mutex_);
+            queued_.push_back(asyncContext);
+        }
+        cv_.notify_all();
+    }
+
+    AsyncContext* WaitCompleted()
+    {
+        std::unique_lock lock(mutex_);
+        cv_.wait(lock, [this]() { return !completed_.empty(); });
+        AsyncContext* asyncContext = completed_.front();
+        completed_.pop_front();
+        return asyncContext;
+    }
+
+    uint64_t GetExecuteCount() const
+    {
+        return executeCount_;
+    }
+
+private:
+    void Run()
+    {
+        std::unique_lock lock(mutex_);
+        while (true) {
+            cv_.wait(lock, [this]() { return stopped_ || !queued_.empty(); });
+            if (stopped_) {
+                return;
+            }
+            AsyncContext* asyncContext = queued_.front();
+            queued_.pop_front();
+            lock.unlock();
+            asyncContext->BeginExecute();
+            SimulateIpc();
+            asyncContext->status = UiAppearanceAbilityErrCode::SUCCEEDED;
+            lock.lock();
+            ++executeCount_;
+            completed_.push_back(asyncContext);
+            cv_.notify_all();
+        }
+    }
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<AsyncContext*> queued_;
+    std::deque<AsyncContext*> completed_;
+    uint64_t executeCount_ = 0;
+    bool stopped_ = false;
+    std::thread thread_;
+};
+} // namespace
+
+// The allocation every set call used to make, against the per-env freelist it now takes its context from.
+static void BM_AsyncContextNewDelete(benchmark::State& state)
+{
+    for (auto _ : state) {
+        auto asyncContext = new (std::nothrow) AsyncContext();
+        asyncContext->waiters.push_back(AsyncWaiter());
+        asyncContext->errMsg = PERMISSION_ERR_MSG;
+        benchmark::DoNotOptimize(asyncContext);
+        delete asyncContext;
+    }
+}
+BENCHMARK(BM_AsyncContextNewDelete);
+
+static void BM_AsyncContextPool(benchmark::State& state)
+{
+    for (auto _ : state) {
+        AsyncContext* asyncContext = AsyncContextPool::Acquire();
+        asyncContext->waiters.push_back(AsyncWaiter());
+        asyncContext->errMsg = PERMISSION_ERR_MSG;
+        benchmark::DoNotOptimize(asyncContext);
+        AsyncContextPool::Release(asyncContext);
+    }
+}
+BENCHMARK(BM_AsyncContextPool);
+
+// A JS thread fires a burst of setFontScale calls and waits for every promise, as a slider drag does.
+// Arg 0 is the burst size, Arg 1 enables merging into the queued request; "ipcPerBurst" is what reaches the service.
+static void BM_SetFontScaleBurst(benchmark::State& state)
+{
+    const int64_t burstSize = state.range(0);
+    const bool isMergeable = state.range(1) != 0;
+    SimulatedWorker worker;
+    for (auto _ : state) {
+        int64_t inFlight = 0;
+        for (int64_t i = 0; i < burstSize; ++i) {
+            double fontScale = 1.0 + static_cast<double>(i) / burstSize;
+            auto update = [fontScale](AsyncContext& asyncContext) { asyncContext.jsFontScale = fontScale; };
+            bool isMerged = false;
+            AsyncContext* asyncContext =
+                RequestMerger::Submit(REQUEST_SET_FONT_SCALE, AsyncWaiter(), update, isMergeable, isMerged);
+            if (!isMerged) {
+                worker.Queue(asyncContext);
+                ++inFlight;
+            }
+        }
+        for (; inFlight > 0; --inFlight) {
+            AsyncContext* asyncContext = worker.WaitCompleted();
+            benchmark::DoNotOptimize(RequestMerger::Complete(asyncContext).size());
+            AsyncContextPool::Release(asyncContext);
+        }
+    }
+    state.counters["ipcPerBurst"] = benchmark::Counter(
+        static_cast<double>(worker.GetExecuteCount()) / static_cast<double>(state.iterations()));
+    state.SetItemsProcessed(state.iterations() * burstSize);
+}
+BENCHMARK(BM_SetFontScaleBurst)->ArgsProduct({ { 1, 8, 64 }, { 0, 1 } })->UseRealTime();
+} // namespace OHOS::ArkUi::UiAppearance
+
+BENCHMARK_MAIN();
@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <fstream>
+#include <string>
+#include <unistd.h>
+
+#include <benchmark/benchmark.h>
+
+#include "background_app_color_switch_settings.h"
+#include "json_utils.h"
+
+namespace OHOS::ArkUi::UiAppearance {
+namespace {
+const std::string ALLOW_LIST_PATH = "/data/local/tmp/dark_mode_whilelist_benchmark.json";
+constexpr int64_t MIN_ENTRIES = 1 << 10;
+constexpr int64_t MAX_ENTRIES = 1 << 17;
+constexpr int64_t ENTRIES_MULTIPLIER = 8;
+
+// Writes an allow list shaped like the shipped one; 1 << 17 entries is about 6 MB.
+int64_t WriteAllowList(int64_t entries)
+{
+    std::ofstream file(ALLOW_LIST_PATH, std::ios::trunc);
+    file << R"({"whiteList":[)";
+    for (int64_t i = 0; i < entries; ++i) {
+        file << (i == 0 ? "" : ",") << R"({"bundleName":"com.example.background.application)" << i << R"("})";
+    }
+    file << R"(],"strategy":{"duration":300,"perTaskNumber":10}})";
+    return static_cast<int64_t>(file.tellp());
+}
+} // namespace
+
+// The previous path: stat + fread into a heap buffer, copy into a std::string, then build a DOM.
+static void BM_ReadFileToBufferThenParse(benchmark::State& state)
+{
+    int64_t fileSize = WriteAllowList(state.range(0));
+    for (auto _ : state) {
+        std::string buffer;
+        JsonUtils::ReadFileToBuffer(ALLOW_LIST_PATH, buffer);
+        nlohmann::json object = nlohmann::json::parse(buffer, nullptr, false);
+        benchmark::DoNotOptimize(object);
+    }
+    state.SetBytesProcessed(state.iterations() * fileSize);
+    unlink(ALLOW_LIST_PATH.c_str());
+}
+BENCHMARK(BM_ReadFileToBufferThenParse)->RangeMultiplier(ENTRIES_MULTIPLIER)->Range(MIN_ENTRIES, MAX_ENTRIES);
+
+// Builds the same DOM from an iterator pair over the mapping, with no intermediate copy.
+static void BM_ReadFileInfoJsonMapped(benchmark::State& state)
+{
+    int64_t fileSize = WriteAllowList(state.range(0));
+    for (auto _ : state) {
+        nlohmann::json object;
+        benchmark::DoNotOptimize(JsonUtils::ReadFileInfoJson(ALLOW_LIST_PATH, object));
+    }
+    state.SetBytesProcessed(state.iterations() * fileSize);
+    unlink(ALLOW_LIST_PATH.c_str());
+}
+BENCHMARK(BM_ReadFileInfoJsonMapped)->RangeMultiplier(ENTRIES_MULTIPLIER)->Range(MIN_ENTRIES, MAX_ENTRIES);
+
+// The allow list reload: streams the mapping through the SAX handler and keeps only the settings.
+static void BM_AllowListSaxReload(benchmark::State& state)
+{
+    int64_t fileSize = WriteAllowList(state.range(0));
+    BackGroundAppColorSwitchSettings& settings = BackGroundAppColorSwitchSettings::GetInstance();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(settings.Reload(ALLOW_LIST_PATH));
+    }
+    state.SetBytesProcessed(state.iterations() * fileSize);
+    settings.Reset();
+    unlink(ALLOW_LIST_PATH.c_str());
+}
+BENCHMARK(BM_AllowListSaxReload)->RangeMultiplier(ENTRIES_MULTIPLIER)->Range(MIN_ENTRIES, MAX_ENTRIES);
+} // namespace OHOS::ArkUi::UiAppearance
+
+BENCHMARK_MAIN();
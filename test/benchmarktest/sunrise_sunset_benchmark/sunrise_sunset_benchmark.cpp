@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "sunrise_sunset_calc.h"
+
+namespace OHOS::ArkUi::UiAppearance {
+namespace {
+// 2025-01-01T00:00:00Z.
+constexpr int64_t YEAR_START_MS = 1735689600000;
+constexpr int64_t DAY_MS = 86400000;
+constexpr int32_t DAYS_PER_YEAR = 365;
+constexpr double LAT_SPAN = 120.0;
+constexpr double LON_SPAN = 360.0;
+constexpr int64_t MIN_POINTS = 64;
+constexpr int64_t MAX_POINTS = 65536;
+
+struct SunPoints {
+    std::vector<double> lats;
+    std::vector<double> lons;
+    std::vector<int64_t> timestamps;
+    std::vector<double> sunrises;
+    std::vector<double> sunsets;
+};
+
+// Spreads the points over latitudes [-60, 60], all longitudes and every day of the year.
+SunPoints MakePoints(size_t count)
+{
+    SunPoints points;
+    for (size_t i = 0; i < count; ++i) {
+        double ratio = static_cast<double>(i) / count;
+        points.lats.push_back(LAT_SPAN * ratio - LAT_SPAN / 2);
+        points.lons.push_back(LON_SPAN * (1.0 - ratio) - LON_SPAN / 2);
+        points.timestamps.push_back(YEAR_START_MS + static_cast<int64_t>(i % DAYS_PER_YEAR) * DAY_MS);
+    }
+    points.sunrises.resize(count);
+    points.sunsets.resize(count);
+    return points;
+}
+} // namespace
+
+static void BM_ScalarSunriseSunset(benchmark::State& state)
+{
+    SunPoints points = MakePoints(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        for (size_t i = 0; i < points.lats.size(); ++i) {
+            SunriseSunsetResult result =
+                SunriseSunsetUtils::CalculateSunriseSunset(points.lats[i], points.lons[i], points.timestamps[i]);
+            points.sunrises[i] = result.sunrise;
+            points.sunsets[i] = result.sunset;
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ScalarSunriseSunset)->RangeMultiplier(16)->Range(MIN_POINTS, MAX_POINTS);
+
+static void BM_FixedPointSunriseSunset(benchmark::State& state)
+{
+    SunPoints points = MakePoints(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        for (size_t i = 0; i < points.lats.size(); ++i) {
+            SunriseSunsetResult result = SunriseSunsetUtils::CalculateSunriseSunsetFixedPoint(points.lats[i],
+                points.lons[i], points.timestamps[i]);
+            points.sunrises[i] = result.sunrise;
+            points.sunsets[i] = result.sunset;
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_FixedPointSunriseSunset)->RangeMultiplier(16)->Range(MIN_POINTS, MAX_POINTS);
+
+// Rebuilding the yearly table is what a location change costs with SunriseSunsetTable.
+static void BM_BuildSunriseSunsetTable(benchmark::State& state)
+{
+    SunriseSunsetTable table;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(table.Build(31.2304, 121.4737, YEAR_START_MS));
+    }
+    state.SetItemsProcessed(state.iterations() * SunriseSunsetTable::DAYS_PER_TABLE);
+}
+BENCHMARK(BM_BuildSunriseSunsetTable);
+
+static void BM_BatchSunriseSunset(benchmark::State& state)
+{
+    SunPoints points = MakePoints(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        SunriseSunsetUtils::CalculateSunriseSunsetBatch(points.lats.size(), points.lats.data(), points.lons.data(),
+            points.timestamps.data(), points.sunrises.data(), points.sunsets.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_BatchSunriseSunset)->RangeMultiplier(16)->Range(MIN_POINTS, MAX_POINTS);
+} // namespace OHOS::ArkUi::UiAppearance
+
+BENCHMARK_MAIN();
@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include "system_ability_definition.h"
+#define private public
+#define protected public
+#include "ui_appearance_ability.h"
+#undef private
+#undef protected
+
+namespace OHOS::ArkUi::UiAppearance {
+namespace {
+constexpr int32_t MAX_THREADS = 16;
+
+class UiAppearanceAbilityBenchmark : public UiAppearanceAbility {
+public:
+    UiAppearanceAbilityBenchmark() : UiAppearanceAbility(ARKUI_UI_APPEARANCE_SERVICE_ID, true) {}
+    ~UiAppearanceAbilityBenchmark() override = default;
+    void OnStart() override {}
+};
+
+// One ability for the whole run, with the calling context already loaded so the getters take their cached path.
+UiAppearanceAbility& GetAbility()
+{
+    static sptr<UiAppearanceAbilityBenchmark> ability = []() {
+        sptr<UiAppearanceAbilityBenchmark> instance = new UiAppearanceAbilityBenchmark;
+        UiAppearanceAbility::UiAppearanceParam param;
+        param.darkMode = DarkMode::ALWAYS_DARK;
+        std::lock_guard<std::mutex> guard(instance->usersParamMutex_);
+        instance->usersParam_[instance->GetCallingAccountContext()] = param;
+        return instance;
+    }();
+    return *ability;
+}
+} // namespace
+
+// Every IPC thread reads the same context, so this shows how the getters scale while sharing usersParamMutex_.
+static void BM_GetDarkModeContended(benchmark::State& state)
+{
+    UiAppearanceAbility& ability = GetAbility();
+    int32_t darkMode = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(ability.GetDarkMode(darkMode));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_GetDarkModeContended)->ThreadRange(1, MAX_THREADS)->UseRealTime();
+
+static void BM_GetFontScaleContended(benchmark::State& state)
+{
+    UiAppearanceAbility& ability = GetAbility();
+    std::string fontScale;
+    int32_t result = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(ability.GetFontScale(fontScale, result));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_GetFontScaleContended)->ThreadRange(1, MAX_THREADS)->UseRealTime();
+
+// Flips the mode on every iteration: configuration update through the mocked AppMgrProxy, parameter writes through
+// the mocked parameter store, then the dark mode manager and setting data notification.
+static void BM_OnSetDarkMode(benchmark::State& state)
+{
+    UiAppearanceAbility& ability = GetAbility();
+    const AccountContext context = ability.GetCallingAccountContext();
+    bool isDark = false;
+    for (auto _ : state) {
+        isDark = !isDark;
+        DarkMode mode = isDark ? DarkMode::ALWAYS_DARK : DarkMode::ALWAYS_LIGHT;
+        benchmark::DoNotOptimize(ability.OnSetDarkMode(context, mode));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_OnSetDarkMode);
+} // namespace OHOS::ArkUi::UiAppearance
+
+BENCHMARK_MAIN();
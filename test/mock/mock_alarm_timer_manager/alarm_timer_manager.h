@@ -20,6 +20,7 @@
 #include <functional>
 #include <gmock/gmock.h>
 
+#include "dump_buffer.h"
 #include "errors.h"
 
 namespace OHOS::ArkUi::UiAppearance {
@@ -46,7 +47,7 @@ public:
         const std::function<void()>& startCallback, const std::function<void()>& endCallback));
     MOCK_METHOD(void, ClearTimerByUserId, (uint64_t userId));
     MOCK_METHOD(bool, RestartAllTimer, ());
-    MOCK_METHOD(void, Dump, (), (const));
+    MOCK_METHOD(void, Dump, (DumpBuffer& out));
     MOCK_METHOD(bool, MockIsWithinTimeInterval, (uint64_t startTime, uint64_t endTime));
     MOCK_METHOD(void, SetRecalculationTimer, (uint64_t userId, const std::function<void()>& callback));
     MOCK_METHOD(void, ClearRecalculationTimer, (uint64_t userId));
@@ -0,0 +1,178 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "simulated_alarm_timer.h"
+
+namespace OHOS::ArkUi::UiAppearance {
+SimulatedAlarmClock::SimulatedAlarmClock(const uint64_t timestamp, const int32_t utcOffset)
+    : timestamp_(timestamp), utcOffset_(utcOffset)
+{}
+
+uint64_t SimulatedAlarmClock::GetCurrentTimestamp() const
+{
+    std::lock_guard lock(mutex_);
+    return timestamp_;
+}
+
+bool SimulatedAlarmClock::GetLocalTime(const std::time_t time, std::tm& localTime) const
+{
+    std::lock_guard lock(mutex_);
+    int32_t dstOffset = GetDstOffsetLocked(time);
+    std::time_t local = time + utcOffset_ + dstOffset;
+    if (gmtime_r(&local, &localTime) == nullptr) {
+        return false;
+    }
+    localTime.tm_isdst = dstOffset != 0 ? 1 : 0;
+    return true;
+}
+
+std::time_t SimulatedAlarmClock::MakeTime(std::tm& localTime) const
+{
+    std::time_t local = timegm(&localTime);
+    std::time_t time = 0;
+    {
+        std::lock_guard lock(mutex_);
+        // Resolve the offset at the guessed instant, then once more in case the guess crossed a DST boundary.
+        time = local - utcOffset_ - GetDstOffsetLocked(local - utcOffset_);
+        time = local - utcOffset_ - GetDstOffsetLocked(time);
+    }
+    GetLocalTime(time, localTime);
+    return time;
+}
+
+void SimulatedAlarmClock::SetCurrentTimestamp(const uint64_t timestamp)
+{
+    std::lock_guard lock(mutex_);
+    timestamp_ = timestamp;
+}
+
+void SimulatedAlarmClock::SetUtcOffset(const int32_t utcOffset)
+{
+    std::lock_guard lock(mutex_);
+    utcOffset_ = utcOffset;
+}
+
+void SimulatedAlarmClock::AddDstPeriod(const std::time_t startTime, const std::time_t endTime,
+    const int32_t dstOffset)
+{
+    std::lock_guard lock(mutex_);
+    dstPeriods_.push_back({ startTime, endTime, dstOffset });
+}
+
+int32_t SimulatedAlarmClock::GetDstOffsetLocked(const std::time_t time) const
+{
+    for (const auto& period : dstPeriods_) {
+        if (period.startTime <= time && time < period.endTime) {
+            return period.dstOffset;
+        }
+    }
+    return 0;
+}
+
+SimulatedAlarmTimerBackend::SimulatedAlarmTimerBackend(const std::shared_ptr<SimulatedAlarmClock>& clock)
+    : clock_(clock)
+{}
+
+uint64_t SimulatedAlarmTimerBackend::CreateTimer(const std::function<void()>& callback, const std::string&)
+{
+    std::lock_guard lock(mutex_);
+    callCount_++;
+    timers_[++nextTimerId_].callback = callback;
+    return nextTimerId_;
+}
+
+bool SimulatedAlarmTimerBackend::StartTimer(const uint64_t timerId, const uint64_t triggerTime)
+{
+    std::lock_guard lock(mutex_);
+    callCount_++;
+    auto it = timers_.find(timerId);
+    if (it == timers_.end()) {
+        return false;
+    }
+    it->second.triggerTime = triggerTime;
+    it->second.started = true;
+    return true;
+}
+
+bool SimulatedAlarmTimerBackend::StopTimer(const uint64_t timerId)
+{
+    std::lock_guard lock(mutex_);
+    callCount_++;
+    auto it = timers_.find(timerId);
+    if (it == timers_.end()) {
+        return false;
+    }
+    it->second.started = false;
+    return true;
+}
+
+bool SimulatedAlarmTimerBackend::DestroyTimer(const uint64_t timerId)
+{
+    std::lock_guard lock(mutex_);
+    callCount_++;
+    return timers_.erase(timerId) > 0;
+}
+
+void SimulatedAlarmTimerBackend::AdvanceTo(const uint64_t timestamp)
+{
+    while (true) {
+        std::function<void()> callback;
+        {
+            std::lock_guard lock(mutex_);
+            auto due = timers_.end();
+            for (auto it = timers_.begin(); it != timers_.end(); ++it) {
+                if (it->second.started && it->second.triggerTime <= timestamp &&
+                    (due == timers_.end() || it->second.triggerTime < due->second.triggerTime)) {
+                    due = it;
+                }
+            }
+            if (due == timers_.end()) {
+                break;
+            }
+            // Timers are one-shot, and an alarm set in the past fires immediately like TimeService does.
+            due->second.started = false;
+            fireCount_++;
+            callback = due->second.callback;
+            if (due->second.triggerTime > clock_->GetCurrentTimestamp()) {
+                clock_->SetCurrentTimestamp(due->second.triggerTime);
+            }
+        }
+        if (callback) {
+            callback();
+        }
+    }
+    if (timestamp > clock_->GetCurrentTimestamp()) {
+        clock_->SetCurrentTimestamp(timestamp);
+    }
+}
+
+uint64_t SimulatedAlarmTimerBackend::GetCallCount() const
+{
+    std::lock_guard lock(mutex_);
+    return callCount_;
+}
+
+uint64_t SimulatedAlarmTimerBackend::GetFireCount() const
+{
+    std::lock_guard lock(mutex_);
+    return fireCount_;
+}
+
+size_t SimulatedAlarmTimerBackend::GetTimerCount() const
+{
+    std::lock_guard lock(mutex_);
+    return timers_.size();
+}
+} // namespace OHOS::ArkUi::UiAppearance
@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef UI_APPEARANCE_MOCK_SIMULATED_ALARM_TIMER_H
+#define UI_APPEARANCE_MOCK_SIMULATED_ALARM_TIMER_H
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "alarm_clock.h"
+#include "alarm_timer_backend.h"
+
+namespace OHOS::ArkUi::UiAppearance {
+/**
+ * Manually driven clock with a fixed UTC offset and optional DST periods.
+ */
+class SimulatedAlarmClock final : public AlarmClock {
+public:
+    explicit SimulatedAlarmClock(uint64_t timestamp, int32_t utcOffset = 0);
+
+    uint64_t GetCurrentTimestamp() const override;
+
+    bool GetLocalTime(std::time_t time, std::tm& localTime) const override;
+
+    std::time_t MakeTime(std::tm& localTime) const override;
+
+    void SetCurrentTimestamp(uint64_t timestamp);
+
+    // Switches the standard UTC offset (seconds), like a time zone change.
+    void SetUtcOffset(int32_t utcOffset);
+
+    // Local time is shifted by dstOffset (seconds) for UTC times in [startTime, endTime).
+    void AddDstPeriod(std::time_t startTime, std::time_t endTime, int32_t dstOffset);
+
+private:
+    struct DstPeriod {
+        std::time_t startTime = 0;
+        std::time_t endTime = 0;
+        int32_t dstOffset = 0;
+    };
+
+    int32_t GetDstOffsetLocked(std::time_t time) const;
+
+    mutable std::mutex mutex_;
+    uint64_t timestamp_ = 0;
+    int32_t utcOffset_ = 0;
+    std::vector<DstPeriod> dstPeriods_;
+};
+
+/**
+ * In-process replacement of TimeService. Timers fire only when the test advances the simulated clock.
+ */
+class SimulatedAlarmTimerBackend final : public AlarmTimerBackend {
+public:
+    explicit SimulatedAlarmTimerBackend(const std::shared_ptr<SimulatedAlarmClock>& clock);
+
+    uint64_t CreateTimer(const std::function<void()>& callback, const std::string& timerName) override;
+
+    bool StartTimer(uint64_t timerId, uint64_t triggerTime) override;
+
+    bool StopTimer(uint64_t timerId) override;
+
+    bool DestroyTimer(uint64_t timerId) override;
+
+    // Moves the clock to timestamp, firing every due timer in trigger order with the clock set to its trigger time.
+    void AdvanceTo(uint64_t timestamp);
+
+    // Number of backend calls, i.e. the TimeService IPCs the real backend would have made.
+    uint64_t GetCallCount() const;
+
+    uint64_t GetFireCount() const;
+
+    size_t GetTimerCount() const;
+
+private:
+    struct SimulatedTimer {
+        std::function<void()> callback;
+        uint64_t triggerTime = 0;
+        bool started = false;
+    };
+
+    std::shared_ptr<SimulatedAlarmClock> clock_;
+    mutable std::mutex mutex_;
+    std::map<uint64_t, SimulatedTimer> timers_;
+    uint64_t nextTimerId_ = 0;
+    uint64_t callCount_ = 0;
+    uint64_t fireCount_ = 0;
+};
+} // namespace OHOS::ArkUi::UiAppearance
+#endif // UI_APPEARANCE_MOCK_SIMULATED_ALARM_TIMER_H
@@ -0,0 +1,291 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <map>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+// mock
+#include "simulated_alarm_timer.h"
+
+#define private public
+#include "alarm_timer_manager.h"
+#undef private
+#include "dark_schedule.h"
+#include "local_time_cache.h"
+
+using namespace testing;
+using namespace testing::ext;
+
+namespace OHOS::ArkUi::UiAppearance {
+namespace {
+constexpr uint64_t SECOND_TO_MILLI = 1000;
+constexpr uint64_t HOUR_TO_MILLI = 60 * 60 * SECOND_TO_MILLI;
+constexpr uint64_t DAY_TO_MILLI = 24 * HOUR_TO_MILLI;
+constexpr uint32_t DAY_TO_MINUTE = 24 * 60;
+constexpr uint32_t DAYS_OF_YEAR = 365;
+// 2026-01-01T00:00:00Z, and the EU DST period of 2026 in UTC seconds.
+constexpr std::time_t YEAR_START = 1767225600;
+constexpr std::time_t DST_START = 1774746000;
+constexpr std::time_t DST_END = 1792890000;
+constexpr int32_t CET_OFFSET = 3600;
+constexpr int32_t DST_OFFSET = 3600;
+constexpr int32_t CST_OFFSET = 8 * 3600;
+// 2026-11-15T00:00:00Z, after DST ends.
+constexpr uint64_t TIME_ZONE_SWITCH_TIME = 1794700800 * SECOND_TO_MILLI;
+constexpr uint64_t TEST_USER100 = 100;
+constexpr uint64_t TEST_USER101 = 101;
+
+// The interval rule the schedule is compiled from, evaluated directly.
+bool IsDarkReference(int64_t startTime, int64_t endTime, int64_t minute)
+{
+    if (endTime <= DAY_TO_MINUTE) {
+        return startTime <= minute && minute < endTime;
+    }
+    return !(endTime - DAY_TO_MINUTE <= minute && minute < startTime);
+}
+}
+
+class AlarmTimerManagerTest : public Test {
+protected:
+    void SetUp() override
+    {
+        clock_ = std::make_shared<SimulatedAlarmClock>(YEAR_START * SECOND_TO_MILLI, CET_OFFSET);
+        clock_->AddDstPeriod(DST_START, DST_END, DST_OFFSET);
+        AlarmClock::SetInstance(clock_);
+        backend_ = std::make_shared<SimulatedAlarmTimerBackend>(clock_);
+    }
+
+    void TearDown() override
+    {
+        AlarmClock::SetInstance(nullptr);
+    }
+
+    uint32_t GetLocalMinuteOfDay() const
+    {
+        std::tm localTime = {};
+        clock_->GetLocalTime(static_cast<std::time_t>(clock_->GetCurrentTimestamp() / SECOND_TO_MILLI), localTime);
+        return static_cast<uint32_t>(localTime.tm_hour * 60 + localTime.tm_min);
+    }
+
+    std::function<void()> RecordTo(std::vector<uint32_t>& minutes) const
+    {
+        return [this, &minutes]() { minutes.push_back(GetLocalMinuteOfDay()); };
+    }
+
+    static void ExpectAllAt(const std::vector<uint32_t>& minutes, const uint32_t minute)
+    {
+        for (size_t index = 0; index < minutes.size(); ++index) {
+            EXPECT_EQ(minutes[index], minute) << "transition " << index;
+        }
+    }
+
+    std::shared_ptr<SimulatedAlarmClock> clock_;
+    std::shared_ptr<SimulatedAlarmTimerBackend> backend_;
+};
+
+/**
+ * @tc.name: ReplayYear_0100
+ * @tc.desc: Replay a year of schedule transitions across both DST switches and a time zone change.
+ * @tc.type: FUNC
+ */
+HWTEST_F(AlarmTimerManagerTest, ReplayYear_0100, TestSize.Level1)
+{
+    AlarmTimerManager manager(backend_);
+    std::vector<uint32_t> nightStart;
+    std::vector<uint32_t> nightEnd;
+    std::vector<uint32_t> dayStart;
+    std::vector<uint32_t> dayEnd;
+    EXPECT_EQ(manager.SetScheduleTime(1200, 1860, TEST_USER100, RecordTo(nightStart), RecordTo(nightEnd)), ERR_OK);
+    EXPECT_EQ(manager.SetScheduleTime(600, 900, TEST_USER101, RecordTo(dayStart), RecordTo(dayEnd)), ERR_OK);
+    uint32_t recalculationCount = 0;
+    manager.SetRecalculationTimer(TEST_USER100, [&recalculationCount]() { recalculationCount++; });
+
+    const uint64_t yearStart = clock_->GetCurrentTimestamp();
+    bool timeZoneSwitched = false;
+    for (uint64_t time = yearStart; time <= yearStart + DAYS_OF_YEAR * DAY_TO_MILLI; time += HOUR_TO_MILLI) {
+        if (!timeZoneSwitched && time >= TIME_ZONE_SWITCH_TIME) {
+            // The service drops the cached local day and restarts its timers on TIMEZONE_CHANGED.
+            clock_->SetUtcOffset(CST_OFFSET);
+            LocalTimeCache::GetInstance().Invalidate();
+            manager.RestartAllTimer();
+            timeZoneSwitched = true;
+        }
+        backend_->AdvanceTo(time);
+    }
+
+    ExpectAllAt(nightStart, 1200);
+    ExpectAllAt(nightEnd, 1860 - DAY_TO_MINUTE);
+    ExpectAllAt(dayStart, 600);
+    ExpectAllAt(dayEnd, 900);
+    for (const auto* minutes : { &nightStart, &nightEnd, &dayStart, &dayEnd }) {
+        EXPECT_GE(minutes->size(), DAYS_OF_YEAR - 1);
+        EXPECT_LE(minutes->size(), DAYS_OF_YEAR + 1);
+    }
+    EXPECT_GE(recalculationCount, DAYS_OF_YEAR - 1);
+    EXPECT_LE(recalculationCount, DAYS_OF_YEAR);
+    // One system alarm serves every task.
+    EXPECT_EQ(backend_->GetTimerCount(), 1);
+}
+
+/**
+ * @tc.name: RestartAllTimer_0100
+ * @tc.desc: Restarting many users costs at most one re-arm of the system alarm.
+ * @tc.type: FUNC
+ */
+HWTEST_F(AlarmTimerManagerTest, RestartAllTimer_0100, TestSize.Level1)
+{
+    AlarmTimerManager manager(backend_);
+    constexpr uint64_t userCount = 16;
+    for (uint64_t userId = TEST_USER100; userId < TEST_USER100 + userCount; ++userId) {
+        EXPECT_EQ(manager.SetScheduleTime(userId, 1000 + userId, userId, []() {}, []() {}), ERR_OK);
+    }
+    uint64_t callCount = backend_->GetCallCount();
+    EXPECT_TRUE(manager.RestartAllTimer());
+    EXPECT_EQ(backend_->GetCallCount(), callCount);
+
+    clock_->SetUtcOffset(CST_OFFSET);
+    LocalTimeCache::GetInstance().Invalidate();
+    EXPECT_TRUE(manager.RestartAllTimer());
+    EXPECT_LE(backend_->GetCallCount(), callCount + 2);
+    EXPECT_EQ(backend_->GetTimerCount(), 1);
+}
+
+/**
+ * @tc.name: MissedTransitions_0100
+ * @tc.desc: Transitions missed while asleep fire once on wake up and the schedule resumes at the local time.
+ * @tc.type: FUNC
+ */
+HWTEST_F(AlarmTimerManagerTest, MissedTransitions_0100, TestSize.Level1)
+{
+    AlarmTimerManager manager(backend_);
+    std::vector<uint32_t> starts;
+    std::vector<uint32_t> ends;
+    EXPECT_EQ(manager.SetScheduleTime(600, 900, TEST_USER100, RecordTo(starts), RecordTo(ends)), ERR_OK);
+
+    // The clock jumps while asleep, so the overdue alarm fires late at wake up.
+    const uint64_t start = clock_->GetCurrentTimestamp();
+    clock_->SetCurrentTimestamp(start + 3 * DAY_TO_MILLI);
+    backend_->AdvanceTo(start + 3 * DAY_TO_MILLI);
+    EXPECT_EQ(starts.size(), 1);
+    EXPECT_EQ(ends.size(), 1);
+
+    starts.clear();
+    ends.clear();
+    backend_->AdvanceTo(start + 4 * DAY_TO_MILLI);
+    EXPECT_EQ(starts.size(), 1);
+    EXPECT_EQ(ends.size(), 1);
+    ExpectAllAt(starts, 600);
+    ExpectAllAt(ends, 900);
+}
+
+/**
+ * @tc.name: LocalTimeCache_0100
+ * @tc.desc: The local day is computed once per day and stays exact on DST switch days.
+ * @tc.type: FUNC
+ */
+HWTEST_F(AlarmTimerManagerTest, LocalTimeCache_0100, TestSize.Level1)
+{
+    LocalTimeCache& cache = LocalTimeCache::GetInstance();
+    const std::time_t dayStart = YEAR_START - CET_OFFSET;
+    EXPECT_EQ(cache.GetLocalTimestamp(*clock_, YEAR_START, 0, 0), dayStart);
+    uint64_t refreshCount = cache.GetRefreshCount();
+    for (std::time_t time = dayStart; time < dayStart + 24 * 60 * 60; time += 60) {
+        EXPECT_EQ(cache.GetSecondOfDay(*clock_, time), time - dayStart);
+    }
+    EXPECT_EQ(cache.GetLocalTimestamp(*clock_, YEAR_START, 1, 1200), dayStart + (24 + 20) * 60 * 60);
+    EXPECT_EQ(cache.GetRefreshCount(), refreshCount);
+
+    // 2026-03-29 jumps from 02:00 to 03:00, so 04:00 local is 3 hours after midnight.
+    const std::time_t dstDayStart = DST_START - 2 * 60 * 60;
+    EXPECT_EQ(cache.GetLocalTimestamp(*clock_, DST_START, 0, 0), dstDayStart);
+    EXPECT_EQ(cache.GetLocalTimestamp(*clock_, DST_START, 0, 240), dstDayStart + 3 * 60 * 60);
+    EXPECT_EQ(cache.GetSecondOfDay(*clock_, dstDayStart + 3 * 60 * 60), 4 * 60 * 60);
+
+    refreshCount = cache.GetRefreshCount();
+    clock_->SetUtcOffset(CST_OFFSET);
+    cache.Invalidate();
+    EXPECT_EQ(cache.GetLocalTimestamp(*clock_, YEAR_START, 0, 0), YEAR_START - CST_OFFSET);
+    EXPECT_EQ(cache.GetRefreshCount(), refreshCount + 1);
+}
+
+/**
+ * @tc.name: DarkSchedule_0100
+ * @tc.desc: The compiled bitmap and the interval rule agree with the reference for every minute.
+ * @tc.type: FUNC
+ */
+HWTEST_F(AlarmTimerManagerTest, DarkSchedule_0100, TestSize.Level1)
+{
+    // Same day, ending at midnight, overnight, overnight ending after the start, whole day and empty schedules.
+    const std::vector<std::pair<int64_t, int64_t>> schedules = {
+        { 7 * 60, 8 * 60 }, { 7 * 60, DAY_TO_MINUTE }, { 0, 9 }, { 22 * 60, (7 + 24) * 60 },
+        { 18 * 60, (18 + 24) * 60 }, { 60, DAY_TO_MINUTE + 120 }, { 0, DAY_TO_MINUTE }, { 9, 0 }, { 0, 0 },
+    };
+    for (const auto& [startTime, endTime] : schedules) {
+        DarkSchedule schedule(startTime, endTime);
+        for (int32_t minute = 0; minute < static_cast<int32_t>(DAY_TO_MINUTE); ++minute) {
+            ASSERT_EQ(schedule.IsDark(minute), IsDarkReference(startTime, endTime, minute))
+                << startTime << "-" << endTime << " at " << minute;
+            ASSERT_EQ(DarkSchedule::IsDarkMinute(startTime, endTime, minute), schedule.IsDark(minute))
+                << startTime << "-" << endTime << " at " << minute;
+        }
+    }
+
+    DarkSchedule overnight(22 * 60, (7 + 24) * 60);
+    EXPECT_TRUE(overnight.IsDark(-1));
+    EXPECT_FALSE(overnight.IsDark(DAY_TO_MINUTE + 7 * 60));
+}
+
+/**
+ * @tc.name: DarkSchedule_0200
+ * @tc.desc: Second resolution lookups are light exactly on a flip, including the flip at midnight.
+ * @tc.type: FUNC
+ */
+HWTEST_F(AlarmTimerManagerTest, DarkSchedule_0200, TestSize.Level1)
+{
+    DarkSchedule morning(7 * 60, 8 * 60);
+    EXPECT_FALSE(morning.IsDarkAtSecond(7 * 60 * 60));
+    EXPECT_TRUE(morning.IsDarkAtSecond(7 * 60 * 60 + 1));
+    EXPECT_TRUE(morning.IsDarkAtSecond(8 * 60 * 60 - 1));
+    EXPECT_FALSE(morning.IsDarkAtSecond(8 * 60 * 60));
+
+    DarkSchedule evening(7 * 60, DAY_TO_MINUTE);
+    EXPECT_TRUE(evening.IsDarkAtSecond(24 * 60 * 60 - 1));
+    EXPECT_FALSE(evening.IsDarkAtSecond(24 * 60 * 60));
+
+    DarkSchedule overnight(22 * 60, (7 + 24) * 60);
+    EXPECT_TRUE(overnight.IsDarkAtSecond(24 * 60 * 60));
+    EXPECT_TRUE(overnight.IsDarkAtSecond(0));
+    EXPECT_FALSE(overnight.IsDarkAtSecond(7 * 60 * 60));
+    EXPECT_FALSE(overnight.IsDarkAtSecond(22 * 60 * 60));
+}
+
+/**
+ * @tc.name: DarkSchedule_0300
+ * @tc.desc: The interval check follows the local time of the clock.
+ * @tc.type: FUNC
+ */
+HWTEST_F(AlarmTimerManagerTest, DarkSchedule_0300, TestSize.Level1)
+{
+    // 2026-01-01 is CET, so YEAR_START is 01:00 local.
+    EXPECT_TRUE(AlarmTimerManager::IsWithinTimeInterval(21 * 60, (6 + 24) * 60));
+    EXPECT_FALSE(AlarmTimerManager::IsWithinTimeInterval(2 * 60, 10 * 60));
+    EXPECT_TRUE(AlarmTimerManager::IsWithinTimeInterval(60, 2 * 60));
+    clock_->SetCurrentTimestamp((YEAR_START + 12 * 60 * 60) * SECOND_TO_MILLI);
+    EXPECT_FALSE(AlarmTimerManager::IsWithinTimeInterval(21 * 60, (6 + 24) * 60));
+    EXPECT_TRUE(AlarmTimerManager::IsWithinTimeInterval(2 * 60, 14 * 60));
+}
+} // namespace OHOS::ArkUi::UiAppearance
@@ -13,6 +13,13 @@
  * limitations under the License.
  */
 
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <future>
+#include <thread>
+#include <unistd.h>
+
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 
@@ -23,6 +30,8 @@
 #define private public
 #include "dark_mode_manager.h"
 #undef private
+#include "metrics_registry.h"
+#include "parameter_wrap.h"
 
 using namespace testing;
 using namespace testing::ext;
@@ -65,6 +74,9 @@ protected:
         manager.settingDataObservers_.clear();
         manager.settingDataObserversContext_ = AccountContextHelper::CreateBaseContext(INVALID_USER_ID);
         manager.settingDataObserversUserId_ = INVALID_USER_ID;
+        manager.activeContexts_.clear();
+        manager.observedContexts_.clear();
+        manager.loadedContexts_.clear();
         manager.darkModeStates_.clear();
         manager.updateCallback_ = nullptr;
     }
@@ -89,6 +101,9 @@ protected:
         manager.settingDataObservers_.clear();
         manager.settingDataObserversContext_ = AccountContextHelper::CreateBaseContext(INVALID_USER_ID);
         manager.settingDataObserversUserId_ = INVALID_USER_ID;
+        manager.activeContexts_.clear();
+        manager.observedContexts_.clear();
+        manager.loadedContexts_.clear();
         manager.darkModeStates_.clear();
         manager.updateCallback_ = nullptr;
     }
@@ -233,21 +248,13 @@ protected:
         ExpectationSet expectSet;
         SettingDataManager& dataManager = SettingDataManager::GetInstance();
         expectSet += EXPECT_CALL(dataManager, IsInitialized()).Times(1).After(expectSet).WillOnce(Return(true));
-        if (origUserId != INVALID_USER_ID) {
+        if (origUserId != INVALID_USER_ID && origUserId != userId) {
+            expectSet += EXPECT_CALL(manager.alarmTimerManager_, ClearRecalculationTimer(origUserId))
+                .Times(1).After(expectSet);
             expectSet += EXPECT_CALL(manager.alarmTimerManager_, ClearTimerByUserId(origUserId))
                 .Times(1).After(expectSet);
-            ExpectationSet input = expectSet;
-            expectSet += EXPECT_CALL(dataManager, MockUnregisterObserver(SETTING_DARK_MODE_MODE, origUserId))
-                .Times(1).After(input).WillOnce(Return(ERR_OK));
-            expectSet += EXPECT_CALL(dataManager, MockUnregisterObserver(SETTING_DARK_MODE_START_TIME, origUserId))
-                .Times(1).After(input).WillOnce(Return(ERR_OK));
-            expectSet += EXPECT_CALL(dataManager, MockUnregisterObserver(SETTING_DARK_MODE_END_TIME, origUserId))
-                .Times(1).After(input).WillOnce(Return(ERR_OK));
-            expectSet += EXPECT_CALL(dataManager, MockUnregisterObserver(SETTING_DARK_MODE_SUN_SET, origUserId))
-                .Times(1).After(input).WillOnce(Return(ERR_OK));
-            expectSet += EXPECT_CALL(dataManager, MockUnregisterObserver(SETTING_DARK_MODE_SUN_RISE, origUserId))
-                .Times(1).After(input).WillOnce(Return(ERR_OK));
         }
+        EXPECT_CALL(dataManager, MockUnregisterObserver(_, _)).Times(0);
 
         ExpectationSet input = expectSet;
         expectSet += EXPECT_CALL(dataManager, MockRegisterObserver(SETTING_DARK_MODE_MODE, _, userId))
@@ -263,6 +270,11 @@ protected:
 
         EXPECT_EQ(manager.OnSwitchUser(userId), registerObsFail ? ERR_NO_INIT : ERR_OK);
         EXPECT_EQ(manager.settingDataObserversUserId_, userId);
+        EXPECT_TRUE(manager.IsContextActive(userId));
+        EXPECT_EQ(manager.observedContexts_.count(userId), registerObsFail ? 0 : 1);
+        manager.activeContexts_.clear();
+        manager.observedContexts_.clear();
+        manager.loadedContexts_.clear();
     }
 
     void RestartTimerNoChangeTest(const int32_t userId, const DarkModeMode mode) const
@@ -623,6 +635,9 @@ private:
 
         manager.settingDataObserversContext_ = AccountContextHelper::CreateBaseContext(INVALID_USER_ID);
         manager.settingDataObserversUserId_ = INVALID_USER_ID;
+        manager.activeContexts_.clear();
+        manager.observedContexts_.clear();
+        manager.loadedContexts_.clear();
         expectSet += EXPECT_CALL(settingDataManager, IsInitialized()).Times(1).After(expectSet).WillOnce(Return(true));
         auto checkRegisterObserver = [&updateFuncMap](const std::string& key,
             const std::function<void(const std::string&, int32_t)>& updateFunc, Unused) {
@@ -982,6 +997,144 @@ HWTEST_F(DarkModeManagerTest, OnSwitchUser_0500, TestSize.Level1)
     OnSwitchUserTest(TEST_USER101, TEST_USER100, true);
 }
 
+HWTEST_F(DarkModeManagerTest, OnSwitchUser_0600, TestSize.Level1)
+{
+    DarkModeManager& manager = DarkModeManager::GetInstance();
+    SettingDataManager& dataManager = SettingDataManager::GetInstance();
+    EXPECT_CALL(dataManager, IsInitialized()).WillRepeatedly(Return(true));
+    EXPECT_CALL(dataManager, MockRegisterObserver(_, _, TEST_USER100)).Times(SETTING_NUM).WillRepeatedly(Return(ERR_OK));
+    EXPECT_CALL(dataManager, MockRegisterObserver(_, _, TEST_USER101)).Times(SETTING_NUM).WillRepeatedly(Return(ERR_OK));
+    EXPECT_CALL(dataManager, MockUnregisterObserver(_, _)).Times(0);
+    EXPECT_CALL(manager.alarmTimerManager_, ClearRecalculationTimer(_)).Times(AnyNumber());
+    EXPECT_CALL(manager.alarmTimerManager_, ClearTimerByUserId(_)).Times(AnyNumber());
+
+    // Switching back and forth registers each context once and keeps only the latest one active.
+    EXPECT_EQ(manager.OnSwitchUser(TEST_USER100), ERR_OK);
+    EXPECT_EQ(manager.OnSwitchUser(TEST_USER101), ERR_OK);
+    EXPECT_EQ(manager.OnSwitchUser(TEST_USER100), ERR_OK);
+    EXPECT_EQ(manager.OnSwitchUser(TEST_USER101), ERR_OK);
+    EXPECT_FALSE(manager.IsContextActive(TEST_USER100));
+    EXPECT_TRUE(manager.IsContextActive(TEST_USER101));
+    EXPECT_EQ(manager.observedContexts_.size(), 2);
+
+    // Other foreground contexts can be active at the same time.
+    EXPECT_EQ(manager.ActivateContext(TEST_USER100), ERR_OK);
+    EXPECT_TRUE(manager.IsContextActive(TEST_USER100));
+    EXPECT_TRUE(manager.IsContextActive(TEST_USER101));
+}
+
+HWTEST_F(DarkModeManagerTest, RetainObservedContexts_0100, TestSize.Level1)
+{
+    DarkModeManager& manager = DarkModeManager::GetInstance();
+    manager.observedContexts_ = { TEST_USER1, TEST_USER100, TEST_USER101 };
+    manager.activeContexts_ = { TEST_USER101 };
+
+    SettingDataManager& dataManager = SettingDataManager::GetInstance();
+    EXPECT_CALL(dataManager, MockUnregisterObserver(_, TEST_USER1)).Times(SETTING_NUM).WillRepeatedly(Return(ERR_OK));
+    EXPECT_CALL(dataManager, MockUnregisterObserver(_, TEST_USER100)).Times(0);
+    EXPECT_CALL(dataManager, MockUnregisterObserver(_, TEST_USER101)).Times(0);
+    manager.RetainObservedContexts({ TEST_USER100 });
+    EXPECT_EQ(manager.observedContexts_.size(), 2);
+    EXPECT_EQ(manager.observedContexts_.count(TEST_USER1), 0);
+}
+
+HWTEST_F(DarkModeManagerTest, InactiveContextUpdate_0100, TestSize.Level1)
+{
+    DarkModeManager& manager = DarkModeManager::GetInstance();
+    manager.darkModeStates_[TEST_USER100].settingMode = DarkModeMode::DARK_MODE_CUSTOM_AUTO;
+
+    SettingDataManager& dataManager = SettingDataManager::GetInstance();
+    EXPECT_CALL(dataManager, MockGetInt32ValueStrictly(SETTING_DARK_MODE_START_TIME, _, TEST_USER100))
+        .Times(1).WillOnce(DoAll(SetArgReferee<1>(1), Return(ERR_OK)));
+    EXPECT_CALL(manager.alarmTimerManager_, SetScheduleTime(_, _, _, _, _)).Times(0);
+    EXPECT_CALL(*this, UpdateCallback(_, _)).Times(0);
+    manager.SettingDataDarkModeStartTimeUpdateFunc(SETTING_DARK_MODE_START_TIME, TEST_USER100);
+    EXPECT_EQ(manager.darkModeStates_[TEST_USER100].settingStartTime, 1);
+}
+
+HWTEST_F(DarkModeManagerTest, InactiveContextUpdate_0200, TestSize.Level1)
+{
+    constexpr int32_t startTime = 1;
+    constexpr int32_t endTime = 2;
+    DarkModeManager& manager = DarkModeManager::GetInstance();
+    manager.darkModeStates_[TEST_USER100].settingMode = DarkModeMode::DARK_MODE_CUSTOM_AUTO;
+    manager.observedContexts_ = { TEST_USER100 };
+    manager.loadedContexts_ = { TEST_USER100 };
+
+    SettingDataManager& dataManager = SettingDataManager::GetInstance();
+    EXPECT_CALL(dataManager, MockGetInt32ValueStrictly(SETTING_DARK_MODE_START_TIME, _, TEST_USER100))
+        .Times(1).WillOnce(DoAll(SetArgReferee<1>(startTime), Return(ERR_OK)));
+    manager.SettingDataDarkModeStartTimeUpdateFunc(SETTING_DARK_MODE_START_TIME, TEST_USER100);
+    EXPECT_TRUE(manager.NeedLoadUserSettingData(TEST_USER100));
+
+    // Activation only registers the context; the deferred change is applied once, by the following load.
+    EXPECT_CALL(*this, UpdateCallback(_, _)).Times(0);
+    EXPECT_EQ(manager.ActivateContext(TEST_USER100), ERR_OK);
+    EXPECT_TRUE(manager.NeedLoadUserSettingData(TEST_USER100));
+    Mock::VerifyAndClearExpectations(this);
+
+    EXPECT_CALL(dataManager, MockGetInt32ValueStrictly(SETTING_DARK_MODE_MODE, _, TEST_USER100))
+        .WillOnce(DoAll(SetArgReferee<1>(DarkModeMode::DARK_MODE_CUSTOM_AUTO), Return(ERR_OK)));
+    EXPECT_CALL(dataManager, MockGetInt32ValueStrictly(SETTING_DARK_MODE_START_TIME, _, TEST_USER100))
+        .WillOnce(DoAll(SetArgReferee<1>(startTime), Return(ERR_OK)));
+    EXPECT_CALL(dataManager, MockGetInt32ValueStrictly(SETTING_DARK_MODE_END_TIME, _, TEST_USER100))
+        .WillOnce(DoAll(SetArgReferee<1>(endTime), Return(ERR_OK)));
+    EXPECT_CALL(dataManager, MockGetInt32ValueStrictly(SETTING_DARK_MODE_SUN_SET, _, TEST_USER100))
+        .WillOnce(Return(ERR_OK));
+    EXPECT_CALL(dataManager, MockGetInt32ValueStrictly(SETTING_DARK_MODE_SUN_RISE, _, TEST_USER100))
+        .WillOnce(Return(ERR_OK));
+    ExpectationSet expectSet;
+    expectSet += EXPECT_CALL(manager.alarmTimerManager_, SetScheduleTime(startTime, endTime, TEST_USER100, _, _))
+        .Times(1).WillOnce(Return(ERR_OK));
+    AlarmTimerManager& alarmTimerManagerStaticInstance = AlarmTimerManager::GetInstance();
+    expectSet += EXPECT_CALL(alarmTimerManagerStaticInstance, MockIsWithinTimeInterval(startTime, endTime))
+        .Times(1).After(expectSet).WillOnce(Return(true));
+    EXPECT_CALL(*this, UpdateCallback(true, TEST_USER100)).Times(1).After(expectSet);
+    bool isDarkMode = false;
+    EXPECT_EQ(manager.LoadUserSettingData(TEST_USER100, true, isDarkMode, false), ERR_OK);
+    EXPECT_FALSE(manager.NeedLoadUserSettingData(TEST_USER100));
+}
+
+HWTEST_F(DarkModeManagerTest, OnSwitchContext_0100, TestSize.Level1)
+{
+    DarkModeManager& manager = DarkModeManager::GetInstance();
+    SettingDataManager& dataManager = SettingDataManager::GetInstance();
+    EXPECT_CALL(dataManager, IsInitialized()).WillRepeatedly(Return(true));
+    EXPECT_CALL(dataManager, MockRegisterObserver(_, _, TEST_USER100)).Times(SETTING_NUM).WillRepeatedly(Return(ERR_OK));
+    EXPECT_CALL(dataManager, MockRegisterObserver(_, _, TEST_USER101)).Times(SETTING_NUM).WillRepeatedly(Return(ERR_OK));
+    EXPECT_CALL(dataManager, MockRegisterObserver(_, _, TEST_USER1)).Times(SETTING_NUM).WillRepeatedly(Return(ERR_OK));
+    EXPECT_CALL(manager.alarmTimerManager_, ClearRecalculationTimer(_)).Times(AnyNumber());
+    EXPECT_CALL(manager.alarmTimerManager_, ClearTimerByUserId(_)).Times(AnyNumber());
+
+    // Every foreground context is activated, and the previous context stays active while it is in the foreground.
+    EXPECT_EQ(manager.OnSwitchContext(TEST_USER100), ERR_OK);
+    EXPECT_EQ(manager.OnSwitchContext(TEST_USER101, { TEST_USER100, TEST_USER101 }), ERR_OK);
+    EXPECT_TRUE(manager.IsContextActive(TEST_USER100));
+    EXPECT_TRUE(manager.IsContextActive(TEST_USER101));
+
+    // Only the contexts that left the foreground are deactivated.
+    EXPECT_EQ(manager.OnSwitchContext(TEST_USER1, { TEST_USER100 }), ERR_OK);
+    EXPECT_TRUE(manager.IsContextActive(TEST_USER1));
+    EXPECT_TRUE(manager.IsContextActive(TEST_USER100));
+    EXPECT_FALSE(manager.IsContextActive(TEST_USER101));
+    EXPECT_TRUE(manager.NeedLoadUserSettingData(TEST_USER101));
+}
+
+HWTEST_F(DarkModeManagerTest, RetainObservedContexts_0200, TestSize.Level1)
+{
+    DarkModeManager& manager = DarkModeManager::GetInstance();
+    manager.observedContexts_ = { TEST_USER100, TEST_USER101 };
+    manager.activeContexts_ = { TEST_USER101 };
+    manager.loadedContexts_ = { TEST_USER100, TEST_USER101 };
+
+    SettingDataManager& dataManager = SettingDataManager::GetInstance();
+    EXPECT_CALL(dataManager, MockUnregisterObserver(_, TEST_USER100)).Times(SETTING_NUM).WillRepeatedly(Return(ERR_OK));
+    // A dropped context has to be loaded again when it comes back to the foreground.
+    manager.RetainObservedContexts({ TEST_USER101 });
+    EXPECT_TRUE(manager.NeedLoadUserSettingData(TEST_USER100));
+    EXPECT_FALSE(manager.NeedLoadUserSettingData(TEST_USER101));
+}
+
 HWTEST_F(DarkModeManagerTest, RestartTimer_0100, TestSize.Level1)
 {
     RestartTimerNoChangeTest(TEST_USER1, DarkModeMode::DARK_MODE_INVALID);
@@ -1005,6 +1158,66 @@ HWTEST_F(DarkModeManagerTest, RestartTimer_0200, TestSize.Level1)
     RestartTimerTest(TEST_USER101, 4, -1, false);
 }
 
+HWTEST_F(DarkModeManagerTest, RequestRestartTimer_0100, TestSize.Level1)
+{
+    constexpr uint32_t burstSize = 3;
+    DarkModeManager& manager = DarkModeManager::GetInstance();
+    manager.settingDataObserversContext_ = AccountContextHelper::CreateBaseContext(TEST_USER100);
+    manager.settingDataObserversUserId_ = TEST_USER100;
+    manager.darkModeStates_[TEST_USER100].settingMode = DarkModeMode::DARK_MODE_CUSTOM_AUTO;
+    manager.darkModeStates_[TEST_USER100].settingStartTime = 0;
+    manager.darkModeStates_[TEST_USER100].settingEndTime = 1;
+
+    AlarmTimerManager& alarmTimerManagerStaticInstance = AlarmTimerManager::GetInstance();
+    EXPECT_CALL(alarmTimerManagerStaticInstance, MockIsWithinTimeInterval(0, 1)).Times(1).WillOnce(Return(false));
+    EXPECT_CALL(*this, UpdateCallback(false, TEST_USER100)).Times(1);
+    EXPECT_CALL(manager.alarmTimerManager_, RestartAllTimer()).Times(1).WillOnce(Return(ERR_OK));
+
+    uint64_t postCount = manager.restartTimerTask_.GetPostCount();
+    uint64_t runCount = manager.restartTimerTask_.GetRunCount();
+    for (uint32_t i = 0; i < burstSize; ++i) {
+        manager.RequestRestartTimer();
+    }
+    manager.restartTimerTask_.Flush();
+    manager.restartTimerTask_.Flush();
+    EXPECT_EQ(manager.restartTimerTask_.GetPostCount(), postCount + burstSize);
+    EXPECT_EQ(manager.restartTimerTask_.GetRunCount(), runCount + 1);
+}
+
+HWTEST_F(DarkModeManagerTest, RequestRestartTimer_0200, TestSize.Level1)
+{
+    constexpr std::chrono::milliseconds blockedWait(50);
+    std::atomic<int32_t> running = 0;
+    std::atomic<int32_t> maxRunning = 0;
+    std::promise<void> started;
+    std::promise<void> release;
+    std::shared_future<void> released = release.get_future().share();
+    std::atomic<bool> isFirstRun = true;
+    DebounceTask task("FlushWhileRunning", 0, [&](uint32_t) {
+        int32_t current = running.fetch_add(1) + 1;
+        maxRunning.store(std::max(maxRunning.load(), current));
+        if (isFirstRun.exchange(false)) {
+            started.set_value();
+            released.wait();
+        }
+        running.fetch_sub(1);
+    });
+
+    task.Post();
+    started.get_future().wait();
+    task.Post();
+    // The worker is inside the task, so Flush has to wait for it instead of running the task alongside.
+    auto flushed = std::async(std::launch::async, [&task]() { task.Flush(); });
+    EXPECT_EQ(flushed.wait_for(blockedWait), std::future_status::timeout);
+    release.set_value();
+    flushed.wait();
+    while (task.GetRunCount() < 2) {
+        std::this_thread::yield();
+    }
+    EXPECT_EQ(task.GetRunCount(), 2u);
+    EXPECT_EQ(maxRunning.load(), 1);
+}
+
 HWTEST_F(DarkModeManagerTest, ModeUpdateFunc_0100, TestSize.Level1)
 {
     ModeUpdateFuncFailTest(TEST_USER1, DarkModeMode::DARK_MODE_INVALID);
@@ -1125,6 +1338,178 @@ HWTEST_F(DarkModeManagerTest, ApplySunriseSunsetTimes_0200, TestSize.Level1)
     manager.ApplySunriseSunsetTimes(31.2304, 121.4737, context);
 }
 
+HWTEST_F(DarkModeManagerTest, ApplySunriseSunsetTimes_0300, TestSize.Level1)
+{
+    const std::string recalcDistanceKey = "persist.uiappearance.sunrise_sunset.recalc_distance";
+    const AccountContext context = AccountContextHelper::CreateBaseContext(TEST_USER100);
+    DarkModeManager& manager = DarkModeManager::GetInstance();
+    auto& state = manager.darkModeStates_[context];
+    state.settingMode = DarkModeMode::DARK_MODE_SUNRISE_SUNSET;
+    state.settingSunsetTime = -1;
+    state.settingSunriseTime = -1;
+    const uint64_t performed = manager.sunriseSunsetRecalcPerformed_;
+    const uint64_t skipped = manager.sunriseSunsetRecalcSkipped_;
+
+    // Mirror the settings observer, which stores the written values in the state.
+    SettingDataManager& dataManager = SettingDataManager::GetInstance();
+    EXPECT_CALL(dataManager, MockSetInt32ValuePair(SETTING_DARK_MODE_SUN_SET, _,
+        SETTING_DARK_MODE_SUN_RISE, _, TEST_USER100)).Times(3).WillRepeatedly(Invoke(
+        [&state](Unused, int32_t sunset, Unused, int32_t sunrise, Unused) {
+            state.settingSunsetTime = sunset;
+            state.settingSunriseTime = sunrise;
+            return ERR_OK;
+        }));
+
+    manager.ApplySunriseSunsetTimes(31.2304, 121.4737, context);
+    EXPECT_EQ(manager.sunriseSunsetRecalcPerformed_, performed + 1);
+    // About 600 meters away, within the default distance.
+    manager.ApplySunriseSunsetTimes(31.2350, 121.4780, context);
+    EXPECT_EQ(manager.sunriseSunsetRecalcSkipped_, skipped + 1);
+    // The distance is configurable.
+    SetParameterWrap(recalcDistanceKey, "100");
+    manager.ApplySunriseSunsetTimes(31.2350, 121.4780, context);
+    EXPECT_EQ(manager.sunriseSunsetRecalcPerformed_, performed + 2);
+    SetParameterWrap(recalcDistanceKey, "");
+    // Moving far away writes new values.
+    manager.ApplySunriseSunsetTimes(39.9042, 116.4074, context);
+    EXPECT_EQ(manager.sunriseSunsetRecalcPerformed_, performed + 3);
+    // A new local day recalculates even without moving.
+    state.sunriseSunsetFix.localDay -= 1;
+    manager.ApplySunriseSunsetTimes(39.9042, 116.4074, context);
+    EXPECT_EQ(manager.sunriseSunsetRecalcPerformed_, performed + 4);
+    // So does a setting changed by someone else, which is written back.
+    state.settingSunsetTime = -1;
+    manager.ApplySunriseSunsetTimes(39.9042, 116.4074, context);
+    EXPECT_EQ(manager.sunriseSunsetRecalcPerformed_, performed + 5);
+    EXPECT_EQ(manager.sunriseSunsetRecalcSkipped_, skipped + 1);
+}
+
+HWTEST_F(DarkModeManagerTest, SunriseSunsetTable_0100, TestSize.Level1)
+{
+    // 2024-01-01T00:00:00Z, a leap year, so all 366 entries are filled.
+    constexpr int64_t yearStartMs = 1704067200000;
+    constexpr int64_t dayMs = 86400000;
+    const std::vector<std::pair<double, double>> locations = { { 31.2, 121.5 }, { -33.9, 18.4 }, { 78.2, 15.6 } };
+    for (const auto& [lat, lon] : locations) {
+        SunriseSunsetTable table;
+        ASSERT_TRUE(table.Build(lat, lon, yearStartMs));
+        for (int32_t day = 0; day < SunriseSunsetTable::DAYS_PER_TABLE; ++day) {
+            const int64_t timestampMs = yearStartMs + day * dayMs + dayMs / 2;
+            SunriseSunsetResult expected = SunriseSunsetUtils::CalculateSunriseSunset(lat, lon, timestampMs);
+            SunriseSunsetResult actual = {};
+            ASSERT_TRUE(table.Lookup(timestampMs, actual));
+            EXPECT_EQ(actual.sunrise, expected.sunrise) << "lat: " << lat << ", day: " << day;
+            EXPECT_EQ(actual.sunset, expected.sunset) << "lat: " << lat << ", day: " << day;
+        }
+        SunriseSunsetResult nextYear = {};
+        EXPECT_FALSE(table.Lookup(yearStartMs + SunriseSunsetTable::DAYS_PER_TABLE * dayMs, nextYear));
+    }
+    SunriseSunsetTable invalid;
+    EXPECT_FALSE(invalid.Build(91.0, 0.0, yearStartMs));
+    EXPECT_TRUE(invalid.NeedsRebuild(0.0, 0.0, yearStartMs));
+}
+
+HWTEST_F(DarkModeManagerTest, SunriseSunsetTable_0200, TestSize.Level1)
+{
+    // 2025-06-01T00:00:00Z and 2026-01-01T00:00:00Z.
+    constexpr int64_t juneMs = 1748736000000;
+    constexpr int64_t nextYearMs = 1767225600000;
+    DarkModeManager& manager = DarkModeManager::GetInstance();
+    manager.sunriseSunsetTable_ = SunriseSunsetTable();
+
+    SunriseSunsetResult first = manager.LookupSunriseSunset(31.2304, 121.4737, juneMs);
+    EXPECT_EQ(manager.sunriseSunsetTable_.GetBuildCount(), 1u);
+    // Small location jitter within the threshold reuses the table.
+    SunriseSunsetResult jitter = manager.LookupSunriseSunset(31.2804, 121.4237, juneMs);
+    EXPECT_EQ(manager.sunriseSunsetTable_.GetBuildCount(), 1u);
+    EXPECT_EQ(jitter.sunrise, first.sunrise);
+    EXPECT_EQ(jitter.sunset, first.sunset);
+    // Moving past the threshold or rolling over the year rebuilds it.
+    manager.LookupSunriseSunset(39.9042, 116.4074, juneMs);
+    EXPECT_EQ(manager.sunriseSunsetTable_.GetBuildCount(), 2u);
+    manager.LookupSunriseSunset(39.9042, 116.4074, nextYearMs);
+    EXPECT_EQ(manager.sunriseSunsetTable_.GetBuildCount(), 3u);
+    // Invalid coordinates fall back to the direct calculation.
+    SunriseSunsetResult invalid = manager.LookupSunriseSunset(91.0, 0.0, juneMs);
+    EXPECT_EQ(invalid.sunrise, -1);
+    EXPECT_EQ(manager.sunriseSunsetTable_.GetBuildCount(), 3u);
+}
+
+HWTEST_F(DarkModeManagerTest, SunriseSunsetBatch_0100, TestSize.Level1)
+{
+    // 2024-01-01T00:00:00Z, sampled weekly at a varying hour of the day.
+    constexpr int64_t yearStartMs = 1704067200000;
+    constexpr int64_t dayMs = 86400000;
+    constexpr int64_t hourMs = 3600000;
+    constexpr int32_t secsPerDay = 86400;
+    std::vector<double> lats;
+    std::vector<double> lons;
+    std::vector<int64_t> timestamps;
+    for (double lat = -85.0; lat <= 85.0; lat += 5.0) {
+        for (double lon = -180.0; lon <= 180.0; lon += 30.0) {
+            for (int32_t day = 0; day < SunriseSunsetTable::DAYS_PER_TABLE; day += 7) {
+                lats.push_back(lat);
+                lons.push_back(lon);
+                timestamps.push_back(yearStartMs + day * dayMs + (day % 24) * hourMs);
+            }
+        }
+    }
+    lats.push_back(91.0);
+    lons.push_back(0.0);
+    timestamps.push_back(yearStartMs);
+
+    const size_t count = lats.size();
+    std::vector<double> sunrises(count);
+    std::vector<double> sunsets(count);
+    SunriseSunsetUtils::CalculateSunriseSunsetBatch(count, lats.data(), lons.data(), timestamps.data(),
+        sunrises.data(), sunsets.data());
+    auto distance = [secsPerDay](double lhs, double rhs) {
+        double diff = std::fabs(lhs - rhs);
+        return std::min(diff, secsPerDay - diff);
+    };
+    for (size_t i = 0; i < count; ++i) {
+        SunriseSunsetResult expected = SunriseSunsetUtils::CalculateSunriseSunset(lats[i], lons[i], timestamps[i]);
+        ASSERT_EQ(sunrises[i] == -1, expected.sunrise == -1) << "lat: " << lats[i] << ", index: " << i;
+        ASSERT_EQ(sunsets[i] == -1, expected.sunset == -1) << "lat: " << lats[i] << ", index: " << i;
+        EXPECT_LE(distance(sunrises[i], expected.sunrise), SunriseSunsetUtils::BATCH_MAX_ERROR_SEC);
+        EXPECT_LE(distance(sunsets[i], expected.sunset), SunriseSunsetUtils::BATCH_MAX_ERROR_SEC);
+    }
+    SunriseSunsetUtils::CalculateSunriseSunsetBatch(count, nullptr, lons.data(), timestamps.data(),
+        sunrises.data(), sunsets.data());
+}
+
+HWTEST_F(DarkModeManagerTest, SunriseSunsetFixedPoint_0100, TestSize.Level1)
+{
+    // 2024-01-01T00:00:00Z and 2049-01-01T00:00:00Z, sampled every five days.
+    const std::vector<int64_t> yearStarts = { 1704067200000, 2493072000000 };
+    constexpr int64_t dayMs = 86400000;
+    constexpr int32_t secsPerDay = 86400;
+    auto distance = [secsPerDay](double lhs, double rhs) {
+        double diff = std::fabs(lhs - rhs);
+        return std::min(diff, secsPerDay - diff);
+    };
+    for (int64_t yearStartMs : yearStarts) {
+        for (double lat = -85.0; lat <= 85.0; lat += 5.0) {
+            for (double lon = -180.0; lon <= 180.0; lon += 45.0) {
+                for (int32_t day = 0; day < SunriseSunsetTable::DAYS_PER_TABLE; day += 5) {
+                    const int64_t timestampMs = yearStartMs + day * dayMs;
+                    SunriseSunsetResult expected = SunriseSunsetUtils::CalculateSunriseSunset(lat, lon, timestampMs);
+                    SunriseSunsetResult actual =
+                        SunriseSunsetUtils::CalculateSunriseSunsetFixedPoint(lat, lon, timestampMs);
+                    ASSERT_EQ(actual.sunrise == -1, expected.sunrise == -1) << "lat: " << lat << ", day: " << day;
+                    ASSERT_EQ(actual.sunset == -1, expected.sunset == -1) << "lat: " << lat << ", day: " << day;
+                    EXPECT_LE(distance(actual.sunrise, expected.sunrise),
+                        SunriseSunsetUtils::FIXED_POINT_MAX_ERROR_SEC);
+                    EXPECT_LE(distance(actual.sunset, expected.sunset), SunriseSunsetUtils::FIXED_POINT_MAX_ERROR_SEC);
+                }
+            }
+        }
+    }
+    SunriseSunsetResult invalid = SunriseSunsetUtils::CalculateSunriseSunsetFixedPoint(NAN, 0.0, yearStarts[0]);
+    EXPECT_EQ(invalid.sunrise, -1);
+    EXPECT_EQ(invalid.sunset, -1);
+}
+
 HWTEST_F(DarkModeManagerTest, InitSunriseSunsetMode_0100, TestSize.Level1)
 {
     const AccountContext context = AccountContextHelper::CreateBaseContext(TEST_USER100);
@@ -1141,6 +1526,192 @@ HWTEST_F(DarkModeManagerTest, InitSunriseSunsetMode_0100, TestSize.Level1)
     SettingDataManager& dataManager = SettingDataManager::GetInstance();
     EXPECT_CALL(dataManager, MockSetInt32Value(_, _, _, _)).Times(0);
     recalculationCallback();
+    EXPECT_TRUE(manager.locationFetcher_.WaitIdle(std::chrono::seconds(1)));
+}
+
+HWTEST_F(DarkModeManagerTest, LocationFetcher_0100, TestSize.Level1)
+{
+    const AccountContext context = AccountContextHelper::CreateBaseContext(TEST_USER100);
+    MetricsRegistry::GetInstance().Reset();
+    std::promise<void> started;
+    std::promise<void> release;
+    std::shared_future<void> released = release.get_future().share();
+    std::atomic<int32_t> fetchCount = 0;
+    std::atomic<int32_t> resultCount = 0;
+    LocationFetcher fetcher(LOCATION_FETCH_DEADLINE_MS,
+        [&](const AccountContext&, LocationFetcher::Coordinate& coordinate) {
+            if (fetchCount.fetch_add(1) == 0) {
+                started.set_value();
+                released.wait();
+            }
+            coordinate.latitude = 39.9;
+            coordinate.longitude = 116.4;
+            return true;
+        },
+        [&](const AccountContext& resultContext, const LocationFetcher::Coordinate& coordinate) {
+            EXPECT_EQ(resultContext, context);
+            EXPECT_DOUBLE_EQ(coordinate.latitude, 39.9);
+            resultCount.fetch_add(1);
+        });
+
+    // The caller returns while the locator is still busy; later requests queue up behind it and merge.
+    fetcher.Request(context);
+    started.get_future().wait();
+    fetcher.Request(context);
+    fetcher.Request(context);
+    EXPECT_EQ(resultCount.load(), 0);
+    release.set_value();
+    ASSERT_TRUE(fetcher.WaitIdle(std::chrono::seconds(1)));
+
+    EXPECT_EQ(fetchCount.load(), 2);
+    EXPECT_EQ(resultCount.load(), 2);
+    EXPECT_EQ(fetcher.GetRequestCount(), 3);
+    EXPECT_EQ(fetcher.GetCoalescedCount(), 1);
+    EXPECT_EQ(fetcher.GetFailureCount(), 0);
+    EXPECT_EQ(MetricsRegistry::GetInstance().GetCount(MetricId::LOCATION_FETCH), 2);
+}
+
+HWTEST_F(DarkModeManagerTest, LocationFetcher_0200, TestSize.Level1)
+{
+    const AccountContext context = AccountContextHelper::CreateBaseContext(TEST_USER100);
+    MetricsRegistry::GetInstance().Reset();
+    static constexpr uint32_t deadlineMs = 10;
+    bool resultDelivered = false;
+    LocationFetcher fetcher(deadlineMs,
+        [](const AccountContext&, LocationFetcher::Coordinate&) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(deadlineMs));
+            return false;
+        },
+        [&resultDelivered](const AccountContext&, const LocationFetcher::Coordinate&) { resultDelivered = true; });
+    fetcher.Request(context);
+    ASSERT_TRUE(fetcher.WaitIdle(std::chrono::seconds(1)));
+
+    EXPECT_FALSE(resultDelivered);
+    EXPECT_EQ(fetcher.GetFailureCount(), 1);
+    EXPECT_EQ(fetcher.GetTimeoutCount(), 1);
+    const MetricsRegistry& registry = MetricsRegistry::GetInstance();
+    EXPECT_EQ(registry.GetCount(MetricId::LOCATION_FETCH), 1);
+    EXPECT_EQ(registry.GetFailureCount(MetricId::LOCATION_FETCH), 1);
+    EXPECT_GE(registry.GetHistogram(MetricId::LOCATION_FETCH).GetMaxLatency(),
+        static_cast<uint64_t>(std::chrono::microseconds(std::chrono::milliseconds(deadlineMs)).count()));
+}
+
+HWTEST_F(DarkModeManagerTest, LocationFetcher_0300, TestSize.Level1)
+{
+    const AccountContext hungContext = AccountContextHelper::CreateBaseContext(TEST_USER100);
+    const AccountContext otherContext = AccountContextHelper::CreateBaseContext(TEST_USER101);
+    static constexpr uint32_t deadlineMs = 10;
+    std::promise<void> release;
+    std::shared_future<void> released = release.get_future().share();
+    std::atomic<int32_t> hungFetchCount = 0;
+    std::atomic<int32_t> concurrentHungFetches = 0;
+    std::atomic<int32_t> maxConcurrentHungFetches = 0;
+    std::mutex resultMutex;
+    std::condition_variable resultCv;
+    std::vector<AccountContext> results;
+    LocationFetcher fetcher(deadlineMs,
+        [&](const AccountContext& context, LocationFetcher::Coordinate&) {
+            if (context == hungContext) {
+                int32_t concurrent = ++concurrentHungFetches;
+                maxConcurrentHungFetches = std::max(maxConcurrentHungFetches.load(), concurrent);
+                if (hungFetchCount.fetch_add(1) == 0) {
+                    released.wait();
+                }
+                --concurrentHungFetches;
+            }
+            return true;
+        },
+        [&](const AccountContext& context, const LocationFetcher::Coordinate&) {
+            std::lock_guard lock(resultMutex);
+            results.push_back(context);
+            resultCv.notify_all();
+        });
+
+    // The locator does not answer the first context; the other one is still served after the deadline.
+    fetcher.Request(hungContext);
+    fetcher.Request(otherContext);
+    {
+        std::unique_lock lock(resultMutex);
+        ASSERT_TRUE(resultCv.wait_for(lock, std::chrono::seconds(1), [&results]() { return !results.empty(); }));
+        EXPECT_EQ(results, std::vector<AccountContext>({ otherContext }));
+    }
+    EXPECT_EQ(fetcher.GetTimeoutCount(), 1);
+    EXPECT_FALSE(fetcher.WaitIdle(std::chrono::milliseconds(deadlineMs)));
+
+    // A request made meanwhile does not start a second fetch; it is served once the late result is in.
+    fetcher.Request(hungContext);
+    release.set_value();
+    ASSERT_TRUE(fetcher.WaitIdle(std::chrono::seconds(1)));
+    EXPECT_EQ(results, std::vector<AccountContext>({ otherContext, hungContext, hungContext }));
+    EXPECT_EQ(hungFetchCount.load(), 2);
+    EXPECT_EQ(maxConcurrentHungFetches.load(), 1);
+    EXPECT_EQ(fetcher.GetFailureCount(), 0);
+}
+
+HWTEST_F(DarkModeManagerTest, StateSnapshot_0100, TestSize.Level1)
+{
+    const AccountContext context(TEST_USER100, 1);
+    StateSnapshot::Records records;
+    StateSnapshot::Record& record = StateSnapshot::GetRecord(records, context);
+    record.flags = StateSnapshot::HAS_APPEARANCE | StateSnapshot::HAS_TEMP_COLOR_MODE;
+    EXPECT_TRUE(StateSnapshot::SetScale(record.fontScale, "1.75"));
+    EXPECT_FALSE(StateSnapshot::SetScale(record.fontWeightScale, "1.2345678901234567"));
+    EXPECT_EQ(StateSnapshot::GetScale(record.fontWeightScale), "");
+    record.tempStateEndTime = 1767225600;
+
+    std::vector<uint8_t> buffer;
+    StateSnapshot::Encode(records, buffer);
+    StateSnapshot::Records decoded;
+    ASSERT_TRUE(StateSnapshot::Decode(buffer.data(), buffer.size(), decoded));
+    ASSERT_EQ(decoded.count(context), 1);
+    EXPECT_EQ(decoded[context].subProfileId, 1);
+    EXPECT_EQ(decoded[context].flags, record.flags);
+    EXPECT_EQ(StateSnapshot::GetScale(decoded[context].fontScale), "1.75");
+    EXPECT_EQ(decoded[context].tempStateEndTime, 1767225600);
+
+    // Truncated, corrupted and foreign files are rejected as a whole.
+    EXPECT_FALSE(StateSnapshot::Decode(buffer.data(), buffer.size() - 1, decoded));
+    buffer.back() ^= 1;
+    EXPECT_FALSE(StateSnapshot::Decode(buffer.data(), buffer.size(), decoded));
+    buffer.back() ^= 1;
+    buffer[0] ^= 1;
+    EXPECT_FALSE(StateSnapshot::Decode(buffer.data(), buffer.size(), decoded));
+}
+
+HWTEST_F(DarkModeManagerTest, StateSnapshot_0200, TestSize.Level1)
+{
+    const std::string path = "/data/local/tmp/ui_appearance_state_snapshot_test.bin";
+    const AccountContext context = AccountContextHelper::CreateBaseContext(TEST_USER100);
+    DarkModeManager& manager = DarkModeManager::GetInstance();
+    auto& state = manager.darkModeStates_[context];
+    state.settingMode = DarkModeMode::DARK_MODE_CUSTOM_AUTO;
+    state.settingStartTime = 1200;
+    state.settingEndTime = 1860;
+    state.version = 1;
+
+    StateSnapshot snapshot(path);
+    snapshot.RegisterCollector("DarkModeManager",
+        [&manager](StateSnapshot::Records& records) { manager.CollectSnapshot(records); });
+    ASSERT_TRUE(snapshot.WriteNow());
+    EXPECT_EQ(snapshot.GetWriteCount(), 1);
+
+    StateSnapshot::Records records;
+    ASSERT_TRUE(snapshot.Load(records));
+    unlink(path.c_str());
+    ASSERT_EQ(records.count(context), 1);
+    EXPECT_TRUE(records[context].flags & StateSnapshot::HAS_DARK_MODE_SETTINGS);
+
+    // A restart starts from empty states; loaded states are newer than the snapshot and are kept.
+    manager.darkModeStates_.clear();
+    manager.RestoreSnapshot(records);
+    EXPECT_EQ(manager.darkModeStates_[context].settingMode, DarkModeMode::DARK_MODE_CUSTOM_AUTO);
+    EXPECT_EQ(manager.darkModeStates_[context].settingStartTime, 1200);
+    EXPECT_EQ(manager.darkModeStates_[context].settingEndTime, 1860);
+
+    manager.darkModeStates_[context].settingStartTime = 1260;
+    manager.darkModeStates_[context].version = 1;
+    manager.RestoreSnapshot(records);
+    EXPECT_EQ(manager.darkModeStates_[context].settingStartTime, 1260);
 }
 
 HWTEST_F(DarkModeManagerTest, SettingDataSunsetTimeUpdateFunc_0100, TestSize.Level1)
@@ -1149,6 +1720,7 @@ HWTEST_F(DarkModeManagerTest, SettingDataSunsetTimeUpdateFunc_0100, TestSize.Lev
     constexpr int32_t sunsetTime = 1081;
     constexpr int32_t sunriseTime = 1860;
     DarkModeManager& manager = DarkModeManager::GetInstance();
+    manager.activeContexts_.insert(context);
     auto& state = manager.darkModeStates_[context];
     state.settingMode = DarkModeMode::DARK_MODE_SUNRISE_SUNSET;
     state.settingSunsetTime = 1080;
@@ -1168,6 +1740,112 @@ HWTEST_F(DarkModeManagerTest, SettingDataSunsetTimeUpdateFunc_0100, TestSize.Lev
     EXPECT_EQ(manager.darkModeStates_[context].settingSunsetTime, sunsetTime);
 }
 
+HWTEST_F(DarkModeManagerTest, ShardedState_0100, TestSize.Level1)
+{
+    constexpr int32_t startTime = 1;
+    constexpr int32_t endTime = 2;
+    constexpr std::chrono::seconds waitTimeout(5);
+    DarkModeManager& manager = DarkModeManager::GetInstance();
+    manager.activeContexts_ = { TEST_USER100, TEST_USER101 };
+    manager.darkModeStates_[TEST_USER100].settingMode = DarkModeMode::DARK_MODE_CUSTOM_AUTO;
+    manager.darkModeStates_[TEST_USER100].settingEndTime = endTime;
+    manager.darkModeStates_[TEST_USER101].settingMode = DarkModeMode::DARK_MODE_CUSTOM_AUTO;
+    manager.darkModeStates_[TEST_USER101].settingEndTime = endTime;
+
+    SettingDataManager& dataManager = SettingDataManager::GetInstance();
+    EXPECT_CALL(dataManager, MockGetInt32ValueStrictly(SETTING_DARK_MODE_START_TIME, _, _))
+        .Times(2).WillRepeatedly(DoAll(SetArgReferee<1>(startTime), Return(ERR_OK)));
+    AlarmTimerManager& alarmTimerManagerStaticInstance = AlarmTimerManager::GetInstance();
+    EXPECT_CALL(alarmTimerManagerStaticInstance, MockIsWithinTimeInterval(startTime, endTime))
+        .Times(2).WillRepeatedly(Return(false));
+    EXPECT_CALL(*this, UpdateCallback(_, _)).Times(AnyNumber());
+
+    // The timer IPC of user 100 only returns once user 101 reaches its own timer IPC, which deadlocks if both
+    // contexts serialize on a shared lock.
+    std::promise<void> user101Arrived;
+    std::future<void> user101ArrivedFuture = user101Arrived.get_future();
+    bool user100Unblocked = false;
+    EXPECT_CALL(manager.alarmTimerManager_, SetScheduleTime(startTime, endTime, TEST_USER100, _, _))
+        .Times(1).WillOnce(Invoke([&user101ArrivedFuture, &user100Unblocked, waitTimeout](Unused, Unused, Unused,
+            Unused, Unused) {
+            user100Unblocked = user101ArrivedFuture.wait_for(waitTimeout) == std::future_status::ready;
+            return ERR_OK;
+        }));
+    EXPECT_CALL(manager.alarmTimerManager_, SetScheduleTime(startTime, endTime, TEST_USER101, _, _))
+        .Times(1).WillOnce(Invoke([&user101Arrived](Unused, Unused, Unused, Unused, Unused) {
+            user101Arrived.set_value();
+            return ERR_OK;
+        }));
+
+    std::thread user100Thread([&manager]() {
+        manager.SettingDataDarkModeStartTimeUpdateFunc(SETTING_DARK_MODE_START_TIME, TEST_USER100);
+    });
+    manager.SettingDataDarkModeStartTimeUpdateFunc(SETTING_DARK_MODE_START_TIME, TEST_USER101);
+    user100Thread.join();
+    EXPECT_TRUE(user100Unblocked);
+    EXPECT_EQ(manager.darkModeStates_[TEST_USER100].settingStartTime, startTime);
+    EXPECT_EQ(manager.darkModeStates_[TEST_USER101].settingStartTime, startTime);
+}
+
+HWTEST_F(DarkModeManagerTest, ShardedState_0200, TestSize.Level1)
+{
+    constexpr int32_t firstStartTime = 1;
+    constexpr int32_t secondStartTime = 3;
+    constexpr int32_t endTime = 2;
+    constexpr std::chrono::milliseconds pollInterval(10);
+    constexpr int32_t maxPollTimes = 500;
+    DarkModeManager& manager = DarkModeManager::GetInstance();
+    manager.activeContexts_ = { TEST_USER100 };
+    auto& state = manager.darkModeStates_[TEST_USER100];
+    state.settingMode = DarkModeMode::DARK_MODE_CUSTOM_AUTO;
+    state.settingEndTime = endTime;
+
+    SettingDataManager& dataManager = SettingDataManager::GetInstance();
+    EXPECT_CALL(dataManager, MockGetInt32ValueStrictly(SETTING_DARK_MODE_START_TIME, _, TEST_USER100))
+        .Times(2)
+        .WillOnce(DoAll(SetArgReferee<1>(firstStartTime), Return(ERR_OK)))
+        .WillOnce(DoAll(SetArgReferee<1>(secondStartTime), Return(ERR_OK)));
+    AlarmTimerManager& alarmTimerManagerStaticInstance = AlarmTimerManager::GetInstance();
+    EXPECT_CALL(alarmTimerManagerStaticInstance, MockIsWithinTimeInterval(_, endTime))
+        .Times(2).WillRepeatedly(Return(false));
+    // One apply per change, not one per retry.
+    EXPECT_CALL(*this, UpdateCallback(false, TEST_USER100)).Times(2);
+
+    // The second change is stored while the first apply is still in its timer IPC, and its apply waits for the first
+    // one to finish instead of overlapping it.
+    std::thread secondThread;
+    std::atomic<int32_t> inFlight = 0;
+    std::atomic<int32_t> maxInFlight = 0;
+    bool secondStored = false;
+    EXPECT_CALL(manager.alarmTimerManager_, SetScheduleTime(firstStartTime, endTime, TEST_USER100, _, _))
+        .Times(1).WillOnce(Invoke([&](Unused, Unused, Unused, Unused, Unused) {
+            maxInFlight = std::max(maxInFlight.load(), ++inFlight);
+            secondThread = std::thread([&manager]() {
+                manager.SettingDataDarkModeStartTimeUpdateFunc(SETTING_DARK_MODE_START_TIME, TEST_USER100);
+            });
+            for (int32_t i = 0; i < maxPollTimes && !secondStored; ++i) {
+                std::this_thread::sleep_for(pollInterval);
+                secondStored = DarkModeManager::GetSettingsSnapshot(state).settingStartTime == secondStartTime;
+            }
+            std::this_thread::sleep_for(pollInterval);
+            --inFlight;
+            return ERR_OK;
+        }));
+    EXPECT_CALL(manager.alarmTimerManager_, SetScheduleTime(secondStartTime, endTime, TEST_USER100, _, _))
+        .Times(1).WillOnce(Invoke([&](Unused, Unused, Unused, Unused, Unused) {
+            maxInFlight = std::max(maxInFlight.load(), ++inFlight);
+            --inFlight;
+            return ERR_OK;
+        }));
+
+    manager.SettingDataDarkModeStartTimeUpdateFunc(SETTING_DARK_MODE_START_TIME, TEST_USER100);
+    if (secondThread.joinable()) {
+        secondThread.join();
+    }
+    EXPECT_TRUE(secondStored);
+    EXPECT_EQ(maxInFlight, 1);
+}
+
 HWTEST_F(DarkModeManagerTest, TimerCallback_0100, TestSize.Level1)
 {
     TimerCallbackFailTest(TEST_USER1, -1, 7, DarkModeMode::DARK_MODE_INVALID, -1, 7);
@@ -1195,58 +1873,84 @@ HWTEST_F(DarkModeManagerTest, TimerCallback_0200, TestSize.Level1)
     TimerCallbackTest(TEST_USER101, 1, -1);
 }
 
+HWTEST_F(DarkModeManagerTest, GetSchedule_0100, TestSize.Level1)
+{
+    DarkModeManager& manager = DarkModeManager::GetInstance();
+    auto& state = manager.darkModeStates_[TEST_USER100];
+    uint64_t compileCount = DarkSchedule::GetCompileCount();
+    auto first = DarkModeManager::GetSchedule(state, 21 * 60, (6 + 24) * 60);
+    auto second = DarkModeManager::GetSchedule(state, 21 * 60, (6 + 24) * 60);
+    EXPECT_EQ(first, second);
+    EXPECT_EQ(DarkSchedule::GetCompileCount(), compileCount + 1);
+
+    // Every context keeps its own schedule, and a change of times recompiles only that context.
+    auto other = DarkModeManager::GetSchedule(manager.darkModeStates_[TEST_USER101], 21 * 60, (6 + 24) * 60);
+    EXPECT_NE(other, first);
+    auto changed = DarkModeManager::GetSchedule(state, 22 * 60, (6 + 24) * 60);
+    EXPECT_EQ(changed->GetStartTime(), 22 * 60);
+    EXPECT_EQ(DarkSchedule::GetCompileCount(), compileCount + 3);
+    EXPECT_EQ(DarkModeManager::GetSchedule(state, 22 * 60, (6 + 24) * 60), changed);
+}
+
 HWTEST_F(DarkModeManagerTest, CheckCurrentTimeInDarkInterval_0100, TestSize.Level1)
 {
-    EXPECT_EQ(DarkModeManager::CheckCurrentTimeInDarkInterval(7 * 60, 8 * 60, 7.5 * 60 * 60), true);
-    EXPECT_EQ(DarkModeManager::CheckCurrentTimeInDarkInterval(7 * 60, 8 * 60, 9 * 60 * 60), false);
-    EXPECT_EQ(DarkModeManager::CheckCurrentTimeInDarkInterval(7 * 60, 8 * 60, 8 * 60 * 60), false);
-
-    EXPECT_EQ(DarkModeManager::CheckCurrentTimeInDarkInterval(7 * 60, 8 * 60, 8 * 60 * 60 - 4), false);
-    EXPECT_EQ(DarkModeManager::CheckCurrentTimeInDarkInterval(7 * 60, 8 * 60, 8 * 60 * 60 - 5), false);
-    EXPECT_EQ(DarkModeManager::CheckCurrentTimeInDarkInterval(7 * 60, 8 * 60, 8 * 60 * 60 - 6), true);
-    EXPECT_EQ(DarkModeManager::CheckCurrentTimeInDarkInterval(7 * 60, 8 * 60, 8 * 60 * 60 + 1), false);
-
-    EXPECT_EQ(DarkModeManager::CheckCurrentTimeInDarkInterval(7 * 60, 8 * 60, 7 * 60 * 60), true);
-    EXPECT_EQ(DarkModeManager::CheckCurrentTimeInDarkInterval(7 * 60, 8 * 60, 7 * 60 * 60 + 1), true);
-    EXPECT_EQ(DarkModeManager::CheckCurrentTimeInDarkInterval(7 * 60, 8 * 60, 7 * 60 * 60 - 1), true);
-    EXPECT_EQ(DarkModeManager::CheckCurrentTimeInDarkInterval(7 * 60, 8 * 60, 7 * 60 * 60 - 4), true);
-    EXPECT_EQ(DarkModeManager::CheckCurrentTimeInDarkInterval(7 * 60, 8 * 60, 7 * 60 * 60 - 5), false);
-
-    EXPECT_EQ(DarkModeManager::CheckCurrentTimeInDarkInterval(22 * 60, (7 + 24) * 60, 23 * 60 * 60), true);
-    EXPECT_EQ(DarkModeManager::CheckCurrentTimeInDarkInterval(22 * 60, (7 + 24) * 60, 10 * 60 * 60), false);
-    EXPECT_EQ(DarkModeManager::CheckCurrentTimeInDarkInterval(22 * 60, (7 + 24) * 60, 22 * 60 * 60), true);
-    EXPECT_EQ(DarkModeManager::CheckCurrentTimeInDarkInterval(22 * 60, (7 + 24) * 60, 22 * 60 * 60 + 1), true);
-    EXPECT_EQ(DarkModeManager::CheckCurrentTimeInDarkInterval(22 * 60, (7 + 24) * 60, 22 * 60 * 60 - 1), true);
-    EXPECT_EQ(DarkModeManager::CheckCurrentTimeInDarkInterval(22 * 60, (7 + 24) * 60, 22 * 60 * 60 - 4), true);
-    EXPECT_EQ(DarkModeManager::CheckCurrentTimeInDarkInterval(22 * 60, (7 + 24) * 60, 22 * 60 * 60 - 5), false);
-
-    EXPECT_EQ(DarkModeManager::CheckCurrentTimeInDarkInterval(22 * 60, (7 + 24) * 60, 7 * 60 * 60), false);
-    EXPECT_EQ(DarkModeManager::CheckCurrentTimeInDarkInterval(22 * 60, (7 + 24) * 60, 7 * 60 * 60 + 1), false);
-    EXPECT_EQ(DarkModeManager::CheckCurrentTimeInDarkInterval(22 * 60, (7 + 24) * 60, 7 * 60 * 60 - 1), false);
-    EXPECT_EQ(DarkModeManager::CheckCurrentTimeInDarkInterval(22 * 60, (7 + 24) * 60, 7 * 60 * 60 - 4), false);
-    EXPECT_EQ(DarkModeManager::CheckCurrentTimeInDarkInterval(22 * 60, (7 + 24) * 60, 7 * 60 * 60 - 5), false);
-    EXPECT_EQ(DarkModeManager::CheckCurrentTimeInDarkInterval(22 * 60, (7 + 24) * 60, 7 * 60 * 60 - 6), true);
-
-    EXPECT_EQ(DarkModeManager::CheckCurrentTimeInDarkInterval(0, 0, 0), false);
-    EXPECT_EQ(DarkModeManager::CheckCurrentTimeInDarkInterval(0, 9, 0), true);
-    EXPECT_EQ(DarkModeManager::CheckCurrentTimeInDarkInterval(9, 0, 0), false);
-
-    EXPECT_EQ(DarkModeManager::CheckCurrentTimeInDarkInterval(0, 0, 1), false);
-    EXPECT_EQ(DarkModeManager::CheckCurrentTimeInDarkInterval(0, 9, 1), true);
-    EXPECT_EQ(DarkModeManager::CheckCurrentTimeInDarkInterval(9, 0, 1), false);
-
-    EXPECT_EQ(DarkModeManager::CheckCurrentTimeInDarkInterval(0, 0, 4), false);
-    EXPECT_EQ(DarkModeManager::CheckCurrentTimeInDarkInterval(0, 9, 4), true);
-    EXPECT_EQ(DarkModeManager::CheckCurrentTimeInDarkInterval(9, 0, 4), false);
-
-    EXPECT_EQ(DarkModeManager::CheckCurrentTimeInDarkInterval(0, 0, 6), false);
-    EXPECT_EQ(DarkModeManager::CheckCurrentTimeInDarkInterval(0, 9, 6), true);
-    EXPECT_EQ(DarkModeManager::CheckCurrentTimeInDarkInterval(9, 0, 6), false);
-
-    EXPECT_EQ(DarkModeManager::CheckCurrentTimeInDarkInterval(7 * 60, 24 * 60, 24 * 60 * 60), false);
-    EXPECT_EQ(DarkModeManager::CheckCurrentTimeInDarkInterval(7 * 60, 24 * 60, 24 * 60 * 60 - 1), false);
-    EXPECT_EQ(DarkModeManager::CheckCurrentTimeInDarkInterval(7 * 60, 24 * 60, 24 * 60 * 60 - 4), false);
-    EXPECT_EQ(DarkModeManager::CheckCurrentTimeInDarkInterval(7 * 60, 24 * 60, 24 * 60 * 60 - 5), false);
-    EXPECT_EQ(DarkModeManager::CheckCurrentTimeInDarkInterval(7 * 60, 24 * 60, 24 * 60 * 60 - 6), true);
+    const DarkSchedule morning(7 * 60, 8 * 60);
+    const DarkSchedule overnight(22 * 60, (7 + 24) * 60);
+    const DarkSchedule empty(0, 0);
+    const DarkSchedule afterMidnight(0, 9);
+    const DarkSchedule inverted(9, 0);
+    const DarkSchedule untilMidnight(7 * 60, 24 * 60);
+
+    EXPECT_EQ(DarkModeManager::CheckCurrentTimeInDarkInterval(morning, 7.5 * 60 * 60), true);
+    EXPECT_EQ(DarkModeManager::CheckCurrentTimeInDarkInterval(morning, 9 * 60 * 60), false);
+    EXPECT_EQ(DarkModeManager::CheckCurrentTimeInDarkInterval(morning, 8 * 60 * 60), false);
+
+    EXPECT_EQ(DarkModeManager::CheckCurrentTimeInDarkInterval(morning, 8 * 60 * 60 - 4), false);
+    EXPECT_EQ(DarkModeManager::CheckCurrentTimeInDarkInterval(morning, 8 * 60 * 60 - 5), false);
+    EXPECT_EQ(DarkModeManager::CheckCurrentTimeInDarkInterval(morning, 8 * 60 * 60 - 6), true);
+    EXPECT_EQ(DarkModeManager::CheckCurrentTimeInDarkInterval(morning, 8 * 60 * 60 + 1), false);
+
+    EXPECT_EQ(DarkModeManager::CheckCurrentTimeInDarkInterval(morning, 7 * 60 * 60), true);
+    EXPECT_EQ(DarkModeManager::CheckCurrentTimeInDarkInterval(morning, 7 * 60 * 60 + 1), true);
+    EXPECT_EQ(DarkModeManager::CheckCurrentTimeInDarkInterval(morning, 7 * 60 * 60 - 1), true);
+    EXPECT_EQ(DarkModeManager::CheckCurrentTimeInDarkInterval(morning, 7 * 60 * 60 - 4), true);
+    EXPECT_EQ(DarkModeManager::CheckCurrentTimeInDarkInterval(morning, 7 * 60 * 60 - 5), false);
+
+    EXPECT_EQ(DarkModeManager::CheckCurrentTimeInDarkInterval(overnight, 23 * 60 * 60), true);
+    EXPECT_EQ(DarkModeManager::CheckCurrentTimeInDarkInterval(overnight, 10 * 60 * 60), false);
+    EXPECT_EQ(DarkModeManager::CheckCurrentTimeInDarkInterval(overnight, 22 * 60 * 60), true);
+    EXPECT_EQ(DarkModeManager::CheckCurrentTimeInDarkInterval(overnight, 22 * 60 * 60 + 1), true);
+    EXPECT_EQ(DarkModeManager::CheckCurrentTimeInDarkInterval(overnight, 22 * 60 * 60 - 1), true);
+    EXPECT_EQ(DarkModeManager::CheckCurrentTimeInDarkInterval(overnight, 22 * 60 * 60 - 4), true);
+    EXPECT_EQ(DarkModeManager::CheckCurrentTimeInDarkInterval(overnight, 22 * 60 * 60 - 5), false);
+
+    EXPECT_EQ(DarkModeManager::CheckCurrentTimeInDarkInterval(overnight, 7 * 60 * 60), false);
+    EXPECT_EQ(DarkModeManager::CheckCurrentTimeInDarkInterval(overnight, 7 * 60 * 60 + 1), false);
+    EXPECT_EQ(DarkModeManager::CheckCurrentTimeInDarkInterval(overnight, 7 * 60 * 60 - 1), false);
+    EXPECT_EQ(DarkModeManager::CheckCurrentTimeInDarkInterval(overnight, 7 * 60 * 60 - 4), false);
+    EXPECT_EQ(DarkModeManager::CheckCurrentTimeInDarkInterval(overnight, 7 * 60 * 60 - 5), false);
+    EXPECT_EQ(DarkModeManager::CheckCurrentTimeInDarkInterval(overnight, 7 * 60 * 60 - 6), true);
+
+    EXPECT_EQ(DarkModeManager::CheckCurrentTimeInDarkInterval(empty, 0), false);
+    EXPECT_EQ(DarkModeManager::CheckCurrentTimeInDarkInterval(afterMidnight, 0), true);
+    EXPECT_EQ(DarkModeManager::CheckCurrentTimeInDarkInterval(inverted, 0), false);
+
+    EXPECT_EQ(DarkModeManager::CheckCurrentTimeInDarkInterval(empty, 1), false);
+    EXPECT_EQ(DarkModeManager::CheckCurrentTimeInDarkInterval(afterMidnight, 1), true);
+    EXPECT_EQ(DarkModeManager::CheckCurrentTimeInDarkInterval(inverted, 1), false);
+
+    EXPECT_EQ(DarkModeManager::CheckCurrentTimeInDarkInterval(empty, 4), false);
+    EXPECT_EQ(DarkModeManager::CheckCurrentTimeInDarkInterval(afterMidnight, 4), true);
+    EXPECT_EQ(DarkModeManager::CheckCurrentTimeInDarkInterval(inverted, 4), false);
+
+    EXPECT_EQ(DarkModeManager::CheckCurrentTimeInDarkInterval(empty, 6), false);
+    EXPECT_EQ(DarkModeManager::CheckCurrentTimeInDarkInterval(afterMidnight, 6), true);
+    EXPECT_EQ(DarkModeManager::CheckCurrentTimeInDarkInterval(inverted, 6), false);
+
+    EXPECT_EQ(DarkModeManager::CheckCurrentTimeInDarkInterval(untilMidnight, 24 * 60 * 60), false);
+    EXPECT_EQ(DarkModeManager::CheckCurrentTimeInDarkInterval(untilMidnight, 24 * 60 * 60 - 1), false);
+    EXPECT_EQ(DarkModeManager::CheckCurrentTimeInDarkInterval(untilMidnight, 24 * 60 * 60 - 4), false);
+    EXPECT_EQ(DarkModeManager::CheckCurrentTimeInDarkInterval(untilMidnight, 24 * 60 * 60 - 5), false);
+    EXPECT_EQ(DarkModeManager::CheckCurrentTimeInDarkInterval(untilMidnight, 24 * 60 * 60 - 6), true);
 }
 } // namespace OHOS::ArkUi::UiAppearance
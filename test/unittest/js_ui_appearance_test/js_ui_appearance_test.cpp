@@ -0,0 +1,202 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "js_ui_appearance.h"
+
+using namespace testing;
+using namespace testing::ext;
+
+namespace OHOS::ArkUi::UiAppearance {
+namespace {
+constexpr int32_t RACE_REQUEST_COUNT = 1000;
+
+// Waiters are only compared here, so any distinct non-null handle will do.
+AsyncWaiter MakeWaiter(uintptr_t id)
+{
+    AsyncWaiter waiter;
+    waiter.deferred = reinterpret_cast<napi_deferred>(id);
+    return waiter;
+}
+
+auto SetFontScale(double fontScale)
+{
+    return [fontScale](AsyncContext& asyncContext) { asyncContext.jsFontScale = fontScale; };
+}
+
+AsyncContext* Submit(RequestKind kind, uintptr_t id, double fontScale, bool isMergeable, bool& isMerged)
+{
+    return RequestMerger::Submit(kind, MakeWaiter(id), SetFontScale(fontScale), isMergeable, isMerged);
+}
+
+void CompleteAndRelease(AsyncContext* asyncContext)
+{
+    RequestMerger::Complete(asyncContext);
+    AsyncContextPool::Release(asyncContext);
+}
+} // namespace
+
+class JsUiAppearanceTest : public Test {};
+
+/**
+ * @tc.name: RequestMerger_0100
+ * @tc.desc: Requests made while one is queued merge into it, the latest value wins and every caller is settled
+ * @tc.type: FUNC
+ */
+HWTEST_F(JsUiAppearanceTest, RequestMerger_0100, TestSize.Level1)
+{
+    bool isMerged = true;
+    AsyncContext* asyncContext = Submit(REQUEST_SET_FONT_SCALE, 1, 1.0, true, isMerged);
+    ASSERT_NE(asyncContext, nullptr);
+    EXPECT_FALSE(isMerged);
+    EXPECT_EQ(RequestMerger::GetQueued(REQUEST_SET_FONT_SCALE), asyncContext);
+
+    EXPECT_EQ(Submit(REQUEST_SET_FONT_SCALE, 2, 1.5, true, isMerged), asyncContext);
+    EXPECT_TRUE(isMerged);
+    EXPECT_EQ(Submit(REQUEST_SET_FONT_SCALE, 3, 2.0, true, isMerged), asyncContext);
+    EXPECT_TRUE(isMerged);
+    EXPECT_DOUBLE_EQ(asyncContext->jsFontScale, 2.0);
+
+    asyncContext->BeginExecute();
+    const std::vector<AsyncWaiter>& waiters = RequestMerger::Complete(asyncContext);
+    ASSERT_EQ(waiters.size(), 3u);
+    for (size_t i = 0; i < waiters.size(); ++i) {
+        EXPECT_EQ(waiters[i].deferred, MakeWaiter(i + 1).deferred);
+    }
+    EXPECT_EQ(RequestMerger::GetQueued(REQUEST_SET_FONT_SCALE), nullptr);
+    AsyncContextPool::Release(asyncContext);
+}
+
+/**
+ * @tc.name: RequestMerger_0200
+ * @tc.desc: A request made once the worker has started on the queued one gets a context of its own
+ * @tc.type: FUNC
+ */
+HWTEST_F(JsUiAppearanceTest, RequestMerger_0200, TestSize.Level1)
+{
+    bool isMerged = true;
+    AsyncContext* executing = Submit(REQUEST_SET_FONT_SCALE, 1, 1.0, true, isMerged);
+    ASSERT_NE(executing, nullptr);
+    executing->BeginExecute();
+
+    AsyncContext* next = Submit(REQUEST_SET_FONT_SCALE, 2, 1.5, true, isMerged);
+    ASSERT_NE(next, nullptr);
+    EXPECT_FALSE(isMerged);
+    EXPECT_NE(next, executing);
+    EXPECT_DOUBLE_EQ(executing->jsFontScale, 1.0);
+    EXPECT_EQ(RequestMerger::GetQueued(REQUEST_SET_FONT_SCALE), next);
+
+    // Completing the older context must not stop later requests from merging into the newer one.
+    EXPECT_EQ(RequestMerger::Complete(executing).size(), 1u);
+    AsyncContextPool::Release(executing);
+    EXPECT_EQ(RequestMerger::GetQueued(REQUEST_SET_FONT_SCALE), next);
+    EXPECT_EQ(Submit(REQUEST_SET_FONT_SCALE, 3, 2.0, true, isMerged), next);
+    EXPECT_TRUE(isMerged);
+    EXPECT_EQ(RequestMerger::Complete(next).size(), 2u);
+    AsyncContextPool::Release(next);
+}
+
+/**
+ * @tc.name: RequestMerger_0300
+ * @tc.desc: A request that is not mergeable neither merges into the queued one nor lets later requests merge into it
+ * @tc.type: FUNC
+ */
+HWTEST_F(JsUiAppearanceTest, RequestMerger_0300, TestSize.Level1)
+{
+    bool isMerged = true;
+    AsyncContext* valid = Submit(REQUEST_SET_FONT_SCALE, 1, 1.0, true, isMerged);
+    ASSERT_NE(valid, nullptr);
+    AsyncContext* invalid = Submit(REQUEST_SET_FONT_SCALE, 2, -1.0, false, isMerged);
+    ASSERT_NE(invalid, nullptr);
+    EXPECT_FALSE(isMerged);
+    EXPECT_NE(invalid, valid);
+    EXPECT_DOUBLE_EQ(valid->jsFontScale, 1.0);
+    EXPECT_EQ(RequestMerger::GetQueued(REQUEST_SET_FONT_SCALE), nullptr);
+
+    AsyncContext* later = Submit(REQUEST_SET_FONT_SCALE, 3, 2.0, true, isMerged);
+    ASSERT_NE(later, nullptr);
+    EXPECT_FALSE(isMerged);
+    EXPECT_NE(later, invalid);
+    CompleteAndRelease(valid);
+    CompleteAndRelease(invalid);
+    CompleteAndRelease(later);
+}
+
+/**
+ * @tc.name: RequestMerger_0400
+ * @tc.desc: Requests of different kinds are never merged with each other
+ * @tc.type: FUNC
+ */
+HWTEST_F(JsUiAppearanceTest, RequestMerger_0400, TestSize.Level1)
+{
+    bool isMerged = true;
+    AsyncContext* fontScale = Submit(REQUEST_SET_FONT_SCALE, 1, 1.0, true, isMerged);
+    ASSERT_NE(fontScale, nullptr);
+    AsyncContext* fontWeightScale = Submit(REQUEST_SET_FONT_WEIGHT_SCALE, 2, 1.0, true, isMerged);
+    ASSERT_NE(fontWeightScale, nullptr);
+    EXPECT_FALSE(isMerged);
+    EXPECT_NE(fontWeightScale, fontScale);
+    EXPECT_EQ(RequestMerger::GetQueued(REQUEST_SET_FONT_SCALE), fontScale);
+    EXPECT_EQ(RequestMerger::GetQueued(REQUEST_SET_FONT_WEIGHT_SCALE), fontWeightScale);
+
+    CompleteAndRelease(fontScale);
+    EXPECT_EQ(RequestMerger::GetQueued(REQUEST_SET_FONT_WEIGHT_SCALE), fontWeightScale);
+    CompleteAndRelease(fontWeightScale);
+    EXPECT_EQ(RequestMerger::GetQueued(REQUEST_SET_FONT_WEIGHT_SCALE), nullptr);
+}
+
+/**
+ * @tc.name: RequestMerger_0500
+ * @tc.desc: While a worker starts on queued contexts concurrently, every caller is settled exactly once
+ * @tc.type: FUNC
+ */
+HWTEST_F(JsUiAppearanceTest, RequestMerger_0500, TestSize.Level1)
+{
+    std::vector<AsyncContext*> queued;
+    std::vector<std::thread> workers;
+    bool isMerged = false;
+    for (int32_t i = 0; i < RACE_REQUEST_COUNT; ++i) {
+        AsyncContext* asyncContext = Submit(REQUEST_SET_FONT_SCALE, i + 1, 1.0 + i, true, isMerged);
+        ASSERT_NE(asyncContext, nullptr);
+        if (isMerged) {
+            continue;
+        }
+        queued.push_back(asyncContext);
+        // The worker may start on the context before or after the next requests try to merge into it.
+        workers.emplace_back([asyncContext]() { asyncContext->BeginExecute(); });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    std::vector<int32_t> settled(RACE_REQUEST_COUNT, 0);
+    for (AsyncContext* asyncContext : queued) {
+        for (const AsyncWaiter& waiter : RequestMerger::Complete(asyncContext)) {
+            ++settled[reinterpret_cast<uintptr_t>(waiter.deferred) - 1];
+        }
+        AsyncContextPool::Release(asyncContext);
+    }
+    for (int32_t count : settled) {
+        EXPECT_EQ(count, 1);
+    }
+    EXPECT_EQ(RequestMerger::GetQueued(REQUEST_SET_FONT_SCALE), nullptr);
+}
+} // namespace OHOS::ArkUi::UiAppearance
@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+#include <gtest/gtest.h>
+
+#include "sunrise_sunset_calc.h"
+
+using namespace testing;
+using namespace testing::ext;
+
+namespace OHOS::ArkUi::UiAppearance {
+namespace {
+constexpr int64_t DAY_MS = 86400000;
+constexpr double SECS_PER_DAY = 86400.0;
+// 2026-01-01T00:00:00Z.
+constexpr int64_t YEAR_START_MS = 1767225600000;
+
+struct ReferenceCase {
+    double lat;
+    double lon;
+    int64_t timestampMs;
+    double sunrise;
+    double sunset;
+};
+
+// Produced by the double-precision path for the 2026 equinoxes and solstices; -1 marks polar day or night.
+constexpr ReferenceCase REFERENCE_CASES[] = {
+    { 39.9, 116.4, 1773964800000, 80280, 37560 },
+    { 39.9, 116.4, 1782000000000, 74760, 42360 },
+    { 39.9, 116.4, 1790121600000, 79380, 36600 },
+    { 39.9, 116.4, 1797811200000, 84720, 31980 },
+    { -33.9, 151.2, 1773964800000, 71880, 29160 },
+    { -33.9, 151.2, 1782000000000, 75600, 24840 },
+    { -33.9, 151.2, 1790121600000, 70980, 28320 },
+    { -33.9, 151.2, 1797811200000, 67260, 32760 },
+    { 51.5, -0.1, 1773964800000, 21720, 65640 },
+    { 51.5, -0.1, 1782000000000, 13380, 73320 },
+    { 51.5, -0.1, 1790121600000, 20940, 64500 },
+    { 51.5, -0.1, 1797811200000, 29040, 57240 },
+    { 40.7, -74.0, 1773964800000, 39480, 83340 },
+    { 40.7, -74.0, 1782000000000, 33900, 1860 },
+    { 40.7, -74.0, 1790121600000, 38700, 82260 },
+    { 40.7, -74.0, 1797811200000, 44220, 77520 },
+    { -0.2, -78.5, 1773964800000, 40680, 84240 },
+    { -0.2, -78.5, 1782000000000, 40380, 83940 },
+    { -0.2, -78.5, 1790121600000, 39780, 83340 },
+    { -0.2, -78.5, 1797811200000, 40080, 83820 },
+    { 69.6, 19.0, 1773964800000, 16860, 61380 },
+    { 69.6, 19.0, 1782000000000, -1, -1 },
+    { 69.6, 19.0, 1790121600000, 16200, 60060 },
+    { 69.6, 19.0, 1797811200000, -1, -1 },
+};
+
+double Distance(double lhs, double rhs)
+{
+    double diff = std::fabs(lhs - rhs);
+    return std::min(diff, SECS_PER_DAY - diff);
+}
+} // namespace
+
+class SunriseSunsetFixedPointTest : public Test {};
+
+/**
+ * @tc.name: SunriseSunsetFixedPoint_0100
+ * @tc.desc: Test the fixed-point build stays within FIXED_POINT_MAX_ERROR_SEC of the double-precision results
+ * @tc.type: FUNC
+ */
+HWTEST_F(SunriseSunsetFixedPointTest, SunriseSunsetFixedPoint_0100, TestSize.Level1)
+{
+    for (const ReferenceCase& expected : REFERENCE_CASES) {
+        SunriseSunsetResult actual =
+            SunriseSunsetUtils::CalculateSunriseSunset(expected.lat, expected.lon, expected.timestampMs);
+        ASSERT_EQ(actual.sunrise == -1, expected.sunrise == -1) << "lat: " << expected.lat;
+        ASSERT_EQ(actual.sunset == -1, expected.sunset == -1) << "lat: " << expected.lat;
+        EXPECT_LE(Distance(actual.sunrise, expected.sunrise), SunriseSunsetUtils::FIXED_POINT_MAX_ERROR_SEC)
+            << "lat: " << expected.lat << ", lon: " << expected.lon << ", timestamp: " << expected.timestampMs;
+        EXPECT_LE(Distance(actual.sunset, expected.sunset), SunriseSunsetUtils::FIXED_POINT_MAX_ERROR_SEC)
+            << "lat: " << expected.lat << ", lon: " << expected.lon << ", timestamp: " << expected.timestampMs;
+    }
+    SunriseSunsetResult invalid = SunriseSunsetUtils::CalculateSunriseSunset(NAN, 0.0, YEAR_START_MS);
+    EXPECT_EQ(invalid.sunrise, -1);
+    EXPECT_EQ(invalid.sunset, -1);
+}
+
+/**
+ * @tc.name: SunriseSunsetFixedPoint_0200
+ * @tc.desc: Test CalculateSunriseSunset and the yearly table both take the fixed-point path in this build
+ * @tc.type: FUNC
+ */
+HWTEST_F(SunriseSunsetFixedPointTest, SunriseSunsetFixedPoint_0200, TestSize.Level1)
+{
+    for (double lat = -60.0; lat <= 60.0; lat += 30.0) {
+        for (double lon = -180.0; lon <= 180.0; lon += 90.0) {
+            SunriseSunsetTable table;
+            ASSERT_TRUE(table.Build(lat, lon, YEAR_START_MS));
+            for (int32_t day = 0; day < SunriseSunsetTable::DAYS_PER_TABLE - 1; ++day) {
+                const int64_t timestampMs = YEAR_START_MS + day * DAY_MS;
+                SunriseSunsetResult expected =
+                    SunriseSunsetUtils::CalculateSunriseSunsetFixedPoint(lat, lon, timestampMs);
+                SunriseSunsetResult actual = SunriseSunsetUtils::CalculateSunriseSunset(lat, lon, timestampMs);
+                EXPECT_EQ(actual.sunrise, expected.sunrise) << "lat: " << lat << ", lon: " << lon << ", day: " << day;
+                EXPECT_EQ(actual.sunset, expected.sunset) << "lat: " << lat << ", lon: " << lon << ", day: " << day;
+                SunriseSunsetResult cached = {};
+                ASSERT_TRUE(table.Lookup(timestampMs, cached));
+                EXPECT_EQ(cached.sunrise, expected.sunrise) << "lat: " << lat << ", lon: " << lon << ", day: " << day;
+                EXPECT_EQ(cached.sunset, expected.sunset) << "lat: " << lat << ", lon: " << lon << ", day: " << day;
+            }
+        }
+    }
+}
+} // namespace OHOS::ArkUi::UiAppearance
@@ -13,17 +13,33 @@
  * limitations under the License.
  */
 
+#include <array>
+#include <atomic>
 #include <chrono>
+#include <cmath>
 #include <cstdio>
+#include <condition_variable>
+#include <cstdlib>
+#include <fstream>
 #include <gtest/gtest.h>
 #include <iostream>
+#include <limits>
 #include <sys/types.h>
 #include <unistd.h>
 #include <string>
+#include <thread>
+#include <vector>
 
 #include "accesstoken_kit.h"
 #include "syspara/parameter.h"
 #include "system_ability_definition.h"
+#include "common_event_support.h"
+#include "dump_buffer.h"
+#include "event_trace.h"
+#include "latest_value_combiner.h"
+#include "matching_skills.h"
+#include "metrics_registry.h"
+#include "oh_ui_appearance.h"
 #define private public
 #define protected public
 #include "ui_appearance_ability.h"
@@ -32,6 +48,10 @@
 #undef protected
 #include "ui_appearance_log.h"
 #include "ui_appearance_ability_client.h"
+#include "ui_appearance_cache.h"
+#include "background_app_color_switch_settings.h"
+#include "file_watcher.h"
+#include "json_utils.h"
 #define private public
 #include "alarm_timer_manager.h"
 #undef private
@@ -51,6 +71,32 @@ const int DAY_TO_MINUTE = 24 * 60;
 const int SECOND_TO_MILLI = 1000;
 const int MINUTE_TO_SECOND = 60;
 static const std::string STANDARD_FONT_WEIGHT = "const.standard_font_weight";
+static const std::string TEST_ALLOW_LIST_PATH = "/data/local/tmp/dark_mode_whilelist_test.json";
+
+static void WriteTestFile(const std::string& path, const std::string& content)
+{
+    std::ofstream file(path, std::ios::trunc);
+    file << content;
+}
+
+static std::string DumpToString(UiAppearanceAbility& ability, const std::vector<std::u16string>& args)
+{
+    std::string dump;
+    FILE* file = tmpfile();
+    if (file == nullptr) {
+        return dump;
+    }
+    if (ability.Dump(fileno(file), args) == ERR_OK) {
+        rewind(file);
+        char buffer[256];
+        size_t size = 0;
+        while ((size = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+            dump.append(buffer, size);
+        }
+    }
+    fclose(file);
+    return dump;
+}
 
 class UiAppearanceAbilityTest : public UiAppearanceAbility {
 public:
@@ -291,10 +337,50 @@ HWTEST_F(DarkModeTest, ui_appearance_test_0071, TestSize.Level0)
     EXPECT_EQ(timerManager->SetScheduleTime(10, 12, userId, []() {}, []() {}), ERR_OK);
 
     timerManager->SetRecalculationTimer(userId, []() {});
-    EXPECT_EQ(timerManager->recalculationTimerIdMap_.count(userId), 1);
+    EXPECT_TRUE(timerManager->HasTask(userId, AlarmTaskType::RECALCULATION));
 
     timerManager->ClearTimerByUserId(userId);
-    EXPECT_EQ(timerManager->recalculationTimerIdMap_.count(userId), 0);
+    EXPECT_FALSE(timerManager->HasTask(userId, AlarmTaskType::RECALCULATION));
+}
+
+/**
+ * @tc.name: ui_appearance_test_0072
+ * @tc.desc: Test that all user timers share one system alarm armed at the earliest deadline.
+ * @tc.type: FUNC
+ */
+HWTEST_F(DarkModeTest, ui_appearance_test_0072, TestSize.Level0)
+{
+    auto timerManager = DarkModeTest::GetAlarmTimerManager();
+    constexpr uint64_t firstUserId = 100;
+    constexpr uint64_t userCount = 4;
+    uint32_t fired = 0;
+    for (uint64_t userId = firstUserId; userId < firstUserId + userCount; ++userId) {
+        EXPECT_EQ(timerManager->SetScheduleTime(10 + userId, 1200, userId, [&fired]() { fired++; },
+            [&fired]() { fired++; }), ERR_OK);
+        timerManager->SetRecalculationTimer(userId, [&fired]() { fired++; });
+    }
+    EXPECT_NE(timerManager->systemTimerId_, 0);
+    EXPECT_EQ(timerManager->scheduledTaskCount_, userCount * static_cast<size_t>(AlarmTaskType::COUNT));
+    EXPECT_EQ(timerManager->armedTriggerTime_, timerManager->taskHeap_.front().triggerTime);
+
+    uint64_t armCount = timerManager->armCount_;
+    EXPECT_TRUE(timerManager->RestartAllTimer());
+    EXPECT_LE(timerManager->armCount_, armCount + 1);
+
+    std::vector<std::function<void()>> callbacks;
+    timerManager->CollectDueTasks(timerManager->GetCurrentTimestamp() + DAY_TO_SECOND * SECOND_TO_MILLI, callbacks);
+    EXPECT_EQ(callbacks.size(), userCount * static_cast<size_t>(AlarmTaskType::COUNT));
+    for (const auto& callback : callbacks) {
+        callback();
+    }
+    EXPECT_EQ(fired, callbacks.size());
+    EXPECT_EQ(timerManager->scheduledTaskCount_, userCount * static_cast<size_t>(AlarmTaskType::COUNT));
+
+    for (uint64_t userId = firstUserId; userId < firstUserId + userCount; ++userId) {
+        timerManager->ClearTimerByUserId(userId);
+    }
+    EXPECT_EQ(timerManager->scheduledTaskCount_, 0);
+    EXPECT_EQ(timerManager->armedTriggerTime_, 0);
 }
 
 /**
@@ -381,7 +467,7 @@ HWTEST_F(DarkModeTest, ui_appearance_test_012, TestSize.Level0)
 
     MockSetParameterValue(STANDARD_FONT_WEIGHT, "1.75");
     UiAppearanceAbility::UiAppearanceParam param;
-    EXPECT_EQ(param.fontWeightScale, "1.75");
+    EXPECT_EQ(param.fontWeightScale.ToString(), "1.75");
 }
 
 /**
@@ -395,7 +481,7 @@ HWTEST_F(DarkModeTest, ui_appearance_test_013, TestSize.Level0)
 
     MockSetParameterValue(STANDARD_FONT_WEIGHT, "0");
     UiAppearanceAbility::UiAppearanceParam param;
-    EXPECT_EQ(param.fontWeightScale, "1");
+    EXPECT_EQ(param.fontWeightScale.ToString(), "1");
 }
 
 /**
@@ -409,7 +495,7 @@ HWTEST_F(DarkModeTest, ui_appearance_test_014, TestSize.Level0)
 
     MockSetParameterValue(STANDARD_FONT_WEIGHT, "-1");
     UiAppearanceAbility::UiAppearanceParam param;
-    EXPECT_EQ(param.fontWeightScale, "1");
+    EXPECT_EQ(param.fontWeightScale.ToString(), "1");
 }
 
 /**
@@ -423,7 +509,7 @@ HWTEST_F(DarkModeTest, ui_appearance_test_015, TestSize.Level0)
 
     MockSetParameterValue(STANDARD_FONT_WEIGHT, "5.1");
     UiAppearanceAbility::UiAppearanceParam param;
-    EXPECT_EQ(param.fontWeightScale, "1");
+    EXPECT_EQ(param.fontWeightScale.ToString(), "1");
 }
 
 /**
@@ -437,7 +523,7 @@ HWTEST_F(DarkModeTest, ui_appearance_test_016, TestSize.Level0)
 
     MockSetParameterValue(STANDARD_FONT_WEIGHT, "abc");
     UiAppearanceAbility::UiAppearanceParam param;
-    EXPECT_EQ(param.fontWeightScale, "1");
+    EXPECT_EQ(param.fontWeightScale.ToString(), "1");
 }
 
 /**
@@ -451,7 +537,7 @@ HWTEST_F(DarkModeTest, ui_appearance_test_017, TestSize.Level0)
 
     MockSetParameterValue(STANDARD_FONT_WEIGHT, "1.2abc");
     UiAppearanceAbility::UiAppearanceParam param;
-    EXPECT_EQ(param.fontWeightScale, "1");
+    EXPECT_EQ(param.fontWeightScale.ToString(), "1");
 }
 
 /**
@@ -465,7 +551,7 @@ HWTEST_F(DarkModeTest, ui_appearance_test_018, TestSize.Level0)
 
     MockSetGetParameterShouldFail(true);
     UiAppearanceAbility::UiAppearanceParam param;
-    EXPECT_EQ(param.fontWeightScale, "1");
+    EXPECT_EQ(param.fontWeightScale.ToString(), "1");
 }
 
 /**
@@ -479,7 +565,7 @@ HWTEST_F(DarkModeTest, ui_appearance_test_019, TestSize.Level0)
 
     MockSetParameterValue(STANDARD_FONT_WEIGHT, "0.5");
     UiAppearanceAbility::UiAppearanceParam param;
-    EXPECT_EQ(param.fontWeightScale, "0.5");
+    EXPECT_EQ(param.fontWeightScale.ToString(), "0.5");
 }
 
 /**
@@ -493,7 +579,7 @@ HWTEST_F(DarkModeTest, ui_appearance_test_020, TestSize.Level0)
 
     MockSetParameterValue(STANDARD_FONT_WEIGHT, "5.0");
     UiAppearanceAbility::UiAppearanceParam param;
-    EXPECT_EQ(param.fontWeightScale, "5.0");
+    EXPECT_EQ(param.fontWeightScale.ToString(), "5.0");
 }
 
 /**
@@ -507,7 +593,7 @@ HWTEST_F(DarkModeTest, ui_appearance_test_021, TestSize.Level0)
 
     MockSetParameterValue(STANDARD_FONT_WEIGHT, "5.00");
     UiAppearanceAbility::UiAppearanceParam param;
-    EXPECT_EQ(param.fontWeightScale, "5.00");
+    EXPECT_EQ(param.fontWeightScale.ToString(), "5.00");
 }
 
 /**
@@ -521,7 +607,7 @@ HWTEST_F(DarkModeTest, ui_appearance_test_022, TestSize.Level0)
 
     MockSetParameterValue(STANDARD_FONT_WEIGHT, "+1.5");
     UiAppearanceAbility::UiAppearanceParam param;
-    EXPECT_EQ(param.fontWeightScale, "+1.5");
+    EXPECT_EQ(param.fontWeightScale.ToString(), "+1.5");
 }
 
 /**
@@ -535,7 +621,7 @@ HWTEST_F(DarkModeTest, ui_appearance_test_023, TestSize.Level0)
 
     MockSetParameterValue(STANDARD_FONT_WEIGHT, " 1.5");
     UiAppearanceAbility::UiAppearanceParam param;
-    EXPECT_EQ(param.fontWeightScale, " 1.5");
+    EXPECT_EQ(param.fontWeightScale.ToString(), " 1.5");
 }
 
 /**
@@ -549,7 +635,7 @@ HWTEST_F(DarkModeTest, ui_appearance_test_024, TestSize.Level0)
 
     MockSetParameterValue(STANDARD_FONT_WEIGHT, "7");
     UiAppearanceAbility::UiAppearanceParam param;
-    EXPECT_EQ(param.fontWeightScale, "1");
+    EXPECT_EQ(param.fontWeightScale.ToString(), "1");
 }
 
 /**
@@ -563,7 +649,7 @@ HWTEST_F(DarkModeTest, ui_appearance_test_025, TestSize.Level0)
 
     MockSetParameterValue(STANDARD_FONT_WEIGHT, "1e309");
     UiAppearanceAbility::UiAppearanceParam param;
-    EXPECT_EQ(param.fontWeightScale, "1");
+    EXPECT_EQ(param.fontWeightScale.ToString(), "1");
 }
 
 /**
@@ -665,5 +751,550 @@ HWTEST_F(DarkModeTest, ui_appearance_test_031, TestSize.Level0)
     EXPECT_EQ(UIAppearance::GetDarkMode(mode), UiAppearanceAbilityErrCode::SYS_ERR);
     EXPECT_EQ(mode, DarkMode::ALWAYS_LIGHT);
 }
+
+/**
+ * @tc.name: ui_appearance_test_032
+ * @tc.desc: Test BackGroundAppColorSwitchSettings::Reload publishes valid settings and keeps them on a bad file.
+ * @tc.type: FUNC
+ */
+HWTEST_F(DarkModeTest, ui_appearance_test_032, TestSize.Level0)
+{
+    auto& manager = BackGroundAppColorSwitchSettings::GetInstance();
+    manager.Reset();
+    uint64_t reloadCount = manager.GetReloadCount();
+    uint64_t failureCount = manager.GetReloadFailureCount();
+
+    WriteTestFile(TEST_ALLOW_LIST_PATH, R"({"whiteList":[{"bundleName":"com.example.a"},)"
+        R"({"bundleName":"com.example.b"}],"strategy":{"duration":300,"perTaskNumber":5}})");
+    EXPECT_EQ(manager.Reload(TEST_ALLOW_LIST_PATH), ERR_OK);
+    auto settings = manager.GetSettings();
+    EXPECT_TRUE(manager.IsSupportHotUpdate());
+    EXPECT_TRUE(manager.CheckInWhileList("com.example.b"));
+    EXPECT_FALSE(manager.CheckInWhileList("com.example.c"));
+    EXPECT_EQ(manager.GetTaskQuantity(), 5);
+    EXPECT_EQ(manager.GetDurationMillisecond(), 300);
+    EXPECT_EQ(manager.GetReloadCount(), reloadCount + 1);
+
+    WriteTestFile(TEST_ALLOW_LIST_PATH, R"({"whiteList":[{"bundleName":"com.example.c"}],)"
+        R"("strategy":{"duration":0,"perTaskNumber":5}})");
+    EXPECT_EQ(manager.Reload(TEST_ALLOW_LIST_PATH), ERR_INVALID_VALUE);
+    EXPECT_EQ(manager.GetSettings(), settings);
+    EXPECT_FALSE(manager.CheckInWhileList("com.example.c"));
+    EXPECT_EQ(manager.GetReloadFailureCount(), failureCount + 1);
+
+    WriteTestFile(TEST_ALLOW_LIST_PATH, R"({"whiteList":[{"bundleName":"com.example.c"}],)"
+        R"("strategy":{"duration":100,"perTaskNumber":2}})");
+    EXPECT_EQ(manager.Reload(TEST_ALLOW_LIST_PATH), ERR_OK);
+    EXPECT_TRUE(manager.CheckInWhileList("com.example.c"));
+    EXPECT_FALSE(manager.CheckInWhileList("com.example.a"));
+    EXPECT_EQ(manager.GetWhileList().size(), 1);
+    // A hot reload parses a copy of the file instead of a mapping and publishes the same settings.
+    EXPECT_EQ(manager.Reload(TEST_ALLOW_LIST_PATH, true), ERR_OK);
+    EXPECT_EQ(manager.GetWhileList(), std::list<std::string>({ "com.example.c" }));
+    // A reader that took a snapshot before the swap still sees a consistent old version.
+    EXPECT_EQ(settings->taskQuantity, 5);
+    EXPECT_EQ(settings->allowList.size(), 2);
+
+    manager.Reset();
+    EXPECT_FALSE(manager.IsSupportHotUpdate());
+    unlink(TEST_ALLOW_LIST_PATH.c_str());
+}
+
+/**
+ * @tc.name: ui_appearance_test_033
+ * @tc.desc: Test FileWatcher reports renames onto and in-place writes of the watched file but not its neighbours.
+ * @tc.type: FUNC
+ */
+HWTEST_F(DarkModeTest, ui_appearance_test_033, TestSize.Level0)
+{
+    static constexpr int32_t waitStepMs = 10;
+    static constexpr int32_t maxWaitSteps = 200;
+    std::atomic<uint32_t> changeCount = 0;
+    auto waitForChange = [&changeCount](uint32_t expected) {
+        for (int32_t i = 0; i < maxWaitSteps && changeCount.load() < expected; ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(waitStepMs));
+        }
+        return changeCount.load() >= expected;
+    };
+    FileWatcher watcher(TEST_ALLOW_LIST_PATH, [&changeCount]() { changeCount++; });
+    ASSERT_TRUE(watcher.Start());
+
+    WriteTestFile(TEST_ALLOW_LIST_PATH + ".other", "{}");
+    std::this_thread::sleep_for(std::chrono::milliseconds(waitStepMs * 5));
+    EXPECT_EQ(changeCount.load(), 0);
+
+    WriteTestFile(TEST_ALLOW_LIST_PATH, "{}");
+    EXPECT_TRUE(waitForChange(1));
+
+    uint32_t countBeforeRename = changeCount.load();
+    WriteTestFile(TEST_ALLOW_LIST_PATH + ".tmp", "{}");
+    EXPECT_EQ(rename((TEST_ALLOW_LIST_PATH + ".tmp").c_str(), TEST_ALLOW_LIST_PATH.c_str()), 0);
+    EXPECT_TRUE(waitForChange(countBeforeRename + 1));
+
+    watcher.Stop();
+    uint32_t countAfterStop = changeCount.load();
+    WriteTestFile(TEST_ALLOW_LIST_PATH + ".tmp", "{}");
+    EXPECT_EQ(rename((TEST_ALLOW_LIST_PATH + ".tmp").c_str(), TEST_ALLOW_LIST_PATH.c_str()), 0);
+    std::this_thread::sleep_for(std::chrono::milliseconds(waitStepMs * 5));
+    EXPECT_EQ(changeCount.load(), countAfterStop);
+    unlink(TEST_ALLOW_LIST_PATH.c_str());
+    unlink((TEST_ALLOW_LIST_PATH + ".other").c_str());
+}
+
+/**
+ * @tc.name: ui_appearance_test_034
+ * @tc.desc: Test the streaming allow list parser on nested, duplicated, malformed and empty documents.
+ * @tc.type: FUNC
+ */
+HWTEST_F(DarkModeTest, ui_appearance_test_034, TestSize.Level0)
+{
+    auto& manager = BackGroundAppColorSwitchSettings::GetInstance();
+    manager.Reset();
+
+    WriteTestFile(TEST_ALLOW_LIST_PATH, R"({"whiteList":[{"bundleName":"a","bundleName":"b"},{"x":{"bundleName":"c"}},)"
+        R"("d",{"bundleName":1}],"strategy":{"duration":1,"perTaskNumber":2,"duration":3}})");
+    EXPECT_EQ(manager.Reload(TEST_ALLOW_LIST_PATH), ERR_OK);
+    EXPECT_EQ(manager.GetWhileList(), std::list<std::string>({ "b" }));
+    EXPECT_EQ(manager.GetDurationMillisecond(), 3);
+    EXPECT_EQ(manager.GetTaskQuantity(), 2);
+
+    WriteTestFile(TEST_ALLOW_LIST_PATH, R"({"whiteList":{},"strategy":{"duration":1,"perTaskNumber":2}})");
+    EXPECT_EQ(manager.Reload(TEST_ALLOW_LIST_PATH), ERR_INVALID_VALUE);
+    WriteTestFile(TEST_ALLOW_LIST_PATH, R"({"whiteList":[]})");
+    EXPECT_EQ(manager.Reload(TEST_ALLOW_LIST_PATH), ERR_NAME_NOT_FOUND);
+    WriteTestFile(TEST_ALLOW_LIST_PATH, R"({"whiteList":[],"strategy":{"duration":"1","perTaskNumber":2}})");
+    EXPECT_EQ(manager.Reload(TEST_ALLOW_LIST_PATH), ERR_INVALID_VALUE);
+    WriteTestFile(TEST_ALLOW_LIST_PATH, R"({"whiteList":[{"bundleName":"e"}],"strategy":{"duration":1,)");
+    EXPECT_EQ(manager.Reload(TEST_ALLOW_LIST_PATH), ERR_NAME_NOT_FOUND);
+    WriteTestFile(TEST_ALLOW_LIST_PATH, "");
+    EXPECT_EQ(manager.Reload(TEST_ALLOW_LIST_PATH), ERR_NAME_NOT_FOUND);
+    EXPECT_EQ(manager.Reload(TEST_ALLOW_LIST_PATH, true), ERR_NAME_NOT_FOUND);
+    EXPECT_EQ(manager.GetWhileList(), std::list<std::string>({ "b" }));
+
+    nlohmann::json object;
+    EXPECT_FALSE(JsonUtils::ReadFileInfoJson(TEST_ALLOW_LIST_PATH, object));
+    WriteTestFile(TEST_ALLOW_LIST_PATH, R"({"whiteList":[{"bundleName":"e"}]})");
+    EXPECT_TRUE(JsonUtils::ReadFileInfoJson(TEST_ALLOW_LIST_PATH, object));
+    EXPECT_EQ(object["whiteList"][0]["bundleName"], "e");
+
+    manager.Reset();
+    unlink(TEST_ALLOW_LIST_PATH.c_str());
+}
+
+/**
+ * @tc.name: ui_appearance_test_035
+ * @tc.desc: Test FontScale parses and formats once, matching the legacy string representations.
+ * @tc.type: FUNC
+ */
+HWTEST_F(DarkModeTest, ui_appearance_test_035, TestSize.Level0)
+{
+    FontScale scale;
+    EXPECT_EQ(scale.ToString(), "1");
+    EXPECT_EQ(scale.ToDouble(), 1.0);
+
+    ASSERT_TRUE(FontScale::FromDouble(1.15, scale));
+    EXPECT_EQ(scale.ToString(), std::to_string(1.15));
+    EXPECT_EQ(scale.GetMicros(), 1150000);
+    ASSERT_TRUE(FontScale::FromDouble(5.0, scale));
+    EXPECT_EQ(scale.ToString(), "5.000000");
+    EXPECT_FALSE(FontScale::FromDouble(0.0, scale));
+    EXPECT_FALSE(FontScale::FromDouble(5.0000001, scale));
+    EXPECT_FALSE(FontScale::FromDouble(std::nan(""), scale));
+    EXPECT_FALSE(FontScale::FromDouble(4e-7, scale));
+    EXPECT_EQ(scale.ToString(), "5.000000");
+    ASSERT_TRUE(FontScale::FromDouble(5e-7, scale));
+    EXPECT_EQ(scale.GetMicros(), 1);
+    EXPECT_EQ(scale.ToString(), "0.000001");
+
+    ASSERT_TRUE(FontScale::FromString(" 1.5", scale));
+    EXPECT_EQ(scale.ToString(), " 1.5");
+    EXPECT_EQ(scale.GetMicros(), 1500000);
+    EXPECT_FALSE(FontScale::FromString("1.2abc", scale));
+    EXPECT_FALSE(FontScale::FromString("1e309", scale));
+    EXPECT_FALSE(FontScale::FromString("", scale));
+    EXPECT_FALSE(FontScale::FromString("1e-7", scale));
+    EXPECT_EQ(scale.ToString(), " 1.5");
+}
+
+/**
+ * @tc.name: ui_appearance_test_036
+ * @tc.desc: Test the typed font scale APIs interoperate with the string ones.
+ * @tc.type: FUNC
+ */
+HWTEST_F(DarkModeTest, ui_appearance_test_036, TestSize.Level0)
+{
+    auto test = DarkModeTest::GetUiAppearanceAbilityTest();
+    int32_t result = -1;
+    test->SetFontScaleValue(1.25, result);
+    EXPECT_EQ(result, UiAppearanceAbilityErrCode::SUCCEEDED);
+    double scaleValue = 0;
+    test->GetFontScaleValue(scaleValue, result);
+    ASSERT_EQ(result, UiAppearanceAbilityErrCode::SUCCEEDED);
+    EXPECT_EQ(scaleValue, 1.25);
+    std::string scaleText;
+    test->GetFontScale(scaleText, result);
+    EXPECT_EQ(scaleText, "1.250000");
+
+    test->SetFontScaleValue(6.0, result);
+    EXPECT_EQ(result, UiAppearanceAbilityErrCode::INVALID_ARG);
+    test->SetFontScale("abc", result);
+    EXPECT_EQ(result, UiAppearanceAbilityErrCode::INVALID_ARG);
+    test->GetFontScaleValue(scaleValue, result);
+    EXPECT_EQ(scaleValue, 1.25);
+
+    test->SetFontWeightScale("0.75", result);
+    EXPECT_EQ(result, UiAppearanceAbilityErrCode::SUCCEEDED);
+    test->GetFontWeightScaleValue(scaleValue, result);
+    ASSERT_EQ(result, UiAppearanceAbilityErrCode::SUCCEEDED);
+    EXPECT_EQ(scaleValue, 0.75);
+    test->SetFontWeightScaleValue(-1.0, result);
+    EXPECT_EQ(result, UiAppearanceAbilityErrCode::INVALID_ARG);
+}
+
+/**
+ * @tc.name: ui_appearance_test_037
+ * @tc.desc: Test committed changes bump the generation client caches watch, and rejected ones do not.
+ * @tc.type: FUNC
+ */
+HWTEST_F(DarkModeTest, ui_appearance_test_037, TestSize.Level0)
+{
+    auto readGeneration = []() {
+        char value[32] = { 0 };
+        GetParameter(CONFIG_GENERATION_PARAM, "0", value, sizeof(value));
+        return std::strtoull(value, nullptr, 10);
+    };
+    auto test = DarkModeTest::GetUiAppearanceAbilityTest();
+    int32_t result = -1;
+    // Exactly one bump per committed change, however many foreground users it is persisted for.
+    uint64_t generation = readGeneration();
+    test->SetFontScaleValue(1.5, result);
+    EXPECT_EQ(result, UiAppearanceAbilityErrCode::SUCCEEDED);
+    EXPECT_EQ(readGeneration(), generation + 1);
+
+    generation = readGeneration();
+    test->SetFontScaleValue(6.0, result);
+    EXPECT_EQ(result, UiAppearanceAbilityErrCode::INVALID_ARG);
+    test->SetDarkMode(DarkMode::UNKNOWN, result);
+    EXPECT_EQ(readGeneration(), generation);
+
+    test->SetFontWeightScaleValue(1.25, result);
+    EXPECT_EQ(result, UiAppearanceAbilityErrCode::SUCCEEDED);
+    EXPECT_EQ(readGeneration(), generation + 1);
+}
+
+/**
+ * @tc.name: ui_appearance_test_038
+ * @tc.desc: Test requests that arrive during an apply are merged and only the latest value is applied.
+ * @tc.type: FUNC
+ */
+HWTEST_F(DarkModeTest, ui_appearance_test_038, TestSize.Level0)
+{
+    static constexpr int32_t waitStepMs = 5;
+    LatestValueCombiner<int32_t> combiner;
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool isReleased = false;
+    std::vector<std::pair<int32_t, uint32_t>> applied;
+    auto apply = [&](const int32_t& value, const uint32_t mergedCount) {
+        std::unique_lock lock(mutex);
+        applied.emplace_back(value, mergedCount);
+        cv.wait(lock, [&isReleased]() { return isReleased; });
+        return value * 10;
+    };
+    auto waitSubmitted = [&combiner](uint64_t count) {
+        while (combiner.GetSubmitCount() < count) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(waitStepMs));
+        }
+    };
+
+    int32_t firstResult = 0;
+    std::thread first([&]() { firstResult = combiner.Submit(1, apply); });
+    waitSubmitted(1);
+    std::array<int32_t, 3> results = {};
+    std::vector<std::thread> merged;
+    for (int32_t i = 0; i < static_cast<int32_t>(results.size()); ++i) {
+        merged.emplace_back([&, i]() { results[i] = combiner.Submit(i + 2, apply); });
+        waitSubmitted(i + 2);
+    }
+    {
+        std::lock_guard lock(mutex);
+        isReleased = true;
+    }
+    cv.notify_all();
+    first.join();
+    for (auto& thread : merged) {
+        thread.join();
+    }
+
+    EXPECT_EQ(firstResult, 10);
+    ASSERT_EQ(applied.size(), 2u);
+    EXPECT_EQ(applied[0], std::make_pair(1, 1u));
+    EXPECT_EQ(applied[1], std::make_pair(4, 3u));
+    for (int32_t result : results) {
+        EXPECT_EQ(result, 40);
+    }
+    EXPECT_EQ(combiner.GetApplyCount(), 2u);
+}
+
+/**
+ * @tc.name: ui_appearance_test_039
+ * @tc.desc: Test concurrent font scale setters all succeed and leave one of the requested values applied.
+ * @tc.type: FUNC
+ */
+HWTEST_F(DarkModeTest, ui_appearance_test_039, TestSize.Level0)
+{
+    static constexpr int32_t threadCount = 8;
+    auto test = DarkModeTest::GetUiAppearanceAbilityTest();
+    std::array<int32_t, threadCount> results = {};
+    std::vector<std::thread> threads;
+    for (int32_t i = 0; i < threadCount; ++i) {
+        threads.emplace_back([&test, &results, i]() { test->SetFontScaleValue(1.0 + 0.5 * i, results[i]); });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    for (int32_t result : results) {
+        EXPECT_EQ(result, UiAppearanceAbilityErrCode::SUCCEEDED);
+    }
+    int32_t result = -1;
+    double fontScale = 0;
+    test->GetFontScaleValue(fontScale, result);
+    EXPECT_EQ(result, UiAppearanceAbilityErrCode::SUCCEEDED);
+    double steps = (fontScale - 1.0) / 0.5;
+    EXPECT_EQ(steps, std::round(steps));
+    EXPECT_GE(fontScale, 1.0);
+    EXPECT_LE(fontScale, 1.0 + 0.5 * (threadCount - 1));
+
+    auto setters = test->GetAppearanceSetters(test->GetCallingAccountContext());
+    EXPECT_EQ(setters->fontScale.GetSubmitCount(), static_cast<uint64_t>(threadCount));
+    EXPECT_LE(setters->fontScale.GetApplyCount(), static_cast<uint64_t>(threadCount));
+}
+
+/**
+ * @tc.name: ui_appearance_test_040
+ * @tc.desc: Test the native change callback registration and snapshot argument checks.
+ * @tc.type: FUNC
+ */
+HWTEST_F(DarkModeTest, ui_appearance_test_040, TestSize.Level0)
+{
+    auto callback = [](const OH_UIAppearance_Snapshot* snapshot, void* userData) {};
+    int32_t userData = 0;
+    EXPECT_EQ(OH_UIAppearance_GetSnapshot(nullptr), UiAppearanceAbilityErrCode::INVALID_ARG);
+    EXPECT_EQ(OH_UIAppearance_RegisterChangeCallback(nullptr, &userData), UiAppearanceAbilityErrCode::INVALID_ARG);
+    EXPECT_EQ(OH_UIAppearance_UnregisterChangeCallback(callback, &userData), UiAppearanceAbilityErrCode::INVALID_ARG);
+
+    EXPECT_EQ(OH_UIAppearance_RegisterChangeCallback(callback, &userData), UiAppearanceAbilityErrCode::SUCCEEDED);
+    EXPECT_EQ(OH_UIAppearance_RegisterChangeCallback(callback, &userData), UiAppearanceAbilityErrCode::INVALID_ARG);
+    EXPECT_EQ(OH_UIAppearance_RegisterChangeCallback(callback, nullptr), UiAppearanceAbilityErrCode::SUCCEEDED);
+    EXPECT_EQ(OH_UIAppearance_UnregisterChangeCallback(callback, &userData), UiAppearanceAbilityErrCode::SUCCEEDED);
+    EXPECT_EQ(OH_UIAppearance_UnregisterChangeCallback(callback, &userData), UiAppearanceAbilityErrCode::INVALID_ARG);
+    EXPECT_EQ(OH_UIAppearance_UnregisterChangeCallback(callback, nullptr), UiAppearanceAbilityErrCode::SUCCEEDED);
+}
+
+/**
+ * @tc.name: ui_appearance_test_041
+ * @tc.desc: Test the metric histogram bucket bounds and percentiles.
+ * @tc.type: FUNC
+ */
+HWTEST_F(DarkModeTest, ui_appearance_test_041, TestSize.Level0)
+{
+    EXPECT_EQ(MetricHistogram::GetBucketIndex(0), 0u);
+    EXPECT_EQ(MetricHistogram::GetBucketIndex(7), 7u);
+    EXPECT_EQ(MetricHistogram::GetBucketIndex(8), 8u);
+    EXPECT_EQ(MetricHistogram::GetBucketIndex(16), 16u);
+    EXPECT_EQ(MetricHistogram::GetBucketIndex(17), 16u);
+    EXPECT_EQ(MetricHistogram::GetBucketIndex(UINT64_MAX), MetricHistogram::BUCKET_COUNT - 1);
+    for (uint64_t value : { 1ULL, 9ULL, 100ULL, 1000ULL, 12345ULL, 1000000ULL }) {
+        size_t index = MetricHistogram::GetBucketIndex(value);
+        EXPECT_GE(MetricHistogram::GetBucketUpperBound(index), value);
+        EXPECT_LT(MetricHistogram::GetBucketUpperBound(index - 1), value);
+        // A bucket is never wider than an eighth of its lower bound.
+        EXPECT_LE(MetricHistogram::GetBucketUpperBound(index) - value, value / MetricHistogram::SUB_BUCKET_COUNT);
+    }
+
+    MetricHistogram histogram;
+    EXPECT_EQ(histogram.GetPercentile(50), 0u);
+    for (uint64_t value = 1; value <= 100; ++value) {
+        histogram.Record(value * 10);
+    }
+    EXPECT_EQ(histogram.GetCount(), 100u);
+    EXPECT_EQ(histogram.GetMaxLatency(), 1000u);
+    uint64_t p50 = histogram.GetPercentile(50);
+    EXPECT_GE(p50, 500u);
+    EXPECT_LE(p50, 500u + 500u / MetricHistogram::SUB_BUCKET_COUNT);
+    EXPECT_EQ(histogram.GetPercentile(100), 1000u);
+    histogram.Reset();
+    EXPECT_EQ(histogram.GetCount(), 0u);
+}
+
+/**
+ * @tc.name: ui_appearance_test_042
+ * @tc.desc: Test IPC methods are counted in the metrics registry and dumped through Dump.
+ * @tc.type: FUNC
+ */
+HWTEST_F(DarkModeTest, ui_appearance_test_042, TestSize.Level0)
+{
+    MetricsRegistry& registry = MetricsRegistry::GetInstance();
+    registry.Reset();
+    auto test = DarkModeTest::GetUiAppearanceAbilityTest();
+    int32_t result = -1;
+    test->SetFontScaleValue(1.5, result);
+    test->SetFontScaleValue(-1.0, result);
+    EXPECT_EQ(result, UiAppearanceAbilityErrCode::INVALID_ARG);
+    EXPECT_EQ(registry.GetCount(MetricId::IPC_SET_FONT_SCALE_VALUE), 2u);
+    EXPECT_EQ(registry.GetFailureCount(MetricId::IPC_SET_FONT_SCALE_VALUE), 1u);
+
+    std::string dump = DumpToString(*test, {});
+    EXPECT_NE(dump.find(MetricsRegistry::GetName(MetricId::IPC_SET_FONT_SCALE_VALUE)), std::string::npos);
+    EXPECT_NE(dump.find(MetricsRegistry::GetName(MetricId::UPDATE_CONFIGURATION)), std::string::npos);
+}
+
+/**
+ * @tc.name: ui_appearance_test_043
+ * @tc.desc: Test Dump selects sections by argument and never grows its buffer.
+ * @tc.type: FUNC
+ */
+HWTEST_F(DarkModeTest, ui_appearance_test_043, TestSize.Level0)
+{
+    static constexpr size_t capacity = 16;
+    DumpBuffer buffer(capacity);
+    buffer.Append("%s", "0123456789");
+    EXPECT_EQ(buffer.GetSize(), 10u);
+    EXPECT_FALSE(buffer.IsTruncated());
+    buffer.Append("%s", "abcdefghij");
+    EXPECT_EQ(buffer.GetSize(), capacity - 1);
+    EXPECT_TRUE(buffer.IsTruncated());
+    EXPECT_EQ(std::string(buffer.GetData(), buffer.GetSize()), "0123456789abcde");
+
+    auto test = DarkModeTest::GetUiAppearanceAbilityTest();
+    int32_t result = -1;
+    test->SetDarkMode(DarkMode::ALWAYS_DARK, result);
+    EXPECT_NE(DumpToString(*test, { u"-h" }).find("usage"), std::string::npos);
+    std::string state = DumpToString(*test, { u"-state" });
+    EXPECT_NE(state.find("users param"), std::string::npos);
+    EXPECT_NE(state.find("setter requests"), std::string::npos);
+    EXPECT_EQ(state.find("metric(us)"), std::string::npos);
+    std::string all = DumpToString(*test, {});
+    EXPECT_NE(all.find("dark mode states"), std::string::npos);
+    EXPECT_NE(all.find("alarm timer"), std::string::npos);
+    EXPECT_NE(all.find("metric(us)"), std::string::npos);
+}
+
+/**
+ * @tc.name: ui_appearance_test_044
+ * @tc.desc: Test the event trace keeps the latest events in order and records subscriber events.
+ * @tc.type: FUNC
+ */
+HWTEST_F(DarkModeTest, ui_appearance_test_044, TestSize.Level0)
+{
+    EventTrace& trace = EventTrace::GetInstance();
+    trace.Reset();
+    static constexpr int32_t extraEvents = 10;
+    const int32_t total = static_cast<int32_t>(EventTrace::CAPACITY) + extraEvents;
+    for (int32_t i = 0; i < total; ++i) {
+        trace.Record(TraceEventType::SETTING_CHANGED, 100, -1, i);
+    }
+    std::vector<TraceEvent> events = trace.GetEvents();
+    ASSERT_EQ(events.size(), EventTrace::CAPACITY);
+    EXPECT_EQ(events.front().value, extraEvents);
+    EXPECT_EQ(events.back().value, total - 1);
+    for (size_t i = 1; i < events.size(); ++i) {
+        EXPECT_EQ(events[i].sequence, events[i - 1].sequence + 1);
+        EXPECT_GE(events[i].timestampNs, events[i - 1].timestampNs);
+    }
+
+    trace.Reset();
+    int32_t switchedUserId = -1;
+    EventFwk::MatchingSkills matchingSkills;
+    matchingSkills.AddEvent(EventFwk::CommonEventSupport::COMMON_EVENT_USER_SWITCHED);
+    EventFwk::CommonEventSubscribeInfo subscribeInfo(matchingSkills);
+    UiAppearanceEventSubscriber subscriber(subscribeInfo,
+        [&switchedUserId](const int32_t userId) { switchedUserId = userId; }, nullptr);
+    AAFwk::Want want;
+    want.SetAction(EventFwk::CommonEventSupport::COMMON_EVENT_USER_SWITCHED);
+    static constexpr int32_t userId = 101;
+    subscriber.OnReceiveEvent(EventFwk::CommonEventData(want, userId, ""));
+    EXPECT_EQ(switchedUserId, userId);
+    events = trace.GetEvents();
+    ASSERT_FALSE(events.empty());
+    EXPECT_EQ(events.front().type, TraceEventType::USER_SWITCHED);
+    EXPECT_EQ(events.front().userId, userId);
+
+    auto test = DarkModeTest::GetUiAppearanceAbilityTest();
+    std::string dump = DumpToString(*test, { u"-trace" });
+    EXPECT_NE(dump.find("event.UserSwitched"), std::string::npos);
+    EXPECT_EQ(dump.find("metric(us)"), std::string::npos);
+}
+
+/**
+ * @tc.name: ui_appearance_test_045
+ * @tc.desc: Test a full event trace ring of the widest lines is dumped without truncation.
+ * @tc.type: FUNC
+ */
+HWTEST_F(DarkModeTest, ui_appearance_test_045, TestSize.Level0)
+{
+    EventTrace& trace = EventTrace::GetInstance();
+    trace.Reset();
+    const int32_t widest = std::numeric_limits<int32_t>::min();
+    for (size_t i = 0; i < EventTrace::CAPACITY * 2; ++i) {
+        trace.Record(TraceEventType::UPDATE_CONFIGURATION, widest, widest, widest);
+    }
+    std::vector<TraceEvent> events = trace.GetEvents();
+    ASSERT_EQ(events.size(), EventTrace::CAPACITY);
+    const std::string lastSequence = "#" + std::to_string(events.back().sequence) + " ";
+
+    auto test = DarkModeTest::GetUiAppearanceAbilityTest();
+    for (const auto& args : std::vector<std::vector<std::u16string>> { { u"-trace" }, {} }) {
+        std::string dump = DumpToString(*test, args);
+        EXPECT_EQ(dump.find("dump truncated"), std::string::npos);
+        EXPECT_NE(dump.find(lastSequence), std::string::npos);
+        size_t lines = 0;
+        for (size_t pos = dump.find("] #"); pos != std::string::npos; pos = dump.find("] #", pos + 1)) {
+            ++lines;
+        }
+        EXPECT_EQ(lines, EventTrace::CAPACITY);
+    }
+    trace.Reset();
+}
+
+/**
+ * @tc.name: ui_appearance_test_046
+ * @tc.desc: Test a merged request that waits too long returns early and is still applied by the applying caller.
+ * @tc.type: FUNC
+ */
+HWTEST_F(DarkModeTest, ui_appearance_test_046, TestSize.Level0)
+{
+    static constexpr int32_t timeoutResult = -1;
+    LatestValueCombiner<int32_t> combiner(std::chrono::milliseconds(20), timeoutResult);
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool isReleased = false;
+    std::vector<std::pair<int32_t, uint32_t>> applied;
+    auto apply = [&](const int32_t& value, const uint32_t mergedCount) {
+        std::unique_lock lock(mutex);
+        applied.emplace_back(value, mergedCount);
+        cv.wait(lock, [&isReleased]() { return isReleased; });
+        return value * 10;
+    };
+
+    int32_t firstResult = 0;
+    std::thread first([&]() { firstResult = combiner.Submit(1, apply); });
+    while (combiner.GetSubmitCount() < 1) {
+        std::this_thread::yield();
+    }
+    EXPECT_EQ(combiner.Submit(2, apply), timeoutResult);
+    EXPECT_EQ(combiner.GetTimeoutCount(), 1u);
+    {
+        std::lock_guard lock(mutex);
+        isReleased = true;
+    }
+    cv.notify_all();
+    first.join();
+
+    EXPECT_EQ(firstResult, 10);
+    ASSERT_EQ(applied.size(), 2u);
+    EXPECT_EQ(applied[1], std::make_pair(2, 1u));
+    EXPECT_EQ(combiner.GetApplyCount(), 2u);
+}
 } // namespace ArkUi::UiAppearance
 } // namespace OHOS